@@ -0,0 +1,208 @@
+#include <lokinet.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// throughput benchmark for lokinet_udp_flow_sendmmsg: many threads push batches of datagrams over
+// one flow between two lokinet contexts and we count what gets queued, sent and received.
+
+using Lokinet_ptr = std::shared_ptr<lokinet_context>;
+
+struct Counters
+{
+  std::atomic<uint64_t> queued{0};
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<uint64_t> sent{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<uint64_t> received{0};
+  std::atomic<uint64_t> receivedBytes{0};
+};
+
+Counters counters;
+
+[[nodiscard]] auto
+MakeLokinet(const std::vector<char>& bootstrap)
+{
+  auto ctx = std::shared_ptr<lokinet_context>(lokinet_context_new(), lokinet_context_free);
+  if (auto err = lokinet_add_bootstrap_rc(bootstrap.data(), bootstrap.size(), ctx.get()))
+    throw std::runtime_error{strerror(err)};
+  if (lokinet_context_start(ctx.get()))
+    throw std::runtime_error{"could not start context"};
+  return ctx;
+}
+
+void
+WaitForReady(const Lokinet_ptr& ctx)
+{
+  while (lokinet_wait_for_ready(1000, ctx.get()))
+  {
+    std::cout << "waiting for context..." << std::endl;
+  }
+}
+
+int
+AcceptFlow(void*, const lokinet_udp_flowinfo*, void** flowdata, int* timeout)
+{
+  *flowdata = nullptr;
+  *timeout = 30;
+  return 0;
+}
+
+void
+CreateOutboundFlow(void*, void** flowdata, int* timeout)
+{
+  *flowdata = nullptr;
+  *timeout = 30;
+}
+
+void
+DropFlow(const lokinet_udp_flowinfo*, void*)
+{}
+
+void
+CountPacket(const lokinet_udp_flowinfo*, const char*, size_t len, void*)
+{
+  counters.received.fetch_add(1, std::memory_order_relaxed);
+  counters.receivedBytes.fetch_add(len, std::memory_order_relaxed);
+}
+
+void
+IgnorePacket(const lokinet_udp_flowinfo*, const char*, size_t, void*)
+{}
+
+void
+BatchDone(size_t sent, size_t dropped, int, void*)
+{
+  counters.sent.fetch_add(sent, std::memory_order_relaxed);
+  counters.dropped.fetch_add(dropped, std::memory_order_relaxed);
+}
+
+void
+SendLoop(
+    const lokinet_udp_flowinfo* remote,
+    lokinet_context* ctx,
+    size_t batchSize,
+    size_t pktSize,
+    const std::atomic<bool>& run)
+{
+  std::vector<char> data(pktSize, 'x');
+  std::vector<lokinet_udp_pkt> pkts(batchSize, lokinet_udp_pkt{data.data(), data.size()});
+  while (run)
+  {
+    if (auto err =
+            lokinet_udp_flow_sendmmsg(remote, pkts.data(), pkts.size(), BatchDone, nullptr, ctx))
+    {
+      counters.rejected.fetch_add(pkts.size(), std::memory_order_relaxed);
+      if (err != EAGAIN)
+      {
+        std::cout << "send failed: " << strerror(err) << std::endl;
+        return;
+      }
+      // the send queue is full, give lokinet a moment to drain it
+      std::this_thread::sleep_for(std::chrono::microseconds{100});
+      continue;
+    }
+    counters.queued.fetch_add(pkts.size(), std::memory_order_relaxed);
+  }
+}
+
+int
+main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cout << "usage: " << argv[0]
+              << " bootstrap.signed [threads=4] [batch=32] [size=512] [seconds=10]" << std::endl;
+    return 1;
+  }
+  const size_t threads = argc > 2 ? std::stoul(argv[2]) : 4;
+  const size_t batchSize = argc > 3 ? std::stoul(argv[3]) : 32;
+  const size_t pktSize = argc > 4 ? std::stoul(argv[4]) : 512;
+  const auto duration = std::chrono::seconds{argc > 5 ? std::stoul(argv[5]) : 10};
+
+  std::vector<char> bootstrap;
+
+  // load bootstrap.signed
+  {
+    std::ifstream inf{argv[1], std::ifstream::ate | std::ifstream::binary};
+    size_t len = inf.tellg();
+    inf.seekg(0);
+    bootstrap.resize(len);
+    inf.read(bootstrap.data(), bootstrap.size());
+  }
+
+  if (auto* loglevel = getenv("LOKINET_LOG"))
+    lokinet_log_level(loglevel);
+  else
+    lokinet_log_level("none");
+
+  const auto port = 10000;
+
+  auto recip = MakeLokinet(bootstrap);
+  WaitForReady(recip);
+  lokinet_udp_bind_result recipBindResult{};
+  if (auto err = lokinet_udp_bind(
+          port, AcceptFlow, CountPacket, DropFlow, nullptr, &recipBindResult, recip.get()))
+  {
+    std::cout << "failed to bind recip udp socket " << strerror(err) << std::endl;
+    return 1;
+  }
+
+  auto sender = MakeLokinet(bootstrap);
+  WaitForReady(sender);
+  lokinet_udp_bind_result senderBindResult{};
+  if (auto err = lokinet_udp_bind(
+          port, AcceptFlow, IgnorePacket, DropFlow, nullptr, &senderBindResult, sender.get()))
+  {
+    std::cout << "failed to bind sender udp socket " << strerror(err) << std::endl;
+    return 1;
+  }
+
+  const std::string recipaddr{lokinet_address(recip.get())};
+  lokinet_udp_flowinfo remote{};
+  remote.socket_id = senderBindResult.socket_id;
+  remote.remote_port = port;
+  std::copy_n(recipaddr.c_str(), recipaddr.size(), remote.remote_host);
+
+  while (auto err = lokinet_udp_establish(CreateOutboundFlow, nullptr, &remote, sender.get()))
+  {
+    std::cout << "failed to establish to recip: " << strerror(err) << std::endl;
+    usleep(100000);
+  }
+
+  std::cout << "sending " << pktSize << " byte datagrams in batches of " << batchSize << " from "
+            << threads << " threads for " << duration.count() << "s" << std::endl;
+
+  std::atomic<bool> run{true};
+  std::vector<std::thread> senders;
+  const auto started = std::chrono::steady_clock::now();
+  for (size_t idx = 0; idx < threads; ++idx)
+    senders.emplace_back(SendLoop, &remote, sender.get(), batchSize, pktSize, std::cref(run));
+  std::this_thread::sleep_for(duration);
+  run = false;
+  for (auto& th : senders)
+    th.join();
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+  // let whatever is still in flight arrive
+  std::this_thread::sleep_for(std::chrono::seconds{2});
+
+  const double secs = elapsed.count();
+  std::cout << "queued:   " << counters.queued << " (" << counters.queued / secs << "/s)\n"
+            << "rejected: " << counters.rejected << " (send queue full)\n"
+            << "sent:     " << counters.sent << " (" << counters.sent / secs << "/s)\n"
+            << "dropped:  " << counters.dropped << "\n"
+            << "received: " << counters.received << " (" << counters.received / secs << "/s, "
+            << (counters.receivedBytes * 8) / (secs * 1000 * 1000) << " Mbit/s)" << std::endl;
+  return 0;
+}
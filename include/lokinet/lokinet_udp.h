@@ -108,6 +108,56 @@ extern "C"
       size_t len,
       struct lokinet_context* ctx);
 
+  /// a datagram to send with lokinet_udp_flow_sendmmsg
+  struct lokinet_udp_pkt
+  {
+    /// pointer to the datagram's data
+    const void* data;
+    /// the length of the data
+    size_t len;
+  };
+
+  /// hook function called once a batch given to lokinet_udp_flow_sendmmsg is done with
+  /// called from lokinet's thread, so it must not block
+  ///
+  /// @param sent how many datagrams were handed to lokinet for sending
+  ///
+  /// @param dropped how many datagrams were dropped because they were malformed or because the
+  /// remote endpoint was unreachable
+  ///
+  /// @param err 0 once lokinet went through the batch, ECANCELED if the context was stopped or
+  /// freed before it got to the batch, in which case every datagram counts as dropped
+  typedef void (*lokinet_udp_flow_send_done_func)(
+      size_t sent, size_t dropped, int err, void* user);
+
+  /// @brief queue many datagrams on an established flow to remote endpoint
+  /// does not block: the datagrams are copied and queued for lokinet's thread which sends them
+  /// later and then reports how it went via done. safe to call from many threads at once.
+  ///
+  /// @param flowinfo remote flow to use for sending
+  ///
+  /// @param pkts the datagrams to send, the memory they point to can be reused as soon as we return
+  ///
+  /// @param num the number of datagrams in pkts
+  ///
+  /// @param done called once the batch is sent or cancelled, may be null. not called if we return
+  /// non zero.
+  ///
+  /// @param user passed to done as user data
+  ///
+  /// @param ctx the lokinet context to use
+  ///
+  /// @returns 0 when the batch was queued and non zero errno on fail; EAGAIN if the send queue is
+  /// full and the caller should back off before trying again
+  int EXPORT
+  lokinet_udp_flow_sendmmsg(
+      const struct lokinet_udp_flowinfo* remote,
+      const struct lokinet_udp_pkt* pkts,
+      size_t num,
+      lokinet_udp_flow_send_done_func done,
+      void* user,
+      struct lokinet_context* ctx);
+
   /// @brief close a bound udp socket
   /// closes all flows immediately
   ///
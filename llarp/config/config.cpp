@@ -866,6 +866,23 @@ namespace llarp
           m_bind.emplace_back(addr);
         });
 
+    conf.defineOption<int>(
+        "dns",
+        "resolver-threads",
+        Default{0},
+        Comment{
+            "Number of threads to read dns requests on and resolve upstream queries with, each",
+            "with its own socket on every bind address and its own upstream resolver. Queries",
+            "for .loki and .snode are still answered on the main thread.",
+            "0 resolves everything on the main thread. Only used when binding a udp socket on",
+            "linux.",
+        },
+        [this](int arg) {
+          if (arg < 0 or arg > 64)
+            throw std::invalid_argument{"resolver-threads must be between 0 and 64"};
+          m_ResolverThreads = arg;
+        });
+
     conf.defineOption<fs::path>(
         "dns",
         "add-hosts",
@@ -160,6 +160,8 @@ namespace llarp
     std::vector<SockAddr> m_upstreamDNS;
     std::vector<fs::path> m_hostfiles;
     std::optional<SockAddr> m_QueryBind;
+    /// threads resolving upstream queries off the main loop, 0 to resolve on the main loop
+    int m_ResolverThreads = 0;
 
     std::unordered_multimap<std::string, std::string> m_ExtraOpts;
 
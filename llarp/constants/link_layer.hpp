@@ -7,6 +7,8 @@
 constexpr size_t MAX_LINK_MSG_SIZE = 8192;
 static constexpr auto DefaultLinkSessionLifetime = 5min;
 constexpr size_t MaxSendQueueSize = 1024 * 16;
+/// send queue backlog at which we tell upper layers to back off
+constexpr size_t SendQueueCongestionThreshold = (MaxSendQueueSize * 3) / 4;
 static constexpr auto LinkLayerConnectTimeout = 5s;
 
 namespace llarp::constants
@@ -39,8 +39,10 @@ namespace llarp
     /// if a path is inactive for this amount of time it's dead
     constexpr auto alive_timeout = latency_interval * 1.5;
 
-    /// how big transit hop traffic queues are
-    constexpr std::size_t transit_hop_queue_size = 256;
+    /// how many spare relay message batches our transit hops share
+    constexpr std::size_t transit_relay_spare_batches = 32;
+    /// relay message batches bigger than this are not kept for reuse
+    constexpr std::size_t transit_relay_max_batch = 64;
 
   }  // namespace path
 }  // namespace llarp
@@ -5,27 +5,40 @@
 #include <llarp/util/bencode.h>
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/mem.hpp>
+#include <llarp/util/pooled_bytes.hpp>
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace llarp
 {
-  /// encrypted buffer base type
+  /// encrypted buffer base type, holds up to bufsz bytes.
+  /// only the space the payload needs is used: small payloads are kept inline and bigger ones in
+  /// a pooled block of the nearest size class, so copying, moving or holding on to a short
+  /// message never touches bufsz bytes and replacing a payload does not go to the allocator.
   template <size_t bufsz = MAX_LINK_MSG_SIZE>
   struct Encrypted
   {
+    /// payloads up to this size are stored inline
+    static constexpr size_t InlineSize = std::min(bufsz, size_t{128});
+    static_assert(bufsz <= util::PooledBytes::MaxSize);
+
     Encrypted(Encrypted&& other)
     {
-      _sz = std::move(other._sz);
-      _buf = std::move(other._buf);
+      _sz = std::exchange(other._sz, 0);
+      _heap = std::move(other._heap);
+      if (not _heap)
+        std::copy_n(other._inline.data(), _sz, _inline.data());
       UpdateBuffer();
+      other.UpdateBuffer();
     }
 
     Encrypted(const Encrypted& other) : Encrypted(other.data(), other.size())
-    {
-      UpdateBuffer();
-    }
+    {}
 
     Encrypted()
     {
@@ -43,14 +56,13 @@ namespace llarp
     {
       if (sz <= bufsz)
       {
+        Reserve(sz);
         _sz = sz;
         if (buf)
-          memcpy(_buf.data(), buf, sz);
+          std::copy_n(buf, sz, data());
         else
-          _buf.Zero();
+          std::fill_n(data(), sz, 0);
       }
-      else
-        _sz = 0;
       UpdateBuffer();
     }
 
@@ -75,6 +87,21 @@ namespace llarp
       return !(*this == other);
     }
 
+    Encrypted&
+    operator=(Encrypted&& other)
+    {
+      if (this != &other)
+      {
+        _sz = std::exchange(other._sz, 0);
+        _heap = std::move(other._heap);
+        if (not _heap)
+          std::copy_n(other._inline.data(), _sz, _inline.data());
+        UpdateBuffer();
+        other.UpdateBuffer();
+      }
+      return *this;
+    }
+
     Encrypted&
     operator=(const Encrypted& other)
     {
@@ -84,26 +111,42 @@ namespace llarp
     Encrypted&
     operator=(const llarp_buffer_t& buf)
     {
-      if (buf.sz <= _buf.size())
+      if (buf.sz <= bufsz)
       {
+        Reserve(buf.sz);
         _sz = buf.sz;
-        memcpy(_buf.data(), buf.base, _sz);
+        if (_sz)
+          memmove(data(), buf.base, _sz);
       }
       UpdateBuffer();
       return *this;
     }
 
+    /// change the payload size keeping the bytes already there, new bytes are zero.
+    /// does nothing if sz is more than we can hold.
+    void
+    Resize(size_t sz)
+    {
+      if (sz > bufsz)
+        return;
+      Reserve(sz);
+      if (sz > _sz)
+        std::fill(data() + _sz, data() + sz, 0);
+      _sz = sz;
+      UpdateBuffer();
+    }
+
     void
     Fill(byte_t fill)
     {
-      std::fill(_buf.begin(), _buf.begin() + _sz, fill);
+      std::fill_n(data(), _sz, fill);
     }
 
     void
     Randomize()
     {
       if (_sz)
-        randombytes(_buf.data(), _sz);
+        randombytes(data(), _sz);
     }
 
     bool
@@ -112,11 +155,12 @@ namespace llarp
       llarp_buffer_t strbuf;
       if (!bencode_read_string(buf, &strbuf))
         return false;
-      if (strbuf.sz > sizeof(_buf))
+      if (strbuf.sz > bufsz)
         return false;
+      Reserve(strbuf.sz);
       _sz = strbuf.sz;
       if (_sz)
-        memcpy(_buf.data(), strbuf.base, _sz);
+        memcpy(data(), strbuf.base, _sz);
       UpdateBuffer();
       return true;
     }
@@ -142,25 +186,39 @@ namespace llarp
     byte_t*
     data()
     {
-      return _buf.data();
+      return _heap ? _heap.data() : _inline.data();
     }
 
     const byte_t*
     data() const
     {
-      return _buf.data();
+      return _heap ? _heap.data() : _inline.data();
     }
 
    protected:
     void
     UpdateBuffer()
     {
-      m_Buffer.base = _buf.data();
-      m_Buffer.cur = _buf.data();
+      m_Buffer.base = data();
+      m_Buffer.cur = data();
       m_Buffer.sz = _sz;
     }
-    AlignedBuffer<bufsz> _buf;
-    size_t _sz;
+
+    /// make room for sz bytes keeping the current payload, only ever grows
+    void
+    Reserve(size_t sz)
+    {
+      const size_t capacity = _heap ? _heap.capacity() : InlineSize;
+      if (sz <= capacity)
+        return;
+      util::PooledBytes heap{sz};
+      std::copy_n(data(), _sz, heap.data());
+      _heap = std::move(heap);
+    }
+
+    std::array<byte_t, InlineSize> _inline;
+    util::PooledBytes _heap;
+    size_t _sz = 0;
     llarp_buffer_t m_Buffer;
   };  // namespace llarp
 }  // namespace llarp
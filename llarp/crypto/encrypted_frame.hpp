@@ -22,16 +22,6 @@ namespace llarp
             std::min(sz, EncryptedFrameBodySize) + EncryptedFrameOverheadSize)
     {}
 
-    void
-    Resize(size_t sz)
-    {
-      if (sz <= EncryptedFrameSize)
-      {
-        _sz = sz;
-        UpdateBuffer();
-      }
-    }
-
     bool
     DoEncrypt(const SharedSecret& shared, bool noDH = false);
 
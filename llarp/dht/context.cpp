@@ -288,9 +288,6 @@ namespace llarp
      private:
       std::shared_ptr<int> _timer_keepalive;
 
-      void
-      CleanupTX();
-
       uint64_t ids;
 
       Key_t ourKey;
@@ -331,8 +328,6 @@ namespace llarp
     void
     Context::handle_cleaner_timer()
     {
-      // clean up transactions
-      CleanupTX();
       const llarp_time_t now = Now();
 
       if (_nodes)
@@ -437,17 +432,6 @@ namespace llarp
       return itr->second.introset;
     }
 
-    void
-    Context::CleanupTX()
-    {
-      auto now = Now();
-      llarp::LogTrace("DHT tick");
-
-      pendingRouterLookups().Expire(now);
-      _pendingIntrosetLookups.Expire(now);
-      pendingExploreLookups().Expire(now);
-    }
-
     util::StatusObject
     Context::ExtractStatus() const
     {
@@ -468,6 +452,10 @@ namespace llarp
       ourKey = us;
       _nodes = std::make_unique<Bucket<RCNode>>(ourKey, llarp::randint);
       _services = std::make_unique<Bucket<ISNode>>(ourKey, llarp::randint);
+      // lookups time out from timers on the router's loop
+      pendingRouterLookups().SetLoop(router->loop());
+      _pendingIntrosetLookups.SetLoop(router->loop());
+      pendingExploreLookups().SetLoop(router->loop());
       llarp::LogDebug("initialize dht with key ", ourKey);
       // start cleanup timer
       _timer_keepalive = std::make_shared<int>(0);
@@ -3,6 +3,7 @@
 
 #include "tx.hpp"
 #include "txowner.hpp"
+#include <llarp/ev/ev.hpp>
 #include <llarp/util/time.hpp>
 #include <llarp/util/status.hpp>
 
@@ -17,13 +18,36 @@ namespace llarp
     struct TXHolder
     {
       using TXPtr = std::unique_ptr<TX<K, V>>;
+
+      struct Timeout
+      {
+        llarp_time_t at;
+        // the event loop timer that times the lookup out
+        EventLoop::TimerID timer;
+      };
+
       // tx who are waiting for a reply for each key
       std::unordered_multimap<K, TXOwner> waiting;
       // tx timesouts by key
-      std::unordered_map<K, llarp_time_t> timeouts;
+      std::unordered_map<K, Timeout> timeouts;
       // maps remote peer with tx to handle reply from them
       std::unordered_map<TXOwner, TXPtr> tx;
 
+      TXHolder() = default;
+
+      ~TXHolder()
+      {
+        for (const auto& [key, timeout] : timeouts)
+          m_Loop->cancel_later(timeout.timer);
+      }
+
+      /// the event loop lookups time out on, set before the first NewTX
+      void
+      SetLoop(EventLoop_ptr loop)
+      {
+        m_Loop = std::move(loop);
+      }
+
       const TX<K, V>*
       GetPendingLookupFrom(const TXOwner& owner) const;
 
@@ -47,7 +71,7 @@ namespace llarp
             std::back_inserter(timeoutsObjs),
             [](const auto& item) -> util::StatusObject {
               return util::StatusObject{
-                  {"time", to_json(item.second)}, {"target", item.first.ExtractStatus()}};
+                  {"time", to_json(item.second.at)}, {"target", item.first.ExtractStatus()}};
             });
         obj["timeouts"] = timeoutsObjs;
         std::transform(
@@ -102,8 +126,14 @@ namespace llarp
           bool sendreply = false,
           bool removeTimeouts = true);
 
+     private:
+      /// the lookup for key ran out of time, called from its timer
       void
-      Expire(llarp_time_t now);
+      TimedOut(const K& key);
+
+      EventLoop_ptr m_Loop;
+      // timers only touch us while this is alive
+      std::shared_ptr<int> m_Alive = std::make_shared<int>(0);
     };
 
     template <typename K, typename V>
@@ -136,7 +166,12 @@ namespace llarp
       auto itr = timeouts.find(k);
       if (itr == timeouts.end())
       {
-        timeouts.emplace(k, time_now_ms() + requestTimeoutMS);
+        const auto timer = m_Loop->call_later(
+            requestTimeoutMS, [this, k, alive = std::weak_ptr<int>{m_Alive}]() {
+              if (not alive.expired())
+                TimedOut(k);
+            });
+        timeouts.emplace(k, Timeout{time_now_ms() + requestTimeoutMS, timer});
       }
       if (count == 0)
       {
@@ -188,27 +223,21 @@ namespace llarp
 
       if (removeTimeouts)
       {
-        timeouts.erase(key);
+        if (auto itr = timeouts.find(key); itr != timeouts.end())
+        {
+          m_Loop->cancel_later(itr->second.timer);
+          timeouts.erase(itr);
+        }
       }
     }
 
     template <typename K, typename V>
     void
-    TXHolder<K, V>::Expire(llarp_time_t now)
+    TXHolder<K, V>::TimedOut(const K& key)
     {
-      auto itr = timeouts.begin();
-      while (itr != timeouts.end())
-      {
-        if (now >= itr->second)
-        {
-          Inform(TXOwner{}, itr->first, {}, true, false);
-          itr = timeouts.erase(itr);
-        }
-        else
-        {
-          ++itr;
-        }
-      }
+      // drop the timeout first, the replies may start a new lookup for the same key
+      timeouts.erase(key);
+      Inform(TXOwner{}, key, {}, true, false);
     }
   }  // namespace dht
 }  // namespace llarp
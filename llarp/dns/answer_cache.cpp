@@ -0,0 +1,175 @@
+#include "answer_cache.hpp"
+#include "dns.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace llarp::dns
+{
+  RR_TTL_t
+  AnswerTTL(llarp_time_t lifetime)
+  {
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(lifetime).count();
+    return std::clamp<int64_t>(secs, 1, MaxAnswerTTL);
+  }
+
+  std::optional<AnswerCache::Key>
+  AnswerCache::KeyFor(const Message& msg)
+  {
+    if (msg.questions.size() != 1)
+      return std::nullopt;
+    const auto& question = msg.questions[0];
+    Key key{question.qname, question.qtype};
+    // names are case insensitive
+    std::transform(key.qname.begin(), key.qname.end(), key.qname.begin(), [](unsigned char ch) {
+      return std::tolower(ch);
+    });
+    return key;
+  }
+
+  bool
+  AnswerCache::Get(Message& query, llarp_time_t now)
+  {
+    const auto key = KeyFor(query);
+    if (not key)
+      return false;
+    auto itr = m_Answers.find(*key);
+    if (itr == m_Answers.end())
+      return false;
+    if (itr->second.expiresAt <= now)
+    {
+      m_Answers.erase(itr);
+      return false;
+    }
+    const auto& entry = itr->second;
+    const auto elapsed = static_cast<RR_TTL_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(now - entry.cachedAt).count());
+    query.hdr_fields = entry.answer.hdr_fields;
+    query.answers.clear();
+    for (const auto& rec : entry.answer.answers)
+    {
+      auto& copy = query.answers.emplace_back(rec);
+      copy.ttl = rec.ttl > elapsed + 1 ? rec.ttl - elapsed : 1;
+    }
+    return true;
+  }
+
+  bool
+  AnswerCache::Pend(const Message& query, Reply_t reply, llarp_time_t now)
+  {
+    const auto key = KeyFor(query);
+    if (not key)
+      return true;
+    auto itr = m_Pending.find(*key);
+    if (itr == m_Pending.end())
+    {
+      m_Pending.emplace(*key, Pending{query, now, {}});
+      return true;
+    }
+    if (itr->second.started + m_PendingTimeout <= now)
+    {
+      // the lookup in flight is lost, whoever is waiting gets the answer of the new one
+      itr->second.started = now;
+      return true;
+    }
+    // answer with the waiter's own message id
+    itr->second.waiting.push_back([id = query.hdr_id, reply = std::move(reply)](Message answer) {
+      answer.hdr_id = id;
+      reply(std::move(answer));
+    });
+    return false;
+  }
+
+  void
+  AnswerCache::Put(const Message& answer, llarp_time_t now)
+  {
+    auto key = KeyFor(answer);
+    if (not key)
+      return;
+
+    std::vector<Reply_t> waiting;
+    if (auto itr = m_Pending.find(*key); itr != m_Pending.end())
+    {
+      waiting = std::move(itr->second.waiting);
+      m_Pending.erase(itr);
+    }
+
+    const auto rcode = answer.hdr_fields & 0xf;
+    std::optional<RR_TTL_t> ttl;
+    if (rcode == flags_RCODENameError)
+      ttl = answer.nx_ttl;
+    else if (rcode == flags_RCODENoError and not answer.answers.empty())
+    {
+      for (const auto& rec : answer.answers)
+        ttl = std::min(ttl.value_or(rec.ttl), rec.ttl);
+    }
+    if (ttl and *ttl > 1)
+    {
+      if (m_Answers.size() >= m_MaxEntries)
+        Expire(now);
+      if (m_Answers.size() >= m_MaxEntries)
+        m_Answers.erase(m_Answers.begin());
+      m_Answers.erase(*key);
+      m_Answers.emplace(std::move(*key), Entry{answer, now, now + std::chrono::seconds{*ttl}});
+    }
+
+    for (auto& reply : waiting)
+      reply(answer);
+  }
+
+  void
+  AnswerCache::Fail(Pending& pending)
+  {
+    for (auto& reply : pending.waiting)
+    {
+      Message fail{pending.query};
+      fail.AddServFail();
+      reply(std::move(fail));
+    }
+  }
+
+  void
+  AnswerCache::Cancel(const Message& query)
+  {
+    const auto key = KeyFor(query);
+    if (not key)
+      return;
+    auto itr = m_Pending.find(*key);
+    if (itr == m_Pending.end())
+      return;
+    auto pending = std::move(itr->second);
+    m_Pending.erase(itr);
+    Fail(pending);
+  }
+
+  void
+  AnswerCache::Expire(llarp_time_t now)
+  {
+    for (auto itr = m_Answers.begin(); itr != m_Answers.end();)
+    {
+      if (itr->second.expiresAt <= now)
+        itr = m_Answers.erase(itr);
+      else
+        ++itr;
+    }
+    std::vector<Pending> lost;
+    for (auto itr = m_Pending.begin(); itr != m_Pending.end();)
+    {
+      if (itr->second.started + m_PendingTimeout <= now)
+      {
+        lost.push_back(std::move(itr->second));
+        itr = m_Pending.erase(itr);
+      }
+      else
+        ++itr;
+    }
+    for (auto& pending : lost)
+      Fail(pending);
+  }
+
+  void
+  AnswerCache::Clear()
+  {
+    m_Answers.clear();
+  }
+}  // namespace llarp::dns
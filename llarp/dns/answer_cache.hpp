@@ -0,0 +1,117 @@
+#pragma once
+
+#include "message.hpp"
+
+#include <llarp/util/time.hpp>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp::dns
+{
+  /// longest we let anyone cache an answer we made up
+  constexpr RR_TTL_t MaxAnswerTTL = 300;
+  /// how long a name that does not exist stays that way
+  constexpr RR_TTL_t NegativeAnswerTTL = 15;
+
+  /// clamp a remaining lifetime to a ttl we are willing to hand out
+  RR_TTL_t
+  AnswerTTL(llarp_time_t lifetime);
+
+  /// answers to hooked dns queries, keyed by question, and the queries waiting on a lookup that
+  /// is already in flight. answers are kept for as long as the shortest ttl in them, answers with
+  /// a ttl of 1 or less and server failures are never kept.
+  /// a lookup that has not answered within the pending timeout is assumed lost, its waiters get a
+  /// server failure and the next query for it starts a new lookup.
+  /// not thread safe, lives on the logic thread with whatever does the lookups.
+  class AnswerCache
+  {
+   public:
+    using Reply_t = std::function<void(Message)>;
+
+    explicit AnswerCache(size_t maxEntries = 4096, llarp_time_t pendingTimeout = 1min)
+        : m_MaxEntries{maxEntries}, m_PendingTimeout{pendingTimeout}
+    {}
+
+    /// if we have a fresh answer to query fill it in with the ttls counted down and return true
+    bool
+    Get(Message& query, llarp_time_t now);
+
+    /// register interest in the answer to query. returns true if the caller should go look it
+    /// up, false if a lookup is already in flight and reply will be called with its answer
+    bool
+    Pend(const Message& query, Reply_t reply, llarp_time_t now);
+
+    /// the lookup for answer's question finished: keep it if it can be cached and send it to
+    /// everyone that was waiting on it
+    void
+    Put(const Message& answer, llarp_time_t now);
+
+    /// the lookup for query was abandoned, everyone waiting on it gets a server failure
+    void
+    Cancel(const Message& query);
+
+    /// drop expired answers and fail lookups that took too long
+    void
+    Expire(llarp_time_t now);
+
+    /// drop every answer, for when the answers we gave are no longer true
+    void
+    Clear();
+
+    size_t
+    size() const
+    {
+      return m_Answers.size();
+    }
+
+   private:
+    struct Key
+    {
+      std::string qname;
+      QType_t qtype;
+
+      bool
+      operator==(const Key& other) const
+      {
+        return qtype == other.qtype and qname == other.qname;
+      }
+    };
+
+    struct KeyHash
+    {
+      size_t
+      operator()(const Key& key) const
+      {
+        return std::hash<std::string>{}(key.qname) ^ key.qtype;
+      }
+    };
+
+    struct Entry
+    {
+      Message answer;
+      llarp_time_t cachedAt;
+      llarp_time_t expiresAt;
+    };
+
+    struct Pending
+    {
+      Message query;
+      llarp_time_t started;
+      std::vector<Reply_t> waiting;
+    };
+
+    static std::optional<Key>
+    KeyFor(const Message& msg);
+
+    static void
+    Fail(Pending& pending);
+
+    const size_t m_MaxEntries;
+    const llarp_time_t m_PendingTimeout;
+    std::unordered_map<Key, Entry, KeyHash> m_Answers;
+    std::unordered_map<Key, Pending, KeyHash> m_Pending;
+  };
+}  // namespace llarp::dns
@@ -10,6 +10,7 @@ namespace llarp
     constexpr uint16_t qTypeAAAA = 28;
     constexpr uint16_t qTypeTXT = 16;
     constexpr uint16_t qTypeMX = 15;
+    constexpr uint16_t qTypeSOA = 6;
     constexpr uint16_t qTypePTR = 12;
     constexpr uint16_t qTypeCNAME = 5;
     constexpr uint16_t qTypeNS = 2;
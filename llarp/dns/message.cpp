@@ -2,6 +2,7 @@
 #include <oxenc/endian.h>
 
 #include "dns.hpp"
+#include "packet.hpp"
 #include "srv_data.hpp"
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/logging.hpp>
@@ -62,6 +63,7 @@ namespace llarp
         , answers(std::move(other.answers))
         , authorities(std::move(other.authorities))
         , additional(std::move(other.additional))
+        , nx_ttl(other.nx_ttl)
     {}
 
     Message::Message(const Message& other)
@@ -71,6 +73,7 @@ namespace llarp
         , answers(other.answers)
         , authorities(other.authorities)
         , additional(other.additional)
+        , nx_ttl(other.nx_ttl)
     {}
 
     Message::Message(const MessageHeader& hdr) : hdr_id(hdr.id), hdr_fields(hdr.fields)
@@ -86,28 +89,54 @@ namespace llarp
       questions.emplace_back(question);
     }
 
-    bool
-    Message::Encode(llarp_buffer_t* buf) const
+    Message::Message(const MessageView& view)
+        : hdr_id{view.Header().id}, hdr_fields{view.Header().fields}
     {
-      MessageHeader hdr;
-      hdr.id = hdr_id;
-      hdr.fields = hdr_fields;
-      hdr.qd_count = questions.size();
-      hdr.an_count = answers.size();
-      hdr.ns_count = 0;
-      hdr.ar_count = 0;
-
-      if (!hdr.Encode(buf))
-        return false;
+      questions.reserve(view.Header().qd_count);
+      view.ForEachQuestion([this](const QuestionView& q) {
+        auto& question = questions.emplace_back();
+        question.qname = q.qname.ToString();
+        question.qtype = q.qtype;
+        question.qclass = q.qclass;
+      });
+      answers.reserve(view.Header().an_count);
+      view.ForEachRecord(Section::answer, [this, &view](const RecordView& rr) {
+        auto& rec = answers.emplace_back();
+        rec.rr_name = rr.rr_name.ToString();
+        rec.rr_type = rr.rr_type;
+        rec.rr_class = rr.rr_class;
+        rec.ttl = rr.ttl;
+        rec.rData = view.RData(rr);
+      });
+    }
 
+    void
+    Message::WriteTo(PacketWriter& writer) const
+    {
+      writer.Header(hdr_id, hdr_fields);
       for (const auto& question : questions)
-        if (!question.Encode(buf))
-          return false;
-
+        writer.Question(question.qname, question.qtype, question.qclass);
       for (const auto& answer : answers)
-        if (!answer.Encode(buf))
-          return false;
+      {
+        writer.Record(
+            Section::answer,
+            answer.rr_name,
+            answer.rr_type,
+            answer.ttl,
+            byte_view_t{answer.rData.data(), answer.rData.size()},
+            answer.rr_class);
+      }
+    }
 
+    bool
+    Message::Encode(llarp_buffer_t* buf) const
+    {
+      PacketWriter writer{buf->cur, buf->size_left()};
+      WriteTo(writer);
+      const auto sz = writer.Finish();
+      if (not sz)
+        return false;
+      buf->cur += *sz;
       return true;
     }
 
@@ -153,11 +182,15 @@ namespace llarp
     OwnedBuffer
     Message::ToBuffer() const
     {
-      std::array<byte_t, 1500> tmp;
-      llarp_buffer_t buf{tmp};
-      if (not Encode(&buf))
+      // encode straight into the buffer we hand out rather than copying out of a scratch one
+      OwnedBuffer pkt{1500};
+      PacketWriter writer{pkt.buf.get(), pkt.sz};
+      WriteTo(writer);
+      const auto sz = writer.Finish();
+      if (not sz)
         throw std::runtime_error("cannot encode dns message");
-      return OwnedBuffer::copy_used(buf);
+      pkt.sz = *sz;
+      return pkt;
     }
 
     void
@@ -388,10 +421,11 @@ namespace llarp
     }
 
     void
-    Message::AddNXReply(RR_TTL_t)
+    Message::AddNXReply(RR_TTL_t ttl)
     {
       if (questions.size())
       {
+        nx_ttl = ttl;
         answers.clear();
         authorities.clear();
         additional.clear();
@@ -421,14 +455,9 @@ namespace llarp
     std::optional<Message>
     MaybeParseDNSMessage(llarp_buffer_t buf)
     {
-      MessageHeader hdr{};
-      if (not hdr.Decode(&buf))
-        return std::nullopt;
-
-      Message msg{hdr};
-      if (not msg.Decode(&buf))
-        return std::nullopt;
-      return msg;
+      if (auto view = MessageView::Parse(buf.view_remaining()))
+        return Message{*view};
+      return std::nullopt;
     }
   }  // namespace dns
 }  // namespace llarp
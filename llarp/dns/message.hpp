@@ -9,6 +9,8 @@ namespace llarp
   namespace dns
   {
     struct SRVData;
+    class MessageView;
+    class PacketWriter;
 
     using MsgID_t = uint16_t;
     using Fields_t = uint16_t;
@@ -49,6 +51,8 @@ namespace llarp
     {
       explicit Message(const MessageHeader& hdr);
       explicit Message(const Question& question);
+      /// copy the questions and answers out of a parsed packet
+      explicit Message(const MessageView& view);
 
       Message(Message&& other);
       Message(const Message& other);
@@ -89,6 +93,10 @@ namespace llarp
       bool
       Decode(llarp_buffer_t* buf) override;
 
+      /// write the questions and answers to writer
+      void
+      WriteTo(PacketWriter& writer) const;
+
       // Wrapper around Encode that encodes into a new buffer and returns it
       [[nodiscard]] OwnedBuffer
       ToBuffer() const;
@@ -102,6 +110,8 @@ namespace llarp
       std::vector<ResourceRecord> answers;
       std::vector<ResourceRecord> authorities;
       std::vector<ResourceRecord> additional;
+      /// how long the name error set by AddNXReply may be cached for
+      RR_TTL_t nx_ttl = 0;
     };
 
     std::optional<Message>
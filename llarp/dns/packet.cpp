@@ -0,0 +1,487 @@
+#include "packet.hpp"
+
+#include <oxenc/endian.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace llarp
+{
+  namespace dns
+  {
+    std::optional<size_t>
+    NameView::Skip(byte_view_t packet, size_t offset)
+    {
+      std::optional<size_t> end;
+      size_t pos = offset;
+      size_t total = 1;
+      size_t jumps = 0;
+      for (;;)
+      {
+        if (pos >= packet.size())
+          return std::nullopt;
+        const byte_t len = packet[pos];
+        if (len == 0)
+          return end ? *end : pos + 1;
+        if ((len & 0xc0) == 0xc0)
+        {
+          if (pos + 1 >= packet.size())
+            return std::nullopt;
+          if (not end)
+            end = pos + 2;
+          // pointers may only go backwards and we only follow so many so a crafted packet cannot
+          // send us around in circles
+          const size_t target = ((len & 0x3f) << 8) | packet[pos + 1];
+          if (target >= pos or ++jumps > MaxNameLabels)
+            return std::nullopt;
+          pos = target;
+          continue;
+        }
+        // extended label types are not a thing
+        if (len & 0xc0)
+          return std::nullopt;
+        total += len + 1;
+        if (total > MaxNameSize or pos + 1 + len > packet.size())
+          return std::nullopt;
+        pos += len + 1;
+      }
+    }
+
+    /// dns names compare ascii case insensitively, std::tolower is locale aware and slow
+    static bool
+    LabelEquals(std::string_view a, std::string_view b)
+    {
+      const auto lower = [](char c) { return (c >= 'A' and c <= 'Z') ? char(c + ('a' - 'A')) : c; };
+      return std::equal(a.begin(), a.end(), b.begin(), b.end(), [lower](char x, char y) {
+        return lower(x) == lower(y);
+      });
+    }
+
+    std::optional<size_t>
+    NameView::CopyTo(char* out, size_t size) const
+    {
+      size_t len = 0;
+      bool fits = true;
+      ForEachLabel([&](std::string_view label) {
+        if (not fits or len + label.size() + 1 > size)
+        {
+          fits = false;
+          return;
+        }
+        std::memcpy(out + len, label.data(), label.size());
+        len += label.size();
+        out[len++] = '.';
+      });
+      if (not fits)
+        return std::nullopt;
+      return len;
+    }
+
+    std::string
+    NameView::ToString() const
+    {
+      std::array<char, MaxNameSize> tmp;
+      // a name that passed Skip always fits
+      const auto len = CopyTo(tmp.data(), tmp.size());
+      return std::string{tmp.data(), len.value_or(0)};
+    }
+
+    bool
+    NameView::MatchesAfter(size_t skip, std::string_view name, bool exact) const
+    {
+      if (not name.empty() and name.back() == '.')
+        name.remove_suffix(1);
+      bool match = true;
+      bool first = true;
+      ForEachLabel([&](std::string_view label) {
+        if (skip)
+        {
+          --skip;
+          return;
+        }
+        if (not match)
+          return;
+        if (not first)
+        {
+          if (name.empty() or name[0] != '.')
+          {
+            match = false;
+            return;
+          }
+          name.remove_prefix(1);
+        }
+        first = false;
+        const auto part = name.substr(0, label.size());
+        if (name.size() < label.size() or not(exact ? part == label : LabelEquals(part, label)))
+        {
+          match = false;
+          return;
+        }
+        name.remove_prefix(label.size());
+      });
+      return match and name.empty();
+    }
+
+    bool
+    NameView::Equals(std::string_view name) const
+    {
+      return MatchesAfter(0, name);
+    }
+
+    bool
+    NameView::Identical(std::string_view name) const
+    {
+      return MatchesAfter(0, name, true);
+    }
+
+    bool
+    NameView::EndsWith(std::string_view suffix) const
+    {
+      if (not suffix.empty() and suffix.front() == '.')
+        suffix.remove_prefix(1);
+      if (not suffix.empty() and suffix.back() == '.')
+        suffix.remove_suffix(1);
+      if (suffix.empty())
+        return true;
+      size_t labels = 0;
+      ForEachLabel([&labels](auto) { ++labels; });
+      const size_t want = std::count(suffix.begin(), suffix.end(), '.') + 1;
+      if (want > labels)
+        return false;
+      // compare our last labels with the suffix
+      return MatchesAfter(labels - want, suffix);
+    }
+
+    /// offset just past the name at pos in a packet that was already checked by Parse
+    static size_t
+    NameEnd(byte_view_t packet, size_t pos)
+    {
+      while (packet[pos] and (packet[pos] & 0xc0) != 0xc0)
+        pos += packet[pos] + 1;
+      return pos + (packet[pos] ? 2 : 1);
+    }
+
+    QuestionView
+    MessageView::QuestionAt(byte_view_t packet, size_t& pos)
+    {
+      QuestionView question;
+      question.qname = NameView{packet, pos};
+      pos = NameEnd(packet, pos);
+      question.qtype = oxenc::load_big_to_host<uint16_t>(packet.data() + pos);
+      question.qclass = oxenc::load_big_to_host<uint16_t>(packet.data() + pos + 2);
+      pos += 4;
+      return question;
+    }
+
+    RecordView
+    MessageView::RecordAt(byte_view_t packet, size_t& pos)
+    {
+      RecordView rec;
+      rec.rr_name = NameView{packet, pos};
+      pos = NameEnd(packet, pos);
+      const auto* ptr = packet.data() + pos;
+      rec.rr_type = oxenc::load_big_to_host<uint16_t>(ptr);
+      rec.rr_class = oxenc::load_big_to_host<uint16_t>(ptr + 2);
+      rec.ttl = oxenc::load_big_to_host<uint32_t>(ptr + 4);
+      const auto rdlen = oxenc::load_big_to_host<uint16_t>(ptr + 8);
+      rec.rData = packet.substr(pos + 10, rdlen);
+      pos += 10 + rdlen;
+      return rec;
+    }
+
+    namespace
+    {
+      /// how the rdata of a record type that carries names is laid out: fixed size fields, then
+      /// the names back to back, then more fixed size fields
+      struct RDataLayout
+      {
+        size_t before;
+        size_t names;
+        size_t after;
+      };
+
+      std::optional<RDataLayout>
+      LayoutOf(RRType_t type)
+      {
+        switch (type)
+        {
+          case qTypeNS:
+          case qTypeCNAME:
+          case qTypePTR:
+            return RDataLayout{0, 1, 0};
+          case qTypeMX:
+            return RDataLayout{2, 1, 0};
+          case qTypeSRV:
+            return RDataLayout{6, 1, 0};
+          case qTypeSOA:
+            return RDataLayout{0, 2, 20};
+          default:
+            return std::nullopt;
+        }
+      }
+
+      /// call visit(begin, end) with where each name in the rdata from pos to end starts and
+      /// stops, checking the names are well formed and inside the rdata. false if the rdata does
+      /// not fit the layout
+      template <typename Visit_t>
+      bool
+      ForEachRDataName(
+          byte_view_t packet, const RDataLayout& layout, size_t pos, size_t end, Visit_t&& visit)
+      {
+        pos += layout.before;
+        for (size_t idx = 0; idx < layout.names; ++idx)
+        {
+          if (pos >= end)
+            return false;
+          const auto next = NameView::Skip(packet, pos);
+          if (not next or *next > end)
+            return false;
+          visit(pos, *next);
+          pos = *next;
+        }
+        return pos + layout.after == end;
+      }
+    }  // namespace
+
+    std::optional<MessageView>
+    MessageView::Parse(byte_view_t packet)
+    {
+      if (packet.size() < MessageHeader::Size)
+        return std::nullopt;
+      MessageView view;
+      view.m_Packet = packet;
+      auto& hdr = view.m_Header;
+      const auto* ptr = packet.data();
+      hdr.id = oxenc::load_big_to_host<uint16_t>(ptr);
+      hdr.fields = oxenc::load_big_to_host<uint16_t>(ptr + 2);
+      hdr.qd_count = oxenc::load_big_to_host<uint16_t>(ptr + 4);
+      hdr.an_count = oxenc::load_big_to_host<uint16_t>(ptr + 6);
+      hdr.ns_count = oxenc::load_big_to_host<uint16_t>(ptr + 8);
+      hdr.ar_count = oxenc::load_big_to_host<uint16_t>(ptr + 10);
+
+      size_t pos = MessageHeader::Size;
+      view.m_SectionAt[0] = pos;
+      for (Count_t idx = 0; idx < hdr.qd_count; ++idx)
+      {
+        const auto end = NameView::Skip(packet, pos);
+        if (not end or *end + 4 > packet.size())
+          return std::nullopt;
+        pos = *end + 4;
+      }
+      const std::array<Count_t, 3> counts{hdr.an_count, hdr.ns_count, hdr.ar_count};
+      for (size_t section = 0; section < counts.size(); ++section)
+      {
+        view.m_SectionAt[section + 1] = pos;
+        for (Count_t idx = 0; idx < counts[section]; ++idx)
+        {
+          const auto end = NameView::Skip(packet, pos);
+          if (not end or *end + 10 > packet.size())
+            return std::nullopt;
+          const auto type = oxenc::load_big_to_host<uint16_t>(packet.data() + *end);
+          const auto rdlen = oxenc::load_big_to_host<uint16_t>(packet.data() + *end + 8);
+          pos = *end + 10 + rdlen;
+          if (pos > packet.size())
+            return std::nullopt;
+          if (const auto layout = LayoutOf(type);
+              layout and not ForEachRDataName(packet, *layout, *end + 10, pos, [](auto, auto) {}))
+            return std::nullopt;
+        }
+      }
+      return view;
+    }
+
+    std::optional<QuestionView>
+    MessageView::FirstQuestion() const
+    {
+      if (m_Header.qd_count == 0)
+        return std::nullopt;
+      size_t pos = m_SectionAt[0];
+      return QuestionAt(m_Packet, pos);
+    }
+
+    std::vector<byte_t>
+    MessageView::RData(const RecordView& rr) const
+    {
+      const auto layout = LayoutOf(rr.rr_type);
+      if (not layout)
+        return {rr.rData.begin(), rr.rData.end()};
+      std::vector<byte_t> rdata;
+      rdata.reserve(rr.rData.size());
+      const size_t begin = rr.rData.data() - m_Packet.data();
+      const size_t end = begin + rr.rData.size();
+      size_t copied = begin;
+      ForEachRDataName(m_Packet, *layout, begin, end, [&](size_t name, size_t next) {
+        rdata.insert(rdata.end(), m_Packet.begin() + copied, m_Packet.begin() + name);
+        NameView{m_Packet, name}.ForEachLabel([&rdata](std::string_view label) {
+          rdata.push_back(label.size());
+          rdata.insert(rdata.end(), label.begin(), label.end());
+        });
+        rdata.push_back(0);
+        copied = next;
+      });
+      rdata.insert(rdata.end(), m_Packet.begin() + copied, m_Packet.begin() + end);
+      return rdata;
+    }
+
+    PacketWriter::PacketWriter(byte_t* data, size_t capacity)
+        : m_Data{data}, m_Capacity{capacity}, m_Failed{capacity < MessageHeader::Size}
+    {}
+
+    bool
+    PacketWriter::Reserve(size_t n)
+    {
+      if (m_Pos + n > m_Capacity)
+        m_Failed = true;
+      return not m_Failed;
+    }
+
+    void
+    PacketWriter::PutUInt16(uint16_t val)
+    {
+      if (not Reserve(2))
+        return;
+      oxenc::write_host_as_big(val, m_Data + m_Pos);
+      m_Pos += 2;
+    }
+
+    void
+    PacketWriter::PutUInt32(uint32_t val)
+    {
+      if (not Reserve(4))
+        return;
+      oxenc::write_host_as_big(val, m_Data + m_Pos);
+      m_Pos += 4;
+    }
+
+    bool
+    PacketWriter::NameMatches(size_t offset, std::string_view name) const
+    {
+      // we only ever point at complete names we wrote ourselves, so they are well formed. only
+      // names spelled the same are shared so every name reads back exactly as it was written
+      return NameView{byte_view_t{m_Data, m_Pos}, offset}.Identical(name);
+    }
+
+    void
+    PacketWriter::PutName(std::string_view name)
+    {
+      if (m_Failed)
+        return;
+      if (not name.empty() and name.back() == '.')
+        name.remove_suffix(1);
+      if (name.size() + 2 > MaxNameSize)
+      {
+        m_Failed = true;
+        return;
+      }
+      // only names that are completely written can be pointed at
+      const auto known = m_NumNames;
+      while (not name.empty())
+      {
+        for (size_t idx = 0; idx < known; ++idx)
+        {
+          if (NameMatches(m_Names[idx], name))
+          {
+            PutUInt16(0xc000 | m_Names[idx]);
+            return;
+          }
+        }
+        const auto dot = name.find('.');
+        const auto label = name.substr(0, dot);
+        if (label.empty() or label.size() > 63)
+        {
+          m_Failed = true;
+          return;
+        }
+        if (not Reserve(label.size() + 1))
+          return;
+        if (m_NumNames < m_Names.size() and m_Pos < 0x4000)
+          m_Names[m_NumNames++] = m_Pos;
+        m_Data[m_Pos++] = label.size();
+        std::copy(label.begin(), label.end(), m_Data + m_Pos);
+        m_Pos += label.size();
+        name = dot == std::string_view::npos ? std::string_view{} : name.substr(dot + 1);
+      }
+      if (Reserve(1))
+        m_Data[m_Pos++] = 0;
+    }
+
+    size_t
+    PacketWriter::PutRecordHeader(
+        Section section, std::string_view name, RRType_t type, RR_TTL_t ttl, RRClass_t rclass)
+    {
+      PutName(name);
+      PutUInt16(type);
+      PutUInt16(rclass);
+      PutUInt32(ttl);
+      const auto rdlen_at = m_Pos;
+      PutUInt16(0);
+      m_Counts[static_cast<size_t>(section) + 1]++;
+      return rdlen_at;
+    }
+
+    void
+    PacketWriter::Question(std::string_view qname, QType_t qtype, QClass_t qclass)
+    {
+      PutName(qname);
+      PutUInt16(qtype);
+      PutUInt16(qclass);
+      m_Counts[0]++;
+    }
+
+    void
+    PacketWriter::Question(const QuestionView& question)
+    {
+      std::array<char, MaxNameSize> name;
+      if (auto len = question.qname.CopyTo(name.data(), name.size()))
+        Question(std::string_view{name.data(), *len}, question.qtype, question.qclass);
+      else
+        m_Failed = true;
+    }
+
+    void
+    PacketWriter::Record(
+        Section section,
+        std::string_view name,
+        RRType_t type,
+        RR_TTL_t ttl,
+        byte_view_t rdata,
+        RRClass_t rclass)
+    {
+      const auto rdlen_at = PutRecordHeader(section, name, type, ttl, rclass);
+      if (rdata.size() > 0xffff)
+        m_Failed = true;
+      if (not Reserve(rdata.size()))
+        return;
+      std::copy(rdata.begin(), rdata.end(), m_Data + m_Pos);
+      m_Pos += rdata.size();
+      oxenc::write_host_as_big<uint16_t>(rdata.size(), m_Data + rdlen_at);
+    }
+
+    void
+    PacketWriter::NameRecord(
+        Section section,
+        std::string_view name,
+        RRType_t type,
+        RR_TTL_t ttl,
+        std::string_view target)
+    {
+      const auto rdlen_at = PutRecordHeader(section, name, type, ttl, qClassIN);
+      const auto begin = m_Pos;
+      PutName(target);
+      if (not m_Failed)
+        oxenc::write_host_as_big<uint16_t>(m_Pos - begin, m_Data + rdlen_at);
+    }
+
+    std::optional<size_t>
+    PacketWriter::Finish()
+    {
+      if (m_Failed)
+        return std::nullopt;
+      oxenc::write_host_as_big(m_ID, m_Data);
+      oxenc::write_host_as_big(m_Fields, m_Data + 2);
+      for (size_t idx = 0; idx < m_Counts.size(); ++idx)
+        oxenc::write_host_as_big(m_Counts[idx], m_Data + 4 + idx * 2);
+      return m_Pos;
+    }
+  }  // namespace dns
+}  // namespace llarp
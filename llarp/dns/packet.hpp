@@ -0,0 +1,272 @@
+#pragma once
+
+#include "dns.hpp"
+#include "message.hpp"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace llarp
+{
+  namespace dns
+  {
+    /// longest encoded name we accept, rfc 1035 section 2.3.4
+    constexpr size_t MaxNameSize = 255;
+    /// most labels an encoded name of MaxNameSize can have
+    constexpr size_t MaxNameLabels = MaxNameSize / 2;
+
+    /// the record sections of a message
+    enum class Section
+    {
+      answer,
+      authority,
+      additional
+    };
+
+    /// a name inside a dns packet. compression pointers are followed when the name is looked at,
+    /// nothing is copied out of the packet unless asked for. only made by MessageView which
+    /// checks the name is well formed so walking it here needs no bounds checks.
+    class NameView
+    {
+      byte_view_t m_Packet;
+      size_t m_Offset = 0;
+
+      /// does the name match name once the first skip labels are left out, ignoring ascii case
+      /// unless exact
+      bool
+      MatchesAfter(size_t skip, std::string_view name, bool exact = false) const;
+
+     public:
+      NameView() = default;
+
+      NameView(byte_view_t packet, size_t offset) : m_Packet{packet}, m_Offset{offset}
+      {}
+
+      /// check the name at offset is well formed, return the offset just past it in the packet
+      static std::optional<size_t>
+      Skip(byte_view_t packet, size_t offset);
+
+      /// call visit(std::string_view label) for each label in order
+      template <typename Visit_t>
+      void
+      ForEachLabel(Visit_t&& visit) const
+      {
+        size_t pos = m_Offset;
+        while (m_Packet[pos])
+        {
+          const byte_t len = m_Packet[pos];
+          if ((len & 0xc0) == 0xc0)
+          {
+            pos = ((len & 0x3f) << 8) | m_Packet[pos + 1];
+            continue;
+          }
+          visit(std::string_view{reinterpret_cast<const char*>(m_Packet.data() + pos + 1), len});
+          pos += len + 1;
+        }
+      }
+
+      /// write the dotted name with a trailing dot to out, return its length or nullopt if it
+      /// does not fit
+      std::optional<size_t>
+      CopyTo(char* out, size_t size) const;
+
+      /// the dotted name with a trailing dot, the root name is empty
+      std::string
+      ToString() const;
+
+      /// case insensitive compare with a dotted name, the trailing dot is optional
+      bool
+      Equals(std::string_view name) const;
+
+      /// like Equals but case sensitive
+      bool
+      Identical(std::string_view name) const;
+
+      /// does the name end with the dotted suffix on a label boundary, case insensitive
+      /// i.e. "foo.loki." ends with both ".loki" and "loki"
+      bool
+      EndsWith(std::string_view suffix) const;
+    };
+
+    struct QuestionView
+    {
+      NameView qname;
+      QType_t qtype;
+      QClass_t qclass;
+    };
+
+    struct RecordView
+    {
+      NameView rr_name;
+      RRType_t rr_type;
+      RRClass_t rr_class;
+      RR_TTL_t ttl;
+      byte_view_t rData;
+    };
+
+    /// a dns message parsed in place, it points into the packet it was parsed from so the packet
+    /// must outlive it. parsing checks every name and record, including the names inside the
+    /// rdata of record types that carry them, and remembers where each section starts, walking
+    /// the sections afterwards never fails and never allocates.
+    class MessageView
+    {
+      byte_view_t m_Packet;
+      MessageHeader m_Header;
+      std::array<size_t, 4> m_SectionAt;
+
+      MessageView() = default;
+
+      static QuestionView
+      QuestionAt(byte_view_t packet, size_t& pos);
+
+      static RecordView
+      RecordAt(byte_view_t packet, size_t& pos);
+
+     public:
+      /// parse packet, nullopt if it is not a well formed dns message
+      static std::optional<MessageView>
+      Parse(byte_view_t packet);
+
+      const MessageHeader&
+      Header() const
+      {
+        return m_Header;
+      }
+
+      byte_view_t
+      Packet() const
+      {
+        return m_Packet;
+      }
+
+      /// the first question, if there is one
+      std::optional<QuestionView>
+      FirstQuestion() const;
+
+      /// a copy of the rdata of rr, a record of this message, with the names in it spelled out in
+      /// full. compression pointers in CNAME, PTR, NS, MX, SOA and SRV rdata only mean something
+      /// inside this packet so rdata has to be copied out with this, not from rr.rData.
+      std::vector<byte_t>
+      RData(const RecordView& rr) const;
+
+      /// call visit(const QuestionView&) for every question
+      template <typename Visit_t>
+      void
+      ForEachQuestion(Visit_t&& visit) const
+      {
+        size_t pos = m_SectionAt[0];
+        for (Count_t idx = 0; idx < m_Header.qd_count; ++idx)
+          visit(QuestionAt(m_Packet, pos));
+      }
+
+      /// call visit(const RecordView&) for every record in section
+      template <typename Visit_t>
+      void
+      ForEachRecord(Section section, Visit_t&& visit) const
+      {
+        const auto idx = static_cast<size_t>(section) + 1;
+        const std::array<Count_t, 4> counts{
+            m_Header.qd_count, m_Header.an_count, m_Header.ns_count, m_Header.ar_count};
+        size_t pos = m_SectionAt[idx];
+        for (Count_t n = 0; n < counts[idx]; ++n)
+          visit(RecordAt(m_Packet, pos));
+      }
+    };
+
+    /// writes a dns message straight into a packet buffer. every name written is compressed
+    /// against the names already in the packet. writing past the end of the buffer is remembered
+    /// and makes Finish fail, so callers can write everything and check once.
+    class PacketWriter
+    {
+      byte_t* const m_Data;
+      const size_t m_Capacity;
+      size_t m_Pos = MessageHeader::Size;
+      bool m_Failed = false;
+      MsgID_t m_ID = 0;
+      Fields_t m_Fields = 0;
+      std::array<Count_t, 4> m_Counts{};
+      /// where the names and name suffixes written so far start, for compression
+      std::array<uint16_t, 64> m_Names;
+      size_t m_NumNames = 0;
+
+      bool
+      Reserve(size_t n);
+
+      void
+      PutUInt16(uint16_t val);
+
+      void
+      PutUInt32(uint32_t val);
+
+      bool
+      NameMatches(size_t offset, std::string_view name) const;
+
+      void
+      PutName(std::string_view name);
+
+      /// write the fixed part of a record, return where its rdata length goes
+      size_t
+      PutRecordHeader(
+          Section section, std::string_view name, RRType_t type, RR_TTL_t ttl, RRClass_t rclass);
+
+     public:
+      PacketWriter(byte_t* data, size_t capacity);
+
+      template <size_t N>
+      explicit PacketWriter(std::array<byte_t, N>& data) : PacketWriter{data.data(), N}
+      {}
+
+      PacketWriter(const PacketWriter&) = delete;
+      PacketWriter&
+      operator=(const PacketWriter&) = delete;
+
+      void
+      Header(MsgID_t id, Fields_t fields)
+      {
+        m_ID = id;
+        m_Fields = fields;
+      }
+
+      void
+      Question(std::string_view qname, QType_t qtype, QClass_t qclass = qClassIN);
+
+      /// copy a question out of a parsed message
+      void
+      Question(const QuestionView& question);
+
+      /// a record with opaque rdata
+      void
+      Record(
+          Section section,
+          std::string_view name,
+          RRType_t type,
+          RR_TTL_t ttl,
+          byte_view_t rdata,
+          RRClass_t rclass = qClassIN);
+
+      /// a record whose rdata is a single name, e.g. CNAME, NS and PTR. the target is compressed
+      /// too.
+      void
+      NameRecord(
+          Section section,
+          std::string_view name,
+          RRType_t type,
+          RR_TTL_t ttl,
+          std::string_view target);
+
+      /// how many bytes are written so far
+      size_t
+      size() const
+      {
+        return m_Pos;
+      }
+
+      /// write the header, return the size of the packet or nullopt if anything did not fit
+      std::optional<size_t>
+      Finish();
+    };
+  }  // namespace dns
+}  // namespace llarp
@@ -2,6 +2,7 @@
 #include <llarp/constants/platform.hpp>
 #include <llarp/constants/apple.hpp>
 #include "dns.hpp"
+#include "packet.hpp"
 #include <iterator>
 #include <llarp/crypto/crypto.hpp>
 #include <array>
@@ -10,8 +11,17 @@
 #include <llarp/ev/udp_handle.hpp>
 #include <optional>
 #include <memory>
+#include <thread>
+#include <unordered_map>
 #include <unbound.h>
 #include <uvw.hpp>
+#include <oxenc/endian.h>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 #include "oxen/log.hpp"
 #include "sd_platform.hpp"
@@ -86,6 +96,41 @@ namespace llarp::dns
   {
     class Resolver;
 
+    /// apply the settings every libunbound context we make shares: options, host files and
+    /// forwarding to our upstream resolvers
+    static void
+    ConfigureContext(ub_ctx* ctx, const llarp::DnsConfig& conf)
+    {
+      ub_ctx_set_option(ctx, "do-tcp:", "no");
+
+      for (const auto& [k, v] : conf.m_ExtraOpts)
+        ub_ctx_set_option(ctx, k.c_str(), v.c_str());
+
+      for (const auto& file : conf.m_hostfiles)
+      {
+        const auto str = file.u8string();
+        if (auto ret = ub_ctx_hosts(ctx, str.c_str()))
+        {
+          throw std::runtime_error{
+              fmt::format("Failed to add host file {}: {}", file, ub_strerror(ret))};
+        }
+      }
+
+      for (const auto& dns : conf.m_upstreamDNS)
+      {
+        std::string str = dns.hostString();
+
+        if (const auto port = dns.getPort(); port != 53)
+          fmt::format_to(std::back_inserter(str), "@{}", port);
+
+        if (auto err = ub_ctx_set_fwd(ctx, str.c_str()))
+        {
+          throw std::runtime_error{
+              fmt::format("cannot use {} as upstream dns: {}", str, ub_strerror(err))};
+        }
+      }
+    }
+
     class Query : public QueryJob_Base, public std::enable_shared_from_this<Query>
     {
       std::shared_ptr<PacketSource_Base> src;
@@ -174,21 +219,6 @@ namespace llarp::dns
         query->SendReply(std::move(pkt));
       }
 
-      void
-      AddUpstreamResolver(const SockAddr& dns)
-      {
-        std::string str = dns.hostString();
-
-        if (const auto port = dns.getPort(); port != 53)
-          fmt::format_to(std::back_inserter(str), "@{}", port);
-
-        if (auto err = ub_ctx_set_fwd(m_ctx, str.c_str()))
-        {
-          throw std::runtime_error{
-              fmt::format("cannot use {} as upstream dns: {}", str, ub_strerror(err))};
-        }
-      }
-
       bool
       ConfigureAppleTrampoline(const SockAddr& dns)
       {
@@ -236,12 +266,9 @@ namespace llarp::dns
       {
         bool is_apple_tramp = false;
 
-        // set up forward dns
+        // forward dns is set up by ConfigureContext, see if it goes through the trampoline
         for (const auto& dns : conf.m_upstreamDNS)
-        {
-          AddUpstreamResolver(dns);
           is_apple_tramp = is_apple_tramp or ConfigureAppleTrampoline(dns);
-        }
 
         if (auto maybe_addr = conf.m_QueryBind; maybe_addr and not is_apple_tramp)
         {
@@ -357,23 +384,7 @@ namespace llarp::dns
 
         m_ctx = ::ub_ctx_create();
         // set libunbound settings
-
-        SetOpt("do-tcp:", "no");
-
-        for (const auto& [k, v] : conf.m_ExtraOpts)
-          SetOpt(k, v);
-
-        // add host files
-        for (const auto& file : conf.m_hostfiles)
-        {
-          const auto str = file.u8string();
-          if (auto ret = ub_ctx_hosts(m_ctx, str.c_str()))
-          {
-            throw std::runtime_error{
-                fmt::format("Failed to add host file {}: {}", file, ub_strerror(ret))};
-          }
-        }
-
+        ConfigureContext(m_ctx, conf);
         ConfigureUpstream(conf);
 
         // set async
@@ -577,6 +588,257 @@ namespace llarp::dns
     }
   }  // namespace libunbound
 
+  byte_view_t
+  PooledReply(
+      const PooledQuery& query, byte_t* answer, size_t answerlen, std::array<byte_t, 512>& servfail)
+  {
+    if (answer and answerlen >= MessageHeader::Size)
+    {
+      // the answer is good as it is once it has the asker's message id
+      oxenc::write_host_as_big(query.id, answer);
+      return byte_view_t{answer, answerlen};
+    }
+    if (answer)
+      log::warning(logcat, "Upstream DNS reply too short: {} bytes", answerlen);
+    PacketWriter writer{servfail};
+    // same as Message::AddServFail
+    writer.Header(
+        query.id,
+        (query.fields | flags_RCODEServFail | flags_QR | flags_AA | flags_RA) & ~flags_RD);
+    writer.Question(query.qname.data(), query.qtype, query.qclass);
+    return byte_view_t{servfail.data(), writer.Finish().value_or(0)};
+  }
+
+#ifndef _WIN32
+  /// reads dns packets on its own thread from a SO_REUSEPORT socket, so the kernel spreads
+  /// queries over every reader bound on the same address. upstream queries are parsed, resolved
+  /// with the reader's own libunbound context and answered from that thread; only queries one of
+  /// our resolvers may hook are handed to the main loop.
+  class ThreadedUDPReader : public PacketSource_Base,
+                            public std::enable_shared_from_this<ThreadedUDPReader>
+  {
+    /// an upstream query in flight in our libunbound context
+    struct Pending
+    {
+      ThreadedUDPReader* reader;
+      PooledQuery query;
+    };
+
+    Server& m_DNS;
+    EventLoop_ptr m_Loop;
+    int m_FD = -1;
+    SockAddr m_LocalAddr;
+    ub_ctx* m_ctx = nullptr;
+    std::atomic<bool> m_Running{false};
+    std::thread m_Thread;
+    /// only touched on our thread
+    std::unordered_map<Pending*, std::unique_ptr<Pending>> m_Pending;
+
+    /// does query need to go to the resolvers on the main loop
+    static bool
+    HandledOnLoop(const MessageView& query)
+    {
+      if (query.Header().qd_count != 1 or query.Header().an_count != 0)
+        return true;
+      const auto q = *query.FirstQuestion();
+      return q.qname.EndsWith("loki") or q.qname.EndsWith("snode") or q.qtype == qTypePTR
+          or q.qname.Equals("use-application-dns.net");
+    }
+
+    void
+    SendRaw(const SockAddr& to, const byte_t* data, size_t sz) const
+    {
+      ::sendto(m_FD, data, sz, 0, static_cast<const sockaddr*>(to), to.sockaddr_len());
+    }
+
+    static void
+    Callback(void* data, int err, ub_result* result)
+    {
+      auto* pending = static_cast<Pending*>(data);
+      auto* self = pending->reader;
+      auto owned = std::move(self->m_Pending.at(pending));
+      self->m_Pending.erase(pending);
+
+      byte_t* answer = nullptr;
+      size_t answerlen = 0;
+      if (err)
+        log::warning(logcat, "Upstream DNS failure: {}", ub_strerror(err));
+      else
+      {
+        answer = static_cast<byte_t*>(result->answer_packet);
+        answerlen = std::max(result->answer_len, 0);
+      }
+      std::array<byte_t, 512> servfail;
+      const auto reply = PooledReply(owned->query, answer, answerlen, servfail);
+      if (not reply.empty())
+        self->SendRaw(owned->query.from, reply.data(), reply.size());
+      ::ub_resolve_free(result);
+    }
+
+    void
+    HandlePacket(const SockAddr& from, byte_t* data, size_t len)
+    {
+      if (from == m_LocalAddr)
+        return;
+      // look at the packet in place, plain upstream queries never get copied out of it
+      auto maybe = MessageView::Parse(byte_view_t{data, len});
+      if (not maybe)
+      {
+        log::warning(
+            logcat, "invalid dns message format from {} to dns listener on {}", from, m_LocalAddr);
+        return;
+      }
+      if (HandledOnLoop(*maybe))
+      {
+        // weak so the last reference to us never goes away on our own thread
+        std::vector<byte_t> pkt{data, data + len};
+        m_Loop->call([weak = weak_from_this(), from, pkt = std::move(pkt)] {
+          if (auto self = weak.lock())
+            self->m_DNS.MaybeHandlePacket(
+                self, self->m_LocalAddr, from, OwnedBuffer{pkt.data(), pkt.size()});
+        });
+        return;
+      }
+
+      const auto q = *maybe->FirstQuestion();
+      auto* pending = new Pending{this, {from, maybe->Header().id, maybe->Header().fields}};
+      m_Pending.emplace(pending, pending);
+      auto& query = pending->query;
+      query.qtype = q.qtype;
+      query.qclass = q.qclass;
+      const auto namelen = q.qname.CopyTo(query.qname.data(), MaxNameSize).value_or(0);
+      query.qname[namelen] = 0;
+      if (namelen == 0)
+      {
+        query.qname[0] = '.';
+        query.qname[1] = 0;
+      }
+      if (auto err = ub_resolve_async(
+              m_ctx,
+              query.qname.data(),
+              q.qtype,
+              q.qclass,
+              pending,
+              &ThreadedUDPReader::Callback,
+              nullptr))
+      {
+        log::warning(
+            logcat, "failed to send upstream query with libunbound: {}", ub_strerror(err));
+        std::array<byte_t, 512> servfail;
+        const auto reply = PooledReply(query, nullptr, 0, servfail);
+        if (not reply.empty())
+          SendRaw(from, reply.data(), reply.size());
+        m_Pending.erase(pending);
+      }
+    }
+
+    void
+    Run()
+    {
+      std::array<pollfd, 2> fds{{{m_FD, POLLIN, 0}, {ub_fd(m_ctx), POLLIN, 0}}};
+      std::array<byte_t, 4096> buf;
+      while (m_Running)
+      {
+        // wake up now and then to notice we are being stopped
+        if (::poll(fds.data(), fds.size(), 100) <= 0)
+          continue;
+        if (fds[1].revents & POLLIN)
+          ub_process(m_ctx);
+        if (not(fds[0].revents & POLLIN))
+          continue;
+        // drain what is queued on the socket but give unbound a turn now and then
+        for (int n = 0; n < 64; ++n)
+        {
+          sockaddr_storage src{};
+          socklen_t srclen = sizeof(src);
+          const auto sz = ::recvfrom(
+              m_FD,
+              buf.data(),
+              buf.size(),
+              MSG_DONTWAIT,
+              reinterpret_cast<sockaddr*>(&src),
+              &srclen);
+          if (sz <= 0)
+            break;
+          HandlePacket(SockAddr{*reinterpret_cast<sockaddr*>(&src)}, buf.data(), sz);
+        }
+      }
+    }
+
+   public:
+    ThreadedUDPReader(
+        Server& dns, EventLoop_ptr loop, const SockAddr& bindaddr, const llarp::DnsConfig& conf)
+        : m_DNS{dns}, m_Loop{std::move(loop)}
+    {
+      const auto* addr = static_cast<const sockaddr*>(bindaddr);
+      m_FD = ::socket(addr->sa_family, SOCK_DGRAM, IPPROTO_UDP);
+      if (m_FD == -1)
+        throw std::runtime_error{
+            fmt::format("Failed to create dns socket: {}", strerror(errno))};
+      const int on = 1;
+      if (::setsockopt(m_FD, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0
+          or ::bind(m_FD, addr, bindaddr.sockaddr_len()) != 0)
+      {
+        const auto err = errno;
+        ::close(m_FD);
+        throw std::runtime_error{
+            fmt::format("Failed to bind dns socket on {}: {}", bindaddr, strerror(err))};
+      }
+      sockaddr_storage bound{};
+      socklen_t boundlen = sizeof(bound);
+      ::getsockname(m_FD, reinterpret_cast<sockaddr*>(&bound), &boundlen);
+      m_LocalAddr = SockAddr{*reinterpret_cast<sockaddr*>(&bound)};
+
+      m_ctx = ::ub_ctx_create();
+      libunbound::ConfigureContext(m_ctx, conf);
+      ub_ctx_async(m_ctx, 1);
+    }
+
+    ~ThreadedUDPReader() override
+    {
+      Stop();
+      if (m_ctx)
+        ::ub_ctx_delete(m_ctx);
+      if (m_FD != -1)
+        ::close(m_FD);
+    }
+
+    /// start reading on our own thread
+    void
+    Start()
+    {
+      m_Running = true;
+      m_Thread = std::thread{[this]() { Run(); }};
+    }
+
+    std::optional<SockAddr>
+    BoundOn() const override
+    {
+      return m_LocalAddr;
+    }
+
+    bool
+    WouldLoop(const SockAddr& to, const SockAddr&) const override
+    {
+      return to != m_LocalAddr;
+    }
+
+    /// thread safe, replies to hooked queries come from the main loop
+    void
+    SendTo(const SockAddr& to, const SockAddr&, llarp::OwnedBuffer buf) const override
+    {
+      SendRaw(to, buf.buf.get(), buf.sz);
+    }
+
+    void
+    Stop() override
+    {
+      if (m_Running.exchange(false) and m_Thread.joinable())
+        m_Thread.join();
+    }
+  };
+#endif
+
   Server::Server(EventLoop_ptr loop, llarp::DnsConfig conf, unsigned int netif)
       : m_Loop{std::move(loop)}
       , m_Config{std::move(conf)}
@@ -596,6 +858,8 @@ namespace llarp::dns
     // set up udp sockets
     for (const auto& addr : m_Config.m_bind)
     {
+      if (MakeThreadedPacketSourcesOn(addr))
+        continue;
       if (auto ptr = MakePacketSourceOn(addr, m_Config))
         AddPacketSource(std::move(ptr));
     }
@@ -623,6 +887,32 @@ namespace llarp::dns
     return std::make_shared<UDPReader>(*this, m_Loop, addr);
   }
 
+  bool
+  Server::MakeThreadedPacketSourcesOn(const llarp::SockAddr& addr)
+  {
+#ifndef _WIN32
+    if constexpr (platform::is_linux)
+    {
+      if (m_Config.m_ResolverThreads <= 0 or m_Config.m_raw_dns or m_Config.m_upstreamDNS.empty())
+        return false;
+      // every reader after the first binds where the first one ended up, for :0 binds
+      SockAddr bindaddr{addr};
+      for (int n = 0; n < m_Config.m_ResolverThreads; ++n)
+      {
+        auto reader = std::make_shared<ThreadedUDPReader>(*this, m_Loop, bindaddr, m_Config);
+        bindaddr = *reader->BoundOn();
+        reader->Start();
+        AddPacketSource(std::shared_ptr<PacketSource_Base>{std::move(reader)});
+      }
+      log::info(
+          logcat, "resolving dns on {} with {} threads", bindaddr, m_Config.m_ResolverThreads);
+      return true;
+    }
+#endif
+    (void)addr;
+    return false;
+  }
+
   std::shared_ptr<Resolver_Base>
   Server::MakeDefaultResolver()
   {
@@ -730,32 +1020,44 @@ namespace llarp::dns
       return false;
     }
 
-    auto maybe = MaybeParseDNSMessage(buf);
-    if (not maybe)
+    auto view = MessageView::Parse(byte_view_t{buf.buf.get(), buf.sz});
+    if (not view)
     {
       log::warning(logcat, "invalid dns message format from {} to dns listener on {}", from, to);
       return false;
     }
 
-    auto& msg = *maybe;
     // we don't provide a DoH resolver because it requires verified TLS
     // TLS needs X509/ASN.1-DER and opting into the Root CA Cabal
     // thankfully mozilla added a backdoor that allows ISPs to turn it off
     // so we disable DoH for firefox using mozilla's ISP backdoor
     // see: https://github.com/oxen-io/lokinet/issues/832
-    for (const auto& q : msg.questions)
-    {
+    bool doh_canary = false;
+    view->ForEachQuestion([&doh_canary](const QuestionView& q) {
       // is this firefox looking for their backdoor record?
-      if (q.IsName("use-application-dns.net"))
+      doh_canary = doh_canary or q.qname.Equals("use-application-dns.net");
+    });
+    if (doh_canary)
+    {
+      // yea it is, let's turn off DoH because god is dead.
+      OwnedBuffer reply{512};
+      PacketWriter writer{reply.buf.get(), reply.sz};
+      // same as Message::AddNXReply
+      writer.Header(
+          view->Header().id,
+          (view->Header().fields | flags_QR | flags_AA | flags_RA | flags_RCODENameError)
+              & ~flags_RD);
+      view->ForEachQuestion([&writer](const QuestionView& q) { writer.Question(q); });
+      if (auto sz = writer.Finish())
       {
-        // yea it is, let's turn off DoH because god is dead.
-        msg.AddNXReply();
+        reply.sz = *sz;
         // press F to pay respects and send it back where it came from
-        ptr->SendTo(from, to, msg.ToBuffer());
-        return true;
+        ptr->SendTo(from, to, std::move(reply));
       }
+      return true;
     }
 
+    Message msg{*view};
     for (const auto& resolver : m_Resolvers)
     {
       if (auto res_ptr = resolver.lock())
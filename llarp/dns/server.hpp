@@ -1,11 +1,13 @@
 #pragma once
 
 #include "message.hpp"
+#include "packet.hpp"
 #include "platform.hpp"
 #include <llarp/config/config.hpp>
 #include <llarp/ev/ev.hpp>
 #include <llarp/net/net.hpp>
 #include <llarp/util/fs.hpp>
+#include <array>
 #include <set>
 
 namespace llarp::dns
@@ -199,6 +201,25 @@ namespace llarp::dns
         const SockAddr& from) = 0;
   };
 
+  /// a query a resolver pool thread sent upstream, holds just enough of it to answer it
+  struct PooledQuery
+  {
+    SockAddr from;
+    MsgID_t id;
+    Fields_t fields;
+    QType_t qtype;
+    QClass_t qclass;
+    /// nul terminated
+    std::array<char, MaxNameSize + 1> qname;
+  };
+
+  /// the reply for the asker of query given libunbound's answer: the answer itself with the
+  /// asker's message id put back, or a SERVFAIL for the question written to servfail when there
+  /// is no answer or it is too short to be a dns message
+  byte_view_t
+  PooledReply(
+      const PooledQuery& query, byte_t* answer, size_t answerlen, std::array<byte_t, 512>& servfail);
+
   // Base class for DNS proxy
   class Server : public std::enable_shared_from_this<Server>
   {
@@ -239,6 +260,11 @@ namespace llarp::dns
     virtual std::shared_ptr<PacketSource_Base>
     MakePacketSourceOn(const SockAddr& bindaddr, const llarp::DnsConfig& conf);
 
+    /// if configured with resolver threads add that many packet sources bound on bindaddr that
+    /// each resolve upstream queries on their own thread and return true
+    bool
+    MakeThreadedPacketSourcesOn(const SockAddr& bindaddr);
+
     /// sets up all internal binds and such and begins operation
     virtual void
     Start();
@@ -69,6 +69,9 @@ namespace llarp
   class EventLoop
   {
    public:
+    /// identifies a callback added by call_later, never 0
+    using TimerID = uint64_t;
+
     // Runs the event loop. This does not return until sometime after `stop()` is called (and so
     // typically you want to run this in its own thread).
     virtual void
@@ -106,10 +109,17 @@ namespace llarp
     virtual void
     call_soon(std::function<void(void)> f) = 0;
 
-    // Adds a timer to the event loop to invoke the given callback after a delay.
-    virtual void
+    // Adds a timer to the event loop to invoke the given callback after a delay.  Returns an id
+    // that can be given to cancel_later to drop the callback before it runs.
+    virtual TimerID
     call_later(llarp_time_t delay_ms, std::function<void(void)> callback) = 0;
 
+    // Drops a callback added by call_later that has not run yet; does nothing if it already has.
+    // Can be called from any thread, from outside the event loop it takes effect once it gets
+    // there.
+    virtual void
+    cancel_later(TimerID id) = 0;
+
     // Created a repeated timer that fires ever `repeat` time unit.  Lifetime of the event
     // is tied to `owner`: callbacks will be invoked so long as `owner` remains alive, but
     // the first time it repeats after `owner` has been destroyed the internal timer object will
@@ -178,6 +188,12 @@ namespace llarp
         std::shared_ptr<vpn::NetworkInterface> netif,
         std::function<void(net::IPPacket)> packetHandler) = 0;
 
+    // Stops or resumes reading packets from a network interface given to add_network_interface.
+    // While paused its packets back up in the OS, which pushes back on whatever is sending them.
+    // Call from the event loop thread.
+    virtual void
+    pause_network_interface(const vpn::NetworkInterface& netif, bool paused) = 0;
+
     virtual bool
     add_ticker(std::function<void(void)> ticker) = 0;
 
@@ -139,6 +139,14 @@ namespace llarp::uv
     if (!(m_WakeUp = m_Impl->resource<uvw::AsyncHandle>()))
       throw std::runtime_error{"Failed to create libuv async"};
     m_WakeUp->on<uvw::AsyncEvent>([this](const auto&, auto&) { tick_event_loop(); });
+
+    if (!(m_TimerHandle = m_Impl->resource<uvw::TimerHandle>()))
+      throw std::runtime_error{"Failed to create libuv timer"};
+    m_TimerHandle->on<uvw::TimerEvent>([this](const auto&, auto&) {
+      m_TimerArmedAt.reset();
+      m_Timers.Advance(time_now());
+      arm_timers();
+    });
   }
 
   bool
@@ -171,40 +179,64 @@ namespace llarp::uv
         std::make_shared<llarp::uv::UDPHandle>(*m_Impl, std::move(on_recv)));
   }
 
-  static void
-  setup_oneshot_timer(uvw::Loop& loop, llarp_time_t delay, std::function<void()> callback)
+  void
+  Loop::arm_timers()
   {
-    auto timer = loop.resource<uvw::TimerHandle>();
-    timer->on<uvw::TimerEvent>([f = std::move(callback)](const auto&, auto& timer) {
-      f();
-      timer.stop();
-      timer.close();
-    });
-    timer->start(delay, 0ms);
+    const auto due = m_Timers.NextDue();
+    if (not due)
+    {
+      m_TimerHandle->stop();
+      m_TimerArmedAt.reset();
+      return;
+    }
+    const auto now = time_now();
+    m_TimerHandle->start(*due > now ? *due - now : 0ms, 0ms);
+    m_TimerArmedAt = *due;
   }
 
   void
+  Loop::add_timer(TimerID id, llarp_time_t at, Callback callback)
+  {
+    // bring an idle wheel up to now first, there is nothing in it to run
+    if (m_Timers.Empty())
+      m_Timers.Advance(time_now());
+    m_Timers.Schedule(id, at, std::move(callback));
+    // only touch the libuv timer when this one is due before it goes off
+    if (not m_TimerArmedAt or at < *m_TimerArmedAt)
+      arm_timers();
+  }
+
+  EventLoop::TimerID
   Loop::call_later(llarp_time_t delay_ms, std::function<void(void)> callback)
   {
     llarp::LogTrace("Loop::call_after_delay()");
 #ifdef TESTNET_SPEED
     delay_ms *= TESTNET_SPEED;
 #endif
+    const auto id = ++m_nextID;
 
     if (inEventLoop())
-      setup_oneshot_timer(*m_Impl, delay_ms, std::move(callback));
+      add_timer(id, time_now() + delay_ms, std::move(callback));
     else
     {
-      call_soon([this, f = std::move(callback), target_time = time_now() + delay_ms] {
-        // Recalculate delay because it may have taken some time to get ourselves into the logic
-        // thread
-        auto updated_delay = target_time - time_now();
-        if (updated_delay <= 0ms)
+      call_soon([this, id, f = std::move(callback), target_time = time_now() + delay_ms]() mutable {
+        // it may have taken some time to get ourselves into the logic thread
+        if (target_time <= time_now())
           f();  // Timer already expired!
         else
-          setup_oneshot_timer(*m_Impl, updated_delay, std::move(f));
+          add_timer(id, target_time, std::move(f));
       });
     }
+    return id;
+  }
+
+  void
+  Loop::cancel_later(TimerID id)
+  {
+    if (inEventLoop())
+      m_Timers.Cancel(id);
+    else
+      call_soon([this, id]() { m_Timers.Cancel(id); });
   }
 
   void
@@ -255,6 +287,24 @@ namespace llarp::uv
     if (!handle)
       return false;
 
+    const auto start = [](auto& handle) {
+#ifdef __linux__
+      handle.start(uvw::PollHandle::Event::READABLE);
+#else
+      handle.start();
+#endif
+    };
+
+    m_NetIfPausers[netif.get()] = [weak = std::weak_ptr{handle}, start](bool paused) {
+      auto handle = weak.lock();
+      if (not handle)
+        return;
+      if (paused)
+        handle->stop();
+      else
+        start(*handle);
+    };
+
     handle->on<event_t>([netif = std::move(netif), handler = std::move(handler)](
                             const event_t&, [[maybe_unused]] auto& handle) {
       for (auto pkt = netif->ReadNextPacket(); true; pkt = netif->ReadNextPacket())
@@ -270,15 +320,17 @@ namespace llarp::uv
       }
     });
 
-#ifdef __linux__
-    handle->start(uvw::PollHandle::Event::READABLE);
-#else
-    handle->start();
-#endif
-
+    start(*handle);
     return true;
   }
 
+  void
+  Loop::pause_network_interface(const llarp::vpn::NetworkInterface& netif, bool paused)
+  {
+    if (auto itr = m_NetIfPausers.find(&netif); itr != m_NetIfPausers.end())
+      itr->second(paused);
+  }
+
   void
   Loop::call_soon(std::function<void(void)> f)
   {
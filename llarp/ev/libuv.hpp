@@ -3,10 +3,12 @@
 #include "udp_handle.hpp"
 #include <llarp/util/thread/queue.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/timer_wheel.hpp>
 
 #include <uvw/loop.h>
 #include <uvw/async.h>
 #include <uvw/poll.h>
+#include <uvw/timer.h>
 #include <uvw/udp.h>
 
 #include <functional>
@@ -37,9 +39,12 @@ namespace llarp::uv
       return m_Impl->now();
     }
 
-    void
+    TimerID
     call_later(llarp_time_t delay_ms, std::function<void(void)> callback) override;
 
+    void
+    cancel_later(TimerID id) override;
+
     void
     tick_event_loop();
 
@@ -54,6 +59,9 @@ namespace llarp::uv
         std::shared_ptr<llarp::vpn::NetworkInterface> netif,
         std::function<void(llarp::net::IPPacket)> handler) override;
 
+    void
+    pause_network_interface(const llarp::vpn::NetworkInterface& netif, bool paused) override;
+
     void
     call_soon(std::function<void(void)> f) override;
 
@@ -89,14 +97,29 @@ namespace llarp::uv
     uint64_t last_time;
     uint64_t loop_run_count;
 #endif
-    std::atomic<uint32_t> m_nextID;
+    std::atomic<TimerID> m_nextID;
 
-    std::map<uint32_t, Callback> m_pendingCalls;
+    /// every call_later callback, run from a single libuv timer set for the next one due
+    util::TimerWheel m_Timers;
+    std::shared_ptr<uvw::TimerHandle> m_TimerHandle;
+    /// when m_TimerHandle is set to go off, nullopt when it is stopped
+    std::optional<llarp_time_t> m_TimerArmedAt;
 
     std::unordered_map<int, std::shared_ptr<uvw::PollHandle>> m_Polls;
 
+    /// stops or restarts the handle reading each network interface
+    std::unordered_map<const llarp::vpn::NetworkInterface*, std::function<void(bool)>>
+        m_NetIfPausers;
+
     void
     wakeup() override;
+
+    void
+    add_timer(TimerID id, llarp_time_t at, Callback callback);
+
+    /// set m_TimerHandle for the next timer due, or stop it if there are none
+    void
+    arm_timers();
   };
 
 }  // namespace llarp::uv
@@ -3,6 +3,7 @@
 #include <llarp/handlers/exit.hpp>
 #include <llarp/path/path_context.hpp>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/router/router_metrics.hpp>
 #include <llarp/quic/tunnel.hpp>
 
 namespace llarp
@@ -110,7 +111,7 @@ namespace llarp
 
     bool
     Endpoint::QueueOutboundTraffic(
-        PathID_t path, std::vector<byte_t> buf, uint64_t counter, service::ProtocolType t)
+        PathID_t path, const llarp_buffer_t& buf, uint64_t counter, service::ProtocolType t)
     {
       const service::ConvoTag tag{path.as_array()};
       if (t == service::ProtocolType::QUIC)
@@ -118,8 +119,9 @@ namespace llarp
         auto quic = m_Parent->GetQUICTunnel();
         if (not quic)
           return false;
-        m_TxRate += buf.size();
-        quic->receive_packet(tag, std::move(buf));
+        m_TxRate += buf.sz;
+        m_Parent->GetRouter()->metrics().exitTXBytes.Add(buf.sz);
+        quic->receive_packet(tag, buf);
         m_LastActive = m_Parent->Now();
         return true;
       }
@@ -127,7 +129,7 @@ namespace llarp
       if (m_UpstreamQueue.size() > MaxUpstreamQueueSize)
         return false;
 
-      llarp::net::IPPacket pkt{std::move(buf)};
+      llarp::net::IPPacket pkt{buf.view_all()};
       if (pkt.empty())
         return false;
 
@@ -154,6 +156,7 @@ namespace llarp
         return false;
       }
       m_TxRate += pkt.size();
+      m_Parent->GetRouter()->metrics().exitTXBytes.Add(pkt.size());
       m_UpstreamQueue.emplace(std::move(pkt), counter);
       m_LastActive = m_Parent->Now();
       return true;
@@ -227,6 +230,7 @@ namespace llarp
             if (path->SendRoutingMessage(msg, m_Parent->GetRouter()))
             {
               m_RxRate += msg.Size();
+              m_Parent->GetRouter()->metrics().exitRXBytes.Add(msg.Size());
               sent = true;
             }
             queue.pop_front();
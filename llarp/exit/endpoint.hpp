@@ -65,10 +65,10 @@ namespace llarp
       Flush();
 
       /// queue outbound traffic
-      /// does ip rewrite here
+      /// does ip rewrite here, data is only copied if it is queued, quic is handed on in place
       bool
       QueueOutboundTraffic(
-          PathID_t txid, std::vector<byte_t> data, uint64_t counter, service::ProtocolType t);
+          PathID_t txid, const llarp_buffer_t& data, uint64_t counter, service::ProtocolType t);
 
       /// update local path id and cascade information to parent
       /// return true if success
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <llarp/net/net_int.hpp>
+
+#include <memory>
+#include <unordered_map>
+
+namespace llarp
+{
+  namespace handlers
+  {
+    /// the exit session each recently used internet ip goes out of, so steady exit traffic is
+    /// sent right away instead of going through the exit lookup and EnsurePathToService per
+    /// packet. sessions are held weakly and only handed back while they are ready to send.
+    template <typename Session_t>
+    class ExitRouteCache
+    {
+     public:
+      /// most routes we remember
+      static constexpr size_t MaxRoutes = 4096;
+
+      /// the session we recently sent ip's traffic out of if it is still ready to send, nullptr
+      /// if we need to take the slow path. exitMapVersion is the endpoint's current exit map
+      /// version, any change to it forgets every route.
+      std::shared_ptr<Session_t>
+      Get(huint128_t ip, uint64_t exitMapVersion)
+      {
+        if (m_Version != exitMapVersion)
+        {
+          // exits were mapped or unmapped, what we remember may not be where traffic goes anymore
+          m_Routes.clear();
+          m_Version = exitMapVersion;
+          return nullptr;
+        }
+        auto itr = m_Routes.find(ip);
+        if (itr == m_Routes.end())
+          return nullptr;
+        auto session = itr->second.lock();
+        if (session and session->ReadyToSend())
+          return session;
+        // the session went away or lost its path, let the slow path sort it out
+        m_Routes.erase(itr);
+        return nullptr;
+      }
+
+      /// remember that traffic for ip goes out of session, if it is ready to send and the
+      /// exits have not changed since the last Get
+      void
+      Put(huint128_t ip, Session_t* session, uint64_t exitMapVersion)
+      {
+        if (not session->ReadyToSend() or m_Version != exitMapVersion)
+          return;
+        if (m_Routes.size() >= MaxRoutes and m_Routes.count(ip) == 0)
+          m_Routes.erase(m_Routes.begin());
+        m_Routes[ip] = session->weak_from_this();
+      }
+
+      size_t
+      size() const
+      {
+        return m_Routes.size();
+      }
+
+     private:
+      std::unordered_map<huint128_t, std::weak_ptr<Session_t>> m_Routes;
+      /// the exit map version m_Routes was filled under
+      uint64_t m_Version = 0;
+    };
+  }  // namespace handlers
+}  // namespace llarp
@@ -13,6 +13,7 @@
 #include <llarp/net/net.hpp>
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/router/route_poker.hpp>
+#include <llarp/router/router_metrics.hpp>
 #include <llarp/service/context.hpp>
 #include <llarp/service/outbound_context.hpp>
 #include <llarp/service/endpoint_state.hpp>
@@ -44,12 +45,16 @@ namespace llarp
         const SockAddr& to,
         const SockAddr& from)
     {
+      Router()->metrics().dnsQueries.Add();
       if (not ShouldHookDNSMessage(query))
         return false;
 
       auto job = std::make_shared<dns::QueryJob>(source, query, to, from);
       if (HandleHookedDNSMessage(query, [job](auto msg) { job->SendReply(msg.ToBuffer()); }))
+      {
+        Router()->metrics().dnsQueriesHandled.Add();
         Router()->TriggerPump();
+      }
       else
         job->Cancel();
       return true;
@@ -314,6 +319,10 @@ namespace llarp
 
       m_DnsConfig = dnsConf;
       m_TrafficPolicy = conf.m_TrafficPolicy;
+      if (m_TrafficPolicy)
+        m_TrafficPolicyMatcher.emplace(*m_TrafficPolicy);
+      else
+        m_TrafficPolicyMatcher.reset();
       m_OwnedRanges = conf.m_OwnedRanges;
 
       m_BaseV6Address = conf.m_baseV6Address;
@@ -484,6 +493,14 @@ namespace llarp
       }
 
       service::Endpoint::Pump(now);
+
+      // leave packets in the os while our queues are backed up, so the apps sending them feel it
+      // instead of us reading and then dropping them
+      if (m_NetIf and IsCongested() != m_ReadsPaused)
+      {
+        m_ReadsPaused = IsCongested();
+        Router()->loop()->pause_network_interface(*m_NetIf, m_ReadsPaused);
+      }
     }
 
     static bool
@@ -522,6 +539,43 @@ namespace llarp
 
     bool
     TunEndpoint::HandleHookedDNSMessage(dns::Message msg, std::function<void(dns::Message)> reply)
+    {
+      // only plain questions are cached, cname hooks carry answers that change the reply
+      if (msg.questions.size() != 1 or not msg.answers.empty())
+        return ResolveHookedDNSMessage(std::move(msg), std::move(reply));
+
+      const auto now = Now();
+      if (m_DNSCache.Get(msg, now))
+      {
+        reply(std::move(msg));
+        return true;
+      }
+      // coalesce onto a lookup for the same question that is already in flight
+      if (not m_DNSCache.Pend(msg, reply, now))
+        return true;
+
+      const dns::Message query{msg};
+      auto cachingReply = [this, reply = std::move(reply)](dns::Message answer) {
+        m_DNSCache.Put(answer, Now());
+        reply(std::move(answer));
+      };
+      if (ResolveHookedDNSMessage(std::move(msg), std::move(cachingReply)))
+        return true;
+      m_DNSCache.Cancel(query);
+      return false;
+    }
+
+    dns::RR_TTL_t
+    TunEndpoint::AnswerTTLFor(service::OutboundContext* ctx) const
+    {
+      // the answer holds for as long as the remote has intros we can reach it by
+      const auto expires = ctx->GetCurrentIntroSet().GetNewestIntroExpiration();
+      const auto now = Now();
+      return dns::AnswerTTL(expires > now ? expires - now : 0s);
+    }
+
+    bool
+    TunEndpoint::ResolveHookedDNSMessage(dns::Message msg, std::function<void(dns::Message)> reply)
     {
       auto ReplyToSNodeDNSWhenReady = [this, reply](RouterID snode, auto msg, bool isV6) -> bool {
         return EnsurePathToSNode(
@@ -701,7 +755,7 @@ namespace llarp
             }
             else
             {
-              msg.AddNXReply();
+              msg.AddNXReply(dns::NegativeAnswerTTL);
             }
             reply(msg);
           });
@@ -840,7 +894,7 @@ namespace llarp
                 if (not maybe.has_value())
                 {
                   LogWarn(name, " lns name ", lnsName, " not resolved");
-                  msg->AddNXReply();
+                  msg->AddNXReply(dns::NegativeAnswerTTL);
                   reply(*msg);
                   return;
                 }
@@ -907,6 +961,7 @@ namespace llarp
     void
     TunEndpoint::ResetInternalState()
     {
+      m_DNSCache.Clear();
       service::Endpoint::ResetInternalState();
     }
 
@@ -1089,6 +1144,11 @@ namespace llarp
     TunEndpoint::Tick(llarp_time_t now)
     {
       Endpoint::Tick(now);
+      m_DNSCache.Expire(now);
+      // user packets no longer trigger pumps while reads are paused, make sure one comes around
+      // to see the congestion clear
+      if (m_ReadsPaused)
+        Router()->TriggerPump();
     }
 
     bool
@@ -1191,9 +1251,20 @@ namespace llarp
       {
         dst = net::ExpandV4(net::TruncateV6(dst));
       }
+      // our outbound queues are backing up, tell ecn capable senders to slow down before we have
+      // to start dropping their packets
+      if (IsCongested())
+        pkt.MarkCongestionExperienced();
       auto itr = m_IPToAddr.find(dst);
       if (itr == m_IPToAddr.end())
       {
+        if (auto ctx = m_ExitRoutes.Get(dst, m_ExitMapVersion))
+        {
+          pkt.ZeroSourceAddress();
+          ctx->SendPacketToRemote(pkt.ConstBuffer(), service::ProtocolType::Exit);
+          Router()->TriggerPump();
+          return;
+        }
         service::Address addr{};
 
         if (auto maybe = ObtainExitAddressFor(dst))
@@ -1215,11 +1286,12 @@ namespace llarp
         MarkAddressOutbound(addr);
         EnsurePathToService(
             addr,
-            [pkt, extra_cb, this](service::Address addr, service::OutboundContext* ctx) {
+            [pkt, extra_cb, dst, this](service::Address addr, service::OutboundContext* ctx) {
               if (ctx)
               {
                 if (extra_cb)
                   extra_cb();
+                m_ExitRoutes.Put(dst, ctx, m_ExitMapVersion);
                 ctx->SendPacketToRemote(pkt.ConstBuffer(), service::ProtocolType::Exit);
                 Router()->TriggerPump();
                 return;
@@ -1297,12 +1369,8 @@ namespace llarp
     bool
     TunEndpoint::ShouldAllowTraffic(const net::IPPacket& pkt) const
     {
-      if (const auto exitPolicy = GetExitPolicy())
-      {
-        if (not exitPolicy->AllowsTraffic(pkt))
-          return false;
-      }
-
+      if (m_TrafficPolicyMatcher)
+        return m_TrafficPolicyMatcher->AllowsTraffic(pkt);
       return true;
     }
 
@@ -1510,7 +1578,8 @@ namespace llarp
         }
         ++itr;
       }
-      // remap address
+      // remap address, any answer we gave with the old mapping is now wrong
+      m_DNSCache.Clear();
       m_IPToAddr[oldest.first] = ident;
       m_AddrToIP[ident] = oldest.first;
       m_SNodes[ident] = snode;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <llarp/dns/answer_cache.hpp>
 #include <llarp/dns/server.hpp>
 #include <llarp/ev/ev.hpp>
+#include <llarp/handlers/exit_route_cache.hpp>
 #include <llarp/net/ip.hpp>
 #include <llarp/net/ip_packet.hpp>
 #include <llarp/net/net.hpp>
@@ -250,6 +252,9 @@ namespace llarp
       /// maps ip address to an exit endpoint, useful when we have multiple exits on a range
       std::unordered_map<huint128_t, service::Address> m_ExitIPToExitAddress;
 
+      /// the exit session each recently used internet ip goes out of
+      ExitRouteCache<service::OutboundContext> m_ExitRoutes;
+
      private:
       /// given an ip address that is not mapped locally find the address it shall be forwarded to
       /// optionally provide a custom selection strategy, if none is provided it will choose a
@@ -261,6 +266,21 @@ namespace llarp
           std::function<service::Address(std::unordered_set<service::Address>)> exitSelectionStrat =
               nullptr);
 
+      /// answer a hooked dns query, HandleHookedDNSMessage without the answer cache
+      bool
+      ResolveHookedDNSMessage(dns::Message query, std::function<void(dns::Message)> sendreply);
+
+      /// ttl for a dns answer that points at a remote we talk to via ctx
+      dns::RR_TTL_t
+      AnswerTTLFor(service::OutboundContext* ctx) const;
+
+      template <typename Endpoint_t>
+      dns::RR_TTL_t
+      AnswerTTLFor(const Endpoint_t&) const
+      {
+        return dns::MaxAnswerTTL;
+      }
+
       template <typename Addr_t, typename Endpoint_t>
       void
       SendDNSReply(
@@ -274,7 +294,7 @@ namespace llarp
         {
           huint128_t ip = ObtainIPForAddr(addr);
           query->answers.clear();
-          query->AddINReply(ip, sendIPv6);
+          query->AddINReply(ip, sendIPv6, AnswerTTLFor(ctx));
         }
         else
           query->AddNXReply();
@@ -283,6 +303,8 @@ namespace llarp
 
       /// dns subsystem for this endpoint
       std::shared_ptr<dns::Server> m_DNS;
+      /// answers to hooked dns queries and the queries waiting on a lookup
+      dns::AnswerCache m_DNSCache;
 
       DnsConfig m_DnsConfig;
 
@@ -308,10 +330,14 @@ namespace llarp
       std::optional<huint128_t> m_BaseV6Address;
 
       std::shared_ptr<vpn::NetworkInterface> m_NetIf;
+      /// we stopped reading m_NetIf because our outbound traffic is congested
+      bool m_ReadsPaused = false;
 
       std::shared_ptr<vpn::PacketRouter> m_PacketRouter;
 
       std::optional<net::TrafficPolicy> m_TrafficPolicy;
+      /// m_TrafficPolicy compiled for checking inbound packets against
+      std::optional<net::TrafficPolicyMatcher> m_TrafficPolicyMatcher;
       /// ranges we advetise as reachable
       std::set<IPRange> m_OwnedRanges;
       /// how long to wait for path alignment
@@ -4,6 +4,7 @@
 #include <llarp/messages/discard.hpp>
 #include <llarp/util/meta/memfn.hpp>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/router/router_metrics.hpp>
 
 #include <queue>
 
@@ -70,6 +71,7 @@ namespace llarp
       m_Parent->SendTo_LL(m_RemoteAddr, pkt);
       m_LastTX = time_now_ms();
       m_TXRate += sz;
+      m_Parent->Router()->metrics().linkTXBytes.Add(sz);
     }
 
     bool
@@ -958,6 +960,7 @@ namespace llarp
     Session::Recv_LL(ILinkSession::Packet_t data)
     {
       m_RXRate += data.size();
+      m_Parent->Router()->metrics().linkRXBytes.Add(data.size());
 
       // TODO: differentiate between good and bad RX packets here
       m_Stats.totalPacketsRX++;
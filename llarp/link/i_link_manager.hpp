@@ -42,6 +42,11 @@ namespace llarp
     virtual bool
     HasOutboundSessionTo(const RouterID& remote) const = 0;
 
+    /// return true if our session with this router had a send queue backlog big enough that
+    /// upper layers should back off, as of the last link layer tick
+    virtual bool
+    IsCongestedTo(const RouterID& remote) const = 0;
+
     /// return true if the session with this pubkey is a client
     /// return false if the session with this pubkey is a router
     /// return std::nullopt we have no session with this pubkey
@@ -74,6 +74,22 @@ namespace llarp
     return false;
   }
 
+  bool
+  LinkManager::IsCongestedTo(const RouterID& remote) const
+  {
+    for (const auto& link : outboundLinks)
+    {
+      if (link->IsCongestedTo(remote))
+        return true;
+    }
+    for (const auto& link : inboundLinks)
+    {
+      if (link->IsCongestedTo(remote))
+        return true;
+    }
+    return false;
+  }
+
   std::optional<bool>
   LinkManager::SessionIsClient(RouterID remote) const
   {
@@ -37,6 +37,9 @@ namespace llarp
     bool
     HasOutboundSessionTo(const RouterID& remote) const override;
 
+    bool
+    IsCongestedTo(const RouterID& remote) const override;
+
     std::optional<bool>
     SessionIsClient(RouterID remote) const override;
 
@@ -8,6 +8,7 @@
 #include <utility>
 #include <unordered_set>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/constants/link_layer.hpp>
 #include <oxenc/variant.h>
 
 static constexpr auto LINK_LAYER_TICK_INTERVAL = 100ms;
@@ -349,8 +350,15 @@ namespace llarp
   {
     {
       Lock_t l(m_AuthedLinksMutex);
+      // we visit every session here anyways, so upper layers asking about congestion per path
+      // only need a lookup
+      m_CongestedPeers.clear();
       for (const auto& [routerid, link] : m_AuthedLinks)
+      {
         link->Tick(now);
+        if (link->SendQueueBacklog() >= SendQueueCongestionThreshold)
+          m_CongestedPeers.insert(routerid);
+      }
     }
 
     {
@@ -372,6 +380,12 @@ namespace llarp
     }
   }
 
+  bool
+  ILinkLayer::IsCongestedTo(const RouterID& pk) const
+  {
+    return not m_CongestedPeers.empty() and m_CongestedPeers.count(pk);
+  }
+
   void
   ILinkLayer::Stop()
   {
@@ -12,6 +12,7 @@
 #include <list>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace llarp
 {
@@ -94,6 +95,11 @@ namespace llarp
     bool
     HasSessionTo(const RouterID& pk);
 
+    /// true if our session with pk had a send queue backlog past SendQueueCongestionThreshold
+    /// as of the last Tick
+    bool
+    IsCongestedTo(const RouterID& pk) const;
+
     void
     ForEachSession(std::function<void(const ILinkSession*)> visit, bool randomize = false) const
         EXCLUDES(m_AuthedLinksMutex);
@@ -269,6 +275,8 @@ namespace llarp
     Pending m_Pending GUARDED_BY(m_PendingMutex);
     std::unordered_map<SockAddr, RouterID> m_AuthedAddrs;
     std::unordered_map<SockAddr, llarp_time_t> m_RecentlyClosed;
+    /// peers whose sessions were backing up at the last Tick
+    std::unordered_set<RouterID> m_CongestedPeers;
 
    private:
     std::shared_ptr<int> m_repeater_keepalive;
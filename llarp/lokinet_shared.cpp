@@ -11,9 +11,11 @@
 #include <llarp/util/logging.hpp>
 #include <llarp/util/logging/buffer.hpp>
 #include <llarp/util/logging/callback_sink.hpp>
+#include <llarp/util/thread/mpsc_ring.hpp>
 
 #include <oxenc/base32z.h>
 
+#include <atomic>
 #include <mutex>
 #include <memory>
 #include <chrono>
@@ -191,6 +193,90 @@ namespace
       AddFlow(from, flow_addr, flow_userdata, flow_timeoutseconds, pkt);
     }
   };
+
+  /// datagrams from one lokinet_udp_flow_sendmmsg call on their way to the router loop
+  struct UDPSendBatch
+  {
+    std::shared_ptr<llarp::EndpointBase> m_Endpoint;
+    llarp::EndpointBase::AddressVariant_t m_Remote;
+    std::vector<llarp::net::IPPacket> m_Packets;
+    size_t m_Dropped = 0;
+    lokinet_udp_flow_send_done_func m_Done = nullptr;
+    void* m_User = nullptr;
+
+    /// send all the datagrams and report back, call on the router loop
+    void
+    Send()
+    {
+      size_t sent = 0;
+      if (auto tag = m_Endpoint->GetBestConvoTagFor(m_Remote))
+      {
+        for (const auto& pkt : m_Packets)
+        {
+          if (m_Endpoint->SendToOrQueue(
+                  *tag, pkt.ConstBuffer(), llarp::service::ProtocolType::TrafficV4))
+            ++sent;
+        }
+      }
+      if (m_Done)
+        m_Done(sent, m_Dropped + m_Packets.size() - sent, 0, m_User);
+    }
+
+    /// report the batch as not sent at all
+    void
+    Cancel()
+    {
+      if (m_Done)
+        m_Done(0, m_Dropped + m_Packets.size(), ECANCELED, m_User);
+    }
+  };
+
+  /// how many batches can wait for the router loop before lokinet_udp_flow_sendmmsg says EAGAIN
+  constexpr size_t UDPSendQueueSize = 1024;
+
+  /// batches from lokinet_udp_flow_sendmmsg, filled from any thread and drained by the router
+  /// loop. only the context owns it, drains scheduled on the loop hold it weakly so one that runs
+  /// as the context goes away does nothing.
+  class UDPSendQueue : public std::enable_shared_from_this<UDPSendQueue>
+  {
+    llarp::thread::MPSCRing<std::unique_ptr<UDPSendBatch>> m_Queue{UDPSendQueueSize};
+    /// set while a drain is scheduled, so a burst of batches wakes the loop once
+    std::atomic<bool> m_Scheduled{false};
+
+   public:
+    /// whatever never made it to the loop is reported as cancelled
+    ~UDPSendQueue()
+    {
+      m_Queue.popBatch(
+          [](std::unique_ptr<UDPSendBatch> batch) { batch->Cancel(); }, m_Queue.capacity());
+    }
+
+    /// queue a batch for loop without blocking, false if the queue is full
+    [[nodiscard]] bool
+    Push(std::unique_ptr<UDPSendBatch> batch, const llarp::EventLoop_ptr& loop)
+    {
+      if (not m_Queue.tryPushBack(std::move(batch)))
+        return false;
+      if (not m_Scheduled.exchange(true))
+      {
+        loop->call([weak = weak_from_this()]() {
+          if (auto self = weak.lock())
+            self->Drain();
+        });
+      }
+      return true;
+    }
+
+    /// send everything queued, call on the router loop
+    void
+    Drain()
+    {
+      // clear the flag first so a batch queued while we drain schedules another drain
+      m_Scheduled.store(false);
+      m_Queue.popBatch(
+          [](std::unique_ptr<UDPSendBatch> batch) { batch->Send(); }, m_Queue.capacity());
+    }
+  };
 }  // namespace
 
 struct lokinet_context
@@ -311,6 +397,16 @@ struct lokinet_context
   std::unordered_map<int, bool> streams;
   std::unordered_map<int, std::shared_ptr<UDPHandler>> udp_sockets;
 
+  /// batches from lokinet_udp_flow_sendmmsg on their way to the router loop
+  std::shared_ptr<UDPSendQueue> udp_send_queue = std::make_shared<UDPSendQueue>();
+
+  /// queue a batch for the router loop without blocking, false if the queue is full
+  [[nodiscard]] bool
+  queue_udp_send(std::unique_ptr<UDPSendBatch> batch)
+  {
+    return udp_send_queue->Push(std::move(batch), impl->router->loop());
+  }
+
   void
   inbound_stream(int id)
   {
@@ -973,6 +1069,63 @@ extern "C"
     return EINVAL;
   }
 
+  int EXPORT
+  lokinet_udp_flow_sendmmsg(
+      const struct lokinet_udp_flowinfo* remote,
+      const struct lokinet_udp_pkt* pkts,
+      size_t num,
+      lokinet_udp_flow_send_done_func done,
+      void* user,
+      struct lokinet_context* ctx)
+  {
+    if (remote == nullptr or remote->remote_port == 0 or pkts == nullptr or num == 0
+        or ctx == nullptr)
+      return EINVAL;
+    auto maybe = llarp::service::ParseAddress(std::string{remote->remote_host});
+    if (not maybe)
+      return EINVAL;
+    auto batch = std::make_unique<UDPSendBatch>();
+    llarp::nuint16_t srcport{0};
+    const auto dstport = llarp::net::port_t::from_host(remote->remote_port);
+    {
+      auto lock = ctx->acquire();
+      if (auto itr = ctx->udp_sockets.find(remote->socket_id); itr != ctx->udp_sockets.end())
+      {
+        batch->m_Endpoint = itr->second->m_Endpoint.lock();
+        srcport = itr->second->m_LocalPort;
+      }
+    }
+    if (not batch->m_Endpoint)
+      return EHOSTUNREACH;
+    batch->m_Remote = *maybe;
+    batch->m_Done = done;
+    batch->m_User = user;
+    // build the packets here rather than on the router loop so many sending threads share the work
+    batch->m_Packets.reserve(num);
+    for (size_t idx = 0; idx < num; ++idx)
+    {
+      const auto* data = static_cast<const byte_t*>(pkts[idx].data);
+      if (data == nullptr or pkts[idx].len == 0)
+      {
+        ++batch->m_Dropped;
+        continue;
+      }
+      auto pkt = llarp::net::IPPacket::make_udp(
+          llarp::net::ipv4addr_t{},
+          srcport,
+          llarp::net::ipv4addr_t{},
+          dstport,
+          std::vector<byte_t>{data, data + pkts[idx].len});
+      if (pkt.empty())
+        ++batch->m_Dropped;
+      else
+        batch->m_Packets.emplace_back(std::move(pkt));
+    }
+    if (not ctx->queue_udp_send(std::move(batch)))
+      return EAGAIN;
+    return 0;
+  }
+
   int EXPORT
   lokinet_udp_establish(
       lokinet_udp_create_flow_func create_flow,
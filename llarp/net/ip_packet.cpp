@@ -558,6 +558,37 @@ namespace llarp::net
     }
   }
 
+  bool
+  IPPacket::MarkCongestionExperienced()
+  {
+    // the ecn codepoint is the low 2 bits of the traffic class, 00 means not ecn capable and 11
+    // means already marked
+    constexpr byte_t ecn_mask = 0b11;
+    if (IsV4() and size() >= MinSize)
+    {
+      auto hdr = Header();
+      const auto ecn = hdr->tos & ecn_mask;
+      if (ecn == 0 or ecn == ecn_mask)
+        return false;
+      hdr->tos |= ecn_mask;
+      hdr->check = 0;
+      hdr->check = ipchksum(data(), std::min<size_t>(hdr->ihl * 4, size()));
+      return true;
+    }
+    if (IsV6() and size() >= sizeof(ipv6_header))
+    {
+      // traffic class straddles the first 2 bytes, its ecn bits are bits 4 and 5 of byte 1
+      constexpr byte_t ecn_v6_mask = ecn_mask << 4;
+      auto& tc = data()[1];
+      const auto ecn = tc & ecn_v6_mask;
+      if (ecn == 0 or ecn == ecn_v6_mask)
+        return false;
+      tc |= ecn_v6_mask;
+      return true;
+    }
+    return false;
+  }
+
   std::optional<IPPacket>
   IPPacket::MakeICMPUnreachable() const
   {
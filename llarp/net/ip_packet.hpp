@@ -371,6 +371,11 @@ namespace llarp::net
     std::optional<IPPacket>
     MakeICMPUnreachable() const;
 
+    /// if this packet is ecn capable mark it as having experienced congestion
+    /// return true if we marked it
+    bool
+    MarkCongestionExperienced();
+
     std::function<void(net::IPPacket)> reply;
   };
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ip_range.hpp"
+#include "ip_range_trie.hpp"
 #include <llarp/util/status.hpp>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -12,7 +14,8 @@ namespace llarp
     /// a container that maps an ip range to a value that allows you to lookup
     /// key by range hit
     ///
-    /// in the future we should do some kind of magic shit to ensure near constant time for lookups
+    /// lookups by ip go through a prefix trie over the entries so they do not get slower with
+    /// every range we add, changes are rare and rebuild it when they remove things
     template <typename Value_t>
     struct IPRangeMap
     {
@@ -41,12 +44,7 @@ namespace llarp
       bool
       ContainsValue(const Value_t& val) const
       {
-        for (const auto& entry : m_Entries)
-        {
-          if (entry.second == val)
-            return true;
-        }
-        return false;
+        return m_ValueCounts.count(val) > 0;
       }
 
       void
@@ -95,11 +93,7 @@ namespace llarp
       FindAllEntries(const IP_t& addr) const
       {
         std::set<Entry_t> found;
-        for (const auto& entry : m_Entries)
-        {
-          if (entry.first.Contains(addr))
-            found.insert(entry);
-        }
+        m_Trie.ForEachMatch(addr, [&](auto idx) { found.insert(m_Entries[idx]); });
         return found;
       }
 
@@ -115,7 +109,9 @@ namespace llarp
       void
       Insert(const Range_t& addr, const Value_t& val)
       {
+        m_Trie.Insert(addr, m_Entries.size());
         m_Entries.emplace_back(addr, val);
+        m_ValueCounts[val]++;
       }
 
       template <typename Visit_t>
@@ -123,13 +119,19 @@ namespace llarp
       RemoveIf(Visit_t visit)
       {
         auto itr = m_Entries.begin();
+        bool removed = false;
         while (itr != m_Entries.end())
         {
           if (visit(*itr))
+          {
             itr = m_Entries.erase(itr);
+            removed = true;
+          }
           else
             ++itr;
         }
+        if (removed)
+          Reindex();
       }
 
       util::StatusObject
@@ -144,7 +146,24 @@ namespace llarp
       }
 
      private:
+      /// rebuild the lookup structures after entries moved around
+      void
+      Reindex()
+      {
+        m_Trie.Clear();
+        m_ValueCounts.clear();
+        for (size_t idx = 0; idx < m_Entries.size(); ++idx)
+        {
+          m_Trie.Insert(m_Entries[idx].first, idx);
+          m_ValueCounts[m_Entries[idx].second]++;
+        }
+      }
+
       Container_t m_Entries;
+      /// ranges to their index in m_Entries
+      IPRangeTrie m_Trie;
+      /// how many entries map to each value
+      std::map<Value_t, size_t> m_ValueCounts;
     };
   }  // namespace net
 }  // namespace llarp
@@ -0,0 +1,126 @@
+#include "ip_range_trie.hpp"
+
+#include <llarp/util/bits.hpp>
+
+#include <algorithm>
+
+namespace llarp::net
+{
+  /// number of leading bits a and b have in common
+  static uint32_t
+  CommonBits(const uint128_t& a, const uint128_t& b)
+  {
+    const auto diff = a ^ b;
+    if (diff.upper)
+      return __builtin_clzll(diff.upper);
+    if (diff.lower)
+      return 64 + __builtin_clzll(diff.lower);
+    return 128;
+  }
+
+  /// val with all but the leading bits cleared, this is on the lookup path so we do not use
+  /// netmask_ipv6_bits which builds the mask one bit at a time
+  static uint128_t
+  MaskTo(const uint128_t& val, uint32_t bits)
+  {
+    if (bits == 0)
+      return uint128_t{0};
+    if (bits <= 64)
+      return uint128_t{val.upper & (~uint64_t{0} << (64 - bits)), 0};
+    return uint128_t{val.upper, val.lower & (~uint64_t{0} << (128 - bits))};
+  }
+
+  IPRangeTrie::IPRangeTrie()
+  {
+    Clear();
+  }
+
+  void
+  IPRangeTrie::Clear()
+  {
+    m_Nodes.clear();
+    m_NumRanges = 0;
+    // the root is ::/0 and always there
+    NewNode(uint128_t{0}, 0);
+  }
+
+  IPRangeTrie::Index_t
+  IPRangeTrie::NewNode(const uint128_t& prefix, uint32_t bits)
+  {
+    auto& node = m_Nodes.emplace_back();
+    node.prefix = prefix;
+    node.bits = bits;
+    return m_Nodes.size() - 1;
+  }
+
+  bool
+  IPRangeTrie::PrefixMatches(const Node& node, const huint128_t& ip)
+  {
+    return MaskTo(ip.h, node.bits) == node.prefix;
+  }
+
+  void
+  IPRangeTrie::Insert(const IPRange& range, Tag_t tag)
+  {
+    const uint32_t bits = bits::count_bits(range.netmask_bits);
+    const auto prefix = MaskTo(range.addr.h, bits);
+    m_NumRanges++;
+    Index_t idx = 0;
+    for (;;)
+    {
+      // node idx holds a prefix of ours, nodes get added below so only hold on to indexes
+      if (m_Nodes[idx].bits == bits)
+      {
+        m_Nodes[idx].tags.push_back(tag);
+        return;
+      }
+      const int dir = BitAt(prefix, m_Nodes[idx].bits);
+      const auto child = m_Nodes[idx].children[dir];
+      if (child == NoNode)
+      {
+        const auto leaf = NewNode(prefix, bits);
+        m_Nodes[leaf].tags.push_back(tag);
+        m_Nodes[idx].children[dir] = leaf;
+        return;
+      }
+      const auto common =
+          std::min({CommonBits(prefix, m_Nodes[child].prefix), bits, m_Nodes[child].bits});
+      if (common == m_Nodes[child].bits)
+      {
+        idx = child;
+        continue;
+      }
+      // we branch off part way along the child's compressed path, put a node where we do
+      const auto split = NewNode(MaskTo(prefix, common), common);
+      m_Nodes[split].children[BitAt(m_Nodes[child].prefix, common)] = child;
+      m_Nodes[idx].children[dir] = split;
+      if (common == bits)
+      {
+        m_Nodes[split].tags.push_back(tag);
+        return;
+      }
+      const auto leaf = NewNode(prefix, bits);
+      m_Nodes[leaf].tags.push_back(tag);
+      m_Nodes[split].children[BitAt(prefix, common)] = leaf;
+      return;
+    }
+  }
+
+  bool
+  IPRangeTrie::Contains(const huint128_t& ip) const
+  {
+    Index_t idx = 0;
+    while (idx != NoNode)
+    {
+      const auto& node = m_Nodes[idx];
+      if (not PrefixMatches(node, ip))
+        return false;
+      if (not node.tags.empty())
+        return true;
+      if (node.bits == 128)
+        return false;
+      idx = node.children[BitAt(ip.h, node.bits)];
+    }
+    return false;
+  }
+}  // namespace llarp::net
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ip_range.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace llarp
+{
+  namespace net
+  {
+    /// a path compressed binary radix trie of ip ranges for longest prefix matching.
+    /// each range is inserted with a tag, a lookup walks one path from the shortest to the
+    /// longest matching prefix, so it costs at most one node per distinct prefix length on the
+    /// way instead of a look at every range we hold.
+    /// ranges are expected to have contiguous netmasks like everything IPRange makes.
+    class IPRangeTrie
+    {
+     public:
+      using Tag_t = size_t;
+
+      IPRangeTrie();
+
+      /// add a range, the same range can be added with multiple tags
+      void
+      Insert(const IPRange& range, Tag_t tag);
+
+      /// forget all ranges
+      void
+      Clear();
+
+      bool
+      Empty() const
+      {
+        return m_NumRanges == 0;
+      }
+
+      /// call visit with the tag of every range containing ip, shortest prefix first, tags of the
+      /// same range in the order they were inserted
+      template <typename Visit_t>
+      void
+      ForEachMatch(const huint128_t& ip, Visit_t&& visit) const
+      {
+        Index_t idx = 0;
+        while (idx != NoNode)
+        {
+          const auto& node = m_Nodes[idx];
+          if (not PrefixMatches(node, ip))
+            return;
+          for (const auto tag : node.tags)
+            visit(tag);
+          if (node.bits == 128)
+            return;
+          idx = node.children[BitAt(ip.h, node.bits)];
+        }
+      }
+
+      /// return true if any range contains ip
+      bool
+      Contains(const huint128_t& ip) const;
+
+     private:
+      using Index_t = uint32_t;
+      static constexpr Index_t NoNode = ~Index_t{};
+
+      struct Node
+      {
+        /// the prefix with all bits past bits cleared
+        uint128_t prefix;
+        /// prefix length
+        uint32_t bits;
+        Index_t children[2] = {NoNode, NoNode};
+        std::vector<Tag_t> tags;
+      };
+
+      /// value of bit n counting from the most significant
+      static constexpr int
+      BitAt(const uint128_t& val, uint32_t n)
+      {
+        return n < 64 ? (val.upper >> (63 - n)) & 1 : (val.lower >> (127 - n)) & 1;
+      }
+
+      static bool
+      PrefixMatches(const Node& node, const huint128_t& ip);
+
+      Index_t
+      NewNode(const uint128_t& prefix, uint32_t bits);
+
+      std::vector<Node> m_Nodes;
+      size_t m_NumRanges = 0;
+    };
+  }  // namespace net
+}  // namespace llarp
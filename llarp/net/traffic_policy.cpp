@@ -1,6 +1,8 @@
 #include "traffic_policy.hpp"
 #include "llarp/util/str.hpp"
 
+#include <algorithm>
+
 namespace llarp::net
 {
   ProtocolInfo::ProtocolInfo(std::string_view data)
@@ -70,6 +72,51 @@ namespace llarp::net
     return false;
   }
 
+  TrafficPolicyMatcher::TrafficPolicyMatcher(const TrafficPolicy& policy)
+      : m_AllowAll{policy.protocols.empty() and policy.ranges.empty()}
+  {
+    for (const auto& proto : policy.protocols)
+    {
+      const auto num = static_cast<std::underlying_type_t<IPProtocol>>(proto.protocol);
+      m_Protocols.set(num);
+      if (proto.port)
+        m_ProtocolPorts.push_back((uint32_t{num} << 16) | ToHost(*proto.port).h);
+      else
+        m_AnyPort.set(num);
+    }
+    std::sort(m_ProtocolPorts.begin(), m_ProtocolPorts.end());
+    for (const auto& range : policy.ranges)
+      m_Ranges.Insert(range, 0);
+  }
+
+  bool
+  TrafficPolicyMatcher::AllowsTraffic(const IPPacket& pkt) const
+  {
+    if (m_AllowAll)
+      return true;
+
+    const auto num = pkt.Header()->protocol;
+    if (m_Protocols.test(num))
+    {
+      if (m_AnyPort.test(num))
+        return true;
+      const auto maybe = pkt.DstPort();
+      // we can't tell what the port is but the protocol matches and that's good enough
+      if (not maybe)
+        return true;
+      const uint32_t key = (uint32_t{num} << 16) | ToHost(*maybe).h;
+      if (std::binary_search(m_ProtocolPorts.begin(), m_ProtocolPorts.end(), key))
+        return true;
+    }
+    if (m_Ranges.Empty())
+      return false;
+    if (pkt.IsV6())
+      return m_Ranges.Contains(pkt.dstv6());
+    if (pkt.IsV4())
+      return m_Ranges.Contains(pkt.dst4to6());
+    return false;
+  }
+
   bool
   ProtocolInfo::BDecode(llarp_buffer_t* buf)
   {
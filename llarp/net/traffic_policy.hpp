@@ -1,10 +1,13 @@
 #pragma once
 
 #include "ip_range.hpp"
+#include "ip_range_trie.hpp"
 #include "ip_packet.hpp"
 #include "llarp/util/status.hpp"
 
+#include <bitset>
 #include <set>
+#include <vector>
 
 namespace llarp::net
 {
@@ -63,4 +66,28 @@ namespace llarp::net
     bool
     AllowsTraffic(const IPPacket& pkt) const;
   };
+
+  /// a TrafficPolicy compiled for checking lots of packets against it, gives the same answers as
+  /// TrafficPolicy::AllowsTraffic without looking at every protocol and range for each packet.
+  /// does not follow changes to the policy it was made from.
+  class TrafficPolicyMatcher
+  {
+   public:
+    explicit TrafficPolicyMatcher(const TrafficPolicy& policy);
+
+    /// returns true if we allow the traffic in this ip packet
+    /// returns false otherwise
+    bool
+    AllowsTraffic(const IPPacket& pkt) const;
+
+   private:
+    bool m_AllowAll;
+    /// ip protocols with any protocol info at all
+    std::bitset<256> m_Protocols;
+    /// ip protocols allowed on any port
+    std::bitset<256> m_AnyPort;
+    /// sorted (protocol << 16 | port in host order) of the protocols allowed on one port
+    std::vector<uint32_t> m_ProtocolPorts;
+    IPRangeTrie m_Ranges;
+  };
 }  // namespace llarp::net
@@ -10,6 +10,7 @@
 #include <llarp/nodedb.hpp>
 #include <llarp/profiling.hpp>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/router/i_outbound_message_handler.hpp>
 #include <llarp/routing/dht_message.hpp>
 #include <llarp/routing/path_latency_message.hpp>
 #include <llarp/routing/transfer_traffic_message.hpp>
@@ -114,6 +115,13 @@ namespace llarp
       return intro.latency > 0s && _status == ePathEstablished;
     }
 
+    bool
+    Path::IsCongested(AbstractRouter* r) const
+    {
+      return r->outboundMessageHandler().IsCongested(TXID())
+          or r->linkManager().IsCongestedTo(Upstream());
+    }
+
     bool
     Path::IsEndpoint(const RouterID& r, const PathID_t& id) const
     {
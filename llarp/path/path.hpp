@@ -345,6 +345,11 @@ namespace llarp
       bool
       IsReady() const;
 
+      /// return true if traffic we send upstream on this path is backing up in the outbound
+      /// message queues or in the link session to our first hop
+      bool
+      IsCongested(AbstractRouter* r) const;
+
       // Is this deprecated?
       // nope not deprecated :^DDDD
       PathID_t
@@ -4,6 +4,7 @@
 #include "path.hpp"
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/router/i_outbound_message_handler.hpp>
+#include <llarp/router/router_metrics.hpp>
 
 namespace llarp
 {
@@ -342,6 +343,37 @@ namespace llarp
     {
       MapPut<SyncTransitMap_t::Lock_t>(m_TransitPaths, hop->info.txID, hop);
       MapPut<SyncTransitMap_t::Lock_t>(m_TransitPaths, hop->info.rxID, hop);
+      ExpireTransitHopLater(hop);
+    }
+
+    void
+    PathContext::ExpireTransitHopLater(const TransitHop_ptr& hop)
+    {
+      const auto now = m_Router->Now();
+      const auto expires = hop->ExpireTime();
+      m_Router->loop()->call_later(
+          expires > now ? expires - now : 0s,
+          [this, alive = std::weak_ptr<int>{m_Alive}, weak = std::weak_ptr<TransitHop>{hop}]() {
+            // we were torn down first, or the hop was removed early
+            auto hop = weak.lock();
+            if (alive.expired() or not hop)
+              return;
+            if (hop->Expired(m_Router->Now()))
+              RemoveTransitHop(hop);
+            else
+              ExpireTransitHopLater(hop);
+          });
+    }
+
+    void
+    PathContext::RemoveTransitHop(const TransitHop_ptr& hop)
+    {
+      for (const auto& id : {hop->info.txID, hop->info.rxID})
+      {
+        MapDel<SyncTransitMap_t::Lock_t>(
+            m_TransitPaths, id, [&hop](const auto& other) { return other == hop; });
+        m_Router->outboundMessageHandler().RemovePath(id);
+      }
     }
 
     void
@@ -351,26 +383,18 @@ namespace llarp
       m_PathLimits.Decay(now);
 
       {
+        // transit hops are removed by their expiry timers, see ExpireTransitHopLater
         SyncTransitMap_t::Lock_t lock(m_TransitPaths.first);
         auto& map = m_TransitPaths.second;
-        auto itr = map.begin();
-        while (itr != map.end())
-        {
-          if (itr->second->Expired(now))
-          {
-            m_Router->outboundMessageHandler().RemovePath(itr->first);
-            itr = map.erase(itr);
-          }
-          else
-          {
-            itr->second->DecayFilters(now);
-            ++itr;
-          }
-        }
+        for (const auto& item : map)
+          item.second->DecayFilters(now);
+        // each hop is mapped by both its ids
+        m_Router->metrics().transitPaths.Set(map.size() / 2);
       }
       {
         util::Lock lock(m_OurPaths.first);
         auto& map = m_OurPaths.second;
+        int64_t established = 0;
         auto itr = map.begin();
         while (itr != map.end())
         {
@@ -381,9 +405,13 @@ namespace llarp
           else
           {
             itr->second->DecayFilters(now);
+            if (itr->second->IsReady())
+              established++;
             ++itr;
           }
         }
+        // each path is mapped by both its ids
+        m_Router->metrics().pathsEstablished.Set(established / 2);
       }
     }
 
@@ -10,6 +10,7 @@
 #include <llarp/router/i_outbound_message_handler.hpp>
 #include <llarp/util/compare_ptr.hpp>
 #include <llarp/util/decaying_hashset.hpp>
+#include <llarp/util/thread/batch_pool.hpp>
 #include <llarp/util/types.hpp>
 
 #include <memory>
@@ -62,9 +63,14 @@ namespace llarp
       bool
       HandleRelayCommit(const LR_CommitMessage& msg);
 
+      /// add a transit hop, it is removed again when it expires
       void
       PutTransitHop(std::shared_ptr<TransitHop> hop);
 
+      /// drop a transit hop before it expires, along with anything queued on its path ids
+      void
+      RemoveTransitHop(const TransitHop_ptr& hop);
+
       HopHandler_ptr
       GetByUpstream(const RouterID& id, const PathID_t& path);
 
@@ -177,12 +183,36 @@ namespace llarp
       uint64_t
       CurrentOwnedPaths(path::PathStatus status = path::PathStatus::ePathEstablished);
 
+      /// storage for the upstream messages transit hops relay, shared by all of them
+      thread::BatchPool<RelayUpstreamMessage>&
+      UpstreamRelayBatches()
+      {
+        return m_UpstreamRelayBatches;
+      }
+
+      /// storage for the downstream messages transit hops relay, shared by all of them
+      thread::BatchPool<RelayDownstreamMessage>&
+      DownstreamRelayBatches()
+      {
+        return m_DownstreamRelayBatches;
+      }
+
      private:
+      /// remove hop from an event loop timer once it has expired
+      void
+      ExpireTransitHopLater(const TransitHop_ptr& hop);
+
       AbstractRouter* m_Router;
       SyncTransitMap_t m_TransitPaths;
       SyncOwnedPathsMap_t m_OurPaths;
       bool m_AllowTransit;
       util::DecayingHashSet<IpAddress> m_PathLimits;
+      thread::BatchPool<RelayUpstreamMessage> m_UpstreamRelayBatches{
+          transit_relay_spare_batches, transit_relay_max_batch};
+      thread::BatchPool<RelayDownstreamMessage> m_DownstreamRelayBatches{
+          transit_relay_spare_batches, transit_relay_max_batch};
+      // hop expiry timers only touch us while this is alive
+      std::shared_ptr<int> m_Alive = std::make_shared<int>(0);
     };
   }  // namespace path
 }  // namespace llarp
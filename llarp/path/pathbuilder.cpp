@@ -8,6 +8,7 @@
 #include <llarp/profiling.hpp>
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/router/i_rc_lookup_handler.hpp>
+#include <llarp/router/router_metrics.hpp>
 #include <llarp/util/buffer.hpp>
 #include <llarp/tooling/path_event.hpp>
 #include <llarp/link/link_manager.hpp>
@@ -143,6 +144,7 @@ namespace llarp
 
     ctx->router->pathContext().AddOwnPath(ctx->pathset, ctx->path);
     ctx->pathset->PathBuildStarted(ctx->path);
+    ctx->router->metrics().pathBuildAttempts.Add();
 
     const RouterID remote = ctx->path->Upstream();
     auto sentHandler = [router = ctx->router, path = ctx->path](auto status) {
@@ -463,12 +465,14 @@ namespace llarp
 
       LogInfo(p->Name(), " built latency=", ToString(p->intro.latency));
       m_BuildStats.success++;
+      m_router->metrics().pathBuildSuccesses.Add();
     }
 
     void
     Builder::HandlePathBuildFailedAt(Path_ptr p, RouterID edge)
     {
       PathSet::HandlePathBuildFailedAt(p, edge);
+      m_router->metrics().pathBuildFailures.Add();
       DoPathBuildBackoff();
     }
 
@@ -486,6 +490,7 @@ namespace llarp
     {
       m_router->routerProfiling().MarkPathTimeout(p.get());
       PathSet::HandlePathBuildTimeout(p);
+      m_router->metrics().pathBuildTimeouts.Add();
       DoPathBuildBackoff();
       for (const auto& hop : p->hops)
       {
@@ -32,16 +32,8 @@ namespace llarp
           downstream);
     }
 
-    TransitHop::TransitHop()
-        : IHopHandler{}
-        , m_UpstreamGather{transit_hop_queue_size}
-        , m_DownstreamGather{transit_hop_queue_size}
-    {
-      m_UpstreamGather.enable();
-      m_DownstreamGather.enable();
-      m_UpstreamWorkCounter = 0;
-      m_DownstreamWorkCounter = 0;
-    }
+    TransitHop::TransitHop() : IHopHandler{}
+    {}
 
     bool
     TransitHop::Expired(llarp_time_t now) const
@@ -108,17 +100,13 @@ namespace llarp
     void
     TransitHop::DownstreamWork(TrafficQueue_t msgs, AbstractRouter* r)
     {
-      auto flushIt = [self = shared_from_this(), r]() {
-        std::vector<RelayDownstreamMessage> msgs;
-        while (auto maybe = self->m_DownstreamGather.tryPopFront())
-        {
-          msgs.push_back(*maybe);
-        }
-        self->HandleAllDownstream(std::move(msgs), r);
-      };
+      if (m_Stopped)
+        return;
+      auto sendmsgs = r->pathContext().DownstreamRelayBatches().Take();
+      sendmsgs.reserve(msgs.size());
       for (auto& ev : msgs)
       {
-        RelayDownstreamMessage msg;
+        auto& msg = sendmsgs.emplace_back();
         const llarp_buffer_t buf(ev.first);
         msg.pathid = info.rxID;
         msg.Y = ev.second ^ nonceXOR;
@@ -131,38 +119,29 @@ namespace llarp
             info.upstream,
             " to ",
             info.downstream);
-        if (m_DownstreamGather.full())
-        {
-          r->loop()->call(flushIt);
-        }
-        if (m_DownstreamGather.enabled())
-          m_DownstreamGather.pushBack(msg);
       }
-      r->loop()->call(flushIt);
+      r->loop()->call([self = shared_from_this(), msgs = std::move(sendmsgs), r]() mutable {
+        self->HandleAllDownstream(std::move(msgs), r);
+      });
     }
 
     void
     TransitHop::UpstreamWork(TrafficQueue_t msgs, AbstractRouter* r)
     {
+      if (m_Stopped)
+        return;
+      auto sendmsgs = r->pathContext().UpstreamRelayBatches().Take();
+      sendmsgs.reserve(msgs.size());
       for (auto& ev : msgs)
       {
+        auto& msg = sendmsgs.emplace_back();
         const llarp_buffer_t buf(ev.first);
-        RelayUpstreamMessage msg;
         CryptoManager::instance()->xchacha20(buf, pathKey, ev.second);
         msg.pathid = info.txID;
         msg.Y = ev.second ^ nonceXOR;
         msg.X = buf;
-        if (m_UpstreamGather.tryPushBack(msg) != thread::QueueReturn::Success)
-          break;
       }
-
-      // Flush it:
-      r->loop()->call([self = shared_from_this(), r] {
-        std::vector<RelayUpstreamMessage> msgs;
-        while (auto maybe = self->m_UpstreamGather.tryPopFront())
-        {
-          msgs.push_back(*maybe);
-        }
+      r->loop()->call([self = shared_from_this(), msgs = std::move(sendmsgs), r]() mutable {
         self->HandleAllUpstream(std::move(msgs), r);
       });
     }
@@ -202,6 +181,7 @@ namespace llarp
           r->SendToOrQueue(info.upstream, msg);
         }
       }
+      r->pathContext().UpstreamRelayBatches().Give(std::move(msgs));
       r->TriggerPump();
     }
 
@@ -219,6 +199,7 @@ namespace llarp
             info.downstream);
         r->SendToOrQueue(info.downstream, msg);
       }
+      r->pathContext().DownstreamRelayBatches().Give(std::move(msgs));
       r->TriggerPump();
     }
 
@@ -400,8 +381,7 @@ namespace llarp
             continue;
           auto counter = oxenc::load_big_to_host<uint64_t>(pkt.data());
           llarp_buffer_t buf{pkt.data() + 8, pkt.size() - 8};
-          sent =
-              endpoint->QueueOutboundTraffic(info.rxID, buf.copy(), counter, msg.protocol) and sent;
+          sent = endpoint->QueueOutboundTraffic(info.rxID, buf, counter, msg.protocol) and sent;
         }
         return sent;
       }
@@ -441,8 +421,7 @@ namespace llarp
     void
     TransitHop::Stop()
     {
-      m_UpstreamGather.disable();
-      m_DownstreamGather.disable();
+      m_Stopped = true;
     }
 
     void
@@ -454,7 +433,10 @@ namespace llarp
     void
     TransitHop::QueueDestroySelf(AbstractRouter* r)
     {
-      r->loop()->call([self = shared_from_this()] { self->SetSelfDestruct(); });
+      r->loop()->call([self = shared_from_this(), r] {
+        self->SetSelfDestruct();
+        r->pathContext().RemoveTransitHop(self);
+      });
     }
   }  // namespace path
 }  // namespace llarp
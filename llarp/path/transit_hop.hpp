@@ -6,7 +6,9 @@
 #include <llarp/routing/handler.hpp>
 #include <llarp/router_id.hpp>
 #include <llarp/util/compare_ptr.hpp>
-#include <llarp/util/thread/queue.hpp>
+
+#include <atomic>
+#include <set>
 
 namespace llarp
 {
@@ -200,10 +202,9 @@ namespace llarp
       SetSelfDestruct();
 
       std::set<std::shared_ptr<TransitHop>, ComparePtr<std::shared_ptr<TransitHop>>> m_FlushOthers;
-      thread::Queue<RelayUpstreamMessage> m_UpstreamGather;
-      thread::Queue<RelayDownstreamMessage> m_DownstreamGather;
-      std::atomic<uint32_t> m_UpstreamWorkCounter;
-      std::atomic<uint32_t> m_DownstreamWorkCounter;
+      // relayed messages are not queued per hop: each batch of work fills a vector taken from the
+      // PathContext's relay batch pools, so an idle hop holds no message storage at all
+      std::atomic<bool> m_Stopped{false};
     };
   }  // namespace path
 
@@ -5,6 +5,8 @@
 #include "util/file.hpp"
 #include "util/logging.hpp"
 
+#include <fstream>
+
 using oxenc::bt_dict_consumer;
 using oxenc::bt_dict_producer;
 
@@ -99,6 +101,68 @@ namespace llarp
     return checkIsGood(pathFailCount, pathSuccessCount, chances);
   }
 
+  RouterProfile
+  Profiling::Record::Get() const
+  {
+    RouterProfile profile;
+    profile.connectTimeoutCount = connectTimeoutCount.load(std::memory_order_relaxed);
+    profile.connectGoodCount = connectGoodCount.load(std::memory_order_relaxed);
+    profile.pathSuccessCount = pathSuccessCount.load(std::memory_order_relaxed);
+    profile.pathFailCount = pathFailCount.load(std::memory_order_relaxed);
+    profile.pathTimeoutCount = pathTimeoutCount.load(std::memory_order_relaxed);
+    profile.lastUpdated = llarp_time_t{lastUpdated.load(std::memory_order_relaxed)};
+    profile.lastDecay = llarp_time_t{lastDecay.load(std::memory_order_relaxed)};
+    profile.version = version.load(std::memory_order_relaxed);
+    return profile;
+  }
+
+  void
+  Profiling::Record::Set(const RouterProfile& profile)
+  {
+    connectTimeoutCount = profile.connectTimeoutCount;
+    connectGoodCount = profile.connectGoodCount;
+    pathSuccessCount = profile.pathSuccessCount;
+    pathFailCount = profile.pathFailCount;
+    pathTimeoutCount = profile.pathTimeoutCount;
+    lastUpdated = profile.lastUpdated.count();
+    lastDecay = profile.lastDecay.count();
+    version = profile.version;
+  }
+
+  void
+  Profiling::Record::Touch()
+  {
+    lastUpdated.store(llarp::time_now_ms().count(), std::memory_order_relaxed);
+    dirty.store(true, std::memory_order_relaxed);
+  }
+
+  /// halve a counter, losing no concurrent increments
+  static void
+  halve(std::atomic<uint64_t>& counter)
+  {
+    auto val = counter.load(std::memory_order_relaxed);
+    while (not counter.compare_exchange_weak(val, val / 2, std::memory_order_relaxed))
+      ;
+  }
+
+  void
+  Profiling::Record::Decay(llarp_time_t now)
+  {
+    static constexpr auto updateInterval = 30s;
+    auto last = lastDecay.load(std::memory_order_relaxed);
+    if (last >= now.count() or now - llarp_time_t{last} <= updateInterval)
+      return;
+    // only one thread gets to decay per interval
+    if (not lastDecay.compare_exchange_strong(last, now.count(), std::memory_order_relaxed))
+      return;
+    halve(connectGoodCount);
+    halve(connectTimeoutCount);
+    halve(pathSuccessCount);
+    halve(pathFailCount);
+    halve(pathTimeoutCount);
+    dirty.store(true, std::memory_order_relaxed);
+  }
+
   Profiling::Profiling() : m_DisableProfiling(false)
   {}
 
@@ -114,16 +178,94 @@ namespace llarp
     m_DisableProfiling.store(false);
   }
 
+  Profiling::Shard&
+  Profiling::ShardFor(const RouterID& r)
+  {
+    return m_Shards[std::hash<RouterID>{}(r) % NumShards];
+  }
+
+  const Profiling::Shard&
+  Profiling::ShardFor(const RouterID& r) const
+  {
+    return m_Shards[std::hash<RouterID>{}(r) % NumShards];
+  }
+
+  std::optional<RouterProfile>
+  Profiling::Find(const RouterID& r) const
+  {
+    {
+      const auto profiles = m_Profiles.Read();
+      if (auto itr = profiles->find(r); itr != profiles->end())
+        return itr->second->Get();
+    }
+    const auto& shard = ShardFor(r);
+    if (shard.numFresh.load(std::memory_order_relaxed) == 0)
+      return std::nullopt;
+    util::Lock lock{shard.mutex};
+    if (auto itr = shard.fresh.find(r); itr != shard.fresh.end())
+      return itr->second->Get();
+    return std::nullopt;
+  }
+
+  std::shared_ptr<Profiling::Record>
+  Profiling::Get(const RouterID& r)
+  {
+    {
+      const auto profiles = m_Profiles.Read();
+      if (auto itr = profiles->find(r); itr != profiles->end())
+        return itr->second;
+    }
+    // first time we see this router, it waits in its shard until the next fold
+    auto& shard = ShardFor(r);
+    util::Lock lock{shard.mutex};
+    if (auto itr = shard.fresh.find(r); itr != shard.fresh.end())
+      return itr->second;
+    {
+      // a fold may have moved it into the index since we looked
+      const auto profiles = m_Profiles.Read();
+      if (auto itr = profiles->find(r); itr != profiles->end())
+        return itr->second;
+    }
+    auto record = std::make_shared<Record>();
+    shard.fresh.emplace(r, record);
+    shard.numFresh.store(shard.fresh.size(), std::memory_order_relaxed);
+    return record;
+  }
+
+  void
+  Profiling::Fold()
+  {
+    util::Lock index{m_IndexMutex};
+    std::vector<std::pair<RouterID, std::shared_ptr<Record>>> fresh;
+    for (auto& shard : m_Shards)
+    {
+      if (shard.numFresh.load(std::memory_order_relaxed) == 0)
+        continue;
+      util::Lock lock{shard.mutex};
+      fresh.insert(fresh.end(), shard.fresh.begin(), shard.fresh.end());
+    }
+    if (fresh.empty())
+      return;
+    // one copy of the index for however many routers turned up since the last fold
+    m_Profiles.Update(
+        [&fresh](ProfileMap_t& profiles) { profiles.insert(fresh.begin(), fresh.end()); });
+    // the records are in the index now, Get finds them there from here on
+    for (const auto& [rid, record] : fresh)
+    {
+      auto& shard = ShardFor(rid);
+      util::Lock lock{shard.mutex};
+      shard.fresh.erase(rid);
+      shard.numFresh.store(shard.fresh.size(), std::memory_order_relaxed);
+    }
+  }
+
   bool
   Profiling::IsBadForConnect(const RouterID& r, uint64_t chances)
   {
     if (m_DisableProfiling.load())
       return false;
-    util::Lock lock{m_ProfilesMutex};
-    auto itr = m_Profiles.find(r);
-    if (itr == m_Profiles.end())
-      return false;
-    return not itr->second.IsGoodForConnect(chances);
+    const auto profile = Find(r);
+    return profile and not profile->IsGoodForConnect(chances);
   }
 
   bool
@@ -131,11 +273,8 @@ namespace llarp
   {
     if (m_DisableProfiling.load())
       return false;
-    util::Lock lock{m_ProfilesMutex};
-    auto itr = m_Profiles.find(r);
-    if (itr == m_Profiles.end())
-      return false;
-    return not itr->second.IsGoodForPath(chances);
+    const auto profile = Find(r);
+    return profile and not profile->IsGoodForPath(chances);
   }
 
   bool
@@ -143,59 +282,63 @@ namespace llarp
   {
     if (m_DisableProfiling.load())
       return false;
-    util::Lock lock{m_ProfilesMutex};
-    auto itr = m_Profiles.find(r);
-    if (itr == m_Profiles.end())
-      return false;
-    return not itr->second.IsGood(chances);
+    const auto profile = Find(r);
+    return profile and not profile->IsGood(chances);
   }
 
   void
-  Profiling::Tick()
+  Profiling::Tick(llarp_time_t now)
   {
-    util::Lock lock(m_ProfilesMutex);
-    for (auto& [rid, profile] : m_Profiles)
-      profile.Tick();
+    Fold();
+    const auto profiles = m_Profiles.Read();
+    for (const auto& [rid, record] : *profiles)
+      record->Decay(now);
   }
 
   void
   Profiling::MarkConnectTimeout(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    auto& profile = m_Profiles[r];
-    profile.connectTimeoutCount += 1;
-    profile.lastUpdated = llarp::time_now_ms();
+    auto record = Get(r);
+    record->connectTimeoutCount += 1;
+    record->Touch();
   }
 
   void
   Profiling::MarkConnectSuccess(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    auto& profile = m_Profiles[r];
-    profile.connectGoodCount += 1;
-    profile.lastUpdated = llarp::time_now_ms();
+    auto record = Get(r);
+    record->connectGoodCount += 1;
+    record->Touch();
   }
 
   void
   Profiling::ClearProfile(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    m_Profiles.erase(r);
+    {
+      util::Lock index{m_IndexMutex};
+      {
+        auto& shard = ShardFor(r);
+        util::Lock lock{shard.mutex};
+        shard.fresh.erase(r);
+        shard.numFresh.store(shard.fresh.size(), std::memory_order_relaxed);
+      }
+      m_Profiles.Update([&r](ProfileMap_t& profiles) { profiles.erase(r); });
+    }
+    util::Lock lock{m_ClearedMutex};
+    m_Cleared.insert(r);
   }
 
   void
   Profiling::MarkHopFail(const RouterID& r)
   {
-    util::Lock lock{m_ProfilesMutex};
-    auto& profile = m_Profiles[r];
-    profile.pathFailCount += 1;
-    profile.lastUpdated = llarp::time_now_ms();
+    auto record = Get(r);
+    record->pathFailCount += 1;
+    record->Touch();
   }
 
   void
   Profiling::MarkPathFail(path::Path* p)
   {
-    util::Lock lock{m_ProfilesMutex};
     bool first = true;
     for (const auto& hop : p->hops)
     {
@@ -204,9 +347,9 @@ namespace llarp
         first = false;
       else
       {
-        auto& profile = m_Profiles[hop.rc.pubkey];
-        profile.pathFailCount += 1;
-        profile.lastUpdated = llarp::time_now_ms();
+        auto record = Get(hop.rc.pubkey);
+        record->pathFailCount += 1;
+        record->Touch();
       }
     }
   }
@@ -214,59 +357,91 @@ namespace llarp
   void
   Profiling::MarkPathTimeout(path::Path* p)
   {
-    util::Lock lock{m_ProfilesMutex};
     for (const auto& hop : p->hops)
     {
-      auto& profile = m_Profiles[hop.rc.pubkey];
-      profile.pathTimeoutCount += 1;
-      profile.lastUpdated = llarp::time_now_ms();
+      auto record = Get(hop.rc.pubkey);
+      record->pathTimeoutCount += 1;
+      record->Touch();
     }
   }
 
   void
   Profiling::MarkPathSuccess(path::Path* p)
   {
-    util::Lock lock{m_ProfilesMutex};
     const auto sz = p->hops.size();
     for (const auto& hop : p->hops)
     {
-      auto& profile = m_Profiles[hop.rc.pubkey];
+      auto record = Get(hop.rc.pubkey);
       // redeem previous fails by halfing the fail count and setting timeout to zero
-      profile.pathFailCount /= 2;
-      profile.pathTimeoutCount = 0;
+      halve(record->pathFailCount);
+      record->pathTimeoutCount = 0;
       // mark success at hop
-      profile.pathSuccessCount += sz;
-      profile.lastUpdated = llarp::time_now_ms();
+      record->pathSuccessCount += sz;
+      record->Touch();
     }
   }
 
+  static fs::path
+  journalPath(const fs::path& fpath)
+  {
+    return fs::path{fpath.string() + ".journal"};
+  }
+
   bool
   Profiling::Save(const fs::path fpath)
   {
-    std::string buf;
+    const auto journal = journalPath(fpath);
+    const bool compact = m_JournalEntries >= MaxJournalEntries or not fs::exists(fpath);
+
+    std::unordered_set<RouterID> cleared;
     {
-      util::Lock lock{m_ProfilesMutex};
-      buf.resize((m_Profiles.size() * (RouterProfile::MaxSize + 32 + 8)) + 8);
-      bt_dict_producer d{buf.data(), buf.size()};
-      try
-      {
-        BEncode(d);
-      }
-      catch (const std::exception& e)
+      util::Lock lock{m_ClearedMutex};
+      cleared.swap(m_Cleared);
+    }
+
+    Fold();
+    // bencode needs the routers in order
+    std::map<RouterID, RouterProfile> profiles;
+    {
+      // let go of the snapshot before touching the disk
+      const auto current = m_Profiles.Read();
+      for (const auto& [rid, record] : *current)
       {
-        log::warning(logcat, "Failed to encode profiling data: {}", e.what());
-        return false;
+        // clear the flag before reading so an update racing with us is saved next time
+        if (record->dirty.exchange(false, std::memory_order_relaxed) or compact)
+          profiles.emplace(rid, record->Get());
       }
-      buf.resize(d.end() - buf.data());
     }
 
     try
     {
-      util::dump_file(fpath, buf);
+      if (compact)
+      {
+        util::dump_file(fpath, BEncode(profiles, {}));
+        if (fs::exists(journal))
+          fs::remove(journal);
+        m_JournalEntries = 0;
+      }
+      else if (not profiles.empty() or not cleared.empty())
+      {
+        // each journal entry is a bencoded string holding a dict of the changed profiles
+        const auto entry = BEncode(profiles, cleared);
+        auto maybe_file =
+            util::OpenFileStream<std::ofstream>(journal, std::ios::binary | std::ios::app);
+        if (not maybe_file)
+          throw std::runtime_error{"cannot open journal"};
+        *maybe_file << entry.size() << ':' << entry;
+        maybe_file->flush();
+        if (not *maybe_file)
+          throw std::runtime_error{"cannot write journal"};
+        m_JournalEntries += profiles.size() + cleared.size();
+      }
     }
     catch (const std::exception& e)
     {
       log::warning(logcat, "Failed to save profiling data to {}: {}", fpath, e.what());
+      // make sure the next save writes everything out again
+      m_JournalEntries = MaxJournalEntries;
       return false;
     }
 
@@ -274,40 +449,101 @@ namespace llarp
     return true;
   }
 
-  void
-  Profiling::BEncode(bt_dict_producer& dict) const
+  std::string
+  Profiling::BEncode(
+      const std::map<RouterID, RouterProfile>& profiles,
+      const std::unordered_set<RouterID>& cleared)
   {
-    for (const auto& [r_id, profile] : m_Profiles)
-      profile.BEncode(dict.append_dict(r_id.ToView()));
+    std::map<RouterID, const RouterProfile*> entries;
+    for (const auto& [rid, profile] : profiles)
+      entries.emplace(rid, &profile);
+    for (const auto& rid : cleared)
+      entries.emplace(rid, nullptr);
+
+    std::string buf;
+    buf.resize((entries.size() * (RouterProfile::MaxSize + 32 + 8)) + 8);
+    bt_dict_producer dict{buf.data(), buf.size()};
+    for (const auto& [rid, profile] : entries)
+    {
+      if (profile)
+        profile->BEncode(dict.append_dict(rid.ToView()));
+      else
+        dict.append_dict(rid.ToView());
+    }
+    buf.resize(dict.end() - buf.data());
+    return buf;
   }
 
   void
-  Profiling::BDecode(bt_dict_consumer dict)
+  Profiling::BDecode(bt_dict_consumer dict, ProfileMap_t& profiles)
   {
-    m_Profiles.clear();
     while (dict)
     {
       auto [rid, subdict] = dict.next_dict_consumer();
       if (rid.size() != RouterID::SIZE)
         throw std::invalid_argument{"invalid RouterID"};
-      m_Profiles.emplace(reinterpret_cast<const byte_t*>(rid.data()), subdict);
+      const RouterID router{reinterpret_cast<const byte_t*>(rid.data())};
+      if (subdict.is_finished())
+      {
+        profiles.erase(router);
+        continue;
+      }
+      auto record = std::make_shared<Record>();
+      record->Set(RouterProfile{subdict});
+      record->dirty = false;
+      profiles[router] = std::move(record);
     }
   }
 
   bool
   Profiling::Load(const fs::path fname)
   {
+    auto profiles = std::make_unique<ProfileMap_t>();
     try
     {
       std::string data = util::slurp_file(fname);
-      util::Lock lock{m_ProfilesMutex};
-      BDecode(bt_dict_consumer{data});
+      BDecode(bt_dict_consumer{data}, *profiles);
     }
     catch (const std::exception& e)
     {
       log::warning(logcat, "failed to load router profiles from {}: {}", fname, e.what());
       return false;
     }
+
+    if (const auto journal = journalPath(fname); fs::exists(journal))
+    {
+      size_t replayed = 0;
+      try
+      {
+        // the journal is a run of bencoded strings, read it as a list of them
+        const std::string data = "l" + util::slurp_file(journal) + "e";
+        oxenc::bt_list_consumer entries{data};
+        while (not entries.is_finished())
+        {
+          BDecode(bt_dict_consumer{entries.consume_string_view()}, *profiles);
+          replayed++;
+        }
+      }
+      catch (const std::exception& e)
+      {
+        // a torn write at the end of the journal loses only the last save
+        log::warning(
+            logcat, "stopped replaying {} after {} entries: {}", journal, replayed, e.what());
+      }
+      // fold the journal back into the profiles file on the next save
+      m_JournalEntries = MaxJournalEntries;
+    }
+
+    {
+      util::Lock index{m_IndexMutex};
+      for (auto& shard : m_Shards)
+      {
+        util::Lock lock{shard.mutex};
+        shard.fresh.clear();
+        shard.numFresh.store(0, std::memory_order_relaxed);
+      }
+      m_Profiles.Store(std::move(profiles));
+    }
     m_LastSave = llarp::time_now_ms();
     return true;
   }
@@ -3,10 +3,17 @@
 #include "path/path.hpp"
 #include "router_id.hpp"
 #include "util/bencode.hpp"
+#include "util/thread/rcu_snapshot.hpp"
 #include "util/thread/threading.hpp"
 
 #include "util/thread/annotations.hpp"
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace oxenc
 {
@@ -60,54 +67,72 @@ namespace llarp
     Tick();
   };
 
+  /// router profiles, looked up and updated from path selection and session churn on many
+  /// threads without serializing on a lock.
+  /// profiles live in records of atomic counters behind an immutable index snapshot. routers
+  /// seen for the first time get a record in one of a set of small locked shards, and Tick folds
+  /// those into a new index in one go.
+  /// saving appends the profiles that changed since the last save to a journal next to the
+  /// profiles file and only rewrites the whole file once the journal has grown large.
   struct Profiling
   {
+    /// compact the journal into the profiles file once it has this many entries
+    static constexpr size_t MaxJournalEntries = 4096;
+
     Profiling();
 
     inline static const int profiling_chances = 4;
 
     /// generic variant
     bool
-    IsBad(const RouterID& r, uint64_t chances = profiling_chances) EXCLUDES(m_ProfilesMutex);
+    IsBad(const RouterID& r, uint64_t chances = profiling_chances);
 
     /// check if this router should have paths built over it
     bool
-    IsBadForPath(const RouterID& r, uint64_t chances = profiling_chances) EXCLUDES(m_ProfilesMutex);
+    IsBadForPath(const RouterID& r, uint64_t chances = profiling_chances);
 
     /// check if this router should be connected directly to
     bool
-    IsBadForConnect(const RouterID& r, uint64_t chances = profiling_chances)
-        EXCLUDES(m_ProfilesMutex);
+    IsBadForConnect(const RouterID& r, uint64_t chances = profiling_chances);
 
     void
-    MarkConnectTimeout(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    MarkConnectTimeout(const RouterID& r);
 
     void
-    MarkConnectSuccess(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    MarkConnectSuccess(const RouterID& r);
 
     void
-    MarkPathTimeout(path::Path* p) EXCLUDES(m_ProfilesMutex);
+    MarkPathTimeout(path::Path* p);
 
     void
-    MarkPathFail(path::Path* p) EXCLUDES(m_ProfilesMutex);
+    MarkPathFail(path::Path* p);
 
     void
-    MarkPathSuccess(path::Path* p) EXCLUDES(m_ProfilesMutex);
+    MarkPathSuccess(path::Path* p);
 
     void
-    MarkHopFail(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    MarkHopFail(const RouterID& r);
 
+    /// drop r's profile, copies the whole index so not for use in a hot path
     void
-    ClearProfile(const RouterID& r) EXCLUDES(m_ProfilesMutex);
+    ClearProfile(const RouterID& r);
+
+    /// get a copy of r's current profile if we have one
+    std::optional<RouterProfile>
+    Find(const RouterID& r) const;
 
+    /// decay profiles that are due for it and index routers first seen since the last tick
     void
-    Tick() EXCLUDES(m_ProfilesMutex);
+    Tick(llarp_time_t now);
 
+    /// load profiles from fname, replaying its journal if there is one
     bool
-    Load(const fs::path fname) EXCLUDES(m_ProfilesMutex);
+    Load(const fs::path fname);
 
+    /// save changed profiles to fname's journal, compacting into fname when needed.
+    /// only call from one thread at a time (the disk io thread)
     bool
-    Save(const fs::path fname) EXCLUDES(m_ProfilesMutex);
+    Save(const fs::path fname);
 
     bool
     ShouldSave(llarp_time_t now) const;
@@ -119,14 +144,83 @@ namespace llarp
     Enable();
 
    private:
-    void
-    BEncode(oxenc::bt_dict_producer& dict) const;
+    /// a router's profile as counters that are updated in place
+    struct Record
+    {
+      std::atomic<uint64_t> connectTimeoutCount{0};
+      std::atomic<uint64_t> connectGoodCount{0};
+      std::atomic<uint64_t> pathSuccessCount{0};
+      std::atomic<uint64_t> pathFailCount{0};
+      std::atomic<uint64_t> pathTimeoutCount{0};
+      std::atomic<int64_t> lastUpdated{0};
+      std::atomic<int64_t> lastDecay{0};
+      std::atomic<uint64_t> version{llarp::constants::proto_version};
+      /// changed since it was last saved
+      std::atomic<bool> dirty{true};
+
+      RouterProfile
+      Get() const;
+
+      void
+      Set(const RouterProfile& profile);
+
+      /// note an update now
+      void
+      Touch();
+
+      void
+      Decay(llarp_time_t now);
+    };
+
+    using ProfileMap_t = std::unordered_map<RouterID, std::shared_ptr<Record>>;
+
+    static constexpr size_t NumShards = 16;
 
+    /// routers first seen since the index was last rebuilt
+    struct Shard
+    {
+      mutable util::Mutex mutex;
+      ProfileMap_t fresh GUARDED_BY(mutex);
+      /// lets lookups skip the lock while the shard is empty, which is nearly always
+      std::atomic<size_t> numFresh{0};
+    };
+
+    Shard&
+    ShardFor(const RouterID& r);
+
+    const Shard&
+    ShardFor(const RouterID& r) const;
+
+    /// get r's record, making it if it does not exist
+    std::shared_ptr<Record>
+    Get(const RouterID& r);
+
+    /// publish a new index with the records the shards picked up
     void
-    BDecode(oxenc::bt_dict_consumer dict);
+    Fold();
+
+    /// decode a dict of router id to profile into profiles, an empty profile means the router's
+    /// profile was cleared
+    static void
+    BDecode(oxenc::bt_dict_consumer dict, ProfileMap_t& profiles);
+
+    /// bencode profiles, with an empty dict for each router in cleared
+    static std::string
+    BEncode(
+        const std::map<RouterID, RouterProfile>& profiles,
+        const std::unordered_set<RouterID>& cleared);
+
+    thread::RCUSnapshot<ProfileMap_t> m_Profiles;
+    std::array<Shard, NumShards> m_Shards;
+    /// serializes everything that publishes a new index
+    util::Mutex m_IndexMutex;
+
+    util::Mutex m_ClearedMutex;  // protects m_Cleared
+    // routers whose profile was cleared since the last save
+    std::unordered_set<RouterID> m_Cleared GUARDED_BY(m_ClearedMutex);
 
-    mutable util::Mutex m_ProfilesMutex;  // protects m_Profiles
-    std::map<RouterID, RouterProfile> m_Profiles GUARDED_BY(m_ProfilesMutex);
+    // entries appended to the journal since the last compaction, only touched by Load and Save
+    size_t m_JournalEntries = 0;
     llarp_time_t m_LastSave = 0s;
     std::atomic<bool> m_DisableProfiling;
   };
@@ -55,13 +55,12 @@ namespace llarp::quic
     return var::get<primary_conn_ptr>(it->second);
   }
 
-  size_t
-  Client::write_packet_header(nuint16_t, uint8_t ecn)
+  void
+  Client::write_packet_header(std::byte* dest, nuint16_t, uint8_t ecn)
   {
-    buf_[0] = CLIENT_TO_SERVER;
+    dest[0] = CLIENT_TO_SERVER;
     auto pseudo_port = local_addr.port();
-    std::memcpy(&buf_[1], &pseudo_port.n, 2);  // remote quic pseudo-port (network order u16)
-    buf_[3] = std::byte{ecn};
-    return 4;
+    std::memcpy(&dest[1], &pseudo_port.n, 2);  // remote quic pseudo-port (network order u16)
+    dest[3] = std::byte{ecn};
   }
 }  // namespace llarp::quic
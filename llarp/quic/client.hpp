@@ -22,8 +22,8 @@ namespace llarp::quic
     get_connection();
 
    private:
-    size_t
-    write_packet_header(nuint16_t remote_port, uint8_t ecn) override;
+    void
+    write_packet_header(std::byte* dest, nuint16_t remote_port, uint8_t ecn) override;
   };
 
 }  // namespace llarp::quic
@@ -5,6 +5,7 @@
 #include <llarp/util/logging.hpp>
 #include <llarp/util/logging/buffer.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <charconv>
 #include <cstring>
@@ -345,13 +346,13 @@ namespace llarp::quic
   io_result
   Connection::send()
   {
-    assert(send_buffer_size <= send_buffer.size());
+    assert(PACKET_HEADER_SIZE + send_buffer_size <= send_buffer.size());
     io_result rv{};
-    bstring_view send_data{send_buffer.data(), send_buffer_size};
 
-    if (!send_data.empty())
+    if (send_buffer_size)
     {
-      rv = endpoint.send_packet(path.remote, send_data, send_pkt_info.ecn);
+      rv = endpoint.send_frame(
+          path.remote, send_buffer.data(), send_buffer_size, send_pkt_info.ecn);
     }
     return rv;
   }
@@ -400,8 +401,8 @@ namespace llarp::quic
 #endif
 
     settings.initial_ts = get_timestamp();
-    // FIXME: IPv6
-    settings.max_udp_payload_size = Endpoint::max_pkt_size_v4;
+    // Sized for the lokinet path rather than an internet udp path, see MAX_PACKET_SIZE
+    settings.max_udp_payload_size = MAX_PACKET_SIZE;
     settings.cc_algo = NGTCP2_CC_ALGO_CUBIC;
     // settings.initial_rtt = ???; # NGTCP2's default is 333ms
 
@@ -550,7 +551,7 @@ namespace llarp::quic
   Connection::flush_streams()
   {
     // conn, path, pi, dest, destlen, and ts
-    std::optional<uint64_t> ts;
+    const auto ts = get_timestamp();
 
     send_pkt_info = {};
 
@@ -558,23 +559,22 @@ namespace llarp::quic
         [&](StreamID stream_id, const ngtcp2_vec* datav, size_t datalen, uint32_t flags = 0) {
           std::array<ngtcp2_ssize, 2> result;
           auto& [nwrite, consumed] = result;
-          if (!ts)
-            ts = get_timestamp();
 
+          constexpr size_t send_capacity = MAX_PACKET_SIZE;
           LogTrace(
-              "send_buffer size=", send_buffer.size(), ", datalen=", datalen, ", flags=", flags);
+              "send_buffer size=", send_capacity, ", datalen=", datalen, ", flags=", flags);
           nwrite = ngtcp2_conn_writev_stream(
               conn.get(),
               &path.path,
               &send_pkt_info,
-              u8data(send_buffer),
-              send_buffer.size(),
+              u8data(send_buffer) + PACKET_HEADER_SIZE,
+              send_capacity,
               &consumed,
               NGTCP2_WRITE_STREAM_FLAG_MORE | flags,
               stream_id.id,
               datav,
               datalen,
-              *ts);
+              ts);
           return result;
         };
 
@@ -600,105 +600,125 @@ namespace llarp::quic
       return true;
     };
 
-    std::list<Stream*> strs;
-    for (auto& [stream_id, stream_ptr] : streams)
-      if (stream_ptr)
-        strs.push_back(stream_ptr.get());
-
-    // Maximum number of stream data packets to send out at once; if we reach this then we'll
-    // schedule another event loop call of ourselves (so that we don't starve the loop).
-    constexpr int max_stream_packets = 15;
-    int stream_packets = 0;
-    while (!strs.empty() && stream_packets < max_stream_packets)
+    // We send a burst of as many packets as ngtcp2's pacer allows right now, back to back, so that
+    // the service endpoint queues them together and they leave on the same path flush.  We then
+    // tell ngtcp2 when the burst went out, which makes the expiry we schedule at the end include
+    // the time the next burst is allowed to go.  The cap keeps a big congestion window from
+    // starving the event loop.
+    constexpr size_t max_burst_packets = 15;
+    const size_t burst_packets = std::clamp<size_t>(
+        ngtcp2_conn_get_send_quantum(*this) / MAX_PACKET_SIZE, 1, max_burst_packets);
+    size_t packets = 0;
+
+    // Streams take turns, starting from the one after the stream that last got to send.  We stop
+    // once the burst is full or once every stream has had a turn since any of them last sent.
+    // The position is kept as a StreamID rather than an iterator because sending can end up
+    // opening or closing streams.
+    std::vector<ngtcp2_vec> vecs;
+    size_t idle_turns = 0;
+    auto it = streams.upper_bound(last_stream);
+    while (packets < burst_packets && idle_turns < streams.size())
     {
-      for (auto it = strs.begin(); it != strs.end();)
+      if (it == streams.end())
+        it = streams.begin();
+      const StreamID id = it->first;
+      ++idle_turns;
+      if (!it->second)
       {
-        auto& stream = **it;
-        auto bufs = stream.pending();
-        std::vector<ngtcp2_vec> vecs;
-        vecs.reserve(bufs.size());
-        std::transform(bufs.begin(), bufs.end(), std::back_inserter(vecs), [](const auto& buf) {
-          return ngtcp2_vec{const_cast<uint8_t*>(u8data(buf)), buf.size()};
-        });
+        ++it;
+        continue;
+      }
+      auto& stream = *it->second;
+      ++it;
+
+      const bool send_fin = stream.is_closing && !stream.sent_fin;
+      if (stream.unsent() == 0 && !send_fin)
+        continue;
+
+      auto bufs = stream.pending();
+      vecs.clear();
+      std::transform(bufs.begin(), bufs.end(), std::back_inserter(vecs), [](const auto& buf) {
+        return ngtcp2_vec{const_cast<uint8_t*>(u8data(buf)), buf.size()};
+      });
 
 #ifndef NDEBUG
+      {
+        std::string buf_sizes;
+        for (auto& b : bufs)
         {
-          std::string buf_sizes;
-          for (auto& b : bufs)
-          {
-            if (!buf_sizes.empty())
-              buf_sizes += '+';
-            buf_sizes += std::to_string(b.size());
-          }
-          LogDebug("Sending ", buf_sizes.empty() ? "no" : buf_sizes, " data for ", stream.id());
+          if (!buf_sizes.empty())
+            buf_sizes += '+';
+          buf_sizes += std::to_string(b.size());
         }
+        LogDebug("Sending ", buf_sizes.empty() ? "no" : buf_sizes, " data for ", stream.id());
+      }
 #endif
 
-        uint32_t extra_flags = 0;
-        if (stream.is_closing && !stream.sent_fin)
-        {
-          LogDebug("Sending FIN");
-          extra_flags |= NGTCP2_WRITE_STREAM_FLAG_FIN;
-          stream.sent_fin = true;
-        }
-        else if (stream.is_new)
+      uint32_t extra_flags = 0;
+      if (send_fin)
+      {
+        LogDebug("Sending FIN");
+        extra_flags |= NGTCP2_WRITE_STREAM_FLAG_FIN;
+        stream.sent_fin = true;
+      }
+      else if (stream.is_new)
+      {
+        stream.is_new = false;
+      }
+
+      auto [nwrite, consumed] = add_stream_data(id, vecs.data(), vecs.size(), extra_flags);
+      LogTrace("add_stream_data for stream ", id, " returned [", nwrite, ",", consumed, "]");
+
+      if (nwrite > 0)
+      {
+        if (consumed >= 0)
         {
-          stream.is_new = false;
+          LogTrace("consumed ", consumed, " bytes from stream ", id);
+          stream.wrote(consumed);
         }
 
-        auto [nwrite, consumed] =
-            add_stream_data(stream.id(), vecs.data(), vecs.size(), extra_flags);
-        LogTrace(
-            "add_stream_data for stream ", stream.id(), " returned [", nwrite, ",", consumed, "]");
+        LogTrace("Sending stream data packet");
+        last_stream = id;
+        idle_turns = 0;
+        if (!send_packet(nwrite))
+          return;
+        ++packets;
+        // The map may have changed underneath us while sending
+        it = streams.upper_bound(id);
+        continue;
+      }
 
-        if (nwrite > 0)
-        {
-          if (consumed >= 0)
-          {
-            LogTrace("consumed ", consumed, " bytes from stream ", stream.id());
-            stream.wrote(consumed);
-          }
+      if (nwrite == NGTCP2_ERR_WRITE_MORE)
+      {
+        // The stream data went into the packet and there is room left for the next stream's
+        LogTrace("consumed ", consumed, " bytes from stream ", id, " and have space left");
+        stream.wrote(consumed);
+        last_stream = id;
+        idle_turns = 0;
+        continue;
+      }
 
-          LogTrace("Sending stream data packet");
-          if (!send_packet(nwrite))
-            return;
-          ++stream_packets;
-          ++it;
-          continue;
-        }
+      if (nwrite == 0)
+      {
+        // Nothing got written even though we have data: we are congested (or out of connection
+        // flow control), so none of the other streams would get anywhere either.
+        LogTrace("Done stream writing to ", id, " (connection is congested)");
+        assert(consumed <= 0);
+        break;
+      }
 
-        switch (nwrite)
-        {
-          case 0:
-            LogTrace(
-                "Done stream writing to ",
-                stream.id(),
-                " (either stream is congested or we have nothing else to send right now)");
-            assert(consumed <= 0);
-            break;
-          case NGTCP2_ERR_WRITE_MORE:
-            LogTrace(
-                "consumed ", consumed, " bytes from stream ", stream.id(), " and have space left");
-            stream.wrote(consumed);
-            if (stream.unsent() > 0)
-            {
-              // We have more to send on this stream, so keep us in the queue
-              ++it;
-              continue;
-            }
-            break;
-          case NGTCP2_ERR_STREAM_DATA_BLOCKED:
-            LogDebug("cannot add to stream ", stream.id(), " right now: stream is blocked");
-            break;
-          case NGTCP2_ERR_STREAM_SHUT_WR:
-            LogDebug("cannot write to ", stream.id(), ": stream is shut down");
-            break;
-          default:
-            assert(consumed <= 0);
-            LogWarn("Error writing to stream ", stream.id(), ": ", ngtcp2_strerror(nwrite));
-            break;
-        }
-        it = strs.erase(it);
+      switch (nwrite)
+      {
+        case NGTCP2_ERR_STREAM_DATA_BLOCKED:
+          LogDebug("cannot add to stream ", id, " right now: stream is blocked");
+          break;
+        case NGTCP2_ERR_STREAM_SHUT_WR:
+          LogDebug("cannot write to ", id, ": stream is shut down");
+          break;
+        default:
+          assert(consumed <= 0);
+          LogWarn("Error writing to stream ", id, ": ", ngtcp2_strerror(nwrite));
+          break;
       }
     }
 
@@ -733,6 +753,7 @@ namespace llarp::quic
         return;
     }
 
+    ngtcp2_conn_update_pkt_tx_time(*this, ts);
     schedule_retransmit();
   }
 
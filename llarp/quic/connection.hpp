@@ -35,6 +35,13 @@ namespace llarp::quic
   constexpr uint64_t STREAM_BUFFER = 64 * 1024;
   // Max number of simultaneous streams we support over one connection
   constexpr uint64_t STREAM_LIMIT = 32;
+  // Size of the lokinet header in front of every quic packet (see
+  // Endpoint::write_packet_header)
+  constexpr size_t PACKET_HEADER_SIZE = 4;
+  // Largest quic packet we send.  Our packets travel inside lokinet traffic rather than across the
+  // internet, so they are bounded by what a path carries for a tunnelled ip packet (the 1500 byte
+  // net mtu) less our header, not by the ~1200 bytes quic assumes for an unknown udp path.
+  constexpr size_t MAX_PACKET_SIZE = 1500 - PACKET_HEADER_SIZE;
 
   using bstring_view = std::basic_string_view<std::byte>;
 
@@ -127,11 +134,17 @@ namespace llarp::quic
       }
     };
 
-    // Packet data storage for a packet we are currently sending
-    std::array<std::byte, NGTCP2_MAX_UDP_PAYLOAD_SIZE> send_buffer{};
+    // Packet data storage for a packet we are currently sending.  ngtcp2 writes the packet after
+    // PACKET_HEADER_SIZE bytes of headroom which the endpoint fills with the lokinet header, so
+    // the packet goes out without being copied again.
+    std::array<std::byte, PACKET_HEADER_SIZE + MAX_PACKET_SIZE> send_buffer{};
     size_t send_buffer_size = 0;
     ngtcp2_pkt_info send_pkt_info{};
 
+    // The stream that most recently got to send data; the next flush starts with the stream after
+    // it so that streams take turns across flushes rather than the first one always going first.
+    StreamID last_stream{};
+
     // Attempts to send the packet in `send_buffer`.  If sending blocks then we set up a write poll
     // on the socket to wait for it to become available, and return an io_result with `.blocked()`
     // set to true.  On other I/O errors we return the errno, and on successful sending we return a
@@ -247,7 +260,8 @@ namespace llarp::quic
 
     // Flush any streams with pending data. Note that, depending on available ngtcp2 state, we may
     // not fully flush all streams -- some streams can individually block while waiting for
-    // confirmation.
+    // confirmation.  At most one paced burst of packets goes out per call; if there is more to send
+    // the retransmit timer brings us back when ngtcp2 says the next burst may go.
     void
     flush_streams();
 
@@ -176,14 +176,19 @@ namespace llarp::quic
 
   io_result
   Endpoint::send_packet(const Address& to, bstring_view data, uint8_t ecn)
+  {
+    assert(PACKET_HEADER_SIZE + data.size() <= buf_.size());
+    std::memcpy(&buf_[PACKET_HEADER_SIZE], data.data(), data.size());
+    return send_frame(to, buf_.data(), data.size(), ecn);
+  }
+
+  io_result
+  Endpoint::send_frame(const Address& to, std::byte* frame, size_t datalen, uint8_t ecn)
   {
     assert(service_endpoint.Loop()->inEventLoop());
 
-    size_t header_size = write_packet_header(to.port(), ecn);
-    size_t outgoing_len = header_size + data.size();
-    assert(outgoing_len <= buf_.size());
-    std::memcpy(&buf_[header_size], data.data(), data.size());
-    bstring_view outgoing{buf_.data(), outgoing_len};
+    write_packet_header(frame, to.port(), ecn);
+    bstring_view outgoing{frame, PACKET_HEADER_SIZE + datalen};
 
     if (service_endpoint.SendToOrQueue(
             to, llarp_buffer_t{outgoing.data(), outgoing.size()}, service::ProtocolType::QUIC))
@@ -64,8 +64,8 @@ namespace llarp::quic
     // Max theoretical size of a UDP packet is 2^16-1 minus IP/UDP header overhead
     static constexpr size_t max_buf_size = 64 * 1024;
     // Max size of a UDP packet that we'll send
-    static constexpr size_t max_pkt_size_v4 = NGTCP2_MAX_UDP_PAYLOAD_SIZE;
-    static constexpr size_t max_pkt_size_v6 = NGTCP2_MAX_UDP_PAYLOAD_SIZE;
+    static constexpr size_t max_pkt_size_v4 = MAX_PACKET_SIZE;
+    static constexpr size_t max_pkt_size_v6 = MAX_PACKET_SIZE;
 
     using primary_conn_ptr = std::shared_ptr<Connection>;
     using alias_conn_ptr = std::weak_ptr<Connection>;
@@ -147,7 +147,7 @@ namespace llarp::quic
     io_result
     read_packet(const Packet& p, Connection& conn);
 
-    // Writes the lokinet packet header to the beginning of `buf_`; the header is prepend to quic
+    // Writes the lokinet packet header to `dest`; the header is prepend to quic
     // packets to identify which quic server the packet should be delivered to and consists of:
     // - type [1 byte]: 1 for client->server packets; 2 for server->client packets (other values
     // reserved)
@@ -159,12 +159,20 @@ namespace llarp::quic
     // a client remote)
     // \param ecn - the ecn value from ngtcp2
     //
-    // Returns the number of bytes written to buf_.
-    virtual size_t
-    write_packet_header(nuint16_t pseudo_port, uint8_t ecn) = 0;
+    // Always writes PACKET_HEADER_SIZE bytes.
+    virtual void
+    write_packet_header(std::byte* dest, nuint16_t pseudo_port, uint8_t ecn) = 0;
 
-    // Sends a packet to `to` containing `data`. Returns a non-error io_result on success,
-    // an io_result with .error_code set to the errno of the failure on failure.
+    // Sends a quic packet that was written in place after PACKET_HEADER_SIZE bytes of headroom at
+    // `frame`: the lokinet header is filled into the headroom so the packet is handed to lokinet
+    // without being copied.  `datalen` is the size of the quic packet, not counting the headroom.
+    io_result
+    send_frame(const Address& to, std::byte* frame, size_t datalen, uint8_t ecn);
+
+    // Sends a packet to `to` containing `data` by copying it behind a header in `buf_`.  Used for
+    // the few packets (version negotiation, connection close) not written with headroom. Returns
+    // a non-error io_result on success, an io_result with .error_code set to the errno of the
+    // failure on failure.
     io_result
     send_packet(const Address& to, bstring_view data, uint8_t ecn);
 
@@ -60,13 +60,12 @@ namespace llarp::quic
     }
   }
 
-  size_t
-  Server::write_packet_header(nuint16_t pport, uint8_t ecn)
+  void
+  Server::write_packet_header(std::byte* dest, nuint16_t pport, uint8_t ecn)
   {
-    buf_[0] = SERVER_TO_CLIENT;
-    std::memcpy(&buf_[1], &pport.n, 2);  // remote quic pseudo-port (network order u16)
-    buf_[3] = std::byte{ecn};
-    return 4;
+    dest[0] = SERVER_TO_CLIENT;
+    std::memcpy(&dest[1], &pport.n, 2);  // remote quic pseudo-port (network order u16)
+    dest[3] = std::byte{ecn};
   }
 
 }  // namespace llarp::quic
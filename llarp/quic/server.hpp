@@ -28,8 +28,8 @@ namespace llarp::quic
     std::shared_ptr<Connection>
     accept_initial_connection(const Packet& p) override;
 
-    size_t
-    write_packet_header(nuint16_t pport, uint8_t ecn) override;
+    void
+    write_packet_header(std::byte* dest, nuint16_t pport, uint8_t ecn) override;
   };
 
 }  // namespace llarp::quic
@@ -68,8 +68,11 @@ namespace llarp::quic
         return;
 
       // Try first to write immediately from the existing buffer to avoid needing an
-      // allocation and copy:
-      auto written = tcp->tryWrite(const_cast<char*>(data.data()), data.size());
+      // allocation and copy.  If earlier data is still queued in libuv the kernel write would
+      // jump ahead of it (or fail), so in that case go straight to the queue.
+      int written = 0;
+      if (tcp->writeQueueSize() == 0)
+        written = tcp->tryWrite(const_cast<char*>(data.data()), data.size());
       if (written < (int)data.size())
       {
         data.remove_prefix(written);
@@ -638,7 +641,7 @@ namespace llarp::quic
   void
   TunnelManager::receive_packet(const service::ConvoTag& tag, const llarp_buffer_t& buf)
   {
-    if (buf.sz <= 4)
+    if (buf.sz <= PACKET_HEADER_SIZE)
     {
       LogWarn("invalid quic packet: packet size (", buf.sz, ") too small");
       return;
@@ -648,7 +651,9 @@ namespace llarp::quic
     std::memcpy(&pseudo_port_n.n, &buf.base[1], 2);
     uint16_t pseudo_port = ToHost(pseudo_port_n).h;
     auto ecn = static_cast<uint8_t>(buf.base[3]);
-    bstring_view data{reinterpret_cast<const std::byte*>(&buf.base[4]), buf.sz - 4};
+    bstring_view data{
+        reinterpret_cast<const std::byte*>(&buf.base[PACKET_HEADER_SIZE]),
+        buf.sz - PACKET_HEADER_SIZE};
 
     SockAddr remote{tag.ToV6()};
     quic::Endpoint* ep = nullptr;
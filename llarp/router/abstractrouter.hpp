@@ -6,6 +6,7 @@
 #include <llarp/util/types.hpp>
 #include <llarp/util/status.hpp>
 #include "i_outbound_message_handler.hpp"
+#include "i_rc_lookup_handler.hpp"
 #include <vector>
 #include <llarp/ev/ev.hpp>
 #include <functional>
@@ -44,6 +45,7 @@ namespace llarp
   struct ILinkManager;
   struct I_RCLookupHandler;
   struct RoutePoker;
+  struct RouterMetrics;
 
   namespace dns
   {
@@ -317,6 +319,10 @@ namespace llarp
         const std::vector<RouterID>& greylist,
         const std::vector<RouterID>& unfundedlist) = 0;
 
+    /// apply changes to router's service node whitelist, see I_RCLookupHandler
+    virtual void
+    UpdateRouterWhitelist(const std::vector<std::pair<RouterID, RouterListColour>>& changes) = 0;
+
     virtual std::unordered_set<RouterID>
     GetRouterWhitelist() const = 0;
 
@@ -357,6 +363,13 @@ namespace llarp
     virtual util::StatusObject
     ExtractSummaryStatus() const = 0;
 
+    /// counters and gauges for this router's subsystems, safe to use from any thread
+    virtual RouterMetrics&
+    metrics() = 0;
+
+    virtual const RouterMetrics&
+    metrics() const = 0;
+
     /// gossip an rc if required
     virtual void
     GossipRCIfNeeded(const RouterContact rc) = 0;
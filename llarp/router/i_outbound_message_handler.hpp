@@ -26,6 +26,13 @@ namespace llarp
   static const size_t MAX_PATH_QUEUE_SIZE = 100;
   static const size_t MAX_OUTBOUND_QUEUE_SIZE = 1000;
   static const size_t MAX_OUTBOUND_MESSAGES_PER_TICK = 500;
+  /// how many bytes a single peer may be sent from path queues in one pump before other peers
+  /// get their turn
+  static const size_t MAX_OUTBOUND_BYTES_PER_PEER_PER_TICK = 256 * 1024;
+
+  /// queue occupancy at which we tell upper layers to back off
+  static const size_t PATH_QUEUE_CONGESTION_THRESHOLD = (MAX_PATH_QUEUE_SIZE * 3) / 4;
+  static const size_t OUTBOUND_QUEUE_CONGESTION_THRESHOLD = (MAX_OUTBOUND_QUEUE_SIZE * 3) / 4;
 
   struct IOutboundMessageHandler
   {
@@ -40,6 +47,11 @@ namespace llarp
     virtual void
     RemovePath(const PathID_t& pathid) = 0;
 
+    /// return true if messages queued for this path are backing up and upper layers should back
+    /// off
+    virtual bool
+    IsCongested(const PathID_t& pathid) const = 0;
+
     virtual util::StatusObject
     ExtractStatus() const = 0;
   };
@@ -19,6 +19,15 @@ namespace llarp
     BadRC
   };
 
+  /// which of oxend's service node lists a router is on, none when it is on no list
+  enum class RouterListColour
+  {
+    none,
+    white,
+    grey,
+    green
+  };
+
   using RCRequestCallback =
       std::function<void(const RouterID&, const RouterContact* const, const RCRequestResult)>;
 
@@ -38,6 +47,10 @@ namespace llarp
         const std::vector<RouterID>& greylist,
         const std::vector<RouterID>& greenlist) = 0;
 
+    /// move each router onto the list for its colour, leaving every other router where it is
+    virtual void
+    UpdateRouterWhitelist(const std::vector<std::pair<RouterID, RouterListColour>>& changes) = 0;
+
     virtual void
     GetRC(const RouterID& router, RCRequestCallback callback, bool forceLookup = false) = 0;
 
@@ -7,16 +7,18 @@
 #include <llarp/util/status.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 
 namespace llarp
 {
-  const PathID_t OutboundMessageHandler::zeroID;
-
   using namespace std::chrono_literals;
 
   OutboundMessageHandler::OutboundMessageHandler(size_t maxQueueSize)
-      : outboundQueue(maxQueueSize), recentlyRemovedPaths(5s), removedSomePaths(false)
+      : m_SmallBlocks(maxQueueSize)
+      , m_LargeBlocks(maxQueueSize / 8)
+      , outboundQueue(maxQueueSize)
+      , recentlyRemovedPaths(5s), removedSomePaths(false)
   {}
 
   bool
@@ -35,46 +37,34 @@ namespace llarp
     ent.inform = std::move(callback);
     ent.pathid = msg.pathid;
     ent.priority = msg.Priority();
+    ent.queued = std::chrono::steady_clock::now();
 
-    std::array<byte_t, MAX_LINK_MSG_SIZE> linkmsg_buffer;
-    llarp_buffer_t buf{linkmsg_buffer};
+    // we only know which block it fits in once it is encoded
+    thread_local std::array<byte_t, MAX_LINK_MSG_SIZE> scratch;
+    llarp_buffer_t buf{scratch};
 
     if (!EncodeBuffer(msg, buf))
     {
       return false;
     }
 
-    ent.message.resize(buf.sz);
-
-    std::copy_n(buf.base, buf.sz, ent.message.data());
-
-    // if we have a session to the destination, queue the message and return
-    if (_router->linkManager().HasSessionTo(remote))
+    ent.size = buf.sz;
+    byte_t* block;
+    if (ent.size <= SmallMessageSize)
     {
-      QueueOutboundMessage(std::move(ent));
-      return true;
+      ent.small = m_SmallBlocks.Take();
+      block = ent.small->data();
     }
-
-    // if we don't have a session to the destination, queue the message onto
-    // a special pending session queue for that destination, and then create
-    // that pending session if there is not already a session establish attempt
-    // in progress.
-    bool shouldCreateSession = false;
-    {
-      util::Lock l{_mutex};
-
-      // create queue for <remote> if it doesn't exist, and get iterator
-      auto [queue_itr, is_new] = pendingSessionMessageQueues.emplace(remote, MessageQueue());
-      queue_itr->second.push(std::move(ent));
-
-      shouldCreateSession = is_new;
-    }
-
-    if (shouldCreateSession)
+    else
     {
-      QueueSessionCreation(remote);
+      ent.large = m_LargeBlocks.Take();
+      block = ent.large->data();
     }
+    std::copy_n(scratch.data(), ent.size, block);
 
+    // session lookup and pending session bookkeeping happen when the queue is drained on the
+    // event loop thread, so producers never contend on a lock here
+    QueueOutboundMessage(std::move(ent));
     return true;
   }
 
@@ -112,17 +102,42 @@ namespace llarp
     });
   }
 
+  bool
+  OutboundMessageHandler::IsCongested(const PathID_t& pathid) const
+  {
+    if (outboundQueue.size() >= OUTBOUND_QUEUE_CONGESTION_THRESHOLD)
+      return true;
+    auto itr = outboundMessageQueues.find(pathid);
+    return itr != outboundMessageQueues.end()
+        and itr->second.messages.size() >= PATH_QUEUE_CONGESTION_THRESHOLD;
+  }
+
   util::StatusObject
   OutboundMessageHandler::ExtractStatus() const
   {
+    size_t pathQueueDepth = 0;
+    size_t congestedPaths = 0;
+    for (const auto& [pathid, queue] : outboundMessageQueues)
+    {
+      pathQueueDepth += queue.messages.size();
+      if (queue.messages.size() >= PATH_QUEUE_CONGESTION_THRESHOLD)
+        congestedPaths++;
+    }
     util::StatusObject status{
         "queueStats",
         {{"queued", m_queueStats.queued},
-         {"dropped", m_queueStats.dropped},
+         {"dropped", m_queueStats.dropped.load(std::memory_order_relaxed)},
          {"sent", m_queueStats.sent},
          {"queueWatermark", m_queueStats.queueWatermark},
          {"perTickMax", m_queueStats.perTickMax},
-         {"numTicks", m_queueStats.numTicks}}};
+         {"numTicks", m_queueStats.numTicks},
+         {"outboundQueueDepth", outboundQueue.size()},
+         {"controlQueueDepth", controlQueue.size()},
+         {"pathQueues", outboundMessageQueues.size()},
+         {"pathQueueDepth", pathQueueDepth},
+         {"congestedPaths", congestedPaths},
+         {"controlResidency", m_queueStats.controlResidency.ExtractStatus()},
+         {"dataResidency", m_queueStats.dataResidency.ExtractStatus()}}};
 
     return status;
   }
@@ -131,7 +146,6 @@ namespace llarp
   OutboundMessageHandler::Init(AbstractRouter* router)
   {
     _router = router;
-    outboundMessageQueues.emplace(zeroID, MessageQueue());
   }
 
   static inline SendStatus
@@ -193,7 +207,7 @@ namespace llarp
   bool
   OutboundMessageHandler::Send(const MessageQueueEntry& ent)
   {
-    const llarp_buffer_t buf{ent.message};
+    const llarp_buffer_t buf{ent.data(), ent.size};
     m_queueStats.sent++;
     SendStatusHandler callback = ent.inform;
     return _router->linkManager().SendTo(
@@ -210,6 +224,34 @@ namespace llarp
         ent.priority);
   }
 
+  void
+  OutboundMessageHandler::ResidencyStats::Add(std::chrono::microseconds residency)
+  {
+    count++;
+    total += residency;
+    max = std::max(max, residency);
+  }
+
+  util::StatusObject
+  OutboundMessageHandler::ResidencyStats::ExtractStatus() const
+  {
+    return util::StatusObject{
+        {"count", count},
+        {"avgMicroseconds", count ? total.count() / count : 0},
+        {"maxMicroseconds", max.count()}};
+  }
+
+  void
+  OutboundMessageHandler::RecordResidency(
+      const MessageQueueEntry& ent, std::chrono::steady_clock::time_point now)
+  {
+    const auto residency = std::chrono::duration_cast<std::chrono::microseconds>(now - ent.queued);
+    if (ent.pathid.IsZero())
+      m_queueStats.controlResidency.Add(residency);
+    else
+      m_queueStats.dataResidency.Add(residency);
+  }
+
   bool
   OutboundMessageHandler::SendIfSession(const MessageQueueEntry& ent)
   {
@@ -225,53 +267,82 @@ namespace llarp
   {
     // copy callback in case we need to call it, so we can std::move(entry)
     auto callback = entry.inform;
-    if (outboundQueue.tryPushBack(std::move(entry)) != llarp::thread::QueueReturn::Success)
+    if (not outboundQueue.tryPushBack(std::move(entry)))
     {
-      m_queueStats.dropped++;
+      m_queueStats.dropped.fetch_add(1, std::memory_order_relaxed);
       DoCallback(callback, SendStatus::Congestion);
     }
-    else
-    {
-      m_queueStats.queued++;
-      uint32_t queueSize = outboundQueue.size();
-      m_queueStats.queueWatermark = std::max(queueSize, m_queueStats.queueWatermark);
-    }
-
     return true;
   }
 
+  void
+  OutboundMessageHandler::QueuePendingSessionMessage(MessageQueueEntry entry)
+  {
+    const auto router = entry.router;
+    // create queue for the router if it doesn't exist, and start a session establish attempt
+    // if it is new
+    auto [queue_itr, is_new] = pendingSessionMessageQueues.emplace(router, PriorityQueue());
+    entry.sequence = queueSequence++;
+    queue_itr->second.push(std::move(entry));
+    if (is_new)
+      QueueSessionCreation(router);
+  }
+
   void
   OutboundMessageHandler::ProcessOutboundQueue()
   {
-    while (not outboundQueue.empty())
-    {
-      MessageQueueEntry entry = outboundQueue.popFront();
+    const uint32_t queueSize = outboundQueue.size();
+    m_queueStats.queueWatermark = std::max(queueSize, m_queueStats.queueWatermark);
+
+    // drain at most one ring's worth per pump so busy producers cannot keep us here forever
+    const auto drained = outboundQueue.popBatch(
+        [this](MessageQueueEntry entry) {
+          // messages may still be queued for processing when a pathid is removed,
+          // so check here if the pathid was recently removed.
+          if (recentlyRemovedPaths.Contains(entry.pathid))
+            return;
+
+          // keep behind messages already waiting on a session establish so order is kept
+          if (pendingSessionMessageQueues.count(entry.router)
+              or not _router->linkManager().HasSessionTo(entry.router))
+          {
+            QueuePendingSessionMessage(std::move(entry));
+            return;
+          }
 
-      // messages may still be queued for processing when a pathid is removed,
-      // so check here if the pathid was recently removed.
-      if (recentlyRemovedPaths.Contains(entry.pathid))
-      {
-        continue;
-      }
+          QueuePathMessage(std::move(entry));
+        },
+        outboundQueue.capacity());
+    m_queueStats.queued += drained;
+  }
 
-      auto [queue_itr, is_new] = outboundMessageQueues.emplace(entry.pathid, MessageQueue());
+  void
+  OutboundMessageHandler::QueuePathMessage(MessageQueueEntry entry)
+  {
+    if (entry.pathid.IsZero())
+    {
+      entry.sequence = queueSequence++;
+      controlQueue.push(std::move(entry));
+      return;
+    }
 
-      if (is_new && !entry.pathid.IsZero())
-      {
-        roundRobinOrder.push(entry.pathid);
-      }
+    auto [queue_itr, is_new] = outboundMessageQueues.emplace(entry.pathid, PathQueue{});
 
-      MessageQueue& path_queue = queue_itr->second;
+    if (is_new)
+    {
+      roundRobinOrder.push(entry.pathid);
+    }
 
-      if (path_queue.size() < MAX_PATH_QUEUE_SIZE || entry.pathid.IsZero())
-      {
-        path_queue.push(std::move(entry));
-      }
-      else
-      {
-        DoCallback(entry.inform, SendStatus::Congestion);
-        m_queueStats.dropped++;
-      }
+    MessageQueue& path_queue = queue_itr->second.messages;
+
+    if (path_queue.size() < MAX_PATH_QUEUE_SIZE)
+    {
+      path_queue.push_back(std::move(entry));
+    }
+    else
+    {
+      DoCallback(entry.inform, SendStatus::Congestion);
+      m_queueStats.dropped.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
@@ -279,14 +350,15 @@ namespace llarp
   OutboundMessageHandler::SendRoundRobin()
   {
     m_queueStats.numTicks++;
+    const auto now = std::chrono::steady_clock::now();
 
     // send routing messages first priority
-    auto& routing_mq = outboundMessageQueues[zeroID];
-    while (not routing_mq.empty())
+    while (not controlQueue.empty())
     {
-      const MessageQueueEntry& entry = routing_mq.top();
+      const MessageQueueEntry& entry = controlQueue.top();
+      RecordResidency(entry, now);
       Send(entry);
-      routing_mq.pop();
+      controlQueue.pop();
     }
 
     size_t num_queues = roundRobinOrder.size();
@@ -314,51 +386,82 @@ namespace llarp
       return false;
     }
 
-    // send messages for each pathid in roundRobinOrder, stopping when
-    // either every path's queue is empty or a set maximum amount of
-    // messages have been sent.
-    size_t consecutive_empty = 0;
-    for (size_t sent_count = 0; sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK;)
+    // reset peer budgets, forgetting peers we sent nothing to last tick
+    for (auto itr = peerBytesThisTick.begin(); itr != peerBytesThisTick.end();)
     {
-      PathID_t pathid = std::move(roundRobinOrder.front());
-      roundRobinOrder.pop();
-
-      auto& message_queue = outboundMessageQueues[pathid];
-      if (message_queue.size() > 0)
+      if (itr->second == 0)
       {
-        const MessageQueueEntry& entry = message_queue.top();
-
-        Send(entry);
-        message_queue.pop();
-
-        consecutive_empty = 0;
-        consecutive_empty++;
+        itr = peerBytesThisTick.erase(itr);
       }
       else
       {
-        consecutive_empty++;
+        itr->second = 0;
+        ++itr;
       }
+    }
 
+    // deficit round robin over path queues, stopping when every path's queue is empty or over
+    // its peer's byte budget, or a set maximum amount of messages have been sent.
+    // the quantum is the largest message we can send so every visit to a backlogged path sends
+    // at least one message.
+    constexpr size_t quantum = MAX_LINK_MSG_SIZE;
+    size_t sent_count = 0;
+    size_t consecutive_idle = 0;
+    bool backlogged = false;
+    while (sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK and consecutive_idle < num_queues)
+    {
+      PathID_t pathid = std::move(roundRobinOrder.front());
+      roundRobinOrder.pop();
+
+      auto& path_queue = outboundMessageQueues[pathid];
+      auto& message_queue = path_queue.messages;
       roundRobinOrder.push(std::move(pathid));
 
-      // if num_queues empty queues in a row, all queues empty.
-      if (consecutive_empty == num_queues)
+      if (message_queue.empty())
+      {
+        path_queue.deficit = 0;
+        consecutive_idle++;
+        continue;
+      }
+
+      auto& peer_bytes = peerBytesThisTick[message_queue.front().router];
+      if (peer_bytes >= MAX_OUTBOUND_BYTES_PER_PEER_PER_TICK)
       {
-        break;
+        backlogged = true;
+        consecutive_idle++;
+        continue;
+      }
+
+      path_queue.deficit += quantum;
+      while (not message_queue.empty() and sent_count < MAX_OUTBOUND_MESSAGES_PER_TICK
+             and peer_bytes < MAX_OUTBOUND_BYTES_PER_PEER_PER_TICK)
+      {
+        const MessageQueueEntry& entry = message_queue.front();
+        const auto sz = entry.size;
+        if (sz > path_queue.deficit)
+          break;
+        path_queue.deficit -= sz;
+        peer_bytes += sz;
+        RecordResidency(entry, now);
+        Send(entry);
+        message_queue.pop_front();
+        sent_count++;
       }
+      if (message_queue.empty())
+        path_queue.deficit = 0;
+      consecutive_idle = 0;
     }
 
-    m_queueStats.perTickMax = std::max((uint32_t)consecutive_empty, m_queueStats.perTickMax);
+    m_queueStats.perTickMax = std::max((uint32_t)sent_count, m_queueStats.perTickMax);
 
-    return consecutive_empty != num_queues;
+    return backlogged or consecutive_idle != num_queues;
   }
 
   void
   OutboundMessageHandler::FinalizeSessionRequest(const RouterID& router, SendStatus status)
   {
-    MessageQueue movedMessages;
+    PriorityQueue movedMessages;
     {
-      util::Lock l(_mutex);
       auto itr = pendingSessionMessageQueues.find(router);
 
       if (itr == pendingSessionMessageQueues.end())
@@ -371,12 +474,14 @@ namespace llarp
       pendingSessionMessageQueues.erase(itr);
     }
 
+    const auto now = std::chrono::steady_clock::now();
     while (!movedMessages.empty())
     {
       const MessageQueueEntry& entry = movedMessages.top();
 
       if (status == SendStatus::Success)
       {
+        RecordResidency(entry, now);
         Send(entry);
       }
       else
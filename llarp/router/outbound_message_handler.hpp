@@ -2,14 +2,21 @@
 
 #include "i_outbound_message_handler.hpp"
 
+#include <llarp/constants/link_layer.hpp>
 #include <llarp/ev/ev.hpp>
-#include <llarp/util/thread/queue.hpp>
+#include <llarp/util/thread/block_pool.hpp>
+#include <llarp/util/thread/mpsc_ring.hpp>
+#include <llarp/util/thread/threading.hpp>
 #include <llarp/util/decaying_hashset.hpp>
 #include <llarp/path/path_types.hpp>
-#include <llarp/util/priority_queue.hpp>
+#include <llarp/util/ring_queue.hpp>
 #include <llarp/router_id.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <list>
+#include <queue>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 
@@ -27,17 +34,15 @@ namespace llarp
 
     OutboundMessageHandler(size_t maxQueueSize = MAX_OUTBOUND_QUEUE_SIZE);
 
-    /* Called to queue a message to be sent to a router.
+    /* Called from any thread to queue a message to be sent to a router.
      *
-     * If there is no session with the destination router, the message is added to a
-     * pending session queue for that router.  If there is no pending session to that
-     * router, one is created.
+     * The message is encoded and placed on the shared lock-free outbound message queue to be
+     * processed on Pump(); the caller never takes a lock.
      *
-     * If there is a session to the destination router, the message is placed on the shared
-     * outbound message queue to be processed on Pump().
-     *
-     * When this class' Pump() is called, that queue is emptied and the messages there
-     * are placed in their paths' respective individual queues.
+     * When this class' Pump() is called, that queue is drained in batches and each message is
+     * placed in its path's individual queue, or, if there is no session with the destination
+     * router, in a pending session queue for that router.  If there is no pending session to
+     * that router, one is created.
      *
      * Returns false if encoding the message into a buffer fails, true otherwise.
      * A return value of true merely means we successfully processed the queue request,
@@ -45,7 +50,7 @@ namespace llarp
      */
     bool
     QueueMessage(const RouterID& remote, const ILinkMessage& msg, SendStatusHandler callback)
-        override EXCLUDES(_mutex);
+        override;
 
     /* Called when pumping output queues, typically scheduled via a call to Router::TriggerPump().
      *
@@ -67,6 +72,12 @@ namespace llarp
     void
     RemovePath(const PathID_t& pathid) override;
 
+    /* Called from the event loop thread to check whether the shared outbound queue or the
+     * given path's queue are filled past their congestion thresholds.
+     */
+    bool
+    IsCongested(const PathID_t& pathid) const override;
+
     util::StatusObject
     ExtractStatus() const override;
 
@@ -74,36 +85,91 @@ namespace llarp
     Init(AbstractRouter* router);
 
    private:
+    /* Encoded messages are kept in pooled blocks of one of two sizes so the common small
+     * message does not pin a whole MAX_LINK_MSG_SIZE block while it waits in a queue.
+     */
+    static constexpr size_t SmallMessageSize = 1024;
+    using SmallBlocks = thread::BlockPool<SmallMessageSize>;
+    using LargeBlocks = thread::BlockPool<MAX_LINK_MSG_SIZE>;
+
     /* A message that has been queued for sending, but not yet
      * processed into an individual path's message queue.
      */
     struct MessageQueueEntry
     {
       uint16_t priority;
-      std::vector<byte_t> message;
+      // the encoded message is the first size bytes of whichever block is set
+      SmallBlocks::Ptr_t small;
+      LargeBlocks::Ptr_t large;
+      size_t size = 0;
       SendStatusHandler inform;
       PathID_t pathid;
       RouterID router;
+      std::chrono::steady_clock::time_point queued;
+      // order the message was queued in, only set for messages in a PriorityQueue
+      uint64_t sequence = 0;
 
+      const byte_t*
+      data() const
+      {
+        return small ? small->data() : large->data();
+      }
+    };
+
+    /* Control messages, and messages waiting on a session, go out highest priority first and
+     * in the order they were queued within a priority, the same order the link layer resends
+     * in.
+     */
+    struct PriorityOrder
+    {
       bool
-      operator>(const MessageQueueEntry& other) const
+      operator()(const MessageQueueEntry& lhs, const MessageQueueEntry& rhs) const
       {
-        return priority > other.priority;
+        // std::priority_queue pops the greatest, so of two equal priorities the later is less
+        return std::tie(lhs.priority, rhs.sequence) < std::tie(rhs.priority, lhs.sequence);
       }
     };
 
+    /* Time messages spend between being queued and being handed to the link layer. */
+    struct ResidencyStats
+    {
+      uint64_t count = 0;
+      std::chrono::microseconds total{0};
+      std::chrono::microseconds max{0};
+
+      void
+      Add(std::chrono::microseconds residency);
+
+      util::StatusObject
+      ExtractStatus() const;
+    };
+
     struct MessageQueueStats
     {
       uint64_t queued = 0;
-      uint64_t dropped = 0;
+      // also counted by producer threads when the shared queue is full
+      std::atomic<uint64_t> dropped{0};
       uint64_t sent = 0;
       uint32_t queueWatermark = 0;
 
       uint32_t perTickMax = 0;
       uint32_t numTicks = 0;
+
+      ResidencyStats controlResidency;
+      ResidencyStats dataResidency;
     };
 
-    using MessageQueue = util::ascending_priority_queue<MessageQueueEntry>;
+    using MessageQueue = util::RingQueue<MessageQueueEntry>;
+
+    using PriorityQueue =
+        std::priority_queue<MessageQueueEntry, std::vector<MessageQueueEntry>, PriorityOrder>;
+
+    /* A path's fifo of messages plus its deficit for deficit round robin. */
+    struct PathQueue
+    {
+      MessageQueue messages;
+      size_t deficit = 0;
+    };
 
     /* If a session is not yet created with the destination router for a message,
      * a special queue is created for that router and an attempt is made to
@@ -132,6 +198,10 @@ namespace llarp
     bool
     Send(const MessageQueueEntry& ent);
 
+    /* records how long a message waited before Send() in the control or data residency stats */
+    void
+    RecordResidency(const MessageQueueEntry& ent, std::chrono::steady_clock::time_point now);
+
     /* Sends the message along to the link layer if we have a session to the remote
      *
      * returns the result of the Send() call, or false if no session.
@@ -150,21 +220,30 @@ namespace llarp
     bool
     QueueOutboundMessage(MessageQueueEntry entry);
 
-    /* Processes messages on the shared message queue into their paths' respective
-     * individual queues.
+    /* Drains the shared message queue in batches on the event loop thread, processing each
+     * message into its path's individual queue, or its router's pending session queue if we
+     * have no session to that router.
      */
     void
     ProcessOutboundQueue();
 
+    /* Places a message popped from the shared queue into its path's individual queue,
+     * dropping it if that queue is full, or into the control queue if it has no path.
+     */
+    void
+    QueuePathMessage(MessageQueueEntry entry);
+
     /*
      * Sends routing messages that have been queued, indicated by pathid 0 when queued.
+     * These are control messages (LRCM, LRSM, DHT, ...) and have strict priority over path
+     * traffic; among themselves they are sent in PriorityOrder.
      *
-     * Sends messages from path queues until all are empty or a set cap has been reached.
-     * This will send one message from each queue in a round-robin fashion such that they
-     * all have roughly equal access to bandwidth.  A notion of priority may be introduced
-     * at a later time, but for now only routing messages get priority.
+     * Sends messages from path queues until all are empty or a set cap has been reached,
+     * using deficit round robin so each path gets an equal share of bytes regardless of its
+     * message sizes.  Each peer may only be sent MAX_OUTBOUND_BYTES_PER_PEER_PER_TICK bytes
+     * of path traffic per call so one busy peer cannot take the whole tick.
      *
-     * Returns true if there is more to send (i.e. we hit the limit before emptying all path
+     * Returns true if there is more to send (i.e. we hit a limit before emptying all path
      * queues), false if all queues were drained.
      */
     bool
@@ -179,28 +258,44 @@ namespace llarp
      * queued messages and drops them.
      */
     void
-    FinalizeSessionRequest(const RouterID& router, SendStatus status) EXCLUDES(_mutex);
+    FinalizeSessionRequest(const RouterID& router, SendStatus status);
 
-    llarp::thread::Queue<MessageQueueEntry> outboundQueue;
+    /* Places a message popped from the shared queue into the pending session queue for its
+     * router, starting a session establish attempt if there is none in progress.  Once the
+     * session is up they are sent in PriorityOrder.
+     */
+    void
+    QueuePendingSessionMessage(MessageQueueEntry entry);
+
+    // storage for encoded messages, declared first so it outlives every queued message.
+    // few messages are large, so fewer spare large blocks are kept around
+    SmallBlocks m_SmallBlocks;
+    LargeBlocks m_LargeBlocks;
+
+    // written by any thread, drained by the event loop thread only
+    llarp::thread::MPSCRing<MessageQueueEntry> outboundQueue;
     llarp::util::DecayingHashSet<PathID_t> recentlyRemovedPaths;
     bool removedSomePaths;
 
-    mutable util::Mutex _mutex;  // protects pendingSessionMessageQueues
+    // only touched from the event loop thread
+    std::unordered_map<RouterID, PriorityQueue> pendingSessionMessageQueues;
 
-    std::unordered_map<RouterID, MessageQueue> pendingSessionMessageQueues GUARDED_BY(_mutex);
+    // messages with pathid "0", which no path can have, are control messages
+    PriorityQueue controlQueue;
+    // next PriorityQueue sequence number
+    uint64_t queueSequence = 0;
 
-    std::unordered_map<PathID_t, MessageQueue> outboundMessageQueues;
+    std::unordered_map<PathID_t, PathQueue> outboundMessageQueues;
 
     std::queue<PathID_t> roundRobinOrder;
 
+    // bytes of path traffic sent to each peer this tick, kept around to reuse its storage
+    std::unordered_map<RouterID, size_t> peerBytesThisTick;
+
     AbstractRouter* _router;
 
     util::ContentionKiller m_Killer;
 
-    // paths cannot have pathid "0", so it can be used as the "pathid"
-    // for non-traffic (control) messages, so they can be prioritized.
-    static const PathID_t zeroID;
-
     MessageQueueStats m_queueStats;
   };
 
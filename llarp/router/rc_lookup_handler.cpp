@@ -21,15 +21,13 @@ namespace llarp
   void
   RCLookupHandler::AddValidRouter(const RouterID& router)
   {
-    util::Lock l(_mutex);
-    whitelistRouters.insert(router);
+    _routerLists.Update([&router](RouterLists& lists) { lists.white.insert(router); });
   }
 
   void
   RCLookupHandler::RemoveValidRouter(const RouterID& router)
   {
-    util::Lock l(_mutex);
-    whitelistRouters.erase(router);
+    _routerLists.Update([&router](RouterLists& lists) { lists.white.erase(router); });
   }
 
   static void
@@ -47,20 +45,62 @@ namespace llarp
   {
     if (whitelist.empty())
       return;
-    util::Lock l(_mutex);
 
-    loadColourList(whitelistRouters, whitelist);
-    loadColourList(greylistRouters, greylist);
-    loadColourList(greenlistRouters, greenlist);
+    auto lists = std::make_unique<RouterLists>();
+    loadColourList(lists->white, whitelist);
+    loadColourList(lists->grey, greylist);
+    loadColourList(lists->green, greenlist);
+    const auto numActive = lists->white.size();
+
+    _routerLists.Store(std::move(lists));
+
+    LogInfo("lokinet service node list now has ", numActive, " active routers");
+  }
+
+  void
+  RCLookupHandler::UpdateRouterWhitelist(
+      const std::vector<std::pair<RouterID, RouterListColour>>& changes)
+  {
+    if (changes.empty())
+      return;
+
+    size_t numActive = 0;
+    _routerLists.Update([&changes, &numActive](RouterLists& lists) {
+      for (const auto& [router, colour] : changes)
+      {
+        lists.white.erase(router);
+        lists.grey.erase(router);
+        lists.green.erase(router);
+        switch (colour)
+        {
+          case RouterListColour::white:
+            lists.white.insert(router);
+            break;
+          case RouterListColour::grey:
+            lists.grey.insert(router);
+            break;
+          case RouterListColour::green:
+            lists.green.insert(router);
+            break;
+          case RouterListColour::none:
+            break;
+        }
+      }
+      numActive = lists.white.size();
+    });
 
-    LogInfo("lokinet service node list now has ", whitelistRouters.size(), " active routers");
+    LogInfo(
+        "applied ",
+        changes.size(),
+        " service node list changes, now have ",
+        numActive,
+        " active routers");
   }
 
   bool
   RCLookupHandler::HaveReceivedWhitelist() const
   {
-    util::Lock l(_mutex);
-    return not whitelistRouters.empty();
+    return not _routerLists->white.empty();
   }
 
   void
@@ -137,24 +177,20 @@ namespace llarp
     if (not useWhitelist)
       return false;
 
-    util::Lock lock{_mutex};
-
-    return greylistRouters.count(remote);
+    return _routerLists->grey.count(remote);
   }
 
   bool
   RCLookupHandler::IsGreenlisted(const RouterID& remote) const
   {
-    util::Lock lock{_mutex};
-    return greenlistRouters.count(remote);
+    return _routerLists->green.count(remote);
   }
 
   bool
   RCLookupHandler::IsRegistered(const RouterID& remote) const
   {
-    util::Lock lock{_mutex};
-    return whitelistRouters.count(remote) || greylistRouters.count(remote)
-        || greenlistRouters.count(remote);
+    const auto lists = _routerLists.Read();
+    return lists->white.count(remote) || lists->grey.count(remote) || lists->green.count(remote);
   }
 
   bool
@@ -169,9 +205,7 @@ namespace llarp
     if (not useWhitelist)
       return true;
 
-    util::Lock lock{_mutex};
-
-    return whitelistRouters.count(remote);
+    return _routerLists->white.count(remote);
   }
 
   bool
@@ -186,9 +220,8 @@ namespace llarp
     if (not useWhitelist)
       return true;
 
-    util::Lock lock{_mutex};
-
-    return whitelistRouters.count(remote) or greylistRouters.count(remote);
+    const auto lists = _routerLists.Read();
+    return lists->white.count(remote) or lists->grey.count(remote);
   }
 
   bool
@@ -226,10 +259,10 @@ namespace llarp
   bool
   RCLookupHandler::GetRandomWhitelistRouter(RouterID& router) const
   {
-    util::Lock l(_mutex);
-
-    const auto sz = whitelistRouters.size();
-    auto itr = whitelistRouters.begin();
+    const auto lists = _routerLists.Read();
+    const auto& white = lists->white;
+    const auto sz = white.size();
+    auto itr = white.begin();
     if (sz == 0)
       return false;
     if (sz > 1)
@@ -312,8 +345,8 @@ namespace llarp
 
       {
         // if we are using a whitelist look up a few routers we don't have
-        util::Lock l(_mutex);
-        for (const auto& r : whitelistRouters)
+        const auto lists = _routerLists.Read();
+        for (const auto& r : lists->white)
         {
           if (now > _routerLookupTimes[r] + RerequestInterval and not _nodedb->Has(r))
           {
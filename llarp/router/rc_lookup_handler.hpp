@@ -3,6 +3,7 @@
 #include <chrono>
 #include "i_rc_lookup_handler.hpp"
 
+#include <llarp/util/thread/rcu_snapshot.hpp>
 #include <llarp/util/thread/threading.hpp>
 
 #include <unordered_map>
@@ -35,10 +36,10 @@ namespace llarp
     ~RCLookupHandler() override = default;
 
     void
-    AddValidRouter(const RouterID& router) override EXCLUDES(_mutex);
+    AddValidRouter(const RouterID& router) override;
 
     void
-    RemoveValidRouter(const RouterID& router) override EXCLUDES(_mutex);
+    RemoveValidRouter(const RouterID& router) override;
 
     void
     SetRouterWhitelist(
@@ -46,7 +47,11 @@ namespace llarp
         const std::vector<RouterID>& greylist,
         const std::vector<RouterID>& greenlist
 
-        ) override EXCLUDES(_mutex);
+        ) override;
+
+    void
+    UpdateRouterWhitelist(
+        const std::vector<std::pair<RouterID, RouterListColour>>& changes) override;
 
     bool
     HaveReceivedWhitelist() const override;
@@ -56,29 +61,29 @@ namespace llarp
         EXCLUDES(_mutex);
 
     bool
-    PathIsAllowed(const RouterID& remote) const override EXCLUDES(_mutex);
+    PathIsAllowed(const RouterID& remote) const override;
 
     bool
-    SessionIsAllowed(const RouterID& remote) const override EXCLUDES(_mutex);
+    SessionIsAllowed(const RouterID& remote) const override;
 
     bool
-    IsGreylisted(const RouterID& remote) const override EXCLUDES(_mutex);
+    IsGreylisted(const RouterID& remote) const override;
 
     // "greenlist" = new routers (i.e. "green") that aren't fully funded yet
     bool
-    IsGreenlisted(const RouterID& remote) const override EXCLUDES(_mutex);
+    IsGreenlisted(const RouterID& remote) const override;
 
     // registered just means that there is at least an operator stake, but doesn't require the node
     // be fully funded, active, or not decommed.  (In other words: it is any of the white, grey, or
     // green list).
     bool
-    IsRegistered(const RouterID& remote) const override EXCLUDES(_mutex);
+    IsRegistered(const RouterID& remote) const override;
 
     bool
     CheckRC(const RouterContact& rc) const override;
 
     bool
-    GetRandomWhitelistRouter(RouterID& router) const override EXCLUDES(_mutex);
+    GetRandomWhitelistRouter(RouterID& router) const override;
 
     bool
     CheckRenegotiateValid(RouterContact newrc, RouterContact oldrc) override;
@@ -108,8 +113,7 @@ namespace llarp
     std::unordered_set<RouterID>
     Whitelist() const
     {
-      util::Lock lock{_mutex};
-      return whitelistRouters;
+      return _routerLists->white;
     }
 
    private:
@@ -126,7 +130,7 @@ namespace llarp
     FinalizeRequest(const RouterID& router, const RouterContact* const rc, RCRequestResult result)
         EXCLUDES(_mutex);
 
-    mutable util::Mutex _mutex;  // protects pendingCallbacks, whitelistRouters
+    mutable util::Mutex _mutex;  // protects pendingCallbacks
 
     llarp_dht_context* _dht = nullptr;
     std::shared_ptr<NodeDB> _nodedb;
@@ -147,12 +151,20 @@ namespace llarp
     bool useWhitelist = false;
     bool isServiceNode = false;
 
-    // whitelist = active routers
-    std::unordered_set<RouterID> whitelistRouters GUARDED_BY(_mutex);
-    // greylist = fully funded, but decommissioned routers
-    std::unordered_set<RouterID> greylistRouters GUARDED_BY(_mutex);
-    // greenlist = registered but not fully-staked routers
-    std::unordered_set<RouterID> greenlistRouters GUARDED_BY(_mutex);
+    /// the service node lists.
+    /// they are checked for every outbound message from many threads and replaced about once a
+    /// block, so they live in an immutable snapshot that readers look at without locking.
+    struct RouterLists
+    {
+      // whitelist = active routers
+      std::unordered_set<RouterID> white;
+      // greylist = fully funded, but decommissioned routers
+      std::unordered_set<RouterID> grey;
+      // greenlist = registered but not fully-staked routers
+      std::unordered_set<RouterID> green;
+    };
+
+    thread::RCUSnapshot<RouterLists> _routerLists;
 
     using TimePoint = std::chrono::steady_clock::time_point;
     std::unordered_map<RouterID, TimePoint> _routerLookupTimes;
@@ -115,94 +115,27 @@ namespace llarp
     if (!_running)
       return util::StatusObject{{"running", false}};
 
-    auto services = _hiddenServiceContext.ExtractStatus();
-
-    auto link_types = _linkManager.ExtractStatus();
-
-    uint64_t tx_rate = 0;
-    uint64_t rx_rate = 0;
-    uint64_t peers = 0;
-    for (const auto& links : link_types)
-    {
-      for (const auto& link : links)
-      {
-        if (link.empty())
-          continue;
-        for (const auto& peer : link["sessions"]["established"])
-        {
-          tx_rate += peer["tx"].get<uint64_t>();
-          rx_rate += peer["rx"].get<uint64_t>();
-          peers++;
-        }
-      }
-    }
-
-    // Compute all stats on all path builders on the default endpoint
-    // Merge snodeSessions, remoteSessions and default into a single array
-    std::vector<nlohmann::json> builders;
-
-    if (services.is_object())
-    {
-      const auto& serviceDefault = services.at("default");
-      builders.push_back(serviceDefault);
-
-      auto snode_sessions = serviceDefault.at("snodeSessions");
-      for (const auto& session : snode_sessions)
-        builders.push_back(session);
-
-      auto remote_sessions = serviceDefault.at("remoteSessions");
-      for (const auto& session : remote_sessions)
-        builders.push_back(session);
-    }
-
-    // Iterate over all items on this array to build the global pathStats
-    uint64_t pathsCount = 0;
-    uint64_t success = 0;
-    uint64_t attempts = 0;
-    for (const auto& builder : builders)
-    {
-      if (builder.is_null())
-        continue;
-
-      const auto& paths = builder.at("paths");
-      if (paths.is_array())
-      {
-        for (const auto& [key, value] : paths.items())
-        {
-          if (value.is_object() && value.at("status").is_string()
-              && value.at("status") == "established")
-            pathsCount++;
-        }
-      }
-
-      const auto& buildStats = builder.at("buildStats");
-      if (buildStats.is_null())
-        continue;
-
-      success += buildStats.at("success").get<uint64_t>();
-      attempts += buildStats.at("attempts").get<uint64_t>();
-    }
+    // everything here comes from counters and gauges kept up to date as we go, so polling this
+    // does not build the status of every session and path just to add them up
+    const auto success = m_Metrics.pathBuildSuccesses.Value();
+    const auto attempts = m_Metrics.pathBuildAttempts.Value();
     double ratio = static_cast<double>(success) / (attempts + 1);
 
     util::StatusObject stats{
         {"running", true},
         {"version", llarp::VERSION_FULL},
         {"uptime", to_json(Uptime())},
-        {"numPathsBuilt", pathsCount},
-        {"numPeersConnected", peers},
+        {"numPathsBuilt", m_Metrics.pathsEstablished.Value()},
+        {"numPeersConnected",
+         m_Metrics.connectedRouters.Value() + m_Metrics.connectedClients.Value()},
         {"numRoutersKnown", _nodedb->NumLoaded()},
         {"ratio", ratio},
-        {"txRate", tx_rate},
-        {"rxRate", rx_rate},
+        {"txRate", m_Metrics.linkTXRate.Value()},
+        {"rxRate", m_Metrics.linkRXRate.Value()},
     };
 
-    if (services.is_object())
-    {
-      stats["authCodes"] = services["default"]["authCodes"];
-      stats["exitMap"] = services["default"]["exitMap"];
-      stats["networkReady"] = services["default"]["networkReady"];
-      stats["lokiAddress"] = services["default"]["identity"];
-    }
+    if (auto ep = _hiddenServiceContext.GetDefault())
+      stats.update(ep->ExtractSummaryStatus());
     return stats;
   }
 
@@ -939,7 +872,7 @@ namespace llarp
 
     m_PathBuildLimiter.Decay(now);
 
-    routerProfiling().Tick();
+    routerProfiling().Tick(now);
 
     if (ShouldReportStats(now))
     {
@@ -1146,6 +1079,10 @@ namespace llarp
         [&peersWeHave](const dht::Key_t& k) -> bool { return peersWeHave.count(k) == 0; });
     // expire paths
     paths.ExpirePaths(now);
+    // sample gauges
+    m_Metrics.connectedRouters.Set(NumberOfConnectedRouters());
+    m_Metrics.connectedClients.Set(NumberOfConnectedClients());
+    m_Metrics.UpdateRates(now);
     // update tick timestamp
     _lastTick = llarp::time_now_ms();
   }
@@ -1252,6 +1189,12 @@ namespace llarp
     _rcLookupHandler.SetRouterWhitelist(whitelist, greylist, unfundedlist);
   }
 
+  void
+  Router::UpdateRouterWhitelist(const std::vector<std::pair<RouterID, RouterListColour>>& changes)
+  {
+    _rcLookupHandler.UpdateRouterWhitelist(changes);
+  }
+
   bool
   Router::StartRpcServer()
   {
@@ -23,6 +23,7 @@
 #include "rc_gossiper.hpp"
 #include "rc_lookup_handler.hpp"
 #include "route_poker.hpp"
+#include "router_metrics.hpp"
 #include <llarp/routing/handler.hpp>
 #include <llarp/routing/message_parser.hpp>
 #include <llarp/rpc/lokid_rpc_client.hpp>
@@ -115,6 +116,18 @@ namespace llarp
     util::StatusObject
     ExtractSummaryStatus() const override;
 
+    RouterMetrics&
+    metrics() override
+    {
+      return m_Metrics;
+    }
+
+    const RouterMetrics&
+    metrics() const override
+    {
+      return m_Metrics;
+    }
+
     const std::shared_ptr<NodeDB>&
     nodedb() const override
     {
@@ -148,6 +161,10 @@ namespace llarp
         const std::vector<RouterID>& greylist,
         const std::vector<RouterID>& unfunded) override;
 
+    void
+    UpdateRouterWhitelist(
+        const std::vector<std::pair<RouterID, RouterListColour>>& changes) override;
+
     std::unordered_set<RouterID>
     GetRouterWhitelist() const override
     {
@@ -306,6 +323,7 @@ namespace llarp
 
     oxenmq::address lokidRPCAddr;
     Profiling _routerProfiling;
+    RouterMetrics m_Metrics;
     fs::path _profilesFile;
     OutboundMessageHandler _outboundMessageHandler;
     OutboundSessionMaker _outboundSessionMaker;
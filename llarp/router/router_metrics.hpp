@@ -0,0 +1,96 @@
+#pragma once
+
+#include <llarp/util/metrics.hpp>
+#include <llarp/util/time.hpp>
+
+namespace llarp
+{
+  /// the counters and gauges a router keeps for its subsystems.
+  /// counters are bumped inline on the hot path from whatever thread does the work, gauges are
+  /// sampled once per router tick, so reading them never walks sessions or paths.
+  struct RouterMetrics
+  {
+    // link layer
+    metrics::Counter linkTXBytes;
+    metrics::Counter linkRXBytes;
+    metrics::Gauge linkTXRate;
+    metrics::Gauge linkRXRate;
+    metrics::Gauge connectedRouters;
+    metrics::Gauge connectedClients;
+
+    // paths
+    metrics::Counter pathBuildAttempts;
+    metrics::Counter pathBuildSuccesses;
+    metrics::Counter pathBuildFailures;
+    metrics::Counter pathBuildTimeouts;
+    metrics::Gauge pathsEstablished;
+    metrics::Gauge transitPaths;
+
+    // exit traffic
+    metrics::Counter exitTXBytes;
+    metrics::Counter exitRXBytes;
+
+    // dns
+    metrics::Counter dnsQueries;
+    metrics::Counter dnsQueriesHandled;
+
+    // hidden service traffic
+    metrics::Counter serviceMessagesSent;
+    metrics::Counter serviceMessagesReceived;
+
+    metrics::Registry registry;
+
+    RouterMetrics()
+    {
+      registry.Register("link_tx_bytes_total", "bytes sent on link sessions", linkTXBytes);
+      registry.Register("link_rx_bytes_total", "bytes received on link sessions", linkRXBytes);
+      registry.Register("link_tx_rate_bytes", "link bytes sent per second", linkTXRate);
+      registry.Register("link_rx_rate_bytes", "link bytes received per second", linkRXRate);
+      registry.Register("connected_routers", "routers we have a session with", connectedRouters);
+      registry.Register("connected_clients", "clients we have a session with", connectedClients);
+      registry.Register("path_build_attempts_total", "path builds started", pathBuildAttempts);
+      registry.Register("path_build_successes_total", "path builds completed", pathBuildSuccesses);
+      registry.Register("path_build_failures_total", "path builds rejected", pathBuildFailures);
+      registry.Register("path_build_timeouts_total", "path builds timed out", pathBuildTimeouts);
+      registry.Register("paths_established", "paths we own that are established", pathsEstablished);
+      registry.Register("transit_paths", "paths we are a hop on", transitPaths);
+      registry.Register("exit_tx_bytes_total", "bytes sent out of the exit", exitTXBytes);
+      registry.Register("exit_rx_bytes_total", "bytes sent back to exit clients", exitRXBytes);
+      registry.Register("dns_queries_total", "dns queries seen by our endpoints", dnsQueries);
+      registry.Register(
+          "dns_queries_handled_total", "dns queries handled by lokinet", dnsQueriesHandled);
+      registry.Register(
+          "service_messages_sent_total", "hidden service messages sent", serviceMessagesSent);
+      registry.Register(
+          "service_messages_received_total",
+          "hidden service messages received",
+          serviceMessagesReceived);
+    }
+
+    RouterMetrics(const RouterMetrics&) = delete;
+    RouterMetrics&
+    operator=(const RouterMetrics&) = delete;
+
+    /// recompute the link rate gauges from the byte counters, call once per tick
+    void
+    UpdateRates(llarp_time_t now)
+    {
+      const auto tx = linkTXBytes.Value();
+      const auto rx = linkRXBytes.Value();
+      if (m_LastRateUpdate > 0s and now > m_LastRateUpdate)
+      {
+        const auto ms = (now - m_LastRateUpdate).count();
+        linkTXRate.Set(((tx - m_LastTXBytes) * 1000) / ms);
+        linkRXRate.Set(((rx - m_LastRXBytes) * 1000) / ms);
+      }
+      m_LastTXBytes = tx;
+      m_LastRXBytes = rx;
+      m_LastRateUpdate = now;
+    }
+
+   private:
+    uint64_t m_LastTXBytes = 0;
+    uint64_t m_LastRXBytes = 0;
+    llarp_time_t m_LastRateUpdate = 0s;
+  };
+}  // namespace llarp
@@ -10,6 +10,8 @@
 #include "transfer_traffic_message.hpp"
 #include <llarp/util/mem.hpp>
 
+#include <string_view>
+
 namespace llarp
 {
   namespace routing
@@ -106,6 +108,33 @@ namespace llarp
       return msg->DecodeKey(*key, buffer);
     }
 
+    bool
+    InboundMessageParser::DecodeSchemaMessage(llarp_buffer_t* buf)
+    {
+      // every message we encode leads with its type, "d1:A1:<type>"
+      constexpr std::string_view prefix{"d1:A1:"};
+      if (buf->size_left() <= prefix.size()
+          or std::string_view{reinterpret_cast<const char*>(buf->cur), prefix.size()} != prefix)
+        return false;
+      switch (buf->cur[prefix.size()])
+      {
+        case 'L':
+          msg = &m_Holder->L;
+          return bencode::Decode(PathLatencyMessageSchema, m_Holder->L, buf);
+        case 'P':
+          msg = &m_Holder->P;
+          return bencode::Decode(PathConfirmMessageSchema, m_Holder->P, buf);
+        case 'T':
+          msg = &m_Holder->T;
+          return bencode::Decode(PathTransferMessageSchema, m_Holder->T, buf);
+        case 'I':
+          msg = &m_Holder->I;
+          return bencode::Decode(TransferTrafficMessageSchema, m_Holder->I, buf);
+        default:
+          return false;
+      }
+    }
+
     bool
     InboundMessageParser::ParseMessageBuffer(
         const llarp_buffer_t& buf, IMessageHandler* h, const PathID_t& from, AbstractRouter* r)
@@ -115,12 +144,18 @@ namespace llarp
       firstKey = true;
       ManagedBuffer copiedBuf(buf);
       auto& copy = copiedBuf.underlying;
-      uint64_t v = 0;
-      if (BEncodeSeekDictVersion(v, &copy, 'V'))
+      // the schema messages read their own "V", no need to seek it out first
+      bool decoded = DecodeSchemaMessage(&copy);
+      if (not decoded and msg == nullptr)
       {
-        version = v;
+        uint64_t v = 0;
+        if (BEncodeSeekDictVersion(v, &copy, 'V'))
+        {
+          version = v;
+        }
+        decoded = bencode_read_dict(*this, &copy);
       }
-      if (bencode_read_dict(*this, &copy))
+      if (decoded)
       {
         msg->from = from;
         LogDebug("handle routing message ", msg->S, " from ", from);
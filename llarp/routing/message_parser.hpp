@@ -31,6 +31,11 @@ namespace llarp
       operator()(llarp_buffer_t* buffer, llarp_buffer_t* key);
 
      private:
+      /// decode the messages that have a bencode schema in one pass, sets msg when the type
+      /// is one of them, false if it is not or the dict does not decode
+      bool
+      DecodeSchemaMessage(llarp_buffer_t* buf);
+
       uint64_t version = 0;
       bool firstKey{false};
       char ourKey{'\0'};
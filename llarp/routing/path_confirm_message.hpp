@@ -1,6 +1,7 @@
 #pragma once
 
 #include "message.hpp"
+#include <llarp/util/bencode_schema.hpp>
 
 namespace llarp
 {
@@ -32,5 +33,13 @@ namespace llarp
         version = 0;
       }
     };
+
+    inline constexpr auto PathConfirmMessageSchema = bencode::MakeSchema(
+        'P',
+        bencode::Unknown::Reject,
+        bencode::Entry("L", &PathConfirmMessage::pathLifetime),
+        bencode::Entry("S", &PathConfirmMessage::S),
+        bencode::Entry("T", &PathConfirmMessage::pathCreated),
+        bencode::Entry("V", &PathConfirmMessage::version));
   }  // namespace routing
 }  // namespace llarp
@@ -1,7 +1,6 @@
 #include "path_latency_message.hpp"
 
 #include "handler.hpp"
-#include <llarp/util/bencode.hpp>
 
 namespace llarp
 {
@@ -12,36 +11,13 @@ namespace llarp
     bool
     PathLatencyMessage::DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val)
     {
-      bool read = false;
-      if (!BEncodeMaybeReadDictInt("L", L, read, key, val))
-        return false;
-      if (!BEncodeMaybeReadDictInt("S", S, read, key, val))
-        return false;
-      if (!BEncodeMaybeReadDictInt("T", T, read, key, val))
-        return false;
-      return read;
+      return bencode::DecodeKey(PathLatencyMessageSchema, *this, key, val);
     }
 
     bool
     PathLatencyMessage::BEncode(llarp_buffer_t* buf) const
     {
-      if (!bencode_start_dict(buf))
-        return false;
-      if (!BEncodeWriteDictMsgType(buf, "A", "L"))
-        return false;
-      if (L)
-      {
-        if (!BEncodeWriteDictInt("L", L, buf))
-          return false;
-      }
-      if (T)
-      {
-        if (!BEncodeWriteDictInt("T", T, buf))
-          return false;
-      }
-      if (!BEncodeWriteDictInt("S", S, buf))
-        return false;
-      return bencode_end(buf);
+      return bencode::Encode(PathLatencyMessageSchema, *this, buf);
     }
 
     bool
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "message.hpp"
+#include <llarp/util/bencode_schema.hpp>
 
 namespace llarp
 {
@@ -29,5 +30,13 @@ namespace llarp
       bool
       HandleMessage(IMessageHandler* h, AbstractRouter* r) const override;
     };
+
+    /// L and T go ahead of S, out of order, as they always have
+    inline constexpr auto PathLatencyMessageSchema = bencode::MakeSchema(
+        'L',
+        bencode::Unknown::Reject,
+        bencode::OptionalEntry("L", &PathLatencyMessage::L),
+        bencode::OptionalEntry("T", &PathLatencyMessage::T),
+        bencode::Entry("S", &PathLatencyMessage::S));
   }  // namespace routing
 }  // namespace llarp
@@ -3,6 +3,7 @@
 #include <llarp/crypto/encrypted.hpp>
 #include <llarp/crypto/types.hpp>
 #include "message.hpp"
+#include <llarp/util/bencode_schema.hpp>
 #include <llarp/service/protocol.hpp>
 
 namespace llarp
@@ -41,5 +42,14 @@ namespace llarp
       }
     };
 
+    /// we always send our own protocol version, whatever version we were decoded with
+    inline constexpr auto PathTransferMessageSchema = bencode::MakeSchema(
+        'T',
+        bencode::Unknown::Reject,
+        bencode::Entry("P", &PathTransferMessage::P),
+        bencode::Entry("S", &PathTransferMessage::S),
+        bencode::Entry("T", &PathTransferMessage::T),
+        bencode::FixedEntry("V", &PathTransferMessage::version, constants::proto_version),
+        bencode::Entry("Y", &PathTransferMessage::Y));
   }  // namespace routing
 }  // namespace llarp
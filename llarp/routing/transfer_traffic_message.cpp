@@ -1,7 +1,6 @@
 #include "transfer_traffic_message.hpp"
 
 #include "handler.hpp"
-#include <llarp/util/bencode.hpp>
 
 #include <oxenc/endian.h>
 
@@ -27,34 +26,13 @@ namespace llarp
     bool
     TransferTrafficMessage::BEncode(llarp_buffer_t* buf) const
     {
-      if (!bencode_start_dict(buf))
-        return false;
-      if (!BEncodeWriteDictMsgType(buf, "A", "I"))
-        return false;
-      if (!BEncodeWriteDictInt("P", protocol, buf))
-        return false;
-      if (!BEncodeWriteDictInt("S", S, buf))
-        return false;
-      if (!BEncodeWriteDictInt("V", version, buf))
-        return false;
-      if (!BEncodeWriteDictList("X", X, buf))
-        return false;
-      return bencode_end(buf);
+      return bencode::Encode(TransferTrafficMessageSchema, *this, buf);
     }
 
     bool
     TransferTrafficMessage::DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* buf)
     {
-      bool read = false;
-      if (!BEncodeMaybeReadDictInt("S", S, read, key, buf))
-        return false;
-      if (!BEncodeMaybeReadDictInt("P", protocol, read, key, buf))
-        return false;
-      if (!BEncodeMaybeReadDictInt("V", version, read, key, buf))
-        return false;
-      if (!BEncodeMaybeReadDictList("X", X, read, key, buf))
-        return false;
-      return read or bencode_discard(buf);
+      return bencode::DecodeKey(TransferTrafficMessageSchema, *this, key, buf);
     }
 
     bool
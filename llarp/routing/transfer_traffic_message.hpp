@@ -2,6 +2,7 @@
 
 #include <llarp/crypto/encrypted.hpp>
 #include "message.hpp"
+#include <llarp/util/bencode_schema.hpp>
 #include <llarp/service/protocol_type.hpp>
 
 #include <vector>
@@ -47,5 +48,14 @@ namespace llarp
       bool
       HandleMessage(IMessageHandler* h, AbstractRouter* r) const override;
     };
+
+    /// keys we do not know are skipped rather than failing the whole message
+    inline constexpr auto TransferTrafficMessageSchema = bencode::MakeSchema(
+        'I',
+        bencode::Unknown::Skip,
+        bencode::Entry("P", &TransferTrafficMessage::protocol),
+        bencode::Entry("S", &TransferTrafficMessage::S),
+        bencode::Entry("V", &TransferTrafficMessage::version),
+        bencode::Entry("X", &TransferTrafficMessage::X));
   }  // namespace routing
 }  // namespace llarp
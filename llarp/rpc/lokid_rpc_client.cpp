@@ -1,5 +1,6 @@
 #include "lokid_rpc_client.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <llarp/util/logging.hpp>
 
@@ -115,44 +116,66 @@ namespace llarp
       if (m_UpdatingList.exchange(true))
         return;  // update already in progress
 
-      nlohmann::json request{
-          {"fields",
-           {
-               {"pubkey_ed25519", true},
-               {"service_node_pubkey", true},
-               {"funded", true},
-               {"active", true},
-               {"block_hash", true},
-           }},
-      };
-      if (!m_LastUpdateHash.empty())
-        request["poll_block_hash"] = m_LastUpdateHash;
+      std::string request;
+      if (m_BTRequests)
+      {
+        // bt-encoded requests get bt-encoded replies, with keys as raw bytes instead of hex
+        oxenc::bt_dict req{
+            {"fields",
+             oxenc::bt_dict{
+                 {"active", 1},
+                 {"block_hash", 1},
+                 {"funded", 1},
+                 {"pubkey_ed25519", 1},
+                 {"service_node_pubkey", 1},
+             }},
+        };
+        if (!m_LastUpdateHash.empty())
+          req["poll_block_hash"] = m_LastUpdateHash;
+        request = oxenc::bt_serialize(req);
+      }
+      else
+      {
+        nlohmann::json req{
+            {"fields",
+             {
+                 {"pubkey_ed25519", true},
+                 {"service_node_pubkey", true},
+                 {"funded", true},
+                 {"active", true},
+                 {"block_hash", true},
+             }},
+        };
+        if (!m_LastUpdateHash.empty())
+          req["poll_block_hash"] = m_LastUpdateHash;
+        request = req.dump();
+      }
 
       Request(
           "rpc.get_service_nodes",
           [self = shared_from_this()](bool success, std::vector<std::string> data) {
+            // timeouts and other errors are tried again as they are on the next update
             if (not success)
               LogWarn("failed to update service node list");
             else if (data.size() < 2)
               LogWarn("oxend gave empty reply for service node list");
+            else if (self->m_BTRequests and (data[0] == "404" or data[0] == "415"))
+              self->FallBackToJSON("status " + data[0]);
+            else if (data[0] != "200")
+              LogWarn("oxend gave status ", data[0], " for service node list: ", data[1]);
             else
             {
               try
               {
-                auto json = nlohmann::json::parse(std::move(data[1]));
-                if (json.at("status") != "OK")
-                  throw std::runtime_error{"get_service_nodes did not return 'OK' status"};
-                if (auto it = json.find("unchanged");
-                    it != json.end() and it->is_boolean() and it->get<bool>())
-                  LogDebug("service node list unchanged");
+                if (self->m_BTRequests)
+                  self->HandleServiceNodeReplyBT(data[1]);
                 else
-                {
-                  self->HandleNewServiceNodeList(json.at("service_node_states"));
-                  if (auto it = json.find("block_hash"); it != json.end() and it->is_string())
-                    self->m_LastUpdateHash = it->get<std::string>();
-                  else
-                    self->m_LastUpdateHash.clear();
-                }
+                  self->HandleServiceNodeReplyJSON(data[1]);
+              }
+              catch (const oxenc::bt_deserialize_invalid& ex)
+              {
+                // older oxend answers a bt request with json
+                self->FallBackToJSON(ex.what());
               }
               catch (const std::exception& ex)
               {
@@ -164,7 +187,73 @@ namespace llarp
             // with the previous update; and 2) so that m_UpdatingList also guards m_LastUpdateHash
             self->m_UpdatingList = false;
           },
-          request.dump());
+          request);
+    }
+
+    void
+    LokidRpcClient::FallBackToJSON(std::string_view why)
+    {
+      LogInfo(
+          "oxend did not give a bt-encoded service node list (", why, "), falling back to json");
+      m_BTRequests = false;
+      m_LastUpdateHash.clear();
+    }
+
+    void
+    LokidRpcClient::HandleServiceNodeReplyBT(std::string_view reply)
+    {
+      std::optional<std::vector<ServiceNodeState>> states;
+      std::string blockHash;
+      std::string_view status;
+      bool unchanged = false;
+
+      // keys come sorted: block_hash, service_node_states, status, unchanged
+      oxenc::bt_dict_consumer dict{reply};
+      while (not dict.is_finished())
+      {
+        const auto key = dict.key();
+        if (key == "block_hash")
+          blockHash = dict.consume_string();
+        else if (key == "service_node_states")
+          states = ParseServiceNodeStates(dict.consume_list_consumer());
+        else if (key == "status")
+          status = dict.consume_string_view();
+        else if (key == "unchanged")
+          unchanged = dict.consume_integer<int>() != 0;
+        else
+          dict.skip_value();
+      }
+
+      if (status != "OK")
+        throw std::runtime_error{"get_service_nodes did not return 'OK' status"};
+      if (unchanged)
+      {
+        LogDebug("service node list unchanged");
+        return;
+      }
+      if (not states)
+        throw std::runtime_error{"get_service_nodes reply has no service_node_states"};
+      HandleNewServiceNodeList(std::move(*states));
+      m_LastUpdateHash = std::move(blockHash);
+    }
+
+    void
+    LokidRpcClient::HandleServiceNodeReplyJSON(std::string_view reply)
+    {
+      auto json = nlohmann::json::parse(reply);
+      if (json.at("status") != "OK")
+        throw std::runtime_error{"get_service_nodes did not return 'OK' status"};
+      if (auto it = json.find("unchanged");
+          it != json.end() and it->is_boolean() and it->get<bool>())
+      {
+        LogDebug("service node list unchanged");
+        return;
+      }
+      HandleNewServiceNodeList(ParseServiceNodeStates(json.at("service_node_states")));
+      if (auto it = json.find("block_hash"); it != json.end() and it->is_string())
+        m_LastUpdateHash = it->get<std::string>();
+      else
+        m_LastUpdateHash.clear();
     }
 
     void
@@ -221,62 +310,28 @@ namespace llarp
     }
 
     void
-    LokidRpcClient::HandleNewServiceNodeList(const nlohmann::json& j)
+    LokidRpcClient::HandleNewServiceNodeList(std::vector<ServiceNodeState> states)
     {
-      std::unordered_map<RouterID, PubKey> keymap;
-      std::vector<RouterID> activeNodeList, decommNodeList, unfundedNodeList;
-      if (not j.is_array())
-        throw std::runtime_error{
-            "Invalid service node list: expected array of service node states"};
-
-      for (auto& snode : j)
-      {
-        const auto ed_itr = snode.find("pubkey_ed25519");
-        if (ed_itr == snode.end() or not ed_itr->is_string())
-          continue;
-        const auto svc_itr = snode.find("service_node_pubkey");
-        if (svc_itr == snode.end() or not svc_itr->is_string())
-          continue;
-        const auto active_itr = snode.find("active");
-        if (active_itr == snode.end() or not active_itr->is_boolean())
-          continue;
-        const bool active = active_itr->get<bool>();
-        const auto funded_itr = snode.find("funded");
-        if (funded_itr == snode.end() or not funded_itr->is_boolean())
-          continue;
-        const bool funded = funded_itr->get<bool>();
-
-        RouterID rid;
-        PubKey pk;
-        if (not rid.FromHex(ed_itr->get<std::string_view>())
-            or not pk.FromHex(svc_itr->get<std::string_view>()))
-          continue;
-
-        keymap[rid] = pk;
-        (active       ? activeNodeList
-             : funded ? decommNodeList
-                      : unfundedNodeList)
-            .push_back(std::move(rid));
-      }
-
-      if (activeNodeList.empty())
+      if (std::none_of(states.begin(), states.end(), [](const auto& state) {
+            return state.colour == RouterListColour::white;
+          }))
       {
         LogWarn("got empty service node list, ignoring.");
         return;
       }
 
-      // inform router about the new list
+      // inform router about what changed since the last list
       if (auto router = m_Router.lock())
       {
         auto& loop = router->loop();
-        loop->call([this,
-                    active = std::move(activeNodeList),
-                    decomm = std::move(decommNodeList),
-                    unfunded = std::move(unfundedNodeList),
-                    keymap = std::move(keymap),
-                    router = std::move(router)]() mutable {
-          m_KeyMap = std::move(keymap);
-          router->SetRouterWhitelist(active, decomm, unfunded);
+        loop->call([this, states = std::move(states), router = std::move(router)]() {
+          const auto changes = m_ServiceNodes.Update(states);
+          if (changes.empty())
+          {
+            LogDebug("service node list has no changes");
+            return;
+          }
+          router->UpdateRouterWhitelist(changes);
         });
       }
       else
@@ -289,10 +344,10 @@ namespace llarp
       if (auto r = m_Router.lock())
       {
         r->loop()->call([router, success, this]() {
-          if (auto itr = m_KeyMap.find(router); itr != m_KeyMap.end())
+          if (const auto* pubkey = m_ServiceNodes.FindPubKey(router))
           {
             const nlohmann::json request = {
-                {"passed", success}, {"pubkey", itr->second.ToHex()}, {"type", "lokinet"}};
+                {"passed", success}, {"pubkey", pubkey->ToHex()}, {"type", "lokinet"}};
             Request(
                 "admin.report_peer_status",
                 [self = shared_from_this()](bool success, std::vector<std::string>) {
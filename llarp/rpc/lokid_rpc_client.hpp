@@ -1,5 +1,7 @@
 #pragma once
 
+#include "service_node_list.hpp"
+
 #include <llarp/router_id.hpp>
 
 #include <oxenmq/oxenmq.h>
@@ -73,10 +75,23 @@ namespace llarp
         m_lokiMQ->request(*m_Connection, std::move(cmd), std::move(func));
       }
 
-      // Handles a service node list update; takes the "service_node_states" object of an oxend
-      // "get_service_nodes" rpc request.
+      // Asks for json service node lists from the next update on, for oxend that cannot give
+      // bt-encoded ones
+      void
+      FallBackToJSON(std::string_view why);
+
+      // Handles a bt-encoded reply to "get_service_nodes"; throws if it is malformed
+      void
+      HandleServiceNodeReplyBT(std::string_view reply);
+
+      // Handles a json reply to "get_service_nodes"; throws if it is malformed
+      void
+      HandleServiceNodeReplyJSON(std::string_view reply);
+
+      // Handles a service node list update; applies whatever changed since the last one to the
+      // router's whitelist.
       void
-      HandleNewServiceNodeList(const nlohmann::json& json);
+      HandleNewServiceNodeList(std::vector<ServiceNodeState> states);
 
       // Handles request from lokid for peer stats on a specific peer
       void
@@ -92,8 +107,13 @@ namespace llarp
       std::weak_ptr<AbstractRouter> m_Router;
       std::atomic<bool> m_UpdatingList;
       std::string m_LastUpdateHash;
+      // ask oxend for bt-encoded service node lists, cleared if oxend says it has no such thing
+      // (404 or 415) or answers with something that is not bt; guarded by m_UpdatingList like
+      // m_LastUpdateHash
+      bool m_BTRequests = true;
 
-      std::unordered_map<RouterID, PubKey> m_KeyMap;
+      // only touched on the router's loop
+      ServiceNodeList m_ServiceNodes;
 
       uint64_t m_BlockHeight;
     };
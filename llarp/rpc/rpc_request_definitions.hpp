@@ -81,6 +81,26 @@ namespace llarp::rpc
     static constexpr auto name = "get_status"sv;
   };
 
+  //  RPC: metrics
+  //    Returns the router's counters and gauges without building any per object status
+  //
+  //  Inputs:
+  //    "format" : "json" (default) or "prometheus" (string)
+  //
+  //  Returns:
+  //    json: {name: value} for every metric
+  //    prometheus: the metrics in the prometheus text exposition format (string)
+  //
+  struct Metrics : RPCRequest, Immediate
+  {
+    static constexpr auto name = "metrics"sv;
+
+    struct request_parameters
+    {
+      std::string format;
+    } request;
+  };
+
   //  RPC: quic_connect
   //    Initializes QUIC connection tunnel
   //    Passes request parameters in nlohmann::json format
@@ -298,6 +318,7 @@ namespace llarp::rpc
       Version,
       Status,
       GetStatus,
+      Metrics,
       QuicConnect,
       QuicListener,
       LookupSnode,
@@ -11,6 +11,12 @@ namespace llarp::rpc
 {
   using nlohmann::json;
 
+  void
+  parse_request(Metrics& metrics, rpc_input input)
+  {
+    get_values(input, "format", metrics.request.format);
+  }
+
   void
   parse_request(QuicConnect& quicconnect, rpc_input input)
   {
@@ -18,6 +18,7 @@
 #include <llarp/service/auth.hpp>
 #include <llarp/service/name.hpp>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/router/router_metrics.hpp>
 #include <llarp/dns/dns.hpp>
 #include <vector>
 #include <oxenmq/fmt.h>
@@ -177,6 +178,19 @@ namespace llarp::rpc
     SetJSONResponse(m_Router.ExtractSummaryStatus(), getstatus.response);
   }
 
+  void
+  RPCServer::invoke(Metrics& metrics)
+  {
+    // metrics are safe to read from any thread so this does not go through the event loop
+    const auto& registry = m_Router.metrics().registry;
+    if (metrics.request.format.empty() or metrics.request.format == "json")
+      SetJSONResponse(registry.Snapshot(), metrics.response);
+    else if (metrics.request.format == "prometheus")
+      SetJSONResponse(registry.PrometheusText(), metrics.response);
+    else
+      SetJSONError("Unknown metrics format: " + metrics.request.format, metrics.response);
+  }
+
   void
   RPCServer::invoke(QuicConnect& quicconnect)
   {
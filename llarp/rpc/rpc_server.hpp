@@ -99,6 +99,8 @@ namespace llarp::rpc
     void
     invoke(GetStatus& getstatus);
     void
+    invoke(Metrics& metrics);
+    void
     invoke(QuicConnect& quicconnect);
     void
     invoke(QuicListener& quiclistener);
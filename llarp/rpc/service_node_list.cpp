@@ -0,0 +1,143 @@
+#include "service_node_list.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+namespace llarp::rpc
+{
+  /// load a key given either as raw bytes or as hex
+  template <typename Key_t>
+  static bool
+  LoadKey(Key_t& key, std::string_view str)
+  {
+    if (str.size() == Key_t::SIZE)
+    {
+      std::copy_n(reinterpret_cast<const byte_t*>(str.data()), Key_t::SIZE, key.data());
+      return true;
+    }
+    return key.FromHex(str);
+  }
+
+  static RouterListColour
+  ColourFor(bool active, bool funded)
+  {
+    return active ? RouterListColour::white
+        : funded  ? RouterListColour::grey
+                  : RouterListColour::green;
+  }
+
+  std::vector<ServiceNodeState>
+  ParseServiceNodeStates(oxenc::bt_list_consumer states)
+  {
+    std::vector<ServiceNodeState> result;
+    while (not states.is_finished())
+    {
+      if (not states.is_dict())
+      {
+        states.skip_value();
+        continue;
+      }
+      auto snode = states.consume_dict_consumer();
+      ServiceNodeState state{};
+      std::optional<bool> active, funded;
+      bool haveRouter = false, havePubKey = false;
+      // keys come sorted, pick out the ones we want and skip the rest
+      while (not snode.is_finished())
+      {
+        const auto key = snode.key();
+        if (key == "active" and snode.is_integer())
+          active = snode.consume_integer<int>() != 0;
+        else if (key == "funded" and snode.is_integer())
+          funded = snode.consume_integer<int>() != 0;
+        else if (key == "pubkey_ed25519" and snode.is_string())
+          haveRouter = LoadKey(state.router, snode.consume_string_view());
+        else if (key == "service_node_pubkey" and snode.is_string())
+          havePubKey = LoadKey(state.pubkey, snode.consume_string_view());
+        else
+          snode.skip_value();
+      }
+      if (not(active and funded and haveRouter and havePubKey))
+        continue;
+      state.colour = ColourFor(*active, *funded);
+      result.push_back(std::move(state));
+    }
+    return result;
+  }
+
+  std::vector<ServiceNodeState>
+  ParseServiceNodeStates(const nlohmann::json& states)
+  {
+    if (not states.is_array())
+      throw std::runtime_error{"Invalid service node list: expected array of service node states"};
+
+    std::vector<ServiceNodeState> result;
+    result.reserve(states.size());
+    for (const auto& snode : states)
+    {
+      const auto ed_itr = snode.find("pubkey_ed25519");
+      if (ed_itr == snode.end() or not ed_itr->is_string())
+        continue;
+      const auto svc_itr = snode.find("service_node_pubkey");
+      if (svc_itr == snode.end() or not svc_itr->is_string())
+        continue;
+      const auto active_itr = snode.find("active");
+      if (active_itr == snode.end() or not active_itr->is_boolean())
+        continue;
+      const auto funded_itr = snode.find("funded");
+      if (funded_itr == snode.end() or not funded_itr->is_boolean())
+        continue;
+
+      ServiceNodeState state{};
+      if (not state.router.FromHex(ed_itr->get<std::string_view>())
+          or not state.pubkey.FromHex(svc_itr->get<std::string_view>()))
+        continue;
+      state.colour = ColourFor(active_itr->get<bool>(), funded_itr->get<bool>());
+      result.push_back(std::move(state));
+    }
+    return result;
+  }
+
+  ServiceNodeList::Changes_t
+  ServiceNodeList::Update(const std::vector<ServiceNodeState>& states)
+  {
+    Changes_t changes;
+    const auto generation = ++m_Generation;
+    for (const auto& state : states)
+    {
+      auto [itr, inserted] =
+          m_Nodes.try_emplace(state.router, Entry{state.pubkey, state.colour, generation});
+      if (not inserted)
+      {
+        itr->second.pubkey = state.pubkey;
+        itr->second.generation = generation;
+        if (itr->second.colour == state.colour)
+          continue;
+        itr->second.colour = state.colour;
+      }
+      changes.emplace_back(state.router, state.colour);
+    }
+    // anything not marked with this generation is no longer on the list
+    for (auto itr = m_Nodes.begin(); itr != m_Nodes.end();)
+    {
+      if (itr->second.generation == generation)
+      {
+        ++itr;
+        continue;
+      }
+      changes.emplace_back(itr->first, RouterListColour::none);
+      itr = m_Nodes.erase(itr);
+    }
+    return changes;
+  }
+
+  const PubKey*
+  ServiceNodeList::FindPubKey(const RouterID& router) const
+  {
+    if (auto itr = m_Nodes.find(router); itr != m_Nodes.end())
+      return &itr->second.pubkey;
+    return nullptr;
+  }
+}  // namespace llarp::rpc
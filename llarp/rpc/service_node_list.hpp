@@ -0,0 +1,66 @@
+#pragma once
+
+#include <llarp/crypto/types.hpp>
+#include <llarp/router/i_rc_lookup_handler.hpp>
+#include <llarp/router_id.hpp>
+
+#include <nlohmann/json_fwd.hpp>
+#include <oxenc/bt_serialize.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace llarp::rpc
+{
+  /// one service node entry of an oxend get_service_nodes reply
+  struct ServiceNodeState
+  {
+    RouterID router;
+    PubKey pubkey;
+    RouterListColour colour;
+  };
+
+  /// parse the bt-encoded "service_node_states" list of a get_service_nodes reply, keys may be
+  /// raw bytes or hex. malformed entries are skipped, a malformed list throws.
+  std::vector<ServiceNodeState>
+  ParseServiceNodeStates(oxenc::bt_list_consumer states);
+
+  /// parse the json "service_node_states" array of a get_service_nodes reply
+  std::vector<ServiceNodeState>
+  ParseServiceNodeStates(const nlohmann::json& states);
+
+  /// the service node list as of the last update from oxend.
+  /// lets us hand the whitelist only what changed instead of rebuilding it every block.
+  class ServiceNodeList
+  {
+   public:
+    using Changes_t = std::vector<std::pair<RouterID, RouterListColour>>;
+
+    /// replace the list with states, returns every router whose colour changed; routers that
+    /// dropped off the list are returned with RouterListColour::none
+    Changes_t
+    Update(const std::vector<ServiceNodeState>& states);
+
+    /// get the oxend service node pubkey of a router on the list
+    const PubKey*
+    FindPubKey(const RouterID& router) const;
+
+    size_t
+    size() const
+    {
+      return m_Nodes.size();
+    }
+
+   private:
+    struct Entry
+    {
+      PubKey pubkey;
+      RouterListColour colour;
+      uint64_t generation;
+    };
+
+    std::unordered_map<RouterID, Entry> m_Nodes;
+    uint64_t m_Generation = 0;
+  };
+}  // namespace llarp::rpc
@@ -0,0 +1,188 @@
+#include "convo_table.hpp"
+
+#include <algorithm>
+
+namespace llarp::service
+{
+  namespace
+  {
+    /// the time at which session could first be expired
+    llarp_time_t
+    ExpiryTime(const Session& session, llarp_time_t now)
+    {
+      // sessions kept forever are looked at again once a lifetime
+      if (session.forever)
+        return now + SessionLifetime;
+      const auto lastUsed = std::max(session.lastSend, session.lastRecv);
+      return lastUsed == 0s ? session.intro.expiresAt : lastUsed + SessionLifetime;
+    }
+  }  // namespace
+
+  ConvoTable::ConvoTable(llarp_time_t now) : m_Wheel{WheelTick, now}, m_Now{now}
+  {}
+
+  Session*
+  ConvoTable::Find(const ConvoTag& tag)
+  {
+    auto itr = m_Sessions.find(tag);
+    if (itr == m_Sessions.end())
+      return nullptr;
+    return &itr->second.session;
+  }
+
+  const Session*
+  ConvoTable::Find(const ConvoTag& tag) const
+  {
+    auto itr = m_Sessions.find(tag);
+    if (itr == m_Sessions.end())
+      return nullptr;
+    return &itr->second.session;
+  }
+
+  Session&
+  ConvoTable::Insert(const ConvoTag& tag)
+  {
+    auto [itr, inserted] = m_Sessions.try_emplace(tag);
+    // new sessions are checked on the next tick, like a full scan would have
+    if (inserted)
+      Schedule(*itr, 0s);
+    return itr->second.session;
+  }
+
+  Session&
+  ConvoTable::Insert(const ConvoTag& tag, const ServiceInfo& remote, bool inbound)
+  {
+    auto [itr, inserted] = m_Sessions.try_emplace(tag);
+    auto& rec = itr->second;
+    if (not inserted)
+      return rec.session;
+    rec.session.remote = remote;
+    rec.session.inbound = inbound;
+    rec.indexed = true;
+    auto& entry = m_ByAddr[remote.Addr()];
+    entry.tags.push_back(tag);
+    if (inbound)
+      entry.inbound++;
+    Schedule(*itr, 0s);
+    return rec.session;
+  }
+
+  void
+  ConvoTable::Unindex(const ConvoTag& tag, const Record& rec)
+  {
+    if (not rec.indexed)
+      return;
+    auto itr = m_ByAddr.find(rec.session.Addr());
+    if (itr == m_ByAddr.end())
+      return;
+    auto& tags = itr->second.tags;
+    if (auto found = std::find(tags.begin(), tags.end(), tag); found != tags.end())
+    {
+      *found = tags.back();
+      tags.pop_back();
+      if (rec.session.inbound)
+        itr->second.inbound--;
+    }
+    if (tags.empty())
+      m_ByAddr.erase(itr);
+  }
+
+  bool
+  ConvoTable::Erase(const ConvoTag& tag)
+  {
+    auto itr = m_Sessions.find(tag);
+    if (itr == m_Sessions.end())
+      return false;
+    m_Wheel.Cancel(itr->second.timer);
+    Unindex(tag, itr->second);
+    m_Sessions.erase(itr);
+    return true;
+  }
+
+  size_t
+  ConvoTable::EraseAllFor(const Address& addr)
+  {
+    auto itr = m_ByAddr.find(addr);
+    if (itr == m_ByAddr.end())
+      return 0;
+    size_t removed = 0;
+    for (const auto& tag : itr->second.tags)
+    {
+      auto found = m_Sessions.find(tag);
+      if (found == m_Sessions.end())
+        continue;
+      m_Wheel.Cancel(found->second.timer);
+      m_Sessions.erase(found);
+      removed++;
+    }
+    m_ByAddr.erase(itr);
+    return removed;
+  }
+
+  const std::vector<ConvoTag>&
+  ConvoTable::TagsFor(const Address& addr) const
+  {
+    static const std::vector<ConvoTag> none;
+    auto itr = m_ByAddr.find(addr);
+    if (itr == m_ByAddr.end())
+      return none;
+    return itr->second.tags;
+  }
+
+  bool
+  ConvoTable::HasInbound(const Address& addr) const
+  {
+    auto itr = m_ByAddr.find(addr);
+    return itr != m_ByAddr.end() and itr->second.inbound > 0;
+  }
+
+  bool
+  ConvoTable::HasOutbound(const Address& addr) const
+  {
+    auto itr = m_ByAddr.find(addr);
+    return itr != m_ByAddr.end() and itr->second.tags.size() > itr->second.inbound;
+  }
+
+  void
+  ConvoTable::ForEach(const Visit_t& visit) const
+  {
+    for (const auto& [tag, rec] : m_Sessions)
+      visit(tag, rec.session);
+  }
+
+  void
+  ConvoTable::Schedule(Entry& entry, llarp_time_t at)
+  {
+    // the wheel runs anything already due on its next tick
+    entry.second.timer = ++m_NextTimer;
+    m_Wheel.Schedule(entry.second.timer, at, [this, &entry]() { Check(entry); });
+  }
+
+  void
+  ConvoTable::Check(Entry& entry)
+  {
+    auto& [tag, rec] = entry;
+    if (not rec.session.IsExpired(m_Now))
+    {
+      Schedule(entry, ExpiryTime(rec.session, m_Now));
+      return;
+    }
+    // expired may erase sessions itself, this one included
+    const ConvoTag expiredTag = tag;
+    (*m_Expired)(expiredTag, rec.session);
+    if (auto itr = m_Sessions.find(expiredTag); itr != m_Sessions.end())
+    {
+      Unindex(expiredTag, itr->second);
+      m_Sessions.erase(itr);
+    }
+  }
+
+  void
+  ConvoTable::Expire(llarp_time_t now, const Visit_t& expired)
+  {
+    m_Now = now;
+    m_Expired = &expired;
+    m_Wheel.Advance(now);
+    m_Expired = nullptr;
+  }
+}  // namespace llarp::service
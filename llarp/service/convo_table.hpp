@@ -0,0 +1,128 @@
+#pragma once
+
+#include "address.hpp"
+#include "convotag.hpp"
+#include "session.hpp"
+
+#include <llarp/util/time.hpp>
+#include <llarp/util/timer_wheel.hpp>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp::service
+{
+  /// the conversations of an endpoint: one session record per convo tag, an index of the tags
+  /// each remote address has and a timer wheel that finds expired sessions without scanning
+  /// them all.
+  ///
+  /// a session's remote and inbound flag are set when it is first inserted with a sender and
+  /// must not be changed through Find, the address index is built from them.
+  class ConvoTable
+  {
+   public:
+    /// granularity expiry is checked at
+    static constexpr auto WheelTick = 1s;
+
+    using Visit_t = std::function<void(const ConvoTag&, const Session&)>;
+
+    /// now is where the wheel starts turning from
+    explicit ConvoTable(llarp_time_t now = time_now_ms());
+
+    /// the wheel's timers point at us
+    ConvoTable(const ConvoTable&) = delete;
+    ConvoTable&
+    operator=(const ConvoTable&) = delete;
+
+    Session*
+    Find(const ConvoTag& tag);
+
+    const Session*
+    Find(const ConvoTag& tag) const;
+
+    bool
+    Has(const ConvoTag& tag) const
+    {
+      return Find(tag) != nullptr;
+    }
+
+    /// the session for tag, made blank with no sender if there is none
+    Session&
+    Insert(const ConvoTag& tag);
+
+    /// the session for tag, made from remote and inbound if there is none. an existing session
+    /// is returned untouched.
+    Session&
+    Insert(const ConvoTag& tag, const ServiceInfo& remote, bool inbound);
+
+    bool
+    Erase(const ConvoTag& tag);
+
+    /// erase every session with remote addr, returns how many there were
+    size_t
+    EraseAllFor(const Address& addr);
+
+    /// the tags of the sessions with remote addr
+    const std::vector<ConvoTag>&
+    TagsFor(const Address& addr) const;
+
+    bool
+    HasInbound(const Address& addr) const;
+
+    bool
+    HasOutbound(const Address& addr) const;
+
+    /// call visit on every session
+    void
+    ForEach(const Visit_t& visit) const;
+
+    /// erase the sessions that expired by now, calling expired on each first. only touches the
+    /// sessions that came due since the last call.
+    void
+    Expire(llarp_time_t now, const Visit_t& expired);
+
+    size_t
+    Size() const
+    {
+      return m_Sessions.size();
+    }
+
+   private:
+    struct Record
+    {
+      Session session;
+      /// the wheel timer that checks it next
+      util::TimerWheel::ID_t timer = 0;
+      /// made with a sender, so in the address index
+      bool indexed = false;
+    };
+
+    using Entry = std::pair<const ConvoTag, Record>;
+
+    struct AddrEntry
+    {
+      std::vector<ConvoTag> tags;
+      size_t inbound = 0;
+    };
+
+    /// check entry at time at, the map's nodes stay put so the timer can hold on to it
+    void
+    Schedule(Entry& entry, llarp_time_t at);
+
+    /// called from entry's timer, expires it or checks it again later
+    void
+    Check(Entry& entry);
+
+    void
+    Unindex(const ConvoTag& tag, const Record& rec);
+
+    std::unordered_map<ConvoTag, Record> m_Sessions;
+    std::unordered_map<Address, AddrEntry> m_ByAddr;
+    util::TimerWheel m_Wheel;
+    util::TimerWheel::ID_t m_NextTimer = 0;
+    /// what the Expire in progress was called with
+    llarp_time_t m_Now = 0s;
+    const Visit_t* m_Expired = nullptr;
+  };
+}  // namespace llarp::service
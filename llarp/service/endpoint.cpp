@@ -24,6 +24,7 @@
 #include <llarp/profiling.hpp>
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/router/route_poker.hpp>
+#include <llarp/router/router_metrics.hpp>
 #include <llarp/routing/dht_message.hpp>
 #include <llarp/routing/path_transfer_message.hpp>
 
@@ -150,6 +151,9 @@ namespace llarp
         if (quic->hasListeners())
           introSet().supportedProtocols.push_back(ProtocolType::QUIC);
       }
+      // we can unpack batches of any of the above
+      if (not introSet().supportedProtocols.empty())
+        introSet().supportedProtocols.push_back(ProtocolType::TrafficBatch);
 
       introSet().intros.clear();
       for (auto& intro : intros)
@@ -201,11 +205,8 @@ namespace llarp
     std::optional<std::variant<Address, RouterID>>
     Endpoint::GetEndpointWithConvoTag(ConvoTag tag) const
     {
-      auto itr = Sessions().find(tag);
-      if (itr != Sessions().end())
-      {
-        return itr->second.remote.Addr();
-      }
+      if (const auto* session = Sessions().Find(tag))
+        return session->remote.Addr();
 
       for (const auto& item : m_state->m_SNodeSessions)
       {
@@ -383,6 +384,9 @@ namespace llarp
       obj["exitMap"] = m_ExitMap.ExtractStatus();
       obj["identity"] = m_Identity.pub.Addr().ToString();
       obj["networkReady"] = ReadyForNetwork();
+      obj["congested"] = m_Congested;
+      obj["inboundQueueDepth"] = m_InboundTrafficQueue.size();
+      obj["sendQueueDepth"] = m_SendQueue.size();
 
       util::StatusObject authCodes;
       for (const auto& [service, info] : m_RemoteAuthInfos)
@@ -394,6 +398,21 @@ namespace llarp
       return m_state->ExtractStatus(obj);
     }
 
+    util::StatusObject
+    Endpoint::ExtractSummaryStatus() const
+    {
+      util::StatusObject authCodes;
+      for (const auto& [service, info] : m_RemoteAuthInfos)
+      {
+        authCodes[service.ToString()] = info.token;
+      }
+      return util::StatusObject{
+          {"authCodes", authCodes},
+          {"exitMap", m_ExitMap.ExtractStatus()},
+          {"networkReady", ReadyForNetwork()},
+          {"lokiAddress", m_Identity.pub.Addr().ToString()}};
+    }
+
     void
     Endpoint::Tick(llarp_time_t)
     {
@@ -422,6 +441,14 @@ namespace llarp
           now, m_state->m_RemoteSessions, m_state->m_DeadSessions, Sessions());
       // expire convotags
       EndpointUtil::ExpireConvoSessions(now, Sessions());
+      // drop reorder windows for convotags that are gone
+      for (auto itr = m_InboundReorder.begin(); itr != m_InboundReorder.end();)
+      {
+        if (itr->second.HasGap() or HasConvoTag(itr->first))
+          ++itr;
+        else
+          itr = m_InboundReorder.erase(itr);
+      }
 
       if (NumInStatus(path::ePathEstablished) > 1)
       {
@@ -438,7 +465,10 @@ namespace llarp
                   if (auto* addr = std::get_if<service::Address>(&*maybe_addr))
                   {
                     if (maybe_range.has_value())
+                    {
                       m_ExitMap.Insert(*maybe_range, *addr);
+                      m_ExitMapVersion++;
+                    }
                     if (maybe_auth.has_value())
                       SetAuthInfoForEndpoint(*addr, *maybe_auth);
                   }
@@ -513,23 +543,13 @@ namespace llarp
     bool
     Endpoint::HasInboundConvo(const Address& addr) const
     {
-      for (const auto& item : Sessions())
-      {
-        if (item.second.remote.Addr() == addr and item.second.inbound)
-          return true;
-      }
-      return false;
+      return Sessions().HasInbound(addr);
     }
 
     bool
     Endpoint::HasOutboundConvo(const Address& addr) const
     {
-      for (const auto& item : Sessions())
-      {
-        if (item.second.remote.Addr() == addr && not item.second.inbound)
-          return true;
-      }
-      return false;
+      return Sessions().HasOutbound(addr);
     }
 
     void
@@ -540,51 +560,34 @@ namespace llarp
         LogError(Name(), " cannot put invalid service info ", info, " T=", tag);
         return;
       }
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
+      if (Sessions().Has(tag))
+        return;
+      if (WantsOutboundSession(info.Addr()) and inbound)
       {
-        if (WantsOutboundSession(info.Addr()) and inbound)
-        {
-          LogWarn(
-              Name(),
-              " not adding sender for ",
-              info.Addr(),
-              " session is inbound and we want outbound T=",
-              tag);
-          return;
-        }
-        itr = Sessions().emplace(tag, Session{}).first;
-        itr->second.inbound = inbound;
-        itr->second.remote = info;
+        LogWarn(
+            Name(),
+            " not adding sender for ",
+            info.Addr(),
+            " session is inbound and we want outbound T=",
+            tag);
+        return;
       }
+      Sessions().Insert(tag, info, inbound);
     }
 
     size_t
     Endpoint::RemoveAllConvoTagsFor(service::Address remote)
     {
-      size_t removed = 0;
-      auto& sessions = Sessions();
-      auto itr = sessions.begin();
-      while (itr != sessions.end())
-      {
-        if (itr->second.remote.Addr() == remote)
-        {
-          itr = sessions.erase(itr);
-          removed++;
-        }
-        else
-          ++itr;
-      }
-      return removed;
+      return Sessions().EraseAllFor(remote);
     }
 
     bool
     Endpoint::GetSenderFor(const ConvoTag& tag, ServiceInfo& si) const
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
+      const auto* session = Sessions().Find(tag);
+      if (not session)
         return false;
-      si = itr->second.remote;
+      si = session->remote;
       si.UpdateAddr();
       return true;
     }
@@ -592,38 +595,33 @@ namespace llarp
     void
     Endpoint::PutIntroFor(const ConvoTag& tag, const Introduction& intro)
     {
-      auto& s = Sessions()[tag];
-      s.intro = intro;
+      Sessions().Insert(tag).intro = intro;
     }
 
     bool
     Endpoint::GetIntroFor(const ConvoTag& tag, Introduction& intro) const
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
+      const auto* session = Sessions().Find(tag);
+      if (not session)
         return false;
-      intro = itr->second.intro;
+      intro = session->intro;
       return true;
     }
 
     void
     Endpoint::PutReplyIntroFor(const ConvoTag& tag, const Introduction& intro)
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
-      {
-        return;
-      }
-      itr->second.replyIntro = intro;
+      if (auto* session = Sessions().Find(tag))
+        session->replyIntro = intro;
     }
 
     bool
     Endpoint::GetReplyIntroFor(const ConvoTag& tag, Introduction& intro) const
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
+      const auto* session = Sessions().Find(tag);
+      if (not session)
         return false;
-      intro = itr->second.replyIntro;
+      intro = session->replyIntro;
       return true;
     }
 
@@ -636,36 +634,31 @@ namespace llarp
     bool
     Endpoint::GetCachedSessionKeyFor(const ConvoTag& tag, SharedSecret& secret) const
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
+      const auto* session = Sessions().Find(tag);
+      if (not session)
         return false;
-      secret = itr->second.sharedKey;
+      secret = session->sharedKey;
       return true;
     }
 
     void
     Endpoint::PutCachedSessionKeyFor(const ConvoTag& tag, const SharedSecret& k)
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
-      {
-        itr = Sessions().emplace(tag, Session{}).first;
-      }
-      itr->second.sharedKey = k;
+      Sessions().Insert(tag).sharedKey = k;
     }
 
     void
     Endpoint::ConvoTagTX(const ConvoTag& tag)
     {
-      if (Sessions().count(tag))
-        Sessions()[tag].TX();
+      if (auto* session = Sessions().Find(tag))
+        session->TX();
     }
 
     void
     Endpoint::ConvoTagRX(const ConvoTag& tag)
     {
-      if (Sessions().count(tag))
-        Sessions()[tag].RX();
+      if (auto* session = Sessions().Find(tag))
+        session->RX();
     }
 
     bool
@@ -1227,14 +1220,17 @@ namespace llarp
         path::Path_ptr p, const PathID_t from, std::shared_ptr<ProtocolMessage> msg)
     {
       PutSenderFor(msg->tag, msg->sender, true);
-      Introduction intro = msg->introReply;
-      if (HasInboundConvo(msg->sender.Addr()))
+      // one lookup for the rest of what we note about the convo
+      if (auto* session = Sessions().Find(msg->tag))
       {
-        intro.pathID = from;
-        intro.router = p->Endpoint();
+        session->replyIntro = msg->introReply;
+        if (HasInboundConvo(msg->sender.Addr()))
+        {
+          session->replyIntro.pathID = from;
+          session->replyIntro.router = p->Endpoint();
+        }
+        session->RX();
       }
-      PutReplyIntroFor(msg->tag, intro);
-      ConvoTagRX(msg->tag);
       return ProcessDataMessage(msg);
     }
 
@@ -1271,10 +1267,8 @@ namespace llarp
     Endpoint::AllRemoteEndpoints() const
     {
       std::unordered_set<AddressVariant_t> remote;
-      for (const auto& item : Sessions())
-      {
-        remote.insert(item.second.remote.Addr());
-      }
+      Sessions().ForEach(
+          [&remote](const auto&, const auto& session) { remote.insert(session.remote.Addr()); });
       for (const auto& item : m_state->m_SNodeSessions)
       {
         remote.insert(item.first);
@@ -1282,13 +1276,19 @@ namespace llarp
       return remote;
     }
 
+    bool
+    Endpoint::WantsInboundTraffic(ProtocolType t, const ServiceInfo& sender) const
+    {
+      return (t == ProtocolType::Exit
+              && (m_state->m_ExitEnabled || m_ExitMap.ContainsValue(sender.Addr())))
+          || t == ProtocolType::TrafficV4 || t == ProtocolType::TrafficV6
+          || (t == ProtocolType::QUIC and m_quic);
+    }
+
     bool
     Endpoint::ProcessDataMessage(std::shared_ptr<ProtocolMessage> msg)
     {
-      if ((msg->proto == ProtocolType::Exit
-           && (m_state->m_ExitEnabled || m_ExitMap.ContainsValue(msg->sender.Addr())))
-          || msg->proto == ProtocolType::TrafficV4 || msg->proto == ProtocolType::TrafficV6
-          || (msg->proto == ProtocolType::QUIC and m_quic))
+      if (msg->proto == ProtocolType::TrafficBatch or WantsInboundTraffic(msg->proto, msg->sender))
       {
         m_InboundTrafficQueue.tryPushBack(std::move(msg));
         Router()->TriggerPump();
@@ -1379,7 +1379,7 @@ namespace llarp
     void
     Endpoint::RemoveConvoTag(const ConvoTag& t)
     {
-      Sessions().erase(t);
+      Sessions().Erase(t);
     }
 
     void
@@ -1753,41 +1753,40 @@ namespace llarp
       for (const auto& [router, session] : m_state->m_SNodeSessions)
         session->FlushDownstream();
 
-      // handle inbound traffic sorted
-      util::ascending_priority_queue<ProtocolMessage> queue;
-      while (not m_InboundTrafficQueue.empty())
-      {
-        // succ it out
-        queue.emplace(std::move(*m_InboundTrafficQueue.popFront()));
-      }
-      while (not queue.empty())
-      {
-        const auto& msg = queue.top();
-        LogDebug(
-            Name(),
-            " handle inbound packet on ",
-            msg.tag,
-            " ",
-            msg.payload.size(),
-            " bytes seqno=",
-            msg.seqno);
-        if (HandleInboundPacket(msg.tag, msg.payload, msg.proto, msg.seqno))
-        {
-          ConvoTagRX(msg.tag);
-        }
+      // handle inbound traffic in sequence per convo tag, in order traffic is handed off right away
+      const auto handleTraffic = [this](ProtocolMessagePtr msg) { HandleInboundTraffic(*msg); };
+      while (auto maybe = m_InboundTrafficQueue.tryPopFront())
+      {
+        auto msg = std::move(*maybe);
+        const auto tag = msg->tag;
+        const auto seqno = msg->seqno;
+        auto& reorder =
+            m_InboundReorder.try_emplace(tag, InboundReorderWindow, InboundReorderGapTimeout)
+                .first->second;
+        reorder.Put(seqno, std::move(msg), now, handleTraffic);
+        if (reorder.HasGap())
+          m_InboundReorderGaps.emplace(tag);
+      }
+      // skip over gaps that have been open too long
+      for (auto itr = m_InboundReorderGaps.begin(); itr != m_InboundReorderGaps.end();)
+      {
+        auto found = m_InboundReorder.find(*itr);
+        if (found != m_InboundReorder.end())
+          found->second.Expire(now, handleTraffic);
+        if (found == m_InboundReorder.end() or not found->second.HasGap())
+          itr = m_InboundReorderGaps.erase(itr);
         else
-        {
-          LogWarn("Failed to handle inbound message");
-        }
-        queue.pop();
+          ++itr;
       }
 
       auto router = Router();
+      bool congested = m_SendQueue.size() >= (m_SendQueue.capacity() * 3) / 4;
       // TODO: locking on this container
       for (const auto& [addr, outctx] : m_state->m_RemoteSessions)
       {
         outctx->FlushUpstream();
         outctx->Pump(now);
+        congested = congested or outctx->IsCongested();
       }
       // TODO: locking on this container
       for (const auto& [router, session] : m_state->m_SNodeSessions)
@@ -1802,9 +1801,63 @@ namespace llarp
           ConvoTagTX(item.first->T.T);
       }
 
+      // check our own paths for inbound convos and snode traffic
+      if (not congested)
+      {
+        ForEachPath([&congested, router](const auto& path) {
+          congested = congested or (path->IsReady() and path->IsCongested(router));
+        });
+      }
+      if (congested != m_Congested)
+        LogDebug(Name(), (congested ? " outbound traffic is congested" : " congestion cleared"));
+      m_Congested = congested;
+
       UpstreamFlush(router);
     }
 
+    void
+    Endpoint::HandleInboundTraffic(ProtocolMessage& msg)
+    {
+      Router()->metrics().serviceMessagesReceived.Add();
+      LogDebug(
+          Name(),
+          " handle inbound packet on ",
+          msg.tag,
+          " ",
+          msg.payload.size(),
+          " bytes seqno=",
+          msg.seqno);
+      if (msg.proto != ProtocolType::TrafficBatch)
+      {
+        if (HandleInboundPacket(msg.tag, msg.payload, msg.proto, msg.seqno))
+        {
+          ConvoTagRX(msg.tag);
+        }
+        else
+        {
+          LogWarn("Failed to handle inbound message");
+        }
+        return;
+      }
+      bool handled = false;
+      const bool valid = ProtocolMessage::ForEachInBatch(
+          llarp_buffer_t{msg.payload}, [&](ProtocolType t, const llarp_buffer_t& pkt) {
+            if (not WantsInboundTraffic(t, msg.sender))
+            {
+              LogWarn(Name(), " dropping batched ", t, " packet we do not want on ", msg.tag);
+              return;
+            }
+            if (HandleInboundPacket(msg.tag, pkt, t, msg.seqno))
+              handled = true;
+            else
+              LogWarn("Failed to handle batched inbound message");
+          });
+      if (not valid)
+        LogWarn(Name(), " got malformed traffic batch on ", msg.tag);
+      if (handled)
+        ConvoTagRX(msg.tag);
+    }
+
     std::optional<ConvoTag>
     Endpoint::GetBestConvoTagFor(std::variant<Address, RouterID> remote) const
     {
@@ -1813,53 +1866,52 @@ namespace llarp
       {
         llarp_time_t rtt = 30s;
         std::optional<ConvoTag> ret = std::nullopt;
-        for (const auto& [tag, session] : Sessions())
+        // only the convos with this remote, from the address index
+        for (const auto& tag : Sessions().TagsFor(*ptr))
         {
           if (tag.IsZero())
             continue;
-          if (session.remote.Addr() == *ptr)
+          const auto& session = *Sessions().Find(tag);
+          if (*ptr == m_Identity.pub.Addr())
           {
-            if (*ptr == m_Identity.pub.Addr())
+            return tag;
+          }
+          if (session.inbound)
+          {
+            auto path = GetPathByRouter(session.replyIntro.router);
+            // if we have no path to the remote router that's fine still use it just in case this
+            // is the ONLY one we have
+            if (path == nullptr)
             {
-              return tag;
+              ret = tag;
+              continue;
             }
-            if (session.inbound)
+
+            if (path and path->IsReady())
             {
-              auto path = GetPathByRouter(session.replyIntro.router);
-              // if we have no path to the remote router that's fine still use it just in case this
-              // is the ONLY one we have
-              if (path == nullptr)
+              const auto rttEstimate = (session.replyIntro.latency + path->intro.latency) * 2;
+              if (rttEstimate < rtt)
               {
                 ret = tag;
-                continue;
-              }
-
-              if (path and path->IsReady())
-              {
-                const auto rttEstimate = (session.replyIntro.latency + path->intro.latency) * 2;
-                if (rttEstimate < rtt)
-                {
-                  ret = tag;
-                  rtt = rttEstimate;
-                }
+                rtt = rttEstimate;
               }
             }
-            else
+          }
+          else
+          {
+            auto range = m_state->m_RemoteSessions.equal_range(*ptr);
+            auto itr = range.first;
+            while (itr != range.second)
             {
-              auto range = m_state->m_RemoteSessions.equal_range(*ptr);
-              auto itr = range.first;
-              while (itr != range.second)
+              if (itr->second->ReadyToSend() and itr->second->estimatedRTT > 0s)
               {
-                if (itr->second->ReadyToSend() and itr->second->estimatedRTT > 0s)
+                if (itr->second->estimatedRTT < rtt)
                 {
-                  if (itr->second->estimatedRTT < rtt)
-                  {
-                    ret = tag;
-                    rtt = itr->second->estimatedRTT;
-                  }
+                  ret = tag;
+                  rtt = itr->second->estimatedRTT;
                 }
-                itr++;
               }
+              itr++;
             }
           }
         }
@@ -1894,7 +1946,7 @@ namespace llarp
             tag.Randomize();
           PutSenderFor(tag, m_Identity.pub, true);
           ConvoTagTX(tag);
-          Sessions()[tag].forever = true;
+          Sessions().Insert(tag).forever = true;
           Loop()->call_soon([tag, hook]() { hook(tag); });
           return true;
         }
@@ -2083,16 +2135,16 @@ namespace llarp
     bool
     Endpoint::HasConvoTag(const ConvoTag& t) const
     {
-      return Sessions().find(t) != Sessions().end();
+      return Sessions().Has(t);
     }
 
     std::optional<uint64_t>
     Endpoint::GetSeqNoForConvo(const ConvoTag& tag)
     {
-      auto itr = Sessions().find(tag);
-      if (itr == Sessions().end())
+      auto* session = Sessions().Find(tag);
+      if (not session)
         return std::nullopt;
-      return itr->second.seqno++;
+      return session->seqno++;
     }
 
     bool
@@ -2143,13 +2195,13 @@ namespace llarp
       return m_state->m_IntroSet;
     }
 
-    const ConvoMap&
+    const ConvoTable&
     Endpoint::Sessions() const
     {
       return m_state->m_Sessions;
     }
 
-    ConvoMap&
+    ConvoTable&
     Endpoint::Sessions()
     {
       return m_state->m_Sessions;
@@ -2172,6 +2224,7 @@ namespace llarp
       if (not exit.IsZero())
         LogInfo(Name(), " map ", range, " to exit at ", exit);
       m_ExitMap.Insert(range, exit);
+      m_ExitMapVersion++;
     }
     bool
     Endpoint::HasFlowToService(Address addr) const
@@ -2189,6 +2242,7 @@ namespace llarp
         LogInfo(Name(), " unmap ", item.first, " exit range mapping");
         return true;
       });
+      m_ExitMapVersion++;
 
       if (m_ExitMap.Empty())
         m_router->routePoker()->Down();
@@ -2206,6 +2260,7 @@ namespace llarp
         }
         return false;
       });
+      m_ExitMapVersion++;
 
       if (m_ExitMap.Empty())
         m_router->routePoker()->Down();
@@ -7,6 +7,7 @@
 #include <llarp/path/path.hpp>
 #include <llarp/path/pathbuilder.hpp>
 #include <llarp/util/compare_ptr.hpp>
+#include <llarp/util/reorder_buffer.hpp>
 
 // --- begin kitchen sink headers ----
 #include <llarp/service/address.hpp>
@@ -21,6 +22,7 @@
 #include <llarp/service/endpoint_types.hpp>
 #include <llarp/endpoint_base.hpp>
 #include <llarp/service/auth.hpp>
+#include <llarp/service/convo_table.hpp>
 // ----- end kitchen sink headers -----
 
 #include <optional>
@@ -62,6 +64,12 @@ namespace llarp
     /// number of unique snodes we want to talk to do to ons lookups
     inline constexpr size_t MIN_ENDPOINTS_FOR_LNS_LOOKUP = 2;
 
+    /// how many out of order inbound messages we hold back per convo tag
+    inline constexpr size_t InboundReorderWindow = 64;
+
+    /// how long we wait for a gap in a convo tag's inbound sequence to fill before skipping it
+    inline constexpr auto InboundReorderGapTimeout = 50ms;
+
     struct Endpoint : public path::Builder,
                       public ILookupHolder,
                       public IDataHandler,
@@ -90,6 +98,11 @@ namespace llarp
       virtual util::StatusObject
       ExtractStatus() const;
 
+      /// the few fields of our status that the router summary wants, without walking our paths
+      /// and sessions
+      util::StatusObject
+      ExtractSummaryStatus() const;
+
       void
       SetHandler(IDataHandler* h);
 
@@ -268,6 +281,13 @@ namespace llarp
       virtual void
       Pump(llarp_time_t now);
 
+      /// return true if our outbound traffic was backing up as of the last pump
+      bool
+      IsCongested() const
+      {
+        return m_Congested;
+      }
+
       /// stop this endpoint
       bool
       Stop() override;
@@ -552,6 +572,8 @@ namespace llarp
       IDataHandler* m_DataHandler = nullptr;
       Identity m_Identity;
       net::IPRangeMap<service::Address> m_ExitMap;
+      /// bumped whenever m_ExitMap changes so anything derived from it knows to start over
+      uint64_t m_ExitMapVersion = 0;
       bool m_PublishIntroSet = true;
       std::unique_ptr<EndpointState> m_state;
       std::shared_ptr<IAuthPolicy> m_AuthPolicy;
@@ -564,6 +586,14 @@ namespace llarp
 
       RecvPacketQueue_t m_InboundTrafficQueue;
 
+      /// per convo tag reorder windows for inbound traffic
+      std::unordered_map<ConvoTag, util::ReorderBuffer<ProtocolMessagePtr>> m_InboundReorder;
+      /// convo tags that have out of order inbound traffic held back
+      std::unordered_set<ConvoTag> m_InboundReorderGaps;
+
+      /// set on pump when any of our send queues or paths are backing up
+      bool m_Congested = false;
+
      public:
       SendMessageQueue_t m_SendQueue;
 
@@ -574,15 +604,22 @@ namespace llarp
       void
       FlushRecvData();
 
+      /// hand off an inbound message that is in sequence for its convo tag
+      void
+      HandleInboundTraffic(ProtocolMessage& msg);
+
+      /// return true if we accept inbound traffic of protocol type t from sender
+      bool
+      WantsInboundTraffic(ProtocolType t, const ServiceInfo& sender) const;
+
       friend struct EndpointUtil;
 
       // clang-format off
       const IntroSet& introSet() const;
       IntroSet&       introSet();
 
-      using ConvoMap = std::unordered_map<ConvoTag, Session>;
-      const ConvoMap& Sessions() const;
-      ConvoMap&       Sessions();
+      const ConvoTable& Sessions() const;
+      ConvoTable&       Sessions();
       // clang-format on
       thread::Queue<RecvDataEvent> m_RecvQueue;
 
@@ -59,11 +59,9 @@ namespace llarp
 
       util::StatusObject sessionObj{};
 
-      for (const auto& item : m_Sessions)
-      {
-        std::string k = item.first.ToHex();
-        sessionObj[k] = item.second.ExtractStatus();
-      }
+      m_Sessions.ForEach([&sessionObj](const auto& tag, const auto& session) {
+        sessionObj[tag.ToHex()] = session.ExtractStatus();
+      });
 
       obj["converstations"] = sessionObj;
       return obj;
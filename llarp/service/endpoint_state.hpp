@@ -5,6 +5,7 @@
 #include "pendingbuffer.hpp"
 #include "router_lookup_job.hpp"
 #include "session.hpp"
+#include "convo_table.hpp"
 #include "endpoint_types.hpp"
 #include <llarp/util/compare_ptr.hpp>
 #include <llarp/util/decaying_hashtable.hpp>
@@ -37,8 +38,6 @@ namespace llarp
       Sessions m_RemoteSessions;
       Sessions m_DeadSessions;
 
-      std::set<ConvoTag> m_InboundConvos;
-
       SNodeSessions m_SNodeSessions;
 
       std::unordered_multimap<Address, PathEnsureHook> m_PendingServiceLookups;
@@ -58,7 +57,7 @@ namespace llarp
       std::list<std::function<bool(void)>> m_OnInit;
 
       /// conversations
-      ConvoMap m_Sessions;
+      ConvoTable m_Sessions;
 
       OutboundSessions_t m_OutboundSessions;
 
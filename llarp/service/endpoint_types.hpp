@@ -43,8 +43,6 @@ namespace llarp
 
     using SNodeSessions = std::unordered_map<RouterID, std::shared_ptr<exit::BaseSession>>;
 
-    using ConvoMap = std::unordered_map<ConvoTag, Session>;
-
     /// set of outbound addresses to maintain to
     using OutboundSessions_t = std::unordered_set<Address>;
 
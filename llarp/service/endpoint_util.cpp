@@ -91,7 +91,7 @@ namespace llarp
 
     void
     EndpointUtil::TickRemoteSessions(
-        llarp_time_t now, Sessions& remoteSessions, Sessions& deadSessions, ConvoMap& sessions)
+        llarp_time_t now, Sessions& remoteSessions, Sessions& deadSessions, ConvoTable& sessions)
     {
       auto itr = remoteSessions.begin();
       while (itr != remoteSessions.end())
@@ -105,7 +105,7 @@ namespace llarp
               " to ",
               itr->second->Addr());
           itr->second->Stop();
-          sessions.erase(itr->second->currentConvoTag);
+          sessions.Erase(itr->second->currentConvoTag);
           deadSessions.emplace(std::move(*itr));
           itr = remoteSessions.erase(itr);
         }
@@ -121,19 +121,11 @@ namespace llarp
     }
 
     void
-    EndpointUtil::ExpireConvoSessions(llarp_time_t now, ConvoMap& sessions)
+    EndpointUtil::ExpireConvoSessions(llarp_time_t now, ConvoTable& sessions)
     {
-      auto itr = sessions.begin();
-      while (itr != sessions.end())
-      {
-        if (itr->second.IsExpired(now))
-        {
-          LogInfo("Expire session T=", itr->first, " to ", itr->second.Addr());
-          itr = sessions.erase(itr);
-        }
-        else
-          ++itr;
-      }
+      sessions.Expire(now, [](const auto& tag, const auto& session) {
+        LogInfo("Expire session T=", tag, " to ", session.Addr());
+      });
     }
 
     void
@@ -170,20 +162,13 @@ namespace llarp
 
     bool
     EndpointUtil::GetConvoTagsForService(
-        const ConvoMap& sessions, const Address& info, std::set<ConvoTag>& tags)
+        const ConvoTable& sessions, const Address& info, std::set<ConvoTag>& tags)
     {
       bool inserted = false;
-      auto itr = sessions.begin();
-      while (itr != sessions.end())
+      for (const auto& tag : sessions.TagsFor(info))
       {
-        if (itr->second.remote.Addr() == info)
-        {
-          if (tags.emplace(itr->first).second)
-          {
-            inserted = true;
-          }
-        }
-        ++itr;
+        if (tags.emplace(tag).second)
+          inserted = true;
       }
       return inserted;
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "convo_table.hpp"
 #include "endpoint_types.hpp"
 
 namespace llarp
@@ -22,10 +23,10 @@ namespace llarp
 
       static void
       TickRemoteSessions(
-          llarp_time_t now, Sessions& remoteSessions, Sessions& deadSessions, ConvoMap& sessions);
+          llarp_time_t now, Sessions& remoteSessions, Sessions& deadSessions, ConvoTable& sessions);
 
       static void
-      ExpireConvoSessions(llarp_time_t now, ConvoMap& sessions);
+      ExpireConvoSessions(llarp_time_t now, ConvoTable& sessions);
 
       static void
       StopRemoteSessions(Sessions& remoteSessions);
@@ -38,7 +39,7 @@ namespace llarp
 
       static bool
       GetConvoTagsForService(
-          const ConvoMap& sessions, const Address& addr, std::set<ConvoTag>& tags);
+          const ConvoTable& sessions, const Address& addr, std::set<ConvoTag>& tags);
     };
 
     template <typename Endpoint_t>
@@ -81,7 +81,15 @@ namespace llarp
       connectTimeout += parent->PathAlignmentTimeout();
     }
 
-    OutboundContext::~OutboundContext() = default;
+    OutboundContext::~OutboundContext()
+    {
+      // it would run on a dangling this
+      if (m_ReadyHooksTimeout)
+      {
+        if (const auto& loop = m_router->loop())
+          loop->cancel_later(m_ReadyHooksTimeout);
+      }
+    }
 
     /// actually swap intros
     void
@@ -327,6 +335,8 @@ namespace llarp
       obj["currentRemoteIntroset"] = currentIntroSet.ExtractStatus();
       obj["nextIntro"] = m_NextIntro.ExtractStatus();
       obj["readyToSend"] = ReadyToSend();
+      obj["sendQueueDepth"] = m_SendQueue.size();
+      obj["congested"] = IsCongested();
       return obj;
     }
 
@@ -410,6 +420,8 @@ namespace llarp
         for (const auto& hook : m_ReadyHooks)
           hook(this);
         m_ReadyHooks.clear();
+        m_router->loop()->cancel_later(m_ReadyHooksTimeout);
+        m_ReadyHooksTimeout = 0;
       }
 
       const auto timeout = std::max(lastGoodSend, m_LastInboundTraffic);
@@ -451,7 +463,8 @@ namespace llarp
       }
       if (m_ReadyHooks.empty())
       {
-        m_router->loop()->call_later(timeout, [this]() {
+        m_ReadyHooksTimeout = m_router->loop()->call_later(timeout, [this]() {
+          m_ReadyHooksTimeout = 0;
           LogWarn(Name(), " did not obtain session in time");
           for (const auto& hook : m_ReadyHooks)
             hook(nullptr);
@@ -513,6 +526,13 @@ namespace llarp
       return sentIntro;
     }
 
+    bool
+    OutboundContext::RemoteSupportsBatching() const
+    {
+      const auto& protos = currentIntroSet.supportedProtocols;
+      return std::find(protos.begin(), protos.end(), ProtocolType::TrafficBatch) != protos.end();
+    }
+
     bool
     OutboundContext::IntroGenerated() const
     {
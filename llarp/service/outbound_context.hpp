@@ -161,6 +161,8 @@ namespace llarp
       IntroGenerated() const override;
       bool
       IntroSent() const override;
+      bool
+      RemoteSupportsBatching() const override;
 
       const dht::Key_t location;
       const Address addr;
@@ -175,6 +177,8 @@ namespace llarp
       bool generatedIntro = false;
       bool sentIntro = false;
       std::vector<std::function<void(OutboundContext*)>> m_ReadyHooks;
+      /// fails the ready hooks when we take too long, cancelled once they are called
+      EventLoop::TimerID m_ReadyHooksTimeout = 0;
       llarp_time_t m_LastIntrosetUpdateAt = 0s;
       llarp_time_t m_LastKeepAliveAt = 0s;
     };
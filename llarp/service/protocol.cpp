@@ -29,6 +29,43 @@ namespace llarp
       memcpy(payload.data(), buf.base, buf.sz);
     }
 
+    bool
+    ProtocolMessage::AppendToBatch(
+        std::vector<byte_t>& batch, ProtocolType t, const llarp_buffer_t& pkt)
+    {
+      // each entry is a 1 byte protocol type then a 2 byte big endian length then the packet
+      constexpr size_t header_size = 3;
+      if (pkt.sz > MAX_BATCHED_PACKET_SIZE or t == ProtocolType::TrafficBatch
+          or batch.size() + header_size + pkt.sz > MAX_TRAFFIC_BATCH_SIZE)
+        return false;
+      batch.push_back(static_cast<byte_t>(t));
+      batch.push_back(static_cast<byte_t>(pkt.sz >> 8));
+      batch.push_back(static_cast<byte_t>(pkt.sz));
+      batch.insert(batch.end(), pkt.base, pkt.base + pkt.sz);
+      return true;
+    }
+
+    bool
+    ProtocolMessage::ForEachInBatch(
+        const llarp_buffer_t& batch, std::function<void(ProtocolType, const llarp_buffer_t&)> visit)
+    {
+      llarp_buffer_t buf{batch.base, batch.base, batch.sz};
+      while (buf.size_left())
+      {
+        byte_t proto;
+        uint16_t sz;
+        if (not buf.read_into(&proto, &proto + 1) or not buf.read_uint16(sz)
+            or buf.size_left() < sz)
+          return false;
+        const auto t = static_cast<ProtocolType>(proto);
+        if (t == ProtocolType::TrafficBatch)
+          return false;
+        visit(t, llarp_buffer_t{buf.cur, sz});
+        buf.cur += sz;
+      }
+      return true;
+    }
+
     void
     ProtocolMessage::ProcessAsync(
         path::Path_ptr path, PathID_t from, std::shared_ptr<ProtocolMessage> self)
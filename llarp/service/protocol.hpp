@@ -13,6 +13,7 @@
 #include <llarp/util/time.hpp>
 #include <llarp/path/pathset.hpp>
 
+#include <functional>
 #include <vector>
 
 struct llarp_threadpool;
@@ -31,6 +32,11 @@ namespace llarp
 
     constexpr std::size_t MAX_PROTOCOL_MESSAGE_SIZE = 2048 * 2;
 
+    /// largest payload we will pack into a ProtocolType::TrafficBatch message
+    constexpr std::size_t MAX_BATCHED_PACKET_SIZE = 512;
+    /// how big a ProtocolType::TrafficBatch payload can get, leaves room for message overhead
+    constexpr std::size_t MAX_TRAFFIC_BATCH_SIZE = 1280;
+
     /// inner message
     struct ProtocolMessage
     {
@@ -60,6 +66,18 @@ namespace llarp
       void
       PutBuffer(const llarp_buffer_t& payload);
 
+      /// append a packet of protocol type t to a ProtocolType::TrafficBatch payload
+      /// return false if it would not fit
+      static bool
+      AppendToBatch(std::vector<byte_t>& batch, ProtocolType t, const llarp_buffer_t& pkt);
+
+      /// call visit for every packet packed into a ProtocolType::TrafficBatch payload
+      /// return false if the batch is malformed
+      static bool
+      ForEachInBatch(
+          const llarp_buffer_t& batch,
+          std::function<void(ProtocolType, const llarp_buffer_t&)> visit);
+
       static void
       ProcessAsync(path::Path_ptr p, PathID_t from, std::shared_ptr<ProtocolMessage> self);
 
@@ -17,20 +17,22 @@ namespace llarp::service
     Exit = 3UL,
     Auth = 4UL,
     QUIC = 5UL,
-
+    /// several small packets of other protocol types packed into one message
+    TrafficBatch = 6UL,
   };
 
   constexpr std::string_view
   ToString(ProtocolType t)
   {
     using namespace std::literals;
-    return t == ProtocolType::Control  ? "Control"sv
-        : t == ProtocolType::TrafficV4 ? "TrafficV4"sv
-        : t == ProtocolType::TrafficV6 ? "TrafficV6"sv
-        : t == ProtocolType::Exit      ? "Exit"sv
-        : t == ProtocolType::Auth      ? "Auth"sv
-        : t == ProtocolType::QUIC      ? "QUIC"sv
-                                       : "(unknown-protocol-type)"sv;
+    return t == ProtocolType::Control     ? "Control"sv
+        : t == ProtocolType::TrafficV4    ? "TrafficV4"sv
+        : t == ProtocolType::TrafficV6    ? "TrafficV6"sv
+        : t == ProtocolType::Exit         ? "Exit"sv
+        : t == ProtocolType::Auth         ? "Auth"sv
+        : t == ProtocolType::QUIC         ? "QUIC"sv
+        : t == ProtocolType::TrafficBatch ? "TrafficBatch"sv
+                                          : "(unknown-protocol-type)"sv;
   }
 
 }  // namespace llarp::service
@@ -1,6 +1,7 @@
 #include "sendcontext.hpp"
 
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/router/router_metrics.hpp>
 #include <llarp/routing/path_transfer_message.hpp>
 #include "endpoint.hpp"
 #include <utility>
@@ -12,6 +13,7 @@ namespace llarp
   namespace service
   {
     static constexpr size_t SendContextQueueSize = 512;
+    static constexpr size_t SendContextCongestionThreshold = (SendContextQueueSize * 3) / 4;
 
     SendContext::SendContext(
         ServiceInfo ident, const Introduction& intro, path::PathSet* send, Endpoint* ep)
@@ -41,6 +43,7 @@ namespace llarp
     void
     SendContext::FlushUpstream()
     {
+      FlushBatch();
       auto r = m_Endpoint->Router();
       std::unordered_set<path::Path_ptr, path::Path::Ptr_Hash> flushpaths;
       auto rttRMS = 0ms;
@@ -51,6 +54,7 @@ namespace llarp
         if (path->SendRoutingMessage(*msg, r))
         {
           lastGoodSend = r->Now();
+          r->metrics().serviceMessagesSent.Add();
           flushpaths.emplace(path);
           m_Endpoint->ConvoTagTX(msg->T.T);
           const auto rtt = (path->intro.latency + remoteIntro.latency) * 2;
@@ -68,6 +72,16 @@ namespace llarp
           static_cast<int64_t>(std::sqrt(rttRMS.count() / flushpaths.size()))};
     }
 
+    bool
+    SendContext::IsCongested() const
+    {
+      if (m_SendQueue.size() >= SendContextCongestionThreshold)
+        return true;
+      if (auto path = m_PathSet->GetPathByRouter(remoteIntro.router))
+        return path->IsCongested(m_Endpoint->Router());
+      return false;
+    }
+
     /// send on an established convo tag
     void
     SendContext::EncryptAndSendTo(const llarp_buffer_t& payload, ProtocolType t)
@@ -122,6 +136,44 @@ namespace llarp
       });
     }
 
+    bool
+    SendContext::QueueBatched(const llarp_buffer_t& payload, ProtocolType t)
+    {
+      if (payload.sz > MAX_BATCHED_PACKET_SIZE or not RemoteSupportsBatching())
+      {
+        // keep ordering with anything we have already batched up
+        FlushBatch();
+        return false;
+      }
+      if (not ProtocolMessage::AppendToBatch(m_PendingBatch, t, payload))
+      {
+        FlushBatch();
+        if (not ProtocolMessage::AppendToBatch(m_PendingBatch, t, payload))
+          return false;
+      }
+      if (m_PendingBatchCount++ == 0)
+        m_Endpoint->Router()->TriggerPump();
+      return true;
+    }
+
+    void
+    SendContext::FlushBatch()
+    {
+      if (m_PendingBatchCount == 0)
+        return;
+      auto batch = std::move(m_PendingBatch);
+      m_PendingBatch.clear();
+      if (std::exchange(m_PendingBatchCount, 0) > 1)
+      {
+        EncryptAndSendTo(llarp_buffer_t{batch}, ProtocolType::TrafficBatch);
+        return;
+      }
+      // a batch of one is sent as is to save the batch overhead
+      ProtocolMessage::ForEachInBatch(
+          llarp_buffer_t{batch},
+          [this](ProtocolType t, const llarp_buffer_t& pkt) { EncryptAndSendTo(pkt, t); });
+    }
+
     void
     SendContext::AsyncSendAuth(std::function<void(AuthResult)> resultHandler)
     {
@@ -141,7 +193,8 @@ namespace llarp
     {
       if (IntroSent())
       {
-        EncryptAndSendTo(data, protocol);
+        if (not QueueBatched(data, protocol))
+          EncryptAndSendTo(data, protocol);
         return;
       }
       // have we generated the initial intro but not sent it yet? bail here so we don't cause
@@ -34,6 +34,10 @@ namespace llarp
       void
       FlushUpstream();
 
+      /// return true if our send queue or the path we send on are backing up
+      bool
+      IsCongested() const;
+
       SharedSecret sharedKey;
       ServiceInfo remoteIdent;
       Introduction remoteIntro;
@@ -54,6 +58,11 @@ namespace llarp
 
       thread::Queue<SendEvent_t> m_SendQueue;
 
+      /// small payloads packed together waiting to be sent as one ProtocolType::TrafficBatch
+      /// message, flushed when full or on the next FlushUpstream
+      std::vector<byte_t> m_PendingBatch;
+      size_t m_PendingBatchCount = 0;
+
       std::function<void(AuthResult)> authResultListener;
 
       virtual bool
@@ -81,9 +90,21 @@ namespace llarp
       virtual bool
       IntroSent() const = 0;
 
+      /// return true if the remote end can unpack ProtocolType::TrafficBatch messages
+      virtual bool
+      RemoteSupportsBatching() const = 0;
+
       void
       EncryptAndSendTo(const llarp_buffer_t& payload, ProtocolType t);
 
+      /// try packing a payload into the pending batch, return false if it must be sent on its own
+      bool
+      QueueBatched(const llarp_buffer_t& payload, ProtocolType t);
+
+      /// send everything in the pending batch
+      void
+      FlushBatch();
+
       virtual void
       AsyncGenIntro(const llarp_buffer_t& payload, ProtocolType t) = 0;
     };
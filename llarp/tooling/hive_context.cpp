@@ -1,6 +1,7 @@
 #include "hive_context.hpp"
 
 #include "hive_router.hpp"
+#include "router_hive.hpp"
 
 namespace tooling
 {
@@ -13,6 +14,15 @@ namespace tooling
     return std::make_shared<HiveRouter>(loop, makeVPNPlatform(), m_hive);
   }
 
+  std::shared_ptr<llarp::vpn::Platform>
+  HiveContext::makeVPNPlatform()
+  {
+    if (not(m_hive and m_hive->simNetwork))
+      return llarp::Context::makeVPNPlatform();
+    simVPN = std::make_shared<SimVPNPlatform>();
+    return simVPN;
+  }
+
   HiveRouter*
   HiveContext::getRouterAsHiveRouter()
   {
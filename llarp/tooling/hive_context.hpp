@@ -2,6 +2,7 @@
 
 #include <llarp.hpp>
 #include "hive_router.hpp"
+#include "sim_vpn.hpp"
 
 namespace tooling
 {
@@ -14,6 +15,10 @@ namespace tooling
     std::shared_ptr<llarp::AbstractRouter>
     makeRouter(const llarp::EventLoop_ptr& loop) override;
 
+    /// userspace interfaces when the hive is simulated, the native platform otherwise
+    std::shared_ptr<llarp::vpn::Platform>
+    makeVPNPlatform() override;
+
     /// Get this context's router as a HiveRouter.
     ///
     /// Returns nullptr if there is no router or throws an exception if the
@@ -21,6 +26,9 @@ namespace tooling
     HiveRouter*
     getRouterAsHiveRouter();
 
+    /// the platform our interfaces came from if the hive is simulated
+    std::shared_ptr<SimVPNPlatform> simVPN;
+
    protected:
     RouterHive* m_hive = nullptr;
   };
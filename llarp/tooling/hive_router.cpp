@@ -27,6 +27,14 @@ namespace tooling
     m_disableGossiping = false;
   }
 
+  llarp_time_t
+  HiveRouter::Now() const
+  {
+    if (m_hive and m_hive->simNetwork)
+      return loop()->time_now();
+    return Router::Now();
+  }
+
   void
   HiveRouter::HandleRouterEvent(RouterEventPtr event) const
   {
@@ -27,6 +27,10 @@ namespace tooling
     void
     enableGossiping();
 
+    /// our loop's clock, which is the virtual one when the hive is simulated
+    llarp_time_t
+    Now() const override;
+
    protected:
     bool m_disableGossiping = false;
     RouterHive* m_hive = nullptr;
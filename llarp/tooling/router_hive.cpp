@@ -12,6 +12,12 @@ using namespace std::chrono_literals;
 
 namespace tooling
 {
+  RouterHive::RouterHive(bool simulated, uint64_t seed)
+  {
+    if (simulated)
+      simNetwork = std::make_shared<SimNetwork>(seed);
+  }
+
   void
   RouterHive::AddRouter(const std::shared_ptr<llarp::Config>& config, bool isSNode)
   {
@@ -21,6 +27,8 @@ namespace tooling
     opts.isSNode = isSNode;
 
     Context_ptr context = std::make_shared<HiveContext>(this);
+    if (simNetwork)
+      context->loop = simNetwork->MakeLoop();
     context->Configure(config);
     context->Setup(opts);
 
@@ -46,6 +54,14 @@ namespace tooling
   {
     auto& container = (isRelay ? relays : clients);
 
+    if (simNetwork)
+    {
+      // started by the first RunFor, the network drives them all from there
+      for (const auto& [routerId, ctx] : container)
+        ctx->loop->call_soon([ctx = ctx]() { ctx->router->Run(); });
+      return;
+    }
+
     for (const auto& [routerId, ctx] : container)
     {
       routerMainThreads.emplace_back([ctx = ctx, isRelay = isRelay]() {
@@ -80,6 +96,26 @@ namespace tooling
       ctx->loop->call([ctx = ctx]() { ctx->HandleSignal(SIGINT); });
     }
 
+    if (simNetwork)
+    {
+      llarp::LogInfo("Running the simulated network until routers are stopped");
+      const auto anyUp = [this]() {
+        for (const auto* container : {&relays, &clients})
+        {
+          for (const auto& [routerId, ctx] : *container)
+          {
+            if (ctx->IsUp())
+              return true;
+          }
+        }
+        return false;
+      };
+      for (int tries = 0; tries < 600 and anyUp(); ++tries)
+        simNetwork->RunFor(100ms);
+      llarp::LogInfo("RouterHive::StopRouters finished");
+      return;
+    }
+
     llarp::LogInfo("Waiting on routers to be stopped");
     for (auto [routerId, ctx] : relays)
     {
@@ -109,6 +145,22 @@ namespace tooling
     llarp::LogInfo("RouterHive::StopRouters finished");
   }
 
+  void
+  RouterHive::RunFor(llarp_time_t dur)
+  {
+    if (simNetwork)
+      simNetwork->RunFor(dur);
+    else
+      std::this_thread::sleep_for(dur);
+  }
+
+  void
+  RouterHive::SetDefaultLink(LinkParams params)
+  {
+    if (simNetwork)
+      simNetwork->SetDefaultLink(params);
+  }
+
   void
   RouterHive::NotifyEvent(RouterEventPtr event)
   {
@@ -198,7 +250,11 @@ namespace tooling
       if (read_done_count == relays.size())
         break;
 
-      std::this_thread::sleep_for(100ms);
+      // nobody runs the calls for us unless we drive the network
+      if (simNetwork)
+        simNetwork->RunFor(0ms);
+      else
+        std::this_thread::sleep_for(100ms);
     }
     return results;
   }
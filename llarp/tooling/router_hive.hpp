@@ -5,6 +5,7 @@
 #include <llarp.hpp>
 #include <llarp/config/config.hpp>
 #include <llarp/tooling/hive_context.hpp>
+#include <llarp/tooling/sim_network.hpp>
 
 #include <vector>
 #include <deque>
@@ -41,6 +42,9 @@ namespace tooling
    public:
     RouterHive() = default;
 
+    /// a hive on a SimNetwork instead of real sockets and a thread per router when simulated
+    explicit RouterHive(bool simulated, uint64_t seed = 0);
+
     void
     AddRelay(const std::shared_ptr<llarp::Config>& conf);
 
@@ -56,6 +60,14 @@ namespace tooling
     void
     StopRouters();
 
+    /// let the hive run for dur; drives the simulated network if we have one, sleeps otherwise
+    void
+    RunFor(llarp_time_t dur);
+
+    /// link parameters for the simulated network, does nothing if we are not simulated
+    void
+    SetDefaultLink(LinkParams params);
+
     void
     NotifyEvent(RouterEventPtr event);
 
@@ -88,6 +100,9 @@ namespace tooling
 
     std::vector<std::thread> routerMainThreads;
 
+    /// all routers run on this if set
+    std::shared_ptr<SimNetwork> simNetwork;
+
     std::mutex eventQueueMutex;
     std::deque<RouterEventPtr> eventQueue;
   };
@@ -0,0 +1,485 @@
+#include "sim_network.hpp"
+
+#include <llarp/util/logging.hpp>
+#include <llarp/util/time.hpp>
+#include <llarp/vpn/platform.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace tooling
+{
+  namespace
+  {
+    /// Trigger() queues the callback once until it has run
+    class SimWakeup : public llarp::EventLoopWakeup, public std::enable_shared_from_this<SimWakeup>
+    {
+     public:
+      SimWakeup(std::weak_ptr<SimLoop> loop, std::function<void()> callback)
+          : m_Loop{std::move(loop)}, m_Callback{std::move(callback)}
+      {}
+
+      void
+      Trigger() override
+      {
+        if (m_Pending.exchange(true))
+          return;
+        if (auto loop = m_Loop.lock())
+        {
+          loop->call_soon([self = weak_from_this()]() {
+            if (auto ptr = self.lock())
+            {
+              ptr->m_Pending = false;
+              ptr->m_Callback();
+            }
+          });
+        }
+      }
+
+     private:
+      std::weak_ptr<SimLoop> m_Loop;
+      std::function<void()> m_Callback;
+      std::atomic<bool> m_Pending{false};
+    };
+
+    /// runs the task every so often until destroyed
+    class SimRepeater : public llarp::EventLoopRepeater,
+                        public std::enable_shared_from_this<SimRepeater>
+    {
+     public:
+      explicit SimRepeater(std::weak_ptr<SimLoop> loop) : m_Loop{std::move(loop)}
+      {}
+
+      void
+      start(llarp_time_t every, std::function<void()> task) override
+      {
+        m_Every = every;
+        m_Task = std::move(task);
+        Again();
+      }
+
+     private:
+      void
+      Again()
+      {
+        if (auto loop = m_Loop.lock())
+        {
+          loop->call_later(m_Every, [self = weak_from_this()]() {
+            // the task may drop the last reference to us, so hold one while it runs
+            if (auto ptr = self.lock())
+            {
+              ptr->m_Task();
+              ptr->Again();
+            }
+          });
+        }
+      }
+
+      std::weak_ptr<SimLoop> m_Loop;
+      llarp_time_t m_Every;
+      std::function<void()> m_Task;
+    };
+  }  // namespace
+
+  SimNetwork::SimNetwork(uint64_t seed) : m_Now{llarp::time_now_ms()}, m_RNG{seed}
+  {}
+
+  std::shared_ptr<SimLoop>
+  SimNetwork::MakeLoop()
+  {
+    return std::make_shared<SimLoop>(weak_from_this());
+  }
+
+  void
+  SimNetwork::SetDefaultLink(LinkParams params)
+  {
+    m_DefaultLink = params;
+  }
+
+  void
+  SimNetwork::SetLink(const llarp::SockAddr& from, const llarp::SockAddr& to, LinkParams params)
+  {
+    m_Links[{from, to}] = params;
+  }
+
+  void
+  SimNetwork::Schedule(llarp_time_t at, std::weak_ptr<SimLoop> loop, Job_t job)
+  {
+    m_Events.push(Event{at, m_Seq++, std::move(loop), std::move(job)});
+  }
+
+  void
+  SimNetwork::Post(std::weak_ptr<SimLoop> loop, Job_t job)
+  {
+    if (InDriver())
+    {
+      Schedule(Now(), std::move(loop), std::move(job));
+      return;
+    }
+    std::lock_guard lock{m_PostedMutex};
+    m_Posted.emplace_back(std::move(loop), std::move(job));
+  }
+
+  void
+  SimNetwork::Later(std::weak_ptr<SimLoop> loop, llarp_time_t delay, Job_t job)
+  {
+    if (InDriver())
+    {
+      Schedule(Now() + delay, std::move(loop), std::move(job));
+      return;
+    }
+    Post(loop, [this, loop, delay, job = std::move(job)]() { Later(loop, delay, job); });
+  }
+
+  void
+  SimNetwork::TakePosted()
+  {
+    std::vector<std::pair<std::weak_ptr<SimLoop>, Job_t>> posted;
+    {
+      std::lock_guard lock{m_PostedMutex};
+      posted.swap(m_Posted);
+    }
+    for (auto& [loop, job] : posted)
+      Schedule(Now(), std::move(loop), std::move(job));
+  }
+
+  size_t
+  SimNetwork::RunFor(llarp_time_t dur)
+  {
+    m_Driver = std::this_thread::get_id();
+    const auto deadline = Now() + dur;
+    size_t ran = 0;
+    for (;;)
+    {
+      TakePosted();
+      if (m_Events.empty() or m_Events.top().at > deadline)
+        break;
+      // top() is const but we are about to pop it anyways
+      auto ev = std::move(const_cast<Event&>(m_Events.top()));
+      m_Events.pop();
+      m_Now.store(std::max(Now(), ev.at));
+
+      auto loop = ev.loop.lock();
+      if (not loop or loop->m_Stopped)
+        continue;
+      m_Current = loop.get();
+      const auto started = std::chrono::steady_clock::now();
+      ev.job();
+      loop->m_Busy += std::chrono::steady_clock::now() - started;
+      ran++;
+      // tickers run once after everything else the loop has to do this tick
+      if (not loop->m_Tickers.empty() and loop->m_TickedAt != Now())
+      {
+        loop->m_TickedAt = Now();
+        Schedule(Now(), loop, [loop = loop.get()]() {
+          for (const auto& ticker : loop->m_Tickers)
+            ticker();
+        });
+      }
+      m_Current = nullptr;
+    }
+    m_Now.store(std::max(Now(), deadline));
+    m_Driver = std::thread::id{};
+    return ran;
+  }
+
+  /// bound to every address
+  static bool
+  IsUnspecified(const llarp::SockAddr& addr)
+  {
+    if (addr.isEmpty())
+      return true;
+    return addr.isIPv4() ? addr.asIPv4() == llarp::huint32_t{0}
+                         : addr.asIPv6() == llarp::huint128_t{0};
+  }
+
+  bool
+  SimNetwork::InUse(const llarp::SockAddr& addr) const
+  {
+    if (IsUnspecified(addr))
+    {
+      auto itr = m_BoundAny.find(addr.getPort());
+      return itr != m_BoundAny.end() and not itr->second.expired();
+    }
+    auto itr = m_Bound.find(addr);
+    return itr != m_Bound.end() and not itr->second.expired();
+  }
+
+  std::optional<llarp::SockAddr>
+  SimNetwork::Bind(llarp::SockAddr addr, std::shared_ptr<SimUDPHandle> handle)
+  {
+    std::lock_guard lock{m_BoundMutex};
+    if (addr.getPort() == 0)
+    {
+      // pick a free port like the kernel would
+      for (size_t tries = 0; tries < 65536; ++tries)
+      {
+        addr.setPort(m_NextPort);
+        m_NextPort = m_NextPort == 65535 ? 40000 : m_NextPort + 1;
+        if (not InUse(addr) and not m_BoundAny.count(addr.getPort()))
+          break;
+      }
+    }
+    if (InUse(addr))
+      return std::nullopt;
+    if (IsUnspecified(addr))
+      m_BoundAny[addr.getPort()] = handle;
+    else
+      m_Bound[addr] = handle;
+    return addr;
+  }
+
+  void
+  SimNetwork::Unbind(const llarp::SockAddr& addr)
+  {
+    std::lock_guard lock{m_BoundMutex};
+    if (IsUnspecified(addr))
+      m_BoundAny.erase(addr.getPort());
+    else
+      m_Bound.erase(addr);
+  }
+
+  std::shared_ptr<SimUDPHandle>
+  SimNetwork::Find(const llarp::SockAddr& addr) const
+  {
+    std::lock_guard lock{m_BoundMutex};
+    if (auto itr = m_Bound.find(addr); itr != m_Bound.end())
+      return itr->second.lock();
+    if (auto itr = m_BoundAny.find(addr.getPort()); itr != m_BoundAny.end())
+      return itr->second.lock();
+    return nullptr;
+  }
+
+  void
+  SimNetwork::Send(
+      const llarp::SockAddr& from, const llarp::SockAddr& to, const llarp_buffer_t& buf)
+  {
+    m_Stats.sent++;
+    const auto linkID = std::make_pair(from, to);
+    const auto itr = m_Links.find(linkID);
+    const auto& link = itr == m_Links.end() ? m_DefaultLink : itr->second;
+    if (link.loss > 0 and std::uniform_real_distribution<double>{}(m_RNG) < link.loss)
+    {
+      m_Stats.lost++;
+      return;
+    }
+    auto departs = Now();
+    if (link.bandwidth)
+    {
+      // keep track of how busy the link is at finer than the clock's granularity so small
+      // packets on fast links still add up
+      const std::chrono::microseconds now = Now();
+      auto& busy = m_LinkBusy[linkID];
+      const auto start = std::max(busy, now);
+      if (start - now > link.maxQueue)
+      {
+        m_Stats.overflowed++;
+        return;
+      }
+      busy = start + std::chrono::microseconds{buf.sz * 1'000'000 / link.bandwidth};
+      departs = std::chrono::duration_cast<llarp_time_t>(start);
+    }
+    auto dest = Find(to);
+    if (not dest)
+    {
+      m_Stats.unreachable++;
+      return;
+    }
+    auto data = std::make_shared<llarp::OwnedBuffer>(llarp::OwnedBuffer::copy_from(buf));
+    Schedule(
+        departs + link.latency,
+        dest->m_Loop,
+        [this, from, data, dest = std::weak_ptr<SimUDPHandle>{dest}]() {
+          if (auto ptr = dest.lock())
+          {
+            m_Stats.delivered++;
+            m_Stats.bytesDelivered += data->sz;
+            ptr->Receive(from, std::move(*data));
+          }
+        });
+  }
+
+  SimLoop::SimLoop(std::weak_ptr<SimNetwork> net) : m_Net{std::move(net)}
+  {}
+
+  void
+  SimLoop::run()
+  {
+    std::unique_lock lock{m_StopMutex};
+    m_StopCond.wait(lock, [this]() { return m_Stopped.load(); });
+  }
+
+  void
+  SimLoop::stop()
+  {
+    {
+      std::lock_guard lock{m_StopMutex};
+      m_Stopped = true;
+    }
+    m_StopCond.notify_all();
+  }
+
+  llarp_time_t
+  SimLoop::time_now() const
+  {
+    if (auto net = m_Net.lock())
+      return net->Now();
+    return llarp::time_now_ms();
+  }
+
+  void
+  SimLoop::call_soon(std::function<void(void)> f)
+  {
+    if (auto net = m_Net.lock())
+      net->Post(weak_from_this(), std::move(f));
+  }
+
+  llarp::EventLoop::TimerID
+  SimLoop::call_later(llarp_time_t delay_ms, std::function<void(void)> callback)
+  {
+    TimerID id;
+    {
+      std::lock_guard lock{m_TimersMutex};
+      id = ++m_NextTimerID;
+      m_Timers.insert(id);
+    }
+    if (auto net = m_Net.lock())
+    {
+      net->Later(weak_from_this(), delay_ms, [this, id, f = std::move(callback)]() {
+        // the network only runs it while we are alive
+        bool pending;
+        {
+          std::lock_guard lock{m_TimersMutex};
+          pending = m_Timers.erase(id) > 0;
+        }
+        if (pending)
+          f();
+      });
+    }
+    return id;
+  }
+
+  void
+  SimLoop::cancel_later(TimerID id)
+  {
+    std::lock_guard lock{m_TimersMutex};
+    m_Timers.erase(id);
+  }
+
+  bool
+  SimLoop::add_ticker(std::function<void(void)> ticker)
+  {
+    call_soon([this, ticker = std::move(ticker)]() { m_Tickers.push_back(ticker); });
+    return true;
+  }
+
+  bool
+  SimLoop::add_network_interface(
+      std::shared_ptr<llarp::vpn::NetworkInterface> netif,
+      std::function<void(llarp::net::IPPacket)> handler)
+  {
+    return add_ticker([this, netif = std::move(netif), handler = std::move(handler)]() {
+      if (m_PausedNetIfs.count(netif.get()))
+        return;
+      for (auto pkt = netif->ReadNextPacket(); not pkt.empty(); pkt = netif->ReadNextPacket())
+      {
+        if (handler)
+          handler(std::move(pkt));
+      }
+    });
+  }
+
+  void
+  SimLoop::pause_network_interface(const llarp::vpn::NetworkInterface& netif, bool paused)
+  {
+    if (paused)
+      m_PausedNetIfs.insert(&netif);
+    else
+      m_PausedNetIfs.erase(&netif);
+  }
+
+  std::shared_ptr<llarp::UDPHandle>
+  SimLoop::make_udp(UDPReceiveFunc on_recv)
+  {
+    return std::make_shared<SimUDPHandle>(m_Net, weak_from_this(), std::move(on_recv));
+  }
+
+  std::shared_ptr<llarp::EventLoopWakeup>
+  SimLoop::make_waker(std::function<void()> callback)
+  {
+    return std::make_shared<SimWakeup>(weak_from_this(), std::move(callback));
+  }
+
+  std::shared_ptr<llarp::EventLoopRepeater>
+  SimLoop::make_repeater()
+  {
+    return std::make_shared<SimRepeater>(weak_from_this());
+  }
+
+  bool
+  SimLoop::inEventLoop() const
+  {
+    auto net = m_Net.lock();
+    return net and net->InDriver() and net->m_Current == this;
+  }
+
+  SimUDPHandle::SimUDPHandle(
+      std::weak_ptr<SimNetwork> net, std::weak_ptr<SimLoop> loop, ReceiveFunc on_recv)
+      : llarp::UDPHandle{std::move(on_recv)}, m_Net{std::move(net)}, m_Loop{std::move(loop)}
+  {}
+
+  SimUDPHandle::~SimUDPHandle()
+  {
+    close();
+  }
+
+  bool
+  SimUDPHandle::listen(const llarp::SockAddr& addr)
+  {
+    auto net = m_Net.lock();
+    if (not net)
+      return false;
+    close();
+    m_Addr = net->Bind(addr, shared_from_this());
+    if (not m_Addr)
+      llarp::LogWarn("simulated udp address ", addr, " is already in use");
+    return m_Addr.has_value();
+  }
+
+  bool
+  SimUDPHandle::send(const llarp::SockAddr& dest, const llarp_buffer_t& buf)
+  {
+    if (not m_Addr and not listen(llarp::SockAddr{}))
+      return false;
+    auto net = m_Net.lock();
+    if (not net)
+      return false;
+    if (net->InDriver())
+    {
+      net->Send(*m_Addr, dest, buf);
+      return true;
+    }
+    // links belong to the driver, send from our loop
+    auto data = std::make_shared<llarp::OwnedBuffer>(llarp::OwnedBuffer::copy_from(buf));
+    net->Post(m_Loop, [net, from = *m_Addr, dest, data]() {
+      net->Send(from, dest, llarp_buffer_t{data->buf.get(), data->sz});
+    });
+    return true;
+  }
+
+  void
+  SimUDPHandle::close()
+  {
+    if (not m_Addr)
+      return;
+    if (auto net = m_Net.lock())
+      net->Unbind(*m_Addr);
+    m_Addr.reset();
+  }
+
+  void
+  SimUDPHandle::Receive(const llarp::SockAddr& from, llarp::OwnedBuffer buf)
+  {
+    on_recv(*this, from, std::move(buf));
+  }
+}  // namespace tooling
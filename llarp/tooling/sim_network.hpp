@@ -0,0 +1,304 @@
+#pragma once
+
+#include <llarp/ev/ev.hpp>
+#include <llarp/ev/udp_handle.hpp>
+#include <llarp/net/sock_addr.hpp>
+#include <llarp/util/time.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tooling
+{
+  class SimLoop;
+  class SimUDPHandle;
+
+  /// how packets fare on a simulated link
+  struct LinkParams
+  {
+    /// one way delay
+    llarp_time_t latency = std::chrono::milliseconds{5};
+    /// bytes per second, 0 for unlimited
+    uint64_t bandwidth = 0;
+    /// chance a packet gets lost, 0 to 1
+    double loss = 0;
+    /// packets that would wait longer than this to get on the link are dropped
+    llarp_time_t maxQueue = std::chrono::seconds{1};
+  };
+
+  /// an in memory network of simulated event loops and udp sockets running on a virtual clock.
+  ///
+  /// nothing happens on its own: whoever drives the network calls RunFor, which runs every timer,
+  /// call and packet delivery of every loop in time order on the calling thread, and only moves
+  /// the clock forward as far as the next thing to do. the same seed and the same calls give the
+  /// same run no matter how many loops there are or how long they sleep, as long as nothing else
+  /// calls into the loops from other threads.
+  ///
+  /// the virtual clock reaches the routers through their loops' time_now(), llarp::time_now_ms()
+  /// stays on the wall clock.
+  class SimNetwork : public std::enable_shared_from_this<SimNetwork>
+  {
+   public:
+    struct Stats
+    {
+      uint64_t sent = 0;
+      uint64_t delivered = 0;
+      uint64_t lost = 0;
+      /// over the link queue limit
+      uint64_t overflowed = 0;
+      /// nobody listening at the destination
+      uint64_t unreachable = 0;
+      uint64_t bytesDelivered = 0;
+    };
+
+    explicit SimNetwork(uint64_t seed = 0);
+
+    /// make a new event loop on this network
+    std::shared_ptr<SimLoop>
+    MakeLoop();
+
+    /// link parameters for anything without its own
+    void
+    SetDefaultLink(LinkParams params);
+
+    /// link parameters for packets from one address to another
+    void
+    SetLink(const llarp::SockAddr& from, const llarp::SockAddr& to, LinkParams params);
+
+    /// the virtual time, read from any thread
+    llarp_time_t
+    Now() const
+    {
+      return m_Now.load();
+    }
+
+    /// run everything that is due over the next dur of virtual time, returns how many events ran
+    size_t
+    RunFor(llarp_time_t dur);
+
+    /// true if called from inside RunFor
+    bool
+    InDriver() const
+    {
+      return m_Driver.load() == std::this_thread::get_id();
+    }
+
+    Stats
+    GetStats() const
+    {
+      return m_Stats;
+    }
+
+   private:
+    friend class SimLoop;
+    friend class SimUDPHandle;
+
+    using Job_t = std::function<void()>;
+
+    struct Event
+    {
+      llarp_time_t at;
+      uint64_t seq;
+      std::weak_ptr<SimLoop> loop;
+      Job_t job;
+
+      bool
+      operator>(const Event& other) const
+      {
+        return std::tie(at, seq) > std::tie(other.at, other.seq);
+      }
+    };
+
+    /// queue job to run on loop at time at, from the driver thread
+    void
+    Schedule(llarp_time_t at, std::weak_ptr<SimLoop> loop, Job_t job);
+
+    /// queue job to run on loop as soon as possible, from any thread
+    void
+    Post(std::weak_ptr<SimLoop> loop, Job_t job);
+
+    /// queue job to run on loop after delay, from any thread
+    void
+    Later(std::weak_ptr<SimLoop> loop, llarp_time_t delay, Job_t job);
+
+    /// bind handle to addr, picking a free port if it has none; returns the address we bound to
+    std::optional<llarp::SockAddr>
+    Bind(llarp::SockAddr addr, std::shared_ptr<SimUDPHandle> handle);
+
+    void
+    Unbind(const llarp::SockAddr& addr);
+
+    /// true if someone is bound to exactly addr, call with m_BoundMutex held
+    bool
+    InUse(const llarp::SockAddr& addr) const;
+
+    /// put a packet on the link from one address to another, from the driver thread
+    void
+    Send(const llarp::SockAddr& from, const llarp::SockAddr& to, const llarp_buffer_t& buf);
+
+    std::shared_ptr<SimUDPHandle>
+    Find(const llarp::SockAddr& addr) const;
+
+    /// move posted jobs onto the event queue
+    void
+    TakePosted();
+
+    /// only moved by the driver, read by the loops from any thread
+    std::atomic<llarp_time_t> m_Now;
+    uint64_t m_Seq = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> m_Events;
+    std::atomic<std::thread::id> m_Driver;
+    /// the loop whose event is running right now
+    const SimLoop* m_Current = nullptr;
+
+    std::mutex m_PostedMutex;
+    std::vector<std::pair<std::weak_ptr<SimLoop>, Job_t>> m_Posted;
+
+    mutable std::mutex m_BoundMutex;
+    std::unordered_map<llarp::SockAddr, std::weak_ptr<SimUDPHandle>> m_Bound;
+    /// sockets bound to the unspecified address, by port
+    std::unordered_map<uint16_t, std::weak_ptr<SimUDPHandle>> m_BoundAny;
+    uint16_t m_NextPort = 40000;
+
+    LinkParams m_DefaultLink;
+    std::map<std::pair<llarp::SockAddr, llarp::SockAddr>, LinkParams> m_Links;
+    /// when each link we sent on is busy until
+    std::map<std::pair<llarp::SockAddr, llarp::SockAddr>, std::chrono::microseconds> m_LinkBusy;
+
+    std::mt19937_64 m_RNG;
+    Stats m_Stats;
+  };
+
+  /// an event loop driven by a SimNetwork
+  class SimLoop : public llarp::EventLoop, public std::enable_shared_from_this<SimLoop>
+  {
+   public:
+    explicit SimLoop(std::weak_ptr<SimNetwork> net);
+
+    /// blocks until stop() like any other loop would, the network does the actual running
+    void
+    run() override;
+
+    bool
+    running() const override
+    {
+      return not m_Stopped;
+    }
+
+    llarp_time_t
+    time_now() const override;
+
+    void
+    call_soon(std::function<void(void)> f) override;
+
+    TimerID
+    call_later(llarp_time_t delay_ms, std::function<void(void)> callback) override;
+
+    void
+    cancel_later(TimerID id) override;
+
+    /// reads the interface dry after each tick like the non linux loops do, so whatever injects
+    /// packets into it has to do so from a call on this loop
+    bool
+    add_network_interface(
+        std::shared_ptr<llarp::vpn::NetworkInterface> netif,
+        std::function<void(llarp::net::IPPacket)> handler) override;
+
+    void
+    pause_network_interface(const llarp::vpn::NetworkInterface& netif, bool paused) override;
+
+    bool
+    add_ticker(std::function<void(void)> ticker) override;
+
+    void
+    stop() override;
+
+    std::shared_ptr<llarp::UDPHandle>
+    make_udp(UDPReceiveFunc on_recv) override;
+
+    std::shared_ptr<llarp::EventLoopWakeup>
+    make_waker(std::function<void()> callback) override;
+
+    std::shared_ptr<llarp::EventLoopRepeater>
+    make_repeater() override;
+
+    bool
+    inEventLoop() const override;
+
+    void
+    wakeup() override
+    {}
+
+    /// wall clock time spent running this loop's events so far, read it between RunFor calls
+    std::chrono::nanoseconds
+    BusyTime() const
+    {
+      return m_Busy;
+    }
+
+   private:
+    friend class SimNetwork;
+
+    std::weak_ptr<SimNetwork> m_Net;
+    /// run after each virtual tick we ran anything in, only touched by the driver
+    std::vector<std::function<void()>> m_Tickers;
+    /// last time the tickers were queued for
+    std::optional<llarp_time_t> m_TickedAt;
+    /// network interfaces the tickers leave alone for now, only touched by the driver
+    std::unordered_set<const llarp::vpn::NetworkInterface*> m_PausedNetIfs;
+    std::chrono::nanoseconds m_Busy{0};
+    /// call_later timers that have not run or been cancelled yet
+    std::mutex m_TimersMutex;
+    std::unordered_set<TimerID> m_Timers;
+    TimerID m_NextTimerID = 0;
+    std::atomic<bool> m_Stopped{false};
+    std::mutex m_StopMutex;
+    std::condition_variable m_StopCond;
+  };
+
+  /// a udp socket on a SimNetwork
+  class SimUDPHandle : public llarp::UDPHandle, public std::enable_shared_from_this<SimUDPHandle>
+  {
+   public:
+    SimUDPHandle(std::weak_ptr<SimNetwork> net, std::weak_ptr<SimLoop> loop, ReceiveFunc on_recv);
+
+    ~SimUDPHandle() override;
+
+    bool
+    listen(const llarp::SockAddr& addr) override;
+
+    bool
+    send(const llarp::SockAddr& dest, const llarp_buffer_t& buf) override;
+
+    void
+    close() override;
+
+    std::optional<llarp::SockAddr>
+    LocalAddr() const override
+    {
+      return m_Addr;
+    }
+
+   private:
+    friend class SimNetwork;
+
+    /// hand a packet that arrived to our receive function
+    void
+    Receive(const llarp::SockAddr& from, llarp::OwnedBuffer buf);
+
+    std::weak_ptr<SimNetwork> m_Net;
+    std::weak_ptr<SimLoop> m_Loop;
+    std::optional<llarp::SockAddr> m_Addr;
+  };
+}  // namespace tooling
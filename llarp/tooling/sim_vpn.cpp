@@ -0,0 +1,58 @@
+#include "sim_vpn.hpp"
+
+namespace tooling
+{
+  SimInterface::SimInterface(llarp::vpn::InterfaceInfo info)
+      : llarp::vpn::NetworkInterface{std::move(info)}
+  {}
+
+  void
+  SimInterface::Inject(llarp::net::IPPacket pkt)
+  {
+    m_Inbound.emplace_back(std::move(pkt));
+  }
+
+  void
+  SimInterface::SetSink(Sink_t sink)
+  {
+    m_Sink = std::move(sink);
+  }
+
+  llarp::net::IPPacket
+  SimInterface::ReadNextPacket()
+  {
+    if (m_Inbound.empty())
+      return llarp::net::IPPacket{};
+    auto pkt = std::move(m_Inbound.front());
+    m_Inbound.pop_front();
+    return pkt;
+  }
+
+  bool
+  SimInterface::WritePacket(llarp::net::IPPacket pkt)
+  {
+    if (not m_Sink)
+      return false;
+    m_Sink(std::move(pkt));
+    return true;
+  }
+
+  std::shared_ptr<llarp::vpn::NetworkInterface>
+  SimVPNPlatform::ObtainInterface(llarp::vpn::InterfaceInfo info, llarp::AbstractRouter*)
+  {
+    const auto ifname = info.ifname;
+    auto netif = std::make_shared<SimInterface>(std::move(info));
+    std::lock_guard lock{m_Access};
+    m_Interfaces[ifname] = netif;
+    return netif;
+  }
+
+  std::shared_ptr<SimInterface>
+  SimVPNPlatform::GetInterface(const std::string& ifname) const
+  {
+    std::lock_guard lock{m_Access};
+    if (auto itr = m_Interfaces.find(ifname); itr != m_Interfaces.end())
+      return itr->second.lock();
+    return nullptr;
+  }
+}  // namespace tooling
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <llarp/vpn/platform.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tooling
+{
+  /// a network interface that exchanges packets with the process instead of the os, for running
+  /// tun endpoints without root or real devices
+  class SimInterface : public llarp::vpn::NetworkInterface
+  {
+   public:
+    using Sink_t = std::function<void(llarp::net::IPPacket)>;
+
+    explicit SimInterface(llarp::vpn::InterfaceInfo info);
+
+    /// hand a packet to lokinet as if the os routed it into the interface; call it from the
+    /// interface's event loop, it is read after that loop's tick
+    void
+    Inject(llarp::net::IPPacket pkt);
+
+    /// where the packets lokinet writes to the interface go, they are dropped without one
+    void
+    SetSink(Sink_t sink);
+
+    llarp::net::IPPacket
+    ReadNextPacket() override;
+
+    bool
+    WritePacket(llarp::net::IPPacket pkt) override;
+
+    int
+    PollFD() const override
+    {
+      return -1;
+    }
+
+   private:
+    std::deque<llarp::net::IPPacket> m_Inbound;
+    Sink_t m_Sink;
+  };
+
+  /// hands out SimInterfaces and ignores all routing
+  class SimVPNPlatform : public llarp::vpn::Platform, public llarp::vpn::IRouteManager
+  {
+   protected:
+    std::shared_ptr<llarp::vpn::NetworkInterface>
+    ObtainInterface(llarp::vpn::InterfaceInfo info, llarp::AbstractRouter* router) override;
+
+   public:
+    /// the interface we made with this name if it is still around
+    std::shared_ptr<SimInterface>
+    GetInterface(const std::string& ifname) const;
+
+    llarp::vpn::IRouteManager&
+    RouteManager() override
+    {
+      return *this;
+    }
+
+    void
+    AddRoute(llarp::net::ipaddr_t, llarp::net::ipaddr_t) override
+    {}
+
+    void
+    DelRoute(llarp::net::ipaddr_t, llarp::net::ipaddr_t) override
+    {}
+
+    void
+    AddDefaultRouteViaInterface(llarp::vpn::NetworkInterface&) override
+    {}
+
+    void
+    DelDefaultRouteViaInterface(llarp::vpn::NetworkInterface&) override
+    {}
+
+    void
+    AddRouteViaInterface(llarp::vpn::NetworkInterface&, llarp::IPRange) override
+    {}
+
+    void
+    DelRouteViaInterface(llarp::vpn::NetworkInterface&, llarp::IPRange) override
+    {}
+
+    std::vector<llarp::net::ipaddr_t>
+    GetGatewaysNotOnInterface(llarp::vpn::NetworkInterface&) override
+    {
+      return {};
+    }
+
+   private:
+    mutable std::mutex m_Access;
+    std::unordered_map<std::string, std::weak_ptr<SimInterface>> m_Interfaces;
+  };
+}  // namespace tooling
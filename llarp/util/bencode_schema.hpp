@@ -0,0 +1,279 @@
+#pragma once
+
+#include "bencode.hpp"
+
+#include <chrono>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/// compile time descriptions of bencoded message dicts. a schema binds each dict key to the member
+/// that holds its value, Encode and Decode walk it in a single pass straight over the caller's
+/// buffer without allocating anything themselves.
+namespace llarp::bencode
+{
+  /// when a field is put on the wire
+  enum class Presence
+  {
+    /// always written
+    Always,
+    /// only written when the member is not zero
+    NonZero,
+    /// always written as a fixed integer, whatever the member holds
+    Fixed,
+  };
+
+  /// what decoding does with keys that are not in the schema
+  enum class Unknown
+  {
+    Reject,
+    Skip,
+  };
+
+  /// one dict key bound to the member holding its value
+  template <typename Obj_t, typename Member_t>
+  struct Field
+  {
+    std::string_view key;
+    Member_t Obj_t::*member;
+    Presence presence;
+    uint64_t fixed;
+  };
+
+  template <typename Obj_t, typename Member_t>
+  constexpr Field<Obj_t, Member_t>
+  Entry(std::string_view key, Member_t Obj_t::*member)
+  {
+    return {key, member, Presence::Always, 0};
+  }
+
+  /// an integer or duration that is left out when it is zero
+  template <typename Obj_t, typename Member_t>
+  constexpr Field<Obj_t, Member_t>
+  OptionalEntry(std::string_view key, Member_t Obj_t::*member)
+  {
+    return {key, member, Presence::NonZero, 0};
+  }
+
+  /// an integer that is always sent as value but read back into member
+  template <typename Obj_t, typename Member_t>
+  constexpr Field<Obj_t, Member_t>
+  FixedEntry(std::string_view key, Member_t Obj_t::*member, uint64_t value)
+  {
+    return {key, member, Presence::Fixed, value};
+  }
+
+  /// a message dict: its "A" message type (0 for none), then its fields in the order they are
+  /// written
+  template <typename... Fields_t>
+  struct Schema
+  {
+    char msgType;
+    Unknown unknown;
+    std::tuple<Fields_t...> fields;
+  };
+
+  template <typename... Fields_t>
+  constexpr Schema<Fields_t...>
+  MakeSchema(char msgType, Unknown unknown, Fields_t... fields)
+  {
+    return {msgType, unknown, std::tuple<Fields_t...>{fields...}};
+  }
+
+  namespace detail
+  {
+    template <typename T>
+    struct is_duration : std::false_type
+    {};
+
+    template <typename Rep, typename Period>
+    struct is_duration<std::chrono::duration<Rep, Period>> : std::true_type
+    {};
+
+    template <typename T>
+    struct is_vector : std::false_type
+    {};
+
+    template <typename T, typename Alloc>
+    struct is_vector<std::vector<T, Alloc>> : std::true_type
+    {};
+
+    template <typename T>
+    constexpr bool is_int_v = std::is_integral_v<T> or std::is_enum_v<T> or is_duration<T>::value;
+
+    template <typename T>
+    bool
+    WriteValue(const T& val, llarp_buffer_t* buf)
+    {
+      if constexpr (std::is_enum_v<T>)
+        return bencode_write_uint64(buf, static_cast<std::underlying_type_t<T>>(val));
+      else if constexpr (is_duration<T>::value)
+        return bencode_write_uint64(buf, val.count());
+      else if constexpr (std::is_integral_v<T>)
+        return bencode_write_uint64(buf, val);
+      else if constexpr (is_vector<T>::value)
+        return BEncodeWriteList(val.begin(), val.end(), buf);
+      else
+        return val.BEncode(buf);
+    }
+
+    template <typename T>
+    bool
+    ReadValue(T& val, llarp_buffer_t* buf)
+    {
+      if constexpr (is_int_v<T>)
+      {
+        uint64_t i;
+        if (not bencode_read_integer(buf, &i))
+          return false;
+        val = static_cast<T>(i);
+        return true;
+      }
+      else if constexpr (is_vector<T>::value)
+        return BEncodeReadList(val, buf);
+      else
+        return val.BDecode(buf);
+    }
+
+    template <typename T>
+    bool
+    IsZero(const T& val)
+    {
+      if constexpr (is_int_v<T>)
+        return val == T{};
+      else
+        return false;
+    }
+
+    inline bool
+    WriteKey(std::string_view key, llarp_buffer_t* buf)
+    {
+      return bencode_write_bytestring(buf, key.data(), key.size());
+    }
+
+    template <typename Obj_t, typename Field_t>
+    bool
+    EncodeField(const Field_t& field, const Obj_t& obj, llarp_buffer_t* buf)
+    {
+      const auto& val = obj.*field.member;
+      switch (field.presence)
+      {
+        case Presence::Fixed:
+          return WriteKey(field.key, buf) and bencode_write_uint64(buf, field.fixed);
+        case Presence::NonZero:
+          if (IsZero(val))
+            return true;
+          [[fallthrough]];
+        case Presence::Always:
+          return WriteKey(field.key, buf) and WriteValue(val, buf);
+      }
+      return false;
+    }
+
+    /// true if key is this field's, ok is then set to whether its value decoded
+    template <typename Obj_t, typename Field_t>
+    bool
+    DecodeField(
+        const Field_t& field, Obj_t& obj, std::string_view key, llarp_buffer_t* buf, bool& ok)
+    {
+      if (field.key != key)
+        return false;
+      ok = ReadValue(obj.*field.member, buf);
+      return true;
+    }
+
+    inline std::string_view
+    View(const llarp_buffer_t& buf)
+    {
+      return {reinterpret_cast<const char*>(buf.cur), buf.size_left()};
+    }
+  }  // namespace detail
+
+  /// write obj as a dict, the "A" message type first then every field in schema order
+  template <typename Obj_t, typename... Fields_t>
+  bool
+  Encode(const Schema<Fields_t...>& schema, const Obj_t& obj, llarp_buffer_t* buf)
+  {
+    if (not bencode_start_dict(buf))
+      return false;
+    if (schema.msgType)
+    {
+      if (not(detail::WriteKey("A", buf) and bencode_write_bytestring(buf, &schema.msgType, 1)))
+        return false;
+    }
+    const bool ok = std::apply(
+        [&](const auto&... field) { return (detail::EncodeField(field, obj, buf) and ...); },
+        schema.fields);
+    return ok and bencode_end(buf);
+  }
+
+  /// decode the value for key into the member the schema binds it to, for DecodeKey overrides
+  /// called by parsers that already handled the "A" key themselves
+  template <typename Obj_t, typename... Fields_t>
+  bool
+  DecodeKey(
+      const Schema<Fields_t...>& schema, Obj_t& obj, std::string_view key, llarp_buffer_t* buf)
+  {
+    bool ok = false;
+    const bool known = std::apply(
+        [&](const auto&... field) {
+          return (detail::DecodeField(field, obj, key, buf, ok) or ...);
+        },
+        schema.fields);
+    if (known)
+      return ok;
+    return schema.unknown == Unknown::Skip and bencode_discard(buf);
+  }
+
+  template <typename Obj_t, typename... Fields_t>
+  bool
+  DecodeKey(
+      const Schema<Fields_t...>& schema, Obj_t& obj, const llarp_buffer_t& key, llarp_buffer_t* buf)
+  {
+    return DecodeKey(schema, obj, detail::View(key), buf);
+  }
+
+  /// decode a whole dict into obj in one pass, the "A" message type must match the schema's
+  template <typename Obj_t, typename... Fields_t>
+  bool
+  Decode(const Schema<Fields_t...>& schema, Obj_t& obj, llarp_buffer_t* buf)
+  {
+    if (buf->size_left() < 2 or *buf->cur != 'd')
+      return false;
+    buf->cur++;
+    bool sawType = schema.msgType == 0;
+    while (buf->size_left() and *buf->cur != 'e')
+    {
+      llarp_buffer_t key;
+      if (not bencode_read_string(buf, &key))
+        return false;
+      const auto k = detail::View(key);
+      if (schema.msgType and k == "A")
+      {
+        llarp_buffer_t type;
+        if (not bencode_read_string(buf, &type))
+          return false;
+        if (type.sz != 1 or *type.base != static_cast<byte_t>(schema.msgType))
+          return false;
+        sawType = true;
+        continue;
+      }
+      if (not DecodeKey(schema, obj, k, buf))
+        return false;
+    }
+    if (buf->size_left() == 0)
+      return false;
+    buf->cur++;
+    return sawType;
+  }
+
+  template <typename Obj_t, typename... Fields_t>
+  bool
+  Decode(const Schema<Fields_t...>& schema, Obj_t& obj, std::string_view data)
+  {
+    // only ever read from, the constness goes no further than this buffer
+    llarp_buffer_t buf{const_cast<char*>(data.data()), data.size()};
+    return Decode(schema, obj, &buf);
+  }
+}  // namespace llarp::bencode
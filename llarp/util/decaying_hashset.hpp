@@ -1,12 +1,16 @@
 #pragma once
 
 #include "time.hpp"
+#include <deque>
 #include <unordered_map>
 
 namespace llarp
 {
   namespace util
   {
+    /// values that are forgotten a fixed interval after they went in. Decay only looks at the
+    /// values that are due, oldest first; a value put in with an earlier time than the one
+    /// before it waits for that one.
     template <typename Val_t, typename Hash_t = std::hash<Val_t>>
     struct DecayingHashSet
     {
@@ -35,14 +39,23 @@ namespace llarp
       {
         if (now == 0s)
           now = llarp::time_now_ms();
-        return m_Values.try_emplace(v, now).second;
+        if (not m_Values.try_emplace(v, now).second)
+          return false;
+        m_Order.emplace_back(now, v);
+        return true;
       }
 
       /// upsert will insert or update a value with time as now
       void
       Upsert(const Val_t& v)
       {
-        m_Values[v] = llarp::time_now_ms();
+        const auto now = llarp::time_now_ms();
+        auto& time = m_Values[v];
+        if (time == now)
+          return;
+        // the entry it had in m_Order is skipped once it comes up
+        time = now;
+        m_Order.emplace_back(now, v);
       }
 
       /// decay hashset entries
@@ -51,7 +64,14 @@ namespace llarp
       {
         if (now == 0s)
           now = llarp::time_now_ms();
-        EraseIf([&](const auto& item) { return (m_CacheInterval + item.second) <= now; });
+        while (not m_Order.empty() and m_Order.front().first + m_CacheInterval <= now)
+        {
+          const auto& [time, val] = m_Order.front();
+          // removed, or put in again since this entry was made
+          if (auto itr = m_Values.find(val); itr != m_Values.end() and itr->second == time)
+            m_Values.erase(itr);
+          m_Order.pop_front();
+        }
       }
 
       Time_t
@@ -72,6 +92,7 @@ namespace llarp
         m_CacheInterval = interval;
       }
 
+      /// its entry in m_Order ages out with the others
       void
       Remove(const Val_t& val)
       {
@@ -79,25 +100,10 @@ namespace llarp
       }
 
      private:
-      template <typename Predicate_t>
-      void
-      EraseIf(Predicate_t pred)
-      {
-        for (auto i = m_Values.begin(), last = m_Values.end(); i != last;)
-        {
-          if (pred(*i))
-          {
-            i = m_Values.erase(i);
-          }
-          else
-          {
-            ++i;
-          }
-        }
-      }
-
       Time_t m_CacheInterval;
       std::unordered_map<Val_t, Time_t, Hash_t> m_Values;
+      /// every value with the time it went in, oldest first
+      std::deque<std::pair<Time_t, Val_t>> m_Order;
     };
   }  // namespace util
 }  // namespace llarp
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "time.hpp"
+#include <deque>
 #include <unordered_map>
 
 namespace llarp::util
 {
+  /// a cache that forgets entries a fixed interval after they went in, oldest first like
+  /// DecayingHashSet
   template <typename Key_t, typename Value_t, typename Hash_t = std::hash<Key_t>>
   struct DecayingHashTable
   {
@@ -14,7 +17,14 @@ namespace llarp::util
     void
     Decay(llarp_time_t now)
     {
-      EraseIf([&](const auto& item) { return item.second.second + m_CacheInterval <= now; });
+      while (not m_Order.empty() and m_Order.front().first + m_CacheInterval <= now)
+      {
+        const auto& [time, key] = m_Order.front();
+        // removed, or put in again since this entry was made
+        if (auto itr = m_Values.find(key); itr != m_Values.end() and itr->second.second == time)
+          m_Values.erase(itr);
+        m_Order.pop_front();
+      }
     }
 
     /// return if we have this value by key
@@ -31,7 +41,10 @@ namespace llarp::util
     {
       if (now == 0s)
         now = llarp::time_now_ms();
-      return m_Values.try_emplace(std::move(key), std::make_pair(std::move(value), now)).second;
+      const bool inserted = m_Values.try_emplace(key, std::make_pair(std::move(value), now)).second;
+      if (inserted)
+        m_Order.emplace_back(now, std::move(key));
+      return inserted;
     }
 
     /// get value by key
@@ -52,24 +65,9 @@ namespace llarp::util
     }
 
    private:
-    template <typename Predicate_t>
-    void
-    EraseIf(Predicate_t pred)
-    {
-      for (auto i = m_Values.begin(), last = m_Values.end(); i != last;)
-      {
-        if (pred(*i))
-        {
-          i = m_Values.erase(i);
-        }
-        else
-        {
-          ++i;
-        }
-      }
-    }
-
     llarp_time_t m_CacheInterval;
     std::unordered_map<Key_t, std::pair<Value_t, llarp_time_t>, Hash_t> m_Values;
+    /// every key with the time it went in, oldest first
+    std::deque<std::pair<llarp_time_t, Key_t>> m_Order;
   };
 }  // namespace llarp::util
@@ -0,0 +1,60 @@
+#include "metrics.hpp"
+
+namespace llarp::metrics
+{
+  size_t
+  ThreadCell()
+  {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t cell = next.fetch_add(1, std::memory_order_relaxed) % NumCounterCells;
+    return cell;
+  }
+
+  void
+  Registry::Register(std::string_view name, std::string_view help, const Counter& counter)
+  {
+    m_Entries.push_back(Entry{name, help, Type::counter, &counter});
+  }
+
+  void
+  Registry::Register(std::string_view name, std::string_view help, const Gauge& gauge)
+  {
+    m_Entries.push_back(Entry{name, help, Type::gauge, &gauge});
+  }
+
+  void
+  Registry::Visit(
+      std::function<void(std::string_view, std::string_view, Type, int64_t)> visit) const
+  {
+    for (const auto& entry : m_Entries)
+    {
+      const int64_t value = entry.type == Type::counter
+          ? static_cast<int64_t>(static_cast<const Counter*>(entry.metric)->Value())
+          : static_cast<const Gauge*>(entry.metric)->Value();
+      visit(entry.name, entry.help, entry.type, value);
+    }
+  }
+
+  util::StatusObject
+  Registry::Snapshot() const
+  {
+    util::StatusObject obj = util::StatusObject::object();
+    Visit([&obj](auto name, auto, auto, int64_t value) { obj[std::string{name}] = value; });
+    return obj;
+  }
+
+  std::string
+  Registry::PrometheusText(std::string_view prefix) const
+  {
+    std::string text;
+    Visit([&text, prefix](auto name, auto help, Type type, int64_t value) {
+      std::string full{prefix};
+      full += name;
+      text += "# HELP " + full + " ";
+      text += help;
+      text += "\n# TYPE " + full + (type == Type::counter ? " counter\n" : " gauge\n");
+      text += full + " " + std::to_string(value) + "\n";
+    });
+    return text;
+  }
+}  // namespace llarp::metrics
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "status.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace llarp::metrics
+{
+  /// number of cells a counter is split over, threads are spread across them so hot counters
+  /// bumped from many threads do not bounce one cache line around
+  constexpr size_t NumCounterCells = 16;
+
+  /// the counter cell the calling thread writes to
+  size_t
+  ThreadCell();
+
+  /// monotonically increasing counter, cheap to bump from any thread
+  class Counter
+  {
+    struct alignas(64) Cell
+    {
+      std::atomic<uint64_t> value{0};
+    };
+
+    std::array<Cell, NumCounterCells> m_Cells;
+
+   public:
+    void
+    Add(uint64_t n = 1)
+    {
+      m_Cells[ThreadCell()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// sum of all cells, may miss adds that race with it
+    uint64_t
+    Value() const
+    {
+      uint64_t sum = 0;
+      for (const auto& cell : m_Cells)
+        sum += cell.value.load(std::memory_order_relaxed);
+      return sum;
+    }
+  };
+
+  /// value that can go up and down, usually set from one place on tick
+  class Gauge
+  {
+    alignas(64) std::atomic<int64_t> m_Value{0};
+
+   public:
+    void
+    Set(int64_t val)
+    {
+      m_Value.store(val, std::memory_order_relaxed);
+    }
+
+    void
+    Add(int64_t n)
+    {
+      m_Value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    int64_t
+    Value() const
+    {
+      return m_Value.load(std::memory_order_relaxed);
+    }
+  };
+
+  /// a set of named metrics that can be read without touching the objects they describe.
+  /// metrics are registered once up front and are not owned by the registry, after
+  /// registration reading a snapshot takes no locks and allocates only for the output.
+  class Registry
+  {
+   public:
+    enum class Type
+    {
+      counter,
+      gauge
+    };
+
+    void
+    Register(std::string_view name, std::string_view help, const Counter& counter);
+
+    void
+    Register(std::string_view name, std::string_view help, const Gauge& gauge);
+
+    /// call visit(name, help, type, value) for every registered metric
+    void
+    Visit(std::function<void(std::string_view, std::string_view, Type, int64_t)> visit) const;
+
+    /// flat {name: value} object of every metric
+    util::StatusObject
+    Snapshot() const;
+
+    /// every metric in the prometheus text exposition format, each name prefixed with prefix
+    std::string
+    PrometheusText(std::string_view prefix = "lokinet_") const;
+
+   private:
+    struct Entry
+    {
+      std::string_view name;
+      std::string_view help;
+      Type type;
+      const void* metric;
+    };
+
+    std::vector<Entry> m_Entries;
+  };
+}  // namespace llarp::metrics
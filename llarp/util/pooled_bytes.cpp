@@ -0,0 +1,95 @@
+#include "pooled_bytes.hpp"
+
+#include "thread/block_pool.hpp"
+
+#include <stdexcept>
+
+namespace llarp
+{
+  namespace util
+  {
+    namespace
+    {
+      template <size_t BlockSize>
+      struct SizeClass : thread::BlockPool<BlockSize>
+      {
+        SizeClass() : thread::BlockPool<BlockSize>{PooledBytes::SpareBytesPerClass / BlockSize}
+        {}
+      };
+
+      struct SizeClasses
+      {
+        SizeClass<256> c256;
+        SizeClass<512> c512;
+        SizeClass<1024> c1k;
+        SizeClass<2048> c2k;
+        SizeClass<4096> c4k;
+        SizeClass<PooledBytes::MaxSize> cMax;
+
+        /// call f with the pool of the smallest class that holds sz bytes
+        template <typename Func_t>
+        void
+        Visit(size_t sz, Func_t&& f)
+        {
+          if (sz <= 256)
+            f(c256);
+          else if (sz <= 512)
+            f(c512);
+          else if (sz <= 1024)
+            f(c1k);
+          else if (sz <= 2048)
+            f(c2k);
+          else if (sz <= 4096)
+            f(c4k);
+          else if (sz <= PooledBytes::MaxSize)
+            f(cMax);
+          else
+            throw std::length_error{"payload larger than PooledBytes::MaxSize"};
+        }
+      };
+
+      static_assert(PooledBytes::MinSize == 256 and PooledBytes::MaxSize > 4096);
+
+      SizeClasses&
+      Classes()
+      {
+        // never destroyed: payloads with static storage duration may give their blocks back
+        // after exit has started tearing down statics
+        static auto* classes = new SizeClasses{};
+        return *classes;
+      }
+    }  // namespace
+
+    PooledBytes::PooledBytes(size_t sz)
+    {
+      Classes().Visit(sz, [this](auto& pool) {
+        auto block = pool.Take();
+        m_Capacity = block->size();
+        m_Data = block.release()->data();
+      });
+    }
+
+    void
+    PooledBytes::Release()
+    {
+      if (not m_Data)
+        return;
+      Classes().Visit(m_Capacity, [this](auto& pool) {
+        using Pool_t = typename std::decay_t<decltype(pool)>::BlockPool;
+        // dropping the handle puts the block back on its pool
+        typename Pool_t::Ptr_t{
+            reinterpret_cast<typename Pool_t::Block_t*>(m_Data), typename Pool_t::Return{&pool}};
+      });
+      m_Data = nullptr;
+      m_Capacity = 0;
+    }
+
+    size_t
+    PooledBytes::NumSpare(size_t sz)
+    {
+      size_t spare = 0;
+      Classes().Visit(sz, [&spare](auto& pool) { spare = pool.NumSpare(); });
+      return spare;
+    }
+  }  // namespace util
+}  // namespace llarp
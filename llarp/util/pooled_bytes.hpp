@@ -0,0 +1,88 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <llarp/constants/link_layer.hpp>
+
+#include <cstddef>
+#include <utility>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// heap storage for payloads whose size is only known at runtime.
+    /// blocks come in power of two size classes from MinSize to MaxSize and are recycled through
+    /// a lock-free pool per class, so code that keeps replacing payloads (relaying path traffic)
+    /// reuses blocks instead of going to the allocator for each one. each pool keeps at most
+    /// SpareBytesPerClass bytes of spare blocks, the rest go back to the allocator.
+    class PooledBytes
+    {
+     public:
+      static constexpr size_t MinSize = 256;
+      static constexpr size_t MaxSize = MAX_LINK_MSG_SIZE;
+      static constexpr size_t SpareBytesPerClass = 512 * 1024;
+
+      PooledBytes() = default;
+
+      /// take a block of at least sz bytes, sz must be at most MaxSize.
+      /// its contents are unspecified.
+      explicit PooledBytes(size_t sz);
+
+      PooledBytes(PooledBytes&& other) noexcept
+          : m_Data{std::exchange(other.m_Data, nullptr)}
+          , m_Capacity{std::exchange(other.m_Capacity, 0)}
+      {}
+
+      PooledBytes&
+      operator=(PooledBytes&& other) noexcept
+      {
+        if (this != &other)
+        {
+          Release();
+          m_Data = std::exchange(other.m_Data, nullptr);
+          m_Capacity = std::exchange(other.m_Capacity, 0);
+        }
+        return *this;
+      }
+
+      PooledBytes(const PooledBytes&) = delete;
+      PooledBytes&
+      operator=(const PooledBytes&) = delete;
+
+      ~PooledBytes()
+      {
+        Release();
+      }
+
+      byte_t*
+      data() const
+      {
+        return m_Data;
+      }
+
+      size_t
+      capacity() const
+      {
+        return m_Capacity;
+      }
+
+      explicit operator bool() const
+      {
+        return m_Data != nullptr;
+      }
+
+      /// number of spare blocks pooled in the size class sz falls in
+      static size_t
+      NumSpare(size_t sz);
+
+     private:
+      /// give the block back to its pool
+      void
+      Release();
+
+      byte_t* m_Data = nullptr;
+      size_t m_Capacity = 0;
+    };
+  }  // namespace util
+}  // namespace llarp
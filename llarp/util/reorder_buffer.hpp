@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// bounded reorder window for a single sequenced stream.
+    /// items that arrive in sequence are handed to the visitor immediately, items that arrive
+    /// ahead of sequence are held until the gap before them is filled, the window overflows or
+    /// the gap has been open for longer than the gap timeout, at which point the gap is skipped.
+    /// items that arrive behind sequence (late or duplicate) are handed off immediately.
+    template <typename Val_t>
+    struct ReorderBuffer
+    {
+      using Time_t = std::chrono::milliseconds;
+      using Seq_t = uint64_t;
+
+      explicit ReorderBuffer(size_t window = 64, Time_t gapTimeout = Time_t{100})
+          : m_Window{window ? window : 1}, m_GapTimeout{gapTimeout}
+      {}
+
+      /// put an item with sequence number seqno, calls visit(Val_t) for every item that is
+      /// ready to be handed off, in sequence order
+      template <typename Visit_t>
+      void
+      Put(Seq_t seqno, Val_t val, Time_t now, Visit_t&& visit)
+      {
+        m_LastActivity = now;
+        if (not m_Next)
+          m_Next = seqno;
+        if (seqno == *m_Next)
+        {
+          visit(std::move(val));
+          ++*m_Next;
+          Drain(visit);
+          return;
+        }
+        if (seqno < *m_Next)
+        {
+          if (*m_Next - seqno > m_Window)
+          {
+            // remote restarted its sequence, hand off everything we are holding and resync
+            SkipTo(*m_Next + m_Window, visit);
+            m_Next = seqno + 1;
+          }
+          visit(std::move(val));
+          return;
+        }
+        if (seqno - *m_Next >= m_Window)
+        {
+          // too far ahead to hold, give up on enough of the gap to make room
+          SkipTo(seqno - m_Window + 1, visit);
+          if (seqno == *m_Next)
+          {
+            visit(std::move(val));
+            ++*m_Next;
+            Drain(visit);
+            return;
+          }
+        }
+        if (m_Slots.empty())
+          m_Slots.resize(m_Window);
+        auto& slot = m_Slots[seqno % m_Window];
+        if (slot)
+          return;  // duplicate of an item we are already holding
+        slot.emplace(seqno, std::move(val));
+        if (m_Held++ == 0)
+          m_GapStarted = now;
+      }
+
+      /// skip over a gap that has been open for longer than the gap timeout, calls visit(Val_t)
+      /// for every item that was released
+      template <typename Visit_t>
+      void
+      Expire(Time_t now, Visit_t&& visit)
+      {
+        if (m_Held == 0 or now < m_GapStarted + m_GapTimeout)
+          return;
+        for (Seq_t seqno = *m_Next; seqno < *m_Next + m_Window; ++seqno)
+        {
+          if (m_Slots[seqno % m_Window])
+          {
+            SkipTo(seqno, visit);
+            break;
+          }
+        }
+        if (m_Held)
+          m_GapStarted = now;
+      }
+
+      /// return true if we are holding items back waiting for a gap to fill
+      bool
+      HasGap() const
+      {
+        return m_Held > 0;
+      }
+
+      /// number of items held back
+      size_t
+      Held() const
+      {
+        return m_Held;
+      }
+
+      /// the last time we had an item put into us
+      Time_t
+      LastActivity() const
+      {
+        return m_LastActivity;
+      }
+
+     private:
+      /// release all held items with a sequence number before target in order and move the
+      /// window to start at target
+      template <typename Visit_t>
+      void
+      SkipTo(Seq_t target, Visit_t&& visit)
+      {
+        const Seq_t last = std::min(target, *m_Next + m_Window);
+        for (Seq_t seqno = *m_Next; m_Held and seqno < last; ++seqno)
+          Release(seqno, visit);
+        m_Next = target;
+        Drain(visit);
+      }
+
+      template <typename Visit_t>
+      void
+      Drain(Visit_t&& visit)
+      {
+        while (m_Held and Release(*m_Next, visit))
+          ++*m_Next;
+      }
+
+      template <typename Visit_t>
+      bool
+      Release(Seq_t seqno, Visit_t&& visit)
+      {
+        auto& slot = m_Slots[seqno % m_Window];
+        if (not slot or slot->first != seqno)
+          return false;
+        auto val = std::move(slot->second);
+        slot.reset();
+        --m_Held;
+        visit(std::move(val));
+        return true;
+      }
+
+      const size_t m_Window;
+      const Time_t m_GapTimeout;
+      std::optional<Seq_t> m_Next;
+      std::vector<std::optional<std::pair<Seq_t, Val_t>>> m_Slots;
+      size_t m_Held = 0;
+      Time_t m_GapStarted{0};
+      Time_t m_LastActivity{0};
+    };
+  }  // namespace util
+}  // namespace llarp
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// single threaded fifo queue over one flat ring of storage.
+    /// storage grows by doubling when full and is kept when the queue drains, so a queue that
+    /// has reached its working size does not allocate on push or pop.
+    template <typename Val_t>
+    struct RingQueue
+    {
+      explicit RingQueue(size_t initialCapacity = 8)
+          : m_Initial{initialCapacity ? initialCapacity : 1}
+      {}
+
+      bool
+      empty() const
+      {
+        return m_Size == 0;
+      }
+
+      size_t
+      size() const
+      {
+        return m_Size;
+      }
+
+      size_t
+      capacity() const
+      {
+        return m_Slots.size();
+      }
+
+      Val_t&
+      front()
+      {
+        return m_Slots[m_Head];
+      }
+
+      const Val_t&
+      front() const
+      {
+        return m_Slots[m_Head];
+      }
+
+      void
+      push_back(Val_t val)
+      {
+        if (m_Size == m_Slots.size())
+          Grow();
+        m_Slots[(m_Head + m_Size) % m_Slots.size()] = std::move(val);
+        ++m_Size;
+      }
+
+      /// pop the front element, resetting its slot so it releases what it holds
+      void
+      pop_front()
+      {
+        m_Slots[m_Head] = Val_t{};
+        m_Head = (m_Head + 1) % m_Slots.size();
+        --m_Size;
+      }
+
+      void
+      clear()
+      {
+        while (not empty())
+          pop_front();
+        m_Head = 0;
+      }
+
+      void
+      swap(RingQueue& other)
+      {
+        std::swap(m_Slots, other.m_Slots);
+        std::swap(m_Head, other.m_Head);
+        std::swap(m_Size, other.m_Size);
+      }
+
+     private:
+      void
+      Grow()
+      {
+        std::vector<Val_t> slots(m_Slots.empty() ? m_Initial : m_Slots.size() * 2);
+        for (size_t idx = 0; idx < m_Size; ++idx)
+          slots[idx] = std::move(m_Slots[(m_Head + idx) % m_Slots.size()]);
+        m_Slots = std::move(slots);
+        m_Head = 0;
+      }
+
+      size_t m_Initial;
+      std::vector<Val_t> m_Slots;
+      size_t m_Head = 0;
+      size_t m_Size = 0;
+    };
+  }  // namespace util
+}  // namespace llarp
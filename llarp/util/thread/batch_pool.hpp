@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// recycles vectors used to hand batches of large objects from one thread to another.
+    /// the thread filling a batch takes a vector, whoever is done with it gives it back, and the
+    /// storage is reused by the next batch instead of being allocated (and page faulted in) again.
+    /// only so many spare vectors are kept, and vectors that grew past maxCapacity are freed, so
+    /// a burst of traffic does not pin its memory forever.
+    template <typename Type>
+    class BatchPool
+    {
+     public:
+      using Batch_t = std::vector<Type>;
+
+      BatchPool(size_t maxSpare, size_t maxCapacity)
+          : m_MaxSpare{maxSpare}, m_MaxCapacity{maxCapacity}
+      {}
+
+      BatchPool(const BatchPool&) = delete;
+      BatchPool&
+      operator=(const BatchPool&) = delete;
+
+      /// get an empty batch, reusing the storage of one given back earlier if we have any
+      Batch_t
+      Take()
+      {
+        std::lock_guard lock{m_Access};
+        if (m_Spare.empty())
+          return Batch_t{};
+        auto batch = std::move(m_Spare.back());
+        m_Spare.pop_back();
+        return batch;
+      }
+
+      /// give back a batch once done with it, its elements are destroyed
+      void
+      Give(Batch_t batch)
+      {
+        if (batch.capacity() == 0 or batch.capacity() > m_MaxCapacity)
+          return;
+        batch.clear();
+        std::lock_guard lock{m_Access};
+        if (m_Spare.size() < m_MaxSpare)
+          m_Spare.emplace_back(std::move(batch));
+      }
+
+      /// number of spare batches held
+      size_t
+      NumSpare() const
+      {
+        std::lock_guard lock{m_Access};
+        return m_Spare.size();
+      }
+
+     private:
+      const size_t m_MaxSpare;
+      const size_t m_MaxCapacity;
+      mutable std::mutex m_Access;
+      std::vector<Batch_t> m_Spare;
+    };
+  }  // namespace thread
+}  // namespace llarp
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// recycles fixed size blocks of bytes between threads without taking a lock.
+    /// any thread may take a block and any thread may drop one; a dropped block goes back on a
+    /// bounded lock-free ring of spares for the next Take() instead of to the allocator. only
+    /// maxSpare blocks are kept, the rest are freed, so a burst does not pin its memory forever.
+    /// blocks must not outlive the pool they came from.
+    template <size_t BlockSize>
+    class BlockPool
+    {
+     public:
+      using Block_t = std::array<uint8_t, BlockSize>;
+
+      /// gives a block back to its pool when dropped
+      struct Return
+      {
+        BlockPool* pool = nullptr;
+
+        void
+        operator()(Block_t* block) const
+        {
+          pool->Give(block);
+        }
+      };
+
+      using Ptr_t = std::unique_ptr<Block_t, Return>;
+
+      /// maxSpare is rounded up to a power of 2
+      explicit BlockPool(size_t maxSpare)
+          : m_Mask{RoundUpCapacity(maxSpare) - 1}, m_Slots{new Slot[m_Mask + 1]}
+      {
+        for (size_t idx = 0; idx <= m_Mask; ++idx)
+          m_Slots[idx].seq.store(idx, std::memory_order_relaxed);
+      }
+
+      BlockPool(const BlockPool&) = delete;
+      BlockPool&
+      operator=(const BlockPool&) = delete;
+
+      ~BlockPool()
+      {
+        while (auto block = TryTakeSpare())
+          delete block;
+      }
+
+      /// get a block, reusing a spare one if we have any. its contents are unspecified.
+      Ptr_t
+      Take()
+      {
+        auto block = TryTakeSpare();
+        if (block == nullptr)
+          block = new Block_t;
+        return Ptr_t{block, Return{this}};
+      }
+
+      /// approximate number of spare blocks held
+      size_t
+      NumSpare() const
+      {
+        const auto tail = m_Tail.load(std::memory_order_relaxed);
+        const auto head = m_Head.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+      }
+
+     private:
+      struct Slot
+      {
+        std::atomic<size_t> seq;
+        Block_t* block = nullptr;
+      };
+
+      static size_t
+      RoundUpCapacity(size_t capacity)
+      {
+        size_t sz = 2;
+        while (sz < capacity)
+          sz <<= 1;
+        return sz;
+      }
+
+      /// the same per slot sequence scheme as MPSCRing, with the head claimed by compare and
+      /// swap as well since blocks are taken from any thread
+      void
+      Give(Block_t* block)
+      {
+        size_t pos = m_Tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+          slot = &m_Slots[pos & m_Mask];
+          const size_t seq = slot->seq.load(std::memory_order_acquire);
+          const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+          if (diff == 0)
+          {
+            if (m_Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+          else if (diff < 0)
+          {
+            // enough spares already
+            delete block;
+            return;
+          }
+          else
+            pos = m_Tail.load(std::memory_order_relaxed);
+        }
+        slot->block = block;
+        slot->seq.store(pos + 1, std::memory_order_release);
+      }
+
+      Block_t*
+      TryTakeSpare()
+      {
+        size_t pos = m_Head.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+          slot = &m_Slots[pos & m_Mask];
+          const size_t seq = slot->seq.load(std::memory_order_acquire);
+          const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+          if (diff == 0)
+          {
+            if (m_Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+          else if (diff < 0)
+            return nullptr;
+          else
+            pos = m_Head.load(std::memory_order_relaxed);
+        }
+        auto block = slot->block;
+        slot->seq.store(pos + m_Mask + 1, std::memory_order_release);
+        return block;
+      }
+
+      const size_t m_Mask;
+      std::unique_ptr<Slot[]> m_Slots;
+
+      alignas(64) std::atomic<size_t> m_Tail{0};
+      alignas(64) std::atomic<size_t> m_Head{0};
+    };
+  }  // namespace thread
+}  // namespace llarp
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// bounded lock-free multi producer, single consumer ring.
+    /// any number of threads may call tryPushBack concurrently, only one thread may pop.
+    /// producers never block: when the ring is full tryPushBack fails and the caller decides what
+    /// to drop. each slot carries a sequence number telling whether it is free for the producer
+    /// that claimed its position or holds a value ready for the consumer.
+    template <typename Type>
+    class MPSCRing
+    {
+      struct Slot
+      {
+        std::atomic<size_t> seq;
+        std::optional<Type> value;
+      };
+
+      static size_t
+      RoundUpCapacity(size_t capacity)
+      {
+        size_t sz = 2;
+        while (sz < capacity)
+          sz <<= 1;
+        return sz;
+      }
+
+      const size_t m_Mask;
+      std::unique_ptr<Slot[]> m_Slots;
+
+      // producers and the consumer each get their own cache line
+      alignas(64) std::atomic<size_t> m_Tail{0};
+      alignas(64) std::atomic<size_t> m_Head{0};
+
+     public:
+      /// capacity is rounded up to a power of 2
+      explicit MPSCRing(size_t capacity)
+          : m_Mask{RoundUpCapacity(capacity) - 1}, m_Slots{new Slot[m_Mask + 1]}
+      {
+        for (size_t idx = 0; idx <= m_Mask; ++idx)
+          m_Slots[idx].seq.store(idx, std::memory_order_relaxed);
+      }
+
+      MPSCRing(const MPSCRing&) = delete;
+      MPSCRing&
+      operator=(const MPSCRing&) = delete;
+
+      size_t
+      capacity() const
+      {
+        return m_Mask + 1;
+      }
+
+      /// approximate number of values in the ring
+      size_t
+      size() const
+      {
+        const auto tail = m_Tail.load(std::memory_order_relaxed);
+        const auto head = m_Head.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+      }
+
+      bool
+      empty() const
+      {
+        return size() == 0;
+      }
+
+      /// push a value from any thread, return false without touching val if the ring is full
+      bool
+      tryPushBack(Type&& val)
+      {
+        size_t pos = m_Tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+          slot = &m_Slots[pos & m_Mask];
+          const size_t seq = slot->seq.load(std::memory_order_acquire);
+          const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+          if (diff == 0)
+          {
+            // slot is free for this position, try to claim it
+            if (m_Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+          else if (diff < 0)
+          {
+            // the consumer has not freed this slot yet, we are full
+            return false;
+          }
+          else
+          {
+            // another producer claimed this position, retry with the current tail
+            pos = m_Tail.load(std::memory_order_relaxed);
+          }
+        }
+        slot->value.emplace(std::move(val));
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// pop a value, consumer thread only
+      std::optional<Type>
+      tryPopFront()
+      {
+        std::optional<Type> val;
+        const size_t pos = m_Head.load(std::memory_order_relaxed);
+        Slot& slot = m_Slots[pos & m_Mask];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+          return val;
+        val.emplace(std::move(*slot.value));
+        slot.value.reset();
+        // free the slot for the producer that wraps around to it
+        slot.seq.store(pos + m_Mask + 1, std::memory_order_release);
+        m_Head.store(pos + 1, std::memory_order_relaxed);
+        return val;
+      }
+
+      /// pop up to max values in one pass calling visit(Type) on each, consumer thread only
+      /// returns how many values were visited
+      template <typename Visit_t>
+      size_t
+      popBatch(Visit_t&& visit, size_t max)
+      {
+        size_t pos = m_Head.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (count < max)
+        {
+          Slot& slot = m_Slots[pos & m_Mask];
+          if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+            break;
+          Type val{std::move(*slot.value)};
+          slot.value.reset();
+          slot.seq.store(pos + m_Mask + 1, std::memory_order_release);
+          ++pos;
+          ++count;
+          // publish progress before visiting so size() stays accurate and a throwing visitor
+          // leaves the ring consistent
+          m_Head.store(pos, std::memory_order_relaxed);
+          visit(std::move(val));
+        }
+        return count;
+      }
+    };
+  }  // namespace thread
+}  // namespace llarp
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace thread
+  {
+    /// holds an immutable snapshot of read mostly data that is replaced wholesale.
+    /// readers take a Reader, which pins the snapshot with one atomic increment on a counter
+    /// stripe and no locks; threads get their own stripe until there are more than NumStripes of
+    /// them, after which some share one. writers serialize between themselves and never wait
+    /// on readers: a replaced snapshot goes on a retired list and is freed by a later publish
+    /// once no reader can still have it.
+    ///
+    /// the counters are split by epoch. each publish flips the epoch so new readers count
+    /// against the other half, letting the half older readers are in drain while reads carry on.
+    /// a retired snapshot is freed once each half has been seen empty since it was retired, so
+    /// with steady reads that is by the second publish after its last reader let go. the cost is
+    /// memory: every retired snapshot stays allocated until then, and a Reader held across
+    /// publishes keeps all of the snapshots retired meanwhile alive until it lets go.
+    template <typename Type>
+    class RCUSnapshot
+    {
+      static constexpr size_t NumStripes = 16;
+
+      struct alignas(64) Counter
+      {
+        std::atomic<size_t> readers{0};
+      };
+
+     public:
+      /// a pinned snapshot, valid for as long as this is alive
+      class Reader
+      {
+       public:
+        Reader(Reader&& other) noexcept
+            : m_Count{std::exchange(other.m_Count, nullptr)}, m_Snapshot{other.m_Snapshot}
+        {}
+
+        Reader(const Reader&) = delete;
+        Reader&
+        operator=(const Reader&) = delete;
+        Reader&
+        operator=(Reader&&) = delete;
+
+        ~Reader()
+        {
+          if (m_Count)
+            m_Count->fetch_sub(1, std::memory_order_release);
+        }
+
+        const Type*
+        get() const
+        {
+          return m_Snapshot;
+        }
+
+        const Type*
+        operator->() const
+        {
+          return m_Snapshot;
+        }
+
+        const Type&
+        operator*() const
+        {
+          return *m_Snapshot;
+        }
+
+       private:
+        friend class RCUSnapshot;
+
+        Reader(std::atomic<size_t>* count, const Type* snapshot)
+            : m_Count{count}, m_Snapshot{snapshot}
+        {}
+
+        std::atomic<size_t>* m_Count;
+        const Type* m_Snapshot;
+      };
+
+      explicit RCUSnapshot(std::unique_ptr<const Type> initial = std::make_unique<const Type>())
+          : m_Owned{std::move(initial)}
+      {
+        m_Current.store(m_Owned.get());
+      }
+
+      RCUSnapshot(const RCUSnapshot&) = delete;
+      RCUSnapshot&
+      operator=(const RCUSnapshot&) = delete;
+
+      /// pin the current snapshot. while the Reader is alive neither its snapshot nor any
+      /// published after it and replaced since can be freed, so hold it for the lookup or copy
+      /// only and never across blocking work such as disk or network io.
+      Reader
+      Read() const
+      {
+        auto& count = m_Counters[m_Epoch.load(std::memory_order_relaxed) & 1][Stripe()].readers;
+        // the increment has to land before we load the snapshot, and a writer loads the
+        // counters after it swapped the snapshot out; both sides seq_cst so they cannot cross
+        count.fetch_add(1);
+        return Reader{&count, m_Current.load()};
+      }
+
+      /// pin the current snapshot for the rest of the full expression
+      Reader
+      operator->() const
+      {
+        return Read();
+      }
+
+      /// publish a new snapshot, the old one is freed by a later publish once no reader has it
+      void
+      Store(std::unique_ptr<const Type> next)
+      {
+        std::lock_guard lock{m_WriteMutex};
+        Publish(std::move(next));
+      }
+
+      /// publish a modified copy of the current snapshot, modify is called with a Type& copy.
+      /// copies the whole snapshot, only for writes that are rare next to reads.
+      template <typename Modify_t>
+      void
+      Update(Modify_t&& modify)
+      {
+        std::lock_guard lock{m_WriteMutex};
+        auto next = std::make_unique<Type>(*m_Owned);
+        modify(*next);
+        Publish(std::move(next));
+      }
+
+     private:
+      /// which counter stripe this thread pins through
+      static size_t
+      Stripe()
+      {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+        return stripe % NumStripes;
+      }
+
+      size_t
+      NumReaders(size_t half) const
+      {
+        size_t total = 0;
+        for (const auto& counter : m_Counters[half])
+          total += counter.readers.load();
+        return total;
+      }
+
+      void
+      Publish(std::unique_ptr<const Type> next)
+      {
+        m_Current.store(next.get());
+        m_Retired.push_back(Retired{std::exchange(m_Owned, std::move(next))});
+        m_Epoch.fetch_add(1);
+        Reclaim();
+      }
+
+      /// free the retired snapshots no reader can still have. a reader that got one pinned its
+      /// counter before loading it, and we load the counters after swapping it out, so a half
+      /// seen empty since then no longer holds any of its readers
+      void
+      Reclaim()
+      {
+        for (size_t half = 0; half < 2; ++half)
+        {
+          if (NumReaders(half) > 0)
+            continue;
+          for (auto& retired : m_Retired)
+            retired.drained[half] = true;
+        }
+        m_Retired.erase(
+            std::remove_if(
+                m_Retired.begin(),
+                m_Retired.end(),
+                [](const auto& retired) { return retired.drained[0] and retired.drained[1]; }),
+            m_Retired.end());
+      }
+
+      struct Retired
+      {
+        std::unique_ptr<const Type> snapshot;
+        /// which halves of the counters have been seen empty since this was retired
+        std::array<bool, 2> drained{};
+      };
+
+      std::atomic<const Type*> m_Current;
+      std::atomic<size_t> m_Epoch{0};
+      mutable std::array<std::array<Counter, NumStripes>, 2> m_Counters;
+      // serializes writers, protects m_Owned and m_Retired
+      std::mutex m_WriteMutex;
+      std::unique_ptr<const Type> m_Owned;
+      std::vector<Retired> m_Retired;
+    };
+  }  // namespace thread
+}  // namespace llarp
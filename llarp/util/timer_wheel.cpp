@@ -0,0 +1,188 @@
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+
+namespace llarp::util
+{
+  namespace
+  {
+    constexpr uint64_t Mask = TimerWheel::NumSlots - 1;
+    /// ticks the top level reaches
+    constexpr uint64_t Span = uint64_t{1} << (TimerWheel::SlotBits * TimerWheel::NumLevels);
+
+    constexpr size_t
+    Shift(size_t level)
+    {
+      return TimerWheel::SlotBits * level;
+    }
+  }  // namespace
+
+  TimerWheel::TimerWheel(llarp_time_t resolution, llarp_time_t now)
+      : m_Resolution{static_cast<uint64_t>(std::max<int64_t>(resolution.count(), 1))}
+      , m_Tick{static_cast<uint64_t>(now.count()) / m_Resolution}
+  {}
+
+  bool
+  TimerWheel::Schedule(ID_t id, llarp_time_t at, Callback_t f)
+  {
+    // the first tick at or after at
+    const uint64_t due = (static_cast<uint64_t>(at.count()) + m_Resolution - 1) / m_Resolution;
+    auto [itr, inserted] = m_Timers.try_emplace(id, Timer{due, std::move(f)});
+    if (not inserted)
+      return false;
+    Place(id, itr->second);
+    return true;
+  }
+
+  bool
+  TimerWheel::Cancel(ID_t id)
+  {
+    auto itr = m_Timers.find(id);
+    if (itr == m_Timers.end())
+      return false;
+    Unlink(id, itr->second);
+    m_Timers.erase(itr);
+    return true;
+  }
+
+  void
+  TimerWheel::Place(ID_t id, Timer& timer)
+  {
+    // never behind us, and parked at the edge of what the top level reaches when it is further
+    // out than that, Fire places it again from there
+    const uint64_t at = std::clamp(timer.due, m_Tick + 1, m_Tick + Span - 1);
+    size_t level = 0;
+    while (level + 1 < NumLevels and (at >> Shift(level + 1)) != (m_Tick >> Shift(level + 1)))
+      ++level;
+    Push(id, timer, level, (at >> Shift(level)) & Mask);
+  }
+
+  void
+  TimerWheel::Push(ID_t id, Timer& timer, size_t level, size_t slot)
+  {
+    auto& ids = m_Slots[level][slot];
+    timer.level = level;
+    timer.slot = slot;
+    timer.index = ids.size();
+    ids.push_back(id);
+  }
+
+  void
+  TimerWheel::Unlink(ID_t id, Timer& timer)
+  {
+    if (timer.level == NumLevels)
+      return;
+    auto& ids = m_Slots[timer.level][timer.slot];
+    // the last id in the slot takes its place
+    if (ids.back() != id)
+    {
+      ids[timer.index] = ids.back();
+      m_Timers.at(ids.back()).index = timer.index;
+    }
+    ids.pop_back();
+    timer.level = NumLevels;
+  }
+
+  std::vector<TimerWheel::ID_t>
+  TimerWheel::TakeSlot(size_t level, size_t slot)
+  {
+    std::vector<ID_t> ids;
+    ids.swap(m_Slots[level][slot]);
+    for (const auto id : ids)
+      m_Timers.at(id).level = NumLevels;
+    return ids;
+  }
+
+  std::optional<uint64_t>
+  TimerWheel::NextTick() const
+  {
+    // every slot of a level starts before any later slot of the level above it, so the first
+    // occupied slot going up from the bottom is the earliest
+    for (size_t level = 0; level < NumLevels; ++level)
+    {
+      const uint64_t current = m_Tick >> Shift(level);
+      // only the top level wraps around onto slots in its next revolution
+      const uint64_t last = level + 1 < NumLevels ? (current | Mask) : current + NumSlots;
+      for (uint64_t slot = current + 1; slot <= last; ++slot)
+      {
+        if (not m_Slots[level][slot & Mask].empty())
+          return slot << Shift(level);
+      }
+    }
+    return std::nullopt;
+  }
+
+  void
+  TimerWheel::Cascade()
+  {
+    // top down, a timer moved out of a level may land in a slot of the level below that starts
+    // on this very tick
+    for (size_t level = NumLevels - 1; level > 0; --level)
+    {
+      if (m_Tick & ((uint64_t{1} << Shift(level)) - 1))
+        continue;
+      for (const auto id : TakeSlot(level, (m_Tick >> Shift(level)) & Mask))
+      {
+        auto& timer = m_Timers.at(id);
+        // due on this tick, Fire runs it right after
+        if (timer.due <= m_Tick)
+          Push(id, timer, 0, m_Tick & Mask);
+        else
+          Place(id, timer);
+      }
+    }
+  }
+
+  size_t
+  TimerWheel::Fire()
+  {
+    size_t ran = 0;
+    for (const auto id : TakeSlot(0, m_Tick & Mask))
+    {
+      // an earlier callback may have cancelled it
+      auto itr = m_Timers.find(id);
+      if (itr == m_Timers.end())
+        continue;
+      if (itr->second.due > m_Tick)
+      {
+        Place(id, itr->second);
+        continue;
+      }
+      // gone from the wheel before it runs, it may schedule or cancel anything
+      auto callback = std::move(itr->second.callback);
+      m_Timers.erase(itr);
+      callback();
+      ran++;
+    }
+    return ran;
+  }
+
+  size_t
+  TimerWheel::Advance(llarp_time_t now)
+  {
+    const uint64_t target = static_cast<uint64_t>(now.count()) / m_Resolution;
+    size_t ran = 0;
+    while (m_Tick < target)
+    {
+      // jump straight over the ticks with nothing in them
+      const auto next = NextTick();
+      if (not next or *next > target)
+      {
+        m_Tick = target;
+        break;
+      }
+      m_Tick = *next;
+      Cascade();
+      ran += Fire();
+    }
+    return ran;
+  }
+
+  std::optional<llarp_time_t>
+  TimerWheel::NextDue() const
+  {
+    if (auto next = NextTick())
+      return llarp_time_t{static_cast<int64_t>(*next * m_Resolution)};
+    return std::nullopt;
+  }
+}  // namespace llarp::util
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "time.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp::util
+{
+  /// hierarchical timing wheel. each level has NumSlots slots each covering NumSlots times the
+  /// ticks of the level below it; a timer goes in the lowest level whose current revolution
+  /// reaches it and moves down a level each time the wheel turns onto its slot. Schedule and
+  /// Cancel are O(1), Advance only does work for the slots that came due.
+  ///
+  /// not thread safe, the event loop owns one and only touches it from its own thread.
+  class TimerWheel
+  {
+   public:
+    using ID_t = uint64_t;
+    using Callback_t = std::function<void()>;
+
+    static constexpr size_t SlotBits = 8;
+    static constexpr size_t NumSlots = size_t{1} << SlotBits;
+    static constexpr size_t NumLevels = 4;
+
+    explicit TimerWheel(llarp_time_t resolution = 1ms, llarp_time_t now = 0s);
+
+    /// call f from Advance once now reaches at. id is chosen by the caller and must never have
+    /// been used before, returns false if it is still in use.
+    bool
+    Schedule(ID_t id, llarp_time_t at, Callback_t f);
+
+    /// drop timer id before it runs, false if it already ran or never existed
+    bool
+    Cancel(ID_t id);
+
+    /// run every timer that came due by now, returns how many ran. timers may schedule and
+    /// cancel timers from their callbacks.
+    size_t
+    Advance(llarp_time_t now);
+
+    /// the earliest time Advance has anything to do, nullopt if there are no timers
+    std::optional<llarp_time_t>
+    NextDue() const;
+
+    size_t
+    Size() const
+    {
+      return m_Timers.size();
+    }
+
+    bool
+    Empty() const
+    {
+      return m_Timers.empty();
+    }
+
+   private:
+    struct Timer
+    {
+      uint64_t due;
+      Callback_t callback;
+      /// where its id is in m_Slots, level is NumLevels while it is in none of them
+      size_t level = NumLevels;
+      size_t slot = 0;
+      size_t index = 0;
+    };
+
+    /// put id in the slot its due tick falls in, as seen from the current tick
+    void
+    Place(ID_t id, Timer& timer);
+
+    /// put id at the back of a slot
+    void
+    Push(ID_t id, Timer& timer, size_t level, size_t slot);
+
+    /// take id out of the slot it is in, if any
+    void
+    Unlink(ID_t id, Timer& timer);
+
+    /// take every id out of a slot to go through, they are in no slot after this
+    std::vector<ID_t>
+    TakeSlot(size_t level, size_t slot);
+
+    /// the next tick after the current one that has a slot to cascade or fire
+    std::optional<uint64_t>
+    NextTick() const;
+
+    /// move the timers of every level whose slot the current tick starts down a level
+    void
+    Cascade();
+
+    /// run the timers in the current tick's slot
+    size_t
+    Fire();
+
+    const uint64_t m_Resolution;
+    /// the last tick Advance went through
+    uint64_t m_Tick;
+    std::unordered_map<ID_t, Timer> m_Timers;
+    /// ids of the timers in each slot, only ever the live ones
+    std::array<std::array<std::vector<ID_t>, NumSlots>, NumLevels> m_Slots;
+  };
+}  // namespace llarp::util
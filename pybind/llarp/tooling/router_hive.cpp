@@ -17,11 +17,27 @@ namespace tooling
 
     py::class_<RouterHive, RouterHive_ptr>(mod, "RouterHive")
         .def(py::init<>())
+        .def(py::init<bool, uint64_t>())
         .def("AddRelay", &RouterHive::AddRelay)
         .def("AddClient", &RouterHive::AddClient)
         .def("StartRelays", &RouterHive::StartRelays)
         .def("StartClients", &RouterHive::StartClients)
         .def("StopAll", &RouterHive::StopRouters)
+        .def(
+            "RunFor",
+            [](RouterHive& hive, uint64_t ms) {
+              py::gil_scoped_release release;
+              hive.RunFor(std::chrono::milliseconds{ms});
+            })
+        .def(
+            "SetDefaultLink",
+            [](RouterHive& hive, uint64_t latency_ms, uint64_t bandwidth, double loss) {
+              LinkParams params;
+              params.latency = std::chrono::milliseconds{latency_ms};
+              params.bandwidth = bandwidth;
+              params.loss = loss;
+              hive.SetDefaultLink(params);
+            })
         .def(
             "ForEachRelay",
             [](RouterHive& hive, ContextVisitor visit) {
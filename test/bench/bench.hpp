@@ -0,0 +1,86 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// lokinet-bench: deterministic workloads with one json object per line of output, so runs can be
+/// diffed and tracked over time. inputs come from fixed seeds and iteration counts, only the
+/// timings change from run to run.
+namespace bench
+{
+  /// heap allocations made by this process so far
+  uint64_t
+  Allocations();
+
+  /// cpu time used by every thread of this process so far
+  std::chrono::nanoseconds
+  CPUTime();
+
+  using Report_t = std::function<void(nlohmann::json)>;
+
+  /// time iterations calls of op and report it as suite/name
+  void
+  Micro(
+      const Report_t& report,
+      std::string suite,
+      std::string name,
+      uint64_t iterations,
+      const std::function<void()>& op);
+
+  /// value at percentile pct (0 to 100) of unsorted samples, 0 if there are none
+  template <typename T>
+  T
+  Percentile(std::vector<T> samples, double pct)
+  {
+    if (samples.empty())
+      return T{};
+    const auto idx = static_cast<size_t>(pct / 100. * (samples.size() - 1) + 0.5);
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx];
+  }
+
+  void
+  RunCrypto(const Report_t& report);
+
+  void
+  RunBencode(const Report_t& report);
+
+  void
+  RunQueue(const Report_t& report);
+
+  /// contended lookups through a locked set and through an rcu snapshot
+  void
+  RunSnapshot(const Report_t& report);
+
+  /// ip range lookups through the prefix trie and through a linear scan
+  void
+  RunIPRangeMap(const Report_t& report);
+
+  /// memory held by idle transit hops
+  void
+  RunTransitHop(const Report_t& report);
+
+  void
+  RunNodeDB(const Report_t& report);
+
+  /// dns message codecs, and queries through the dns server with and without resolver pool
+  /// threads
+  void
+  RunDNS(const Report_t& report);
+
+  /// hidden service convo bookkeeping with 100k sessions
+  void
+  RunConvo(const Report_t& report);
+
+#ifdef LOKINET_HIVE
+  /// relay, hidden service and exit traffic through routers on a simulated network
+  void
+  RunNetwork(const Report_t& report);
+#endif
+}  // namespace bench
@@ -0,0 +1,115 @@
+#include "bench.hpp"
+
+#include <llarp/dns/message.hpp>
+#include <llarp/dns/packet.hpp>
+#include <mocks/mock_dns.hpp>
+
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bench
+{
+  namespace
+  {
+    void
+    RunCodec(const Report_t& report)
+    {
+      using namespace llarp::dns;
+      Message reply{Question{"some.name.loki.", qTypeA}};
+      reply.AddINReply(llarp::huint128_t{0x0a000001}, false);
+      reply.AddINReply(llarp::huint128_t{0x0a000002}, false);
+      const auto pkt = reply.ToBuffer();
+      const llarp::byte_view_t packet{pkt.buf.get(), pkt.sz};
+
+      Micro(report, "dns", "message_decode", 200'000, [&]() {
+        MessageHeader hdr;
+        llarp_buffer_t buf{pkt.buf.get(), pkt.sz};
+        hdr.Decode(&buf);
+        Message msg{hdr};
+        if (not msg.Decode(&buf))
+          throw std::runtime_error{"benchmark dns message did not decode"};
+      });
+      Micro(report, "dns", "view_parse", 200'000, [&]() {
+        auto view = MessageView::Parse(packet);
+        if (not view->FirstQuestion()->qname.EndsWith("loki"))
+          throw std::runtime_error{"benchmark dns message lost its question"};
+      });
+      // what a pool thread does to rewrite an answer without building a Message
+      Micro(report, "dns", "view_parse_rewrite", 200'000, [&]() {
+        auto view = MessageView::Parse(packet);
+        std::array<byte_t, 512> out;
+        PacketWriter writer{out};
+        writer.Header(view->Header().id, view->Header().fields);
+        writer.Question(*view->FirstQuestion());
+        view->ForEachRecord(Section::answer, [&](const RecordView& rr) {
+          writer.Record(Section::answer, "some.name.loki", rr.rr_type, rr.ttl, rr.rData);
+        });
+        if (not writer.Finish())
+          throw std::runtime_error{"benchmark dns message did not fit"};
+      });
+      Micro(report, "dns", "message_encode", 200'000, [&]() {
+        if (reply.ToBuffer().sz == 0)
+          throw std::runtime_error{"benchmark dns message did not encode"};
+      });
+    }
+  }  // namespace
+
+  void
+  RunDNS(const Report_t& report)
+  {
+    RunCodec(report);
+
+    constexpr size_t count = 20'000;
+    constexpr size_t window = 256;
+    mocks::DNSUpstream upstream;
+
+    // queries for distinct names against a stand-in upstream on loopback, keeping window of
+    // them in flight
+    for (int threads : {0, 1, 2, 4})
+    {
+      mocks::DNSServer dns{upstream, threads};
+      llarp::SockAddr clientAddr;
+      const int fd = mocks::BindLoopbackUDP(clientAddr);
+      std::array<byte_t, 1500> buf;
+      pollfd pfd{fd, POLLIN, 0};
+      size_t sent = 0, answered = 0;
+      const auto started = std::chrono::steady_clock::now();
+      while (answered < count)
+      {
+        while (sent < count and sent - answered < window)
+        {
+          const auto query = mocks::MakeDNSQuery(sent, "q" + std::to_string(sent) + ".bench.test");
+          ::sendto(
+              fd,
+              query.data(),
+              query.size(),
+              0,
+              static_cast<const sockaddr*>(dns.addr),
+              dns.addr.sockaddr_len());
+          ++sent;
+        }
+        if (::poll(&pfd, 1, 1000) <= 0)
+          break;
+        while (::recv(fd, buf.data(), buf.size(), MSG_DONTWAIT) > 0)
+          ++answered;
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+      ::close(fd);
+      if (answered < count)
+        throw std::runtime_error{"benchmark dns queries went unanswered"};
+
+      report(nlohmann::json{
+          {"suite", "dns"},
+          {"name", "resolver_pool_" + std::to_string(threads) + "_threads"},
+          {"iterations", count},
+          {"ns_per_op", elapsed.count() * 1e9 / count},
+          {"ops_per_sec", count / elapsed.count()}});
+    }
+  }
+}  // namespace bench
@@ -0,0 +1,561 @@
+#include "bench.hpp"
+
+#include <llarp/crypto/crypto.hpp>
+#include <llarp/crypto/types.hpp>
+#include <llarp/net/ip_range_map.hpp>
+#include <llarp/nodedb.hpp>
+#include <llarp/path/transit_hop.hpp>
+#include <llarp/router_contact.hpp>
+#include <llarp/routing/path_confirm_message.hpp>
+#include <llarp/routing/path_latency_message.hpp>
+#include <llarp/routing/path_transfer_message.hpp>
+#include <llarp/routing/transfer_traffic_message.hpp>
+#include <llarp/service/convo_table.hpp>
+#include <llarp/util/bencode_schema.hpp>
+#include <llarp/util/thread/mpsc_ring.hpp>
+#include <llarp/util/thread/queue.hpp>
+#include <llarp/util/thread/rcu_snapshot.hpp>
+#include <llarp/util/thread/threading.hpp>
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <unistd.h>
+
+namespace bench
+{
+  namespace
+  {
+    /// what a full path hop or exit message carries
+    constexpr size_t PacketSize = 1500;
+
+    template <typename Buf_t>
+    void
+    Fill(Buf_t& buf, std::mt19937_64& rng)
+    {
+      for (size_t idx = 0; idx < buf.size(); ++idx)
+        buf[idx] = rng();
+    }
+
+    llarp::RouterContact
+    MakeSignedRC()
+    {
+      auto* crypto = llarp::CryptoManager::instance();
+      llarp::SecretKey sign, encr;
+      crypto->identity_keygen(sign);
+      crypto->encryption_keygen(encr);
+      llarp::RouterContact rc;
+      rc.enckey = encr.toPublic();
+      rc.pubkey = sign.toPublic();
+      rc.SetNick("bench");
+      if (not rc.Sign(sign))
+        throw std::runtime_error{"cannot sign benchmark rc"};
+      return rc;
+    }
+
+    /// resident set size of this process in bytes
+    size_t
+    ResidentBytes()
+    {
+      std::ifstream statm{"/proc/self/statm"};
+      size_t pages = 0, resident = 0;
+      statm >> pages >> resident;
+      return resident * sysconf(_SC_PAGESIZE);
+    }
+
+    /// encode msg and decode it again in a single pass through its schema
+    template <typename Msg_t, typename Schema_t>
+    void
+    MessageCodec(
+        const Report_t& report, const std::string& name, const Msg_t& msg, const Schema_t& schema)
+    {
+      std::array<byte_t, PacketSize * 2> data;
+      size_t size = 0;
+      Micro(report, "bencode", name + "_encode", 100'000, [&]() {
+        llarp_buffer_t buf{data};
+        if (not msg.BEncode(&buf))
+          throw std::runtime_error{"cannot encode benchmark " + name};
+        size = buf.cur - buf.base;
+      });
+      Micro(report, "bencode", name + "_decode", 100'000, [&]() {
+        llarp_buffer_t buf{data.data(), size};
+        Msg_t decoded;
+        if (not llarp::bencode::Decode(schema, decoded, &buf))
+          throw std::runtime_error{"cannot decode benchmark " + name};
+      });
+    }
+  }  // namespace
+
+  void
+  RunCrypto(const Report_t& report)
+  {
+    auto* crypto = llarp::CryptoManager::instance();
+    std::mt19937_64 rng{1};
+
+    std::array<byte_t, PacketSize> data;
+    Fill(data, rng);
+    llarp::SharedSecret shared;
+    Fill(shared, rng);
+    llarp::TunnelNonce nonce;
+    Fill(nonce, rng);
+
+    Micro(report, "crypto", "xchacha20_1500", 100'000, [&]() {
+      crypto->xchacha20(llarp_buffer_t{data}, shared, nonce);
+    });
+
+    llarp::ShortHash hash;
+    Micro(report, "crypto", "shorthash_1500", 100'000, [&]() {
+      crypto->shorthash(hash, llarp_buffer_t{data});
+    });
+
+    llarp::SecretKey identity;
+    crypto->identity_keygen(identity);
+    const llarp::PubKey pub = identity.toPublic();
+    llarp::Signature sig;
+    Micro(report, "crypto", "sign_1500", 10'000, [&]() {
+      crypto->sign(sig, identity, llarp_buffer_t{data});
+    });
+    Micro(report, "crypto", "verify_1500", 10'000, [&]() {
+      if (not crypto->verify(pub, llarp_buffer_t{data}, sig))
+        throw std::runtime_error{"benchmark signature does not verify"};
+    });
+
+    // what each hop of a path build costs the client and the relay
+    llarp::SecretKey ours, theirs;
+    crypto->encryption_keygen(ours);
+    crypto->encryption_keygen(theirs);
+    const llarp::PubKey theirPub = theirs.toPublic();
+    Micro(report, "crypto", "dh_client", 10'000, [&]() {
+      crypto->dh_client(shared, theirPub, ours, nonce);
+    });
+    Micro(report, "crypto", "transport_dh_client", 10'000, [&]() {
+      crypto->transport_dh_client(shared, theirPub, ours, nonce);
+    });
+  }
+
+  void
+  RunBencode(const Report_t& report)
+  {
+    std::mt19937_64 rng{2};
+
+    const auto rc = MakeSignedRC();
+    std::array<byte_t, MAX_RC_SIZE> rcData;
+    size_t rcSize = 0;
+    Micro(report, "bencode", "rc_encode", 100'000, [&]() {
+      llarp_buffer_t buf{rcData};
+      if (not rc.BEncode(&buf))
+        throw std::runtime_error{"cannot encode benchmark rc"};
+      rcSize = buf.cur - buf.base;
+    });
+    Micro(report, "bencode", "rc_decode", 100'000, [&]() {
+      llarp_buffer_t buf{rcData.data(), rcSize};
+      llarp::RouterContact decoded;
+      if (not decoded.BDecode(&buf))
+        throw std::runtime_error{"cannot decode benchmark rc"};
+    });
+    Micro(report, "bencode", "rc_verify", 10'000, [&]() {
+      if (not rc.VerifySignature())
+        throw std::runtime_error{"benchmark rc does not verify"};
+    });
+
+    llarp::routing::PathLatencyMessage latency;
+    latency.S = 1;
+    latency.T = rng();
+    MessageCodec(report, "path_latency", latency, llarp::routing::PathLatencyMessageSchema);
+
+    llarp::routing::PathConfirmMessage confirm{std::chrono::minutes{10}};
+    confirm.S = 1;
+    MessageCodec(report, "path_confirm", confirm, llarp::routing::PathConfirmMessageSchema);
+
+    std::array<byte_t, llarp::routing::MaxExitMTU> payload;
+    Fill(payload, rng);
+
+    llarp::service::ProtocolFrame frame;
+    Fill(frame.F, rng);
+    Fill(frame.N, rng);
+    Fill(frame.T, rng);
+    Fill(frame.Z, rng);
+    frame.D = llarp::service::ProtocolFrame::Encrypted_t{payload.data(), 1024};
+    llarp::PathID_t pathID;
+    Fill(pathID, rng);
+    llarp::routing::PathTransferMessage transfer{frame, pathID};
+    transfer.S = 1;
+    MessageCodec(report, "path_transfer", transfer, llarp::routing::PathTransferMessageSchema);
+
+    llarp::routing::TransferTrafficMessage traffic;
+    traffic.S = 1;
+    if (not traffic.PutBuffer(llarp_buffer_t{payload}, 1))
+      throw std::runtime_error{"cannot fill benchmark traffic message"};
+    MessageCodec(
+        report, "transfer_traffic", traffic, llarp::routing::TransferTrafficMessageSchema);
+  }
+
+  void
+  RunQueue(const Report_t& report)
+  {
+    llarp::thread::Queue<uint64_t> queue{1024};
+    uint64_t val = 0;
+    Micro(report, "queue", "queue_push_pop", 1'000'000, [&]() {
+      queue.tryPushBack(val++);
+      queue.tryPopFront();
+    });
+
+    llarp::thread::MPSCRing<uint64_t> ring{1024};
+    Micro(report, "queue", "mpsc_ring_push_pop", 1'000'000, [&]() {
+      ring.tryPushBack(val++);
+      ring.tryPopFront();
+    });
+
+    // one producer thread handing items to us, each iteration moves a batch through
+    constexpr uint64_t Batch = 10'000;
+    Micro(report, "queue", "queue_handoff_10k", 100, [&]() {
+      std::thread producer{[&]() {
+        for (uint64_t idx = 0; idx < Batch; ++idx)
+          queue.pushBack(idx);
+      }};
+      for (uint64_t idx = 0; idx < Batch; ++idx)
+        queue.popFront();
+      producer.join();
+    });
+    Micro(report, "queue", "mpsc_ring_handoff_10k", 100, [&]() {
+      std::thread producer{[&]() {
+        for (uint64_t idx = 0; idx < Batch; ++idx)
+        {
+          while (not ring.tryPushBack(uint64_t{idx}))
+            std::this_thread::yield();
+        }
+      }};
+      for (uint64_t got = 0; got < Batch;)
+      {
+        if (ring.tryPopFront())
+          got++;
+        else
+          std::this_thread::yield();
+      }
+      producer.join();
+    });
+
+    // several producers contending for the same queue, as router threads do for the outbound
+    // message queue
+    for (const size_t producers : {2, 4, 8})
+    {
+      const auto handoff = [producers](auto push, auto pop) {
+        std::vector<std::thread> threads;
+        for (size_t idx = 0; idx < producers; ++idx)
+        {
+          threads.emplace_back([&push, producers]() {
+            for (uint64_t item = 0; item < Batch / producers; ++item)
+            {
+              while (not push(item))
+                std::this_thread::yield();
+            }
+          });
+        }
+        for (uint64_t got = 0; got < Batch / producers * producers;)
+        {
+          if (pop())
+            got++;
+          else
+            std::this_thread::yield();
+        }
+        for (auto& thread : threads)
+          thread.join();
+      };
+      const auto suffix = "_contention_" + std::to_string(producers) + "p";
+      Micro(report, "queue", "queue" + suffix, 20, [&]() {
+        handoff(
+            [&queue](uint64_t item) {
+              return queue.tryPushBack(std::move(item)) == llarp::thread::QueueReturn::Success;
+            },
+            [&queue]() { return queue.tryPopFront().has_value(); });
+      });
+      Micro(report, "queue", "mpsc_ring" + suffix, 20, [&]() {
+        handoff(
+            [&ring](uint64_t item) { return ring.tryPushBack(std::move(item)); },
+            [&ring]() { return ring.tryPopFront().has_value(); });
+      });
+    }
+  }
+
+  void
+  RunSnapshot(const Report_t& report)
+  {
+    constexpr uint64_t NumIDs = 2'000;
+    constexpr uint64_t Lookups = 100'000;
+    std::vector<uint64_t> ids;
+    for (uint64_t id = 0; id < NumIDs; ++id)
+      ids.push_back(id * 7919);
+
+    // what RCLookupHandler used to do: exclusive lock on a mutex and a hash lookup
+    llarp::util::Mutex mutex;
+    const std::unordered_set<uint64_t> set{ids.begin(), ids.end()};
+    // what it does now: the same set in a snapshot
+    llarp::thread::RCUSnapshot<std::unordered_set<uint64_t>> snapshot{
+        std::make_unique<const std::unordered_set<uint64_t>>(ids.begin(), ids.end())};
+
+    // every thread looks up ids at the same time, each iteration is Lookups per thread
+    for (const size_t threads : {1, 2, 4, 8})
+    {
+      const auto contend = [threads](auto lookup) {
+        std::atomic<uint64_t> found{0};
+        std::vector<std::thread> workers;
+        for (size_t idx = 0; idx < threads; ++idx)
+        {
+          workers.emplace_back([&found, &lookup, idx]() {
+            uint64_t hits = 0;
+            for (uint64_t n = 0; n < Lookups; ++n)
+              hits += lookup(((n + idx) % NumIDs) * 7919);
+            found += hits;
+          });
+        }
+        for (auto& worker : workers)
+          worker.join();
+        if (found != threads * Lookups)
+          throw std::runtime_error{"benchmark id went missing from the set"};
+      };
+      const auto suffix = "_100k_" + std::to_string(threads) + "t";
+      Micro(report, "snapshot", "locked_set" + suffix, 20, [&]() {
+        contend([&mutex, &set](uint64_t id) {
+          llarp::util::Lock lock{mutex};
+          return set.count(id);
+        });
+      });
+      Micro(report, "snapshot", "rcu_snapshot" + suffix, 20, [&]() {
+        contend([&snapshot](uint64_t id) { return snapshot->count(id); });
+      });
+    }
+  }
+
+  void
+  RunIPRangeMap(const Report_t& report)
+  {
+    std::mt19937_64 rng{5};
+    const auto randomIP = [&rng]() { return llarp::huint128_t{llarp::uint128_t{rng(), rng()}}; };
+    for (const size_t numRanges : {10, 100, 1'000, 10'000})
+    {
+      llarp::net::IPRangeMap<std::string> map;
+      std::vector<llarp::IPRange> ranges;
+      for (size_t idx = 0; idx < numRanges; ++idx)
+      {
+        // the sort of ranges exit maps and policies have, few of them overlap
+        if (rng() % 4)
+          ranges.emplace_back(
+              llarp::net::ExpandV4(llarp::huint32_t{static_cast<uint32_t>(rng())}),
+              llarp::netmask_ipv6_bits(96 + 8 + rng() % 25));
+        else
+          ranges.emplace_back(randomIP(), llarp::netmask_ipv6_bits(32 + rng() % 97));
+        map.Insert(ranges.back(), std::to_string(idx % 16));
+      }
+      // most lookups land inside one of the ranges
+      std::vector<llarp::huint128_t> ips(10'000);
+      for (auto& ip : ips)
+      {
+        ip = randomIP();
+        if (rng() % 4)
+        {
+          const auto& range = ranges[rng() % ranges.size()];
+          ip = (range.addr & range.netmask_bits) | (ip & ~range.netmask_bits);
+        }
+      }
+
+      size_t idx = 0;
+      const auto suffix = "_" + std::to_string(numRanges);
+      Micro(report, "iprangemap", "trie_find_all" + suffix, 100'000, [&]() {
+        map.FindAllEntries(ips[idx++ % ips.size()]);
+      });
+      // what a lookup cost before the trie, a scan over every entry
+      Micro(report, "iprangemap", "linear_find_all" + suffix, 10'000, [&]() {
+        const auto& ip = ips[idx++ % ips.size()];
+        std::set<std::pair<llarp::IPRange, std::string>> found;
+        map.ForEachEntry([&](const auto& range, const auto& value) {
+          if (range.Contains(ip))
+            found.emplace(range, value);
+        });
+      });
+    }
+  }
+
+  void
+  RunTransitHop(const Report_t& report)
+  {
+    constexpr size_t NumHops = 50'000;
+    const auto before = ResidentBytes();
+    std::vector<std::shared_ptr<llarp::path::TransitHop>> hops;
+    hops.reserve(NumHops);
+    for (size_t idx = 0; idx < NumHops; ++idx)
+      hops.emplace_back(std::make_shared<llarp::path::TransitHop>());
+    const auto grown = ResidentBytes() - before;
+
+    // the per hop gather queues this replaced reserved 256 messages each way
+    report(nlohmann::json{
+        {"suite", "transit_hop"},
+        {"name", "idle_50k"},
+        {"hops", NumHops},
+        {"sizeof_hop", sizeof(llarp::path::TransitHop)},
+        {"resident_bytes_per_hop", grown / NumHops},
+        {"gather_queue_bytes_per_hop",
+         256 * (sizeof(llarp::RelayUpstreamMessage) + sizeof(llarp::RelayDownstreamMessage))}});
+  }
+
+  void
+  RunNodeDB(const Report_t& report)
+  {
+    std::mt19937_64 rng{3};
+    constexpr size_t NumRCs = 10'000;
+
+    std::vector<llarp::RouterContact> rcs(NumRCs);
+    for (auto& rc : rcs)
+      Fill(rc.pubkey, rng);
+    std::vector<llarp::dht::Key_t> keys(1024);
+    for (auto& key : keys)
+      Fill(key, rng);
+
+    // in memory only, nothing goes to disk
+    llarp::NodeDB nodedb;
+    size_t idx = 0;
+    Micro(report, "nodedb", "put_10k", NumRCs, [&]() { nodedb.Put(rcs[idx++ % NumRCs]); });
+    Micro(report, "nodedb", "get_10k", 100'000, [&]() {
+      if (not nodedb.Get(rcs[idx++ % NumRCs].pubkey))
+        throw std::runtime_error{"benchmark rc went missing from the nodedb"};
+    });
+    Micro(report, "nodedb", "find_closest_10k", 1'000, [&]() {
+      nodedb.FindClosestTo(keys[idx++ % keys.size()]);
+    });
+    Micro(report, "nodedb", "find_many_closest_4_10k", 1'000, [&]() {
+      nodedb.FindManyClosestTo(keys[idx++ % keys.size()], 4);
+    });
+  }
+
+  void
+  RunConvo(const Report_t& report)
+  {
+    using llarp::service::ConvoTag;
+    using llarp::service::Session;
+    using llarp::service::SessionLifetime;
+
+    std::mt19937_64 rng{4};
+    constexpr size_t NumConvos = 100'000;
+    constexpr size_t NumRemotes = 10'000;
+
+    std::vector<llarp::service::ServiceInfo> remotes(NumRemotes);
+    for (auto& remote : remotes)
+    {
+      llarp::PubKey sign, enc;
+      Fill(sign, rng);
+      Fill(enc, rng);
+      remote.Update(sign.data(), enc.data());
+    }
+
+    // every convo last heard from somewhere in the past lifetime, so some come due each second
+    const llarp_time_t start = SessionLifetime;
+    llarp::service::ConvoTable table{start};
+    // what the endpoint kept before: a flat map of tag to session scanned for everything else
+    std::unordered_map<ConvoTag, Session> legacy;
+    std::vector<ConvoTag> tags(NumConvos);
+    for (size_t idx = 0; idx < NumConvos; ++idx)
+    {
+      Fill(tags[idx], rng);
+      const auto& remote = remotes[idx % NumRemotes];
+      // every remote has both inbound and outbound convos
+      const bool inbound = (idx / NumRemotes) % 2;
+      const auto lastRecv = 2s + llarp_time_t(rng() % (SessionLifetime - 2s).count());
+      table.Insert(tags[idx], remote, inbound).lastRecv = lastRecv;
+      auto& session = legacy[tags[idx]];
+      session.remote = remote;
+      session.inbound = inbound;
+      session.lastRecv = lastRecv;
+    }
+    // the first pass over the table sees every new session, none of them expired yet
+    table.Expire(start + 1s, [](const auto&, const auto&) {});
+
+    size_t idx = 0;
+    Micro(report, "convo", "legacy_lookup_100k", 1'000'000, [&]() {
+      if (legacy.find(tags[idx++ % NumConvos]) == legacy.end())
+        throw std::runtime_error{"benchmark convo went missing"};
+    });
+    Micro(report, "convo", "table_lookup_100k", 1'000'000, [&]() {
+      if (not table.Find(tags[idx++ % NumConvos]))
+        throw std::runtime_error{"benchmark convo went missing"};
+    });
+
+    // HasInboundConvo and GetBestConvoTagFor, done per packet sent to a remote
+    Micro(report, "convo", "legacy_has_inbound_100k", 100, [&]() {
+      const auto addr = remotes[idx++ % NumRemotes].Addr();
+      for (const auto& [tag, session] : legacy)
+      {
+        if (session.remote.Addr() == addr and session.inbound)
+          return;
+      }
+      throw std::runtime_error{"benchmark remote has no inbound convo"};
+    });
+    Micro(report, "convo", "table_has_inbound_100k", 1'000'000, [&]() {
+      if (not table.HasInbound(remotes[idx++ % NumRemotes].Addr()))
+        throw std::runtime_error{"benchmark remote has no inbound convo"};
+    });
+    Micro(report, "convo", "legacy_tags_for_100k", 100, [&]() {
+      const auto addr = remotes[idx++ % NumRemotes].Addr();
+      size_t found = 0;
+      for (const auto& [tag, session] : legacy)
+      {
+        if (session.remote.Addr() == addr)
+          found++;
+      }
+      if (found == 0)
+        throw std::runtime_error{"benchmark remote has no convos"};
+    });
+    Micro(report, "convo", "table_tags_for_100k", 1'000'000, [&]() {
+      if (table.TagsFor(remotes[idx++ % NumRemotes].Addr()).empty())
+        throw std::runtime_error{"benchmark remote has no convos"};
+    });
+
+    // one endpoint tick a second, whatever expired comes back as a fresh convo so the population
+    // stays at 100k
+    llarp_time_t now = start + 1s;
+    std::vector<ConvoTag> expired;
+    const auto replace = [&](auto& put) {
+      for (auto& tag : expired)
+      {
+        Fill(tag, rng);
+        put(tag, remotes[idx++ % NumRemotes]);
+      }
+      expired.clear();
+    };
+    Micro(report, "convo", "legacy_expire_tick_100k", 300, [&]() {
+      now += 1s;
+      for (auto itr = legacy.begin(); itr != legacy.end();)
+      {
+        if (itr->second.IsExpired(now))
+        {
+          expired.push_back(itr->first);
+          itr = legacy.erase(itr);
+        }
+        else
+          ++itr;
+      }
+      auto put = [&](const auto& tag, const auto& remote) {
+        auto& session = legacy[tag];
+        session.remote = remote;
+        session.lastRecv = now;
+      };
+      replace(put);
+    });
+    now = start + 1s;
+    Micro(report, "convo", "table_expire_tick_100k", 300, [&]() {
+      now += 1s;
+      table.Expire(now, [&](const auto& tag, const auto&) { expired.push_back(tag); });
+      auto put = [&](const auto& tag, const auto& remote) {
+        table.Insert(tag, remote, false).lastRecv = now;
+      };
+      replace(put);
+    });
+  }
+}  // namespace bench
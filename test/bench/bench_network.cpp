@@ -0,0 +1,446 @@
+#include "bench.hpp"
+
+#include <llarp/config/config.hpp>
+#include <llarp/router/abstractrouter.hpp>
+#include <llarp/service/context.hpp>
+#include <llarp/service/endpoint.hpp>
+#include <llarp/tooling/router_hive.hpp>
+#include <llarp/util/fs.hpp>
+
+#include <cstring>
+
+namespace bench
+{
+  using namespace std::literals;
+
+  namespace
+  {
+    constexpr size_t NumRelays = 20;
+    /// udp payload of each packet, leaves room for lokinet's overhead under the 1500 mtu
+    constexpr size_t PayloadSize = 1200;
+    /// offered load: PerBurst packets every SendEvery of virtual time
+    constexpr size_t PerBurst = 10;
+    constexpr auto SendEvery = 10ms;
+    constexpr auto MeasureFor = 10s;
+    /// how long packets still in flight after the last send get to arrive
+    constexpr auto Drain = 5s;
+    /// how long we wait for a path to the destination to come up before giving up
+    constexpr auto Warmup = 60s;
+    const auto TargetIP = llarp::ipaddr_ipv4_bits(198, 51, 100, 1);
+
+    const fs::path BenchDir = fs::temp_directory_path() / "lokinet-bench";
+
+    using Context_ptr = tooling::RouterHive::Context_ptr;
+
+    std::shared_ptr<llarp::Config>
+    MakeConfig(const fs::path& dir, bool relay)
+    {
+      fs::create_directories(dir / "nodedb");
+      auto conf = std::make_shared<llarp::Config>(dir);
+      if (not conf->Load(std::nullopt, relay))
+        throw std::runtime_error{"cannot load default config for " + dir.string()};
+      conf->router.m_dataDir = dir;
+      conf->router.m_netId = "bench";
+      conf->router.m_blockBogons = false;
+      conf->network.m_enableProfiling = false;
+      conf->network.m_endpointType = "null";
+      conf->api.m_enableRPCServer = false;
+      conf->lokid.whitelistRouters = false;
+      // every router is on 127.0.0.1
+      conf->paths.m_UniqueHopsNetmaskSize = 0;
+      // there is nothing outside of the simulation to ask
+      conf->dns.m_upstreamDNS.clear();
+      return conf;
+    }
+
+    std::shared_ptr<llarp::Config>
+    RelayConfig(size_t idx, const std::optional<llarp::RouterContact>& seed)
+    {
+      auto conf = MakeConfig(BenchDir / "relays" / std::to_string(idx), true);
+      conf->router.m_nickname = "bench" + std::to_string(idx);
+      conf->links.InboundListenAddrs.emplace_back(
+          "127.0.0.1", llarp::huint16_t{static_cast<uint16_t>(30000 + idx)});
+      if (seed)
+        conf->bootstrap.routers.emplace(*seed);
+      else
+        conf->bootstrap.seednode = true;
+      return conf;
+    }
+
+    std::shared_ptr<llarp::Config>
+    ClientConfig(size_t idx, const llarp::RouterContact& seed)
+    {
+      auto conf = MakeConfig(BenchDir / "clients" / std::to_string(idx), false);
+      conf->bootstrap.routers.emplace(seed);
+      return conf;
+    }
+
+    /// give a router a userspace network interface of its own, idx keeps them apart
+    void
+    UseInterface(llarp::Config& conf, uint8_t idx)
+    {
+      conf.network.m_endpointType = "tun";
+      conf.network.m_ifname = "bench" + std::to_string(idx);
+      conf.network.m_ifaddr = llarp::IPRange::FromIPv4(10, idx, 0, 1, 16);
+      conf.dns.m_bind = {llarp::SockAddr{fmt::format("127.3.{}.1:53", idx)}};
+    }
+
+    /// run fn on ctx's loop and wait for it
+    template <typename Func_t>
+    auto
+    CallOn(tooling::RouterHive& hive, const Context_ptr& ctx, Func_t fn)
+    {
+      std::optional<decltype(fn())> result;
+      ctx->loop->call_soon([&]() { result = fn(); });
+      while (not result)
+        hive.RunFor(0ms);
+      return *result;
+    }
+
+    std::chrono::nanoseconds
+    BusyTime(const Context_ptr& ctx)
+    {
+      if (auto loop = std::dynamic_pointer_cast<tooling::SimLoop>(ctx->loop))
+        return loop->BusyTime();
+      return 0ns;
+    }
+
+    std::chrono::nanoseconds
+    BusyTime(const std::unordered_map<llarp::RouterID, Context_ptr>& routers)
+    {
+      std::chrono::nanoseconds total = 0ns;
+      for (const auto& [id, ctx] : routers)
+        total += BusyTime(ctx);
+      return total;
+    }
+
+    /// udp packets with a sequence number and when they were sent, from a tun endpoint's
+    /// interface to wherever they come out of lokinet
+    class Flow
+    {
+     public:
+      Flow(
+          tooling::RouterHive& hive,
+          Context_ptr from,
+          const std::string& ifname,
+          llarp::huint32_t dst,
+          std::shared_ptr<tooling::SimInterface> sink)
+          : m_Hive{hive}
+          , m_From{std::move(from)}
+          , m_Source{m_From->simVPN->GetInterface(ifname)}
+          , m_Sink{std::move(sink)}
+          , m_Src{llarp::net::TruncateV6(
+                m_From->router->hiddenServiceContext().GetDefault()->GetIfAddr())}
+          , m_Dst{dst}
+      {
+        if (not(m_Source and m_Sink))
+          throw std::runtime_error{"benchmark flow is missing an interface"};
+        m_Sink->SetSink([this](llarp::net::IPPacket pkt) { Received(std::move(pkt)); });
+      }
+
+      ~Flow()
+      {
+        m_Sink->SetSink(nullptr);
+      }
+
+      /// queue num packets into the source interface
+      void
+      Send(size_t num)
+      {
+        m_From->loop->call_soon([this, num]() {
+          for (size_t idx = 0; idx < num; ++idx)
+            m_Source->Inject(MakePacket());
+        });
+        m_Sent += num;
+      }
+
+      /// send a trickle of packets until they come out the other end
+      bool
+      WarmUp()
+      {
+        const auto deadline = m_Hive.simNetwork->Now() + Warmup;
+        while (m_Received == 0 and m_Hive.simNetwork->Now() < deadline)
+        {
+          Send(1);
+          m_Hive.RunFor(100ms);
+        }
+        return m_Received > 0;
+      }
+
+      /// forget about everything we sent so far, packets from before this get ignored
+      void
+      Reset()
+      {
+        m_FirstSeq = m_NextSeq;
+        m_Sent = 0;
+        m_Received = 0;
+        m_Bytes = 0;
+        m_Latencies.clear();
+      }
+
+      uint64_t
+      Sent() const
+      {
+        return m_Sent;
+      }
+
+      uint64_t
+      Received() const
+      {
+        return m_Received;
+      }
+
+      uint64_t
+      Bytes() const
+      {
+        return m_Bytes;
+      }
+
+      const std::vector<int64_t>&
+      Latencies() const
+      {
+        return m_Latencies;
+      }
+
+     private:
+      llarp::net::IPPacket
+      MakePacket()
+      {
+        std::vector<byte_t> body(PayloadSize);
+        const uint64_t seq = m_NextSeq++;
+        const int64_t sentAt = m_Hive.simNetwork->Now().count();
+        std::memcpy(body.data(), &seq, sizeof(seq));
+        std::memcpy(body.data() + sizeof(seq), &sentAt, sizeof(sentAt));
+        const auto port = llarp::net::port_t::from_host(9000);
+        return llarp::net::IPPacket::make_udp(
+            llarp::ToNet(m_Src), port, llarp::ToNet(m_Dst), port, std::move(body));
+      }
+
+      void
+      Received(llarp::net::IPPacket pkt)
+      {
+        const auto data = pkt.L4Data();
+        if (not data or data->second < sizeof(uint64_t) + sizeof(int64_t))
+          return;
+        uint64_t seq;
+        int64_t sentAt;
+        std::memcpy(&seq, data->first, sizeof(seq));
+        std::memcpy(&sentAt, data->first + sizeof(seq), sizeof(sentAt));
+        if (seq < m_FirstSeq)
+          return;
+        m_Received++;
+        m_Bytes += pkt.size();
+        m_Latencies.push_back(m_Hive.simNetwork->Now().count() - sentAt);
+      }
+
+      tooling::RouterHive& m_Hive;
+      Context_ptr m_From;
+      std::shared_ptr<tooling::SimInterface> m_Source;
+      std::shared_ptr<tooling::SimInterface> m_Sink;
+      llarp::huint32_t m_Src;
+      llarp::huint32_t m_Dst;
+
+      uint64_t m_NextSeq = 0;
+      uint64_t m_FirstSeq = 0;
+      uint64_t m_Sent = 0;
+      uint64_t m_Received = 0;
+      uint64_t m_Bytes = 0;
+      std::vector<int64_t> m_Latencies;
+    };
+
+    /// push the offered load through flow and report what came out
+    void
+    Measure(const Report_t& report, const std::string& name, tooling::RouterHive& hive, Flow& flow)
+    {
+      if (not flow.WarmUp())
+      {
+        report(nlohmann::json{
+            {"suite", "network"}, {"name", name}, {"error", "no path came up during warmup"}});
+        return;
+      }
+      flow.Reset();
+      const auto relayBusy = BusyTime(hive.relays);
+      const auto clientBusy = BusyTime(hive.clients);
+      const auto cpu = CPUTime();
+      const auto allocs = Allocations();
+
+      for (auto elapsed = 0ms; elapsed < MeasureFor; elapsed += SendEvery)
+      {
+        flow.Send(PerBurst);
+        hive.RunFor(SendEvery);
+        // nobody reads the router events, do not let them pile up
+        hive.GetAllEvents();
+      }
+      hive.RunFor(Drain);
+
+      const std::chrono::duration<double> cpuUsed = CPUTime() - cpu;
+      const std::chrono::duration<double> relayUsed = BusyTime(hive.relays) - relayBusy;
+      const std::chrono::duration<double> clientUsed = BusyTime(hive.clients) - clientBusy;
+      const auto received = flow.Received();
+      const double gbits = flow.Bytes() * 8 / 1e9;
+      nlohmann::json result{
+          {"suite", "network"},
+          {"name", name},
+          {"packets_sent", flow.Sent()},
+          {"packets_received", received},
+          {"loss", 1. - double(received) / flow.Sent()},
+          // per second of cpu, the virtual clock says nothing about how fast we are
+          {"packets_per_sec", received / cpuUsed.count()},
+          {"mbit_per_sec", gbits * 1000 / cpuUsed.count()},
+          {"latency_p50_ms", Percentile(flow.Latencies(), 50)},
+          {"latency_p99_ms", Percentile(flow.Latencies(), 99)},
+          {"allocs_per_packet", received ? double(Allocations() - allocs) / received : 0.}};
+      if (gbits > 0)
+      {
+        result["cpu_sec_per_gbit"] = cpuUsed.count() / gbits;
+        result["relay_cpu_sec_per_gbit"] = relayUsed.count() / gbits;
+        result["client_cpu_sec_per_gbit"] = clientUsed.count() / gbits;
+      }
+      report(std::move(result));
+    }
+
+    /// run relay 0 on its own once so it has an rc everyone else can bootstrap from
+    llarp::RouterContact
+    MakeSeed()
+    {
+      tooling::RouterHive hive{true};
+      hive.AddRelay(RelayConfig(0, std::nullopt));
+      hive.StartRelays();
+      hive.RunFor(2s);
+      auto rc = hive.GetRelayRCs().at(0);
+      hive.StopRouters();
+      return rc;
+    }
+
+    /// a fresh network of relays with clients set up by makeClients, all started and settled
+    template <typename MakeClients_t>
+    std::unique_ptr<tooling::RouterHive>
+    MakeHive(const llarp::RouterContact& seed, bool relayTun, MakeClients_t&& makeClients)
+    {
+      // keep relay 0 for its keys and rc, everything else starts from scratch
+      for (const auto& dir : fs::directory_iterator{BenchDir / "relays"})
+      {
+        if (dir.path().filename() != "0")
+          fs::remove_all(dir.path());
+      }
+      fs::remove_all(BenchDir / "clients");
+
+      auto hive = std::make_unique<tooling::RouterHive>(true, 0);
+      tooling::LinkParams link;
+      link.latency = 10ms;
+      hive->SetDefaultLink(link);
+      for (size_t idx = 0; idx < NumRelays; ++idx)
+      {
+        auto conf = RelayConfig(idx, idx ? std::make_optional(seed) : std::nullopt);
+        // the last relay is the one clients talk to as a .snode
+        if (relayTun and idx + 1 == NumRelays)
+          UseInterface(*conf, 1);
+        hive->AddRelay(conf);
+      }
+      makeClients(*hive);
+      hive->StartRelays();
+      hive->RunFor(5s);
+      hive->StartClients();
+      hive->RunFor(10s);
+      return hive;
+    }
+
+    Context_ptr
+    AddClient(tooling::RouterHive& hive, const llarp::RouterContact& seed, size_t idx, bool allowExit)
+    {
+      auto conf = ClientConfig(idx, seed);
+      UseInterface(*conf, 10 + idx);
+      conf->network.m_AllowExit = allowExit;
+      const auto before = hive.clients;
+      hive.AddClient(conf);
+      for (const auto& [id, ctx] : hive.clients)
+      {
+        if (not before.count(id))
+          return ctx;
+      }
+      throw std::runtime_error{"client went missing from the hive"};
+    }
+
+    llarp::service::Address
+    AddressOf(const Context_ptr& ctx)
+    {
+      return ctx->router->hiddenServiceContext().GetDefault()->GetIdentity().pub.Addr();
+    }
+
+    /// client to a relay's exit endpoint as a .snode
+    void
+    RunRelay(const Report_t& report, const llarp::RouterContact& seed)
+    {
+      Context_ptr client;
+      auto hive = MakeHive(
+          seed, true, [&](auto& into) { client = AddClient(into, seed, 0, false); });
+      Context_ptr relay;
+      for (const auto& [id, ctx] : hive->relays)
+      {
+        if (ctx->simVPN and ctx->simVPN->GetInterface("bench1"))
+          relay = ctx;
+      }
+      if (not relay)
+        throw std::runtime_error{"no relay came up with an exit interface"};
+      const llarp::RouterID relayID{relay->router->pubkey()};
+      const auto dst = CallOn(*hive, client, [&]() {
+        auto ep = client->router->hiddenServiceContext().GetDefault();
+        ep->MarkAddressOutbound(relayID);
+        return llarp::net::TruncateV6(ep->ObtainIPForAddr(relayID));
+      });
+      Flow flow{*hive, client, "bench10", dst, relay->simVPN->GetInterface("bench1")};
+      Measure(report, "relay", *hive, flow);
+      hive->StopRouters();
+    }
+
+    /// client to client over .loki
+    void
+    RunHiddenService(const Report_t& report, const llarp::RouterContact& seed)
+    {
+      Context_ptr alice, bob;
+      auto hive = MakeHive(seed, false, [&](auto& into) {
+        alice = AddClient(into, seed, 0, false);
+        bob = AddClient(into, seed, 1, false);
+      });
+      const auto dst = CallOn(*hive, alice, [&]() {
+        auto ep = alice->router->hiddenServiceContext().GetDefault();
+        const auto addr = AddressOf(bob);
+        ep->MarkAddressOutbound(addr);
+        return llarp::net::TruncateV6(ep->ObtainIPForAddr(addr));
+      });
+      Flow flow{*hive, alice, "bench10", dst, bob->simVPN->GetInterface("bench11")};
+      Measure(report, "hidden-service", *hive, flow);
+      hive->StopRouters();
+    }
+
+    /// client to a public ip through another client acting as an exit
+    void
+    RunExit(const Report_t& report, const llarp::RouterContact& seed)
+    {
+      Context_ptr client, exitNode;
+      auto hive = MakeHive(seed, false, [&](auto& into) {
+        client = AddClient(into, seed, 0, false);
+        exitNode = AddClient(into, seed, 1, true);
+      });
+      CallOn(*hive, client, [&]() {
+        client->router->hiddenServiceContext().GetDefault()->MapExitRange(
+            llarp::IPRange::FromIPv4(0, 0, 0, 0, 0), AddressOf(exitNode));
+        return true;
+      });
+      Flow flow{*hive, client, "bench10", TargetIP, exitNode->simVPN->GetInterface("bench11")};
+      Measure(report, "exit", *hive, flow);
+      hive->StopRouters();
+    }
+  }  // namespace
+
+  void
+  RunNetwork(const Report_t& report)
+  {
+    fs::remove_all(BenchDir);
+    const auto seed = MakeSeed();
+    RunRelay(report, seed);
+    RunHiddenService(report, seed);
+    RunExit(report, seed);
+    fs::remove_all(BenchDir);
+  }
+}  // namespace bench
@@ -0,0 +1,144 @@
+#include "bench.hpp"
+
+#include <llarp/constants/version.hpp>
+#include <llarp/crypto/crypto.hpp>
+#include <llarp/crypto/crypto_libsodium.hpp>
+#include <llarp/util/logging.hpp>
+#include <llarp/util/service_manager.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <new>
+#include <set>
+
+namespace
+{
+  std::atomic<uint64_t> allocations{0};
+}  // namespace
+
+/// count every allocation so benchmarks can report how many they make per operation
+void*
+operator new(size_t sz)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto* ptr = std::malloc(sz ? sz : 1))
+    return ptr;
+  throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace bench
+{
+  uint64_t
+  Allocations()
+  {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+  std::chrono::nanoseconds
+  CPUTime()
+  {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+  }
+
+  void
+  Micro(
+      const Report_t& report,
+      std::string suite,
+      std::string name,
+      uint64_t iterations,
+      const std::function<void()>& op)
+  {
+    // one untimed call so lazy setup does not count against the first benchmark
+    op();
+    const auto allocsBefore = Allocations();
+    const auto started = std::chrono::steady_clock::now();
+    for (uint64_t idx = 0; idx < iterations; ++idx)
+      op();
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - started;
+    const auto allocs = Allocations() - allocsBefore;
+
+    report(nlohmann::json{
+        {"suite", std::move(suite)},
+        {"name", std::move(name)},
+        {"iterations", iterations},
+        {"ns_per_op", elapsed.count() / iterations},
+        {"ops_per_sec", iterations / (elapsed.count() / 1e9)},
+        {"allocs_per_op", double(allocs) / iterations}});
+  }
+}  // namespace bench
+
+int
+main(int argc, char* argv[])
+{
+  llarp::sys::service_manager->disable();
+  llarp::log::reset_level(llarp::log::Level::off);
+
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager{&crypto};
+
+  const std::map<std::string, void (*)(const bench::Report_t&)> suites{
+      {"crypto", bench::RunCrypto},
+      {"bencode", bench::RunBencode},
+      {"queue", bench::RunQueue},
+      {"snapshot", bench::RunSnapshot},
+      {"iprangemap", bench::RunIPRangeMap},
+      {"transit_hop", bench::RunTransitHop},
+      {"nodedb", bench::RunNodeDB},
+      {"convo", bench::RunConvo},
+      {"dns", bench::RunDNS},
+#ifdef LOKINET_HIVE
+      {"network", bench::RunNetwork},
+#endif
+  };
+
+  // run the suites named on the command line, or all of them
+  std::set<std::string> wanted;
+  for (int idx = 1; idx < argc; ++idx)
+  {
+    const std::string arg{argv[idx]};
+    if (arg == "-h" or arg == "--help")
+    {
+      std::cout << "usage: " << argv[0] << " [suite...]\nsuites:";
+      for (const auto& [name, run] : suites)
+        std::cout << " " << name;
+      std::cout << std::endl;
+      return 0;
+    }
+    if (not suites.count(arg))
+    {
+      std::cerr << "no such benchmark suite: " << arg << std::endl;
+      return 1;
+    }
+    wanted.insert(arg);
+  }
+
+  const auto report = [](nlohmann::json result) { std::cout << result.dump() << std::endl; };
+  report(nlohmann::json{
+      {"suite", "meta"},
+      {"version", llarp::VERSION_FULL},
+      {"time", std::time(nullptr)}});
+  for (const auto& [name, run] : suites)
+  {
+    if (wanted.empty() or wanted.count(name))
+      run(report);
+  }
+  return 0;
+}
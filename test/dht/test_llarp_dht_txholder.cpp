@@ -0,0 +1,99 @@
+#include <llarp/dht/txholder.hpp>
+#include <llarp/router_id.hpp>
+
+#include <catch2/catch.hpp>
+#include "mocks/mock_loop.hpp"
+#include "test_util.hpp"
+
+using namespace std::literals;
+using llarp::RouterID;
+using llarp::dht::TXOwner;
+using llarp::test::makeBuf;
+
+namespace
+{
+  /// counts its replies
+  struct CountingTX : public llarp::dht::TX<RouterID, RouterID>
+  {
+    size_t& replies;
+
+    CountingTX(const RouterID& target, size_t& replies)
+        : TX{TXOwner{}, target, nullptr}, replies{replies}
+    {}
+
+    bool
+    Validate(const RouterID&) const override
+    {
+      return true;
+    }
+
+    void
+    Start(const TXOwner&) override
+    {}
+
+    void
+    SendReply() override
+    {
+      replies++;
+    }
+  };
+}  // namespace
+
+TEST_CASE("DHT lookups time out from event loop timers", "[dht]")
+{
+  auto loop = std::make_shared<mocks::ManualLoop>();
+  llarp::dht::TXHolder<RouterID, RouterID> lookups;
+  lookups.SetLoop(loop);
+
+  const auto target = makeBuf<RouterID>(1);
+  const TXOwner asked{makeBuf<llarp::dht::Key_t>(2), 1};
+  size_t replies = 0;
+  lookups.NewTX(asked, TXOwner{}, target, new CountingTX{target, replies}, 5s);
+  REQUIRE(lookups.HasLookupFor(target));
+  REQUIRE(loop->NumTimers() == 1);
+
+  SECTION("times out once its time is up")
+  {
+    loop->Advance(4999ms);
+    CHECK(lookups.HasLookupFor(target));
+    CHECK(replies == 0);
+    loop->Advance(1ms);
+    CHECK_FALSE(lookups.HasLookupFor(target));
+    CHECK_FALSE(lookups.HasPendingLookupFrom(asked));
+    CHECK(replies == 1);
+  }
+
+  SECTION("an answered lookup drops its timer")
+  {
+    lookups.Found(asked, target, {makeBuf<RouterID>(3)});
+    CHECK_FALSE(lookups.HasLookupFor(target));
+    CHECK(replies == 1);
+    CHECK(loop->NumTimers() == 0);
+    loop->Advance(10s);
+    CHECK(replies == 1);
+  }
+
+  SECTION("a second asker for the same key shares the timer")
+  {
+    const TXOwner other{makeBuf<llarp::dht::Key_t>(4), 2};
+    lookups.NewTX(other, TXOwner{}, target, new CountingTX{target, replies}, 5s);
+    CHECK(loop->NumTimers() == 1);
+    loop->Advance(5s);
+    CHECK(replies == 2);
+  }
+}
+
+TEST_CASE("DHT lookups that go away cancel their timers", "[dht]")
+{
+  auto loop = std::make_shared<mocks::ManualLoop>();
+  {
+    llarp::dht::TXHolder<RouterID, RouterID> lookups;
+    lookups.SetLoop(loop);
+    const auto target = makeBuf<RouterID>(1);
+    size_t replies = 0;
+    lookups.NewTX(TXOwner{}, TXOwner{}, target, new CountingTX{target, replies}, 5s);
+    REQUIRE(loop->NumTimers() == 1);
+  }
+  CHECK(loop->NumTimers() == 0);
+  loop->Advance(10s);
+}
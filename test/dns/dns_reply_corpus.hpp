@@ -0,0 +1,121 @@
+#pragma once
+#include <llarp/util/types.hpp>
+
+#include <vector>
+
+namespace dns_corpus
+{
+  using Packet = std::vector<byte_t>;
+
+  /// upstream replies laid out the way recursive resolvers send them: names compressed against
+  /// everything before them including inside rdata, mixed case kept as asked, edns opt records,
+  /// records in the authority and additional sections. the fuzz test mutates these and every
+  /// one must survive a round trip through dns::Message unchanged.
+  inline std::vector<Packet>
+  Replies()
+  {
+    return {
+    // CNAME chain to an A record
+    Packet{
+        0x5c, 0x1e, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x03, 0x77, 0x77,
+        0x77, 0x06, 0x67, 0x69, 0x74, 0x68, 0x75, 0x62, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x01,
+        0x00, 0x01, 0xc0, 0x0c, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x02, 0xc0,
+        0x10, 0xc0, 0x10, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x04, 0x8c, 0x52,
+        0x79, 0x04, 0x00, 0x00, 0x29, 0x04, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    },
+    // MX records whose exchanges point into each other
+    Packet{
+        0x0b, 0x7a, 0x81, 0x80, 0x00, 0x01, 0x00, 0x05, 0x00, 0x00, 0x00, 0x01, 0x05, 0x67, 0x6d,
+        0x61, 0x69, 0x6c, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x0f, 0x00, 0x01, 0xc0, 0x0c, 0x00,
+        0x0f, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x1b, 0x00, 0x05, 0x0d, 0x67, 0x6d, 0x61,
+        0x69, 0x6c, 0x2d, 0x73, 0x6d, 0x74, 0x70, 0x2d, 0x69, 0x6e, 0x01, 0x6c, 0x06, 0x67, 0x6f,
+        0x6f, 0x67, 0x6c, 0x65, 0xc0, 0x12, 0xc0, 0x0c, 0x00, 0x0f, 0x00, 0x01, 0x00, 0x00, 0x0e,
+        0x10, 0x00, 0x09, 0x00, 0x0a, 0x04, 0x61, 0x6c, 0x74, 0x31, 0xc0, 0x29, 0xc0, 0x0c, 0x00,
+        0x0f, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x09, 0x00, 0x14, 0x04, 0x61, 0x6c, 0x74,
+        0x32, 0xc0, 0x29, 0xc0, 0x0c, 0x00, 0x0f, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x09,
+        0x00, 0x1e, 0x04, 0x61, 0x6c, 0x74, 0x33, 0xc0, 0x29, 0xc0, 0x0c, 0x00, 0x0f, 0x00, 0x01,
+        0x00, 0x00, 0x0e, 0x10, 0x00, 0x09, 0x00, 0x28, 0x04, 0x61, 0x6c, 0x74, 0x34, 0xc0, 0x29,
+        0x00, 0x00, 0x29, 0x04, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    },
+    // NS records with glue in the additional section
+    Packet{
+        0x7f, 0x00, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x04, 0x07, 0x65, 0x78,
+        0x61, 0x6d, 0x70, 0x6c, 0x65, 0x03, 0x6f, 0x72, 0x67, 0x00, 0x00, 0x02, 0x00, 0x01, 0xc0,
+        0x0c, 0x00, 0x02, 0x00, 0x01, 0x00, 0x01, 0x51, 0x80, 0x00, 0x14, 0x01, 0x61, 0x0c, 0x69,
+        0x61, 0x6e, 0x61, 0x2d, 0x73, 0x65, 0x72, 0x76, 0x65, 0x72, 0x73, 0x03, 0x6e, 0x65, 0x74,
+        0x00, 0xc0, 0x0c, 0x00, 0x02, 0x00, 0x01, 0x00, 0x01, 0x51, 0x80, 0x00, 0x04, 0x01, 0x62,
+        0xc0, 0x2b, 0xc0, 0x29, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x07, 0x08, 0x00, 0x04, 0xc7,
+        0x2b, 0x87, 0x35, 0xc0, 0x29, 0x00, 0x1c, 0x00, 0x01, 0x00, 0x00, 0x07, 0x08, 0x00, 0x10,
+        0x20, 0x01, 0x05, 0x00, 0x00, 0x8f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x53, 0xc0, 0x49, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x07, 0x08, 0x00, 0x04, 0xc7, 0x2b,
+        0x85, 0x35, 0x00, 0x00, 0x29, 0x04, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    },
+    // NXDOMAIN with the zone SOA in the authority section
+    Packet{
+        0xde, 0xad, 0x81, 0x83, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x0c, 0x64, 0x6f,
+        0x65, 0x73, 0x6e, 0x6f, 0x74, 0x65, 0x78, 0x69, 0x73, 0x74, 0x07, 0x65, 0x78, 0x61, 0x6d,
+        0x70, 0x6c, 0x65, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x01, 0x00, 0x01, 0xc0, 0x19, 0x00,
+        0x06, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x2c, 0x02, 0x6e, 0x73, 0x05, 0x69, 0x63,
+        0x61, 0x6e, 0x6e, 0x03, 0x6f, 0x72, 0x67, 0x00, 0x03, 0x6e, 0x6f, 0x63, 0x03, 0x64, 0x6e,
+        0x73, 0xc0, 0x39, 0x78, 0x96, 0x0f, 0x8d, 0x00, 0x00, 0x1c, 0x20, 0x00, 0x00, 0x0e, 0x10,
+        0x00, 0x12, 0x75, 0x00, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x00, 0x29, 0x04, 0xd0, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    },
+    // CNAME to a name with no AAAA, SOA in the authority section
+    Packet{
+        0x22, 0x22, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x03, 0x77, 0x77,
+        0x77, 0x07, 0x45, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x03, 0x4e, 0x45, 0x54, 0x00, 0x00,
+        0x1c, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x01, 0x2c, 0x00, 0x22,
+        0x04, 0x65, 0x64, 0x67, 0x65, 0x07, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x03, 0x6e,
+        0x65, 0x74, 0x03, 0x63, 0x64, 0x6e, 0x0a, 0x63, 0x6c, 0x6f, 0x75, 0x64, 0x66, 0x6c, 0x61,
+        0x72, 0x65, 0xc0, 0x18, 0xc0, 0x42, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00, 0x07, 0x08, 0x00,
+        0x2e, 0x03, 0x6e, 0x73, 0x31, 0xc0, 0x42, 0x03, 0x64, 0x6e, 0x73, 0x0a, 0x63, 0x6c, 0x6f,
+        0x75, 0x64, 0x66, 0x6c, 0x61, 0x72, 0x65, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x8a, 0x9a, 0x94,
+        0xc8, 0x00, 0x00, 0x27, 0x10, 0x00, 0x00, 0x09, 0x60, 0x00, 0x09, 0x3a, 0x80, 0x00, 0x00,
+        0x07, 0x08
+    },
+    // PTR record
+    Packet{
+        0x11, 0x11, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x01, 0x31, 0x01,
+        0x31, 0x01, 0x31, 0x01, 0x31, 0x07, 0x69, 0x6e, 0x2d, 0x61, 0x64, 0x64, 0x72, 0x04, 0x61,
+        0x72, 0x70, 0x61, 0x00, 0x00, 0x0c, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x0c, 0x00, 0x01, 0x00,
+        0x00, 0x07, 0x08, 0x00, 0x11, 0x03, 0x6f, 0x6e, 0x65, 0x03, 0x6f, 0x6e, 0x65, 0x03, 0x6f,
+        0x6e, 0x65, 0x03, 0x6f, 0x6e, 0x65, 0x00, 0x00, 0x00, 0x29, 0x04, 0xd0, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00
+    },
+    // SRV records
+    Packet{
+        0x33, 0x33, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x5f, 0x78,
+        0x6d, 0x70, 0x70, 0x2d, 0x73, 0x65, 0x72, 0x76, 0x65, 0x72, 0x04, 0x5f, 0x74, 0x63, 0x70,
+        0x06, 0x6a, 0x61, 0x62, 0x62, 0x65, 0x72, 0x03, 0x6f, 0x72, 0x67, 0x00, 0x00, 0x21, 0x00,
+        0x01, 0xc0, 0x0c, 0x00, 0x21, 0x00, 0x01, 0x00, 0x00, 0x03, 0x84, 0x00, 0x1a, 0x00, 0x00,
+        0x00, 0x00, 0x14, 0x95, 0x07, 0x68, 0x65, 0x72, 0x6d, 0x65, 0x73, 0x32, 0x06, 0x6a, 0x61,
+        0x62, 0x62, 0x65, 0x72, 0x03, 0x6f, 0x72, 0x67, 0x00, 0xc0, 0x0c, 0x00, 0x21, 0x00, 0x01,
+        0x00, 0x00, 0x03, 0x84, 0x00, 0x19, 0x00, 0x0a, 0x00, 0x05, 0x14, 0x95, 0x06, 0x68, 0x65,
+        0x72, 0x6d, 0x65, 0x73, 0x06, 0x6a, 0x61, 0x62, 0x62, 0x65, 0x72, 0x03, 0x6f, 0x72, 0x67,
+        0x00
+    },
+    // TXT records
+    Packet{
+        0x44, 0x44, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x07, 0x65, 0x78,
+        0x61, 0x6d, 0x70, 0x6c, 0x65, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x10, 0x00, 0x01, 0xc0,
+        0x0c, 0x00, 0x10, 0x00, 0x01, 0x00, 0x01, 0x51, 0x80, 0x00, 0x0c, 0x0b, 0x76, 0x3d, 0x73,
+        0x70, 0x66, 0x31, 0x20, 0x2d, 0x61, 0x6c, 0x6c, 0xc0, 0x0c, 0x00, 0x10, 0x00, 0x01, 0x00,
+        0x01, 0x51, 0x80, 0x00, 0x2f, 0x20, 0x77, 0x67, 0x79, 0x66, 0x38, 0x7a, 0x38, 0x63, 0x67,
+        0x76, 0x6d, 0x32, 0x71, 0x6d, 0x78, 0x70, 0x6e, 0x62, 0x6e, 0x6c, 0x64, 0x72, 0x63, 0x6c,
+        0x74, 0x76, 0x6b, 0x34, 0x78, 0x71, 0x66, 0x6e, 0x0d, 0x73, 0x65, 0x63, 0x6f, 0x6e, 0x64,
+        0x20, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x00, 0x00, 0x29, 0x04, 0xd0, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00
+    },
+    // CNAME to an AAAA record
+    Packet{
+        0x55, 0x55, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x04, 0x69, 0x70,
+        0x76, 0x36, 0x06, 0x67, 0x6f, 0x6f, 0x67, 0x6c, 0x65, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00,
+        0x1c, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x54, 0x60, 0x00, 0x09,
+        0x04, 0x69, 0x70, 0x76, 0x36, 0x01, 0x6c, 0xc0, 0x11, 0xc0, 0x2d, 0x00, 0x1c, 0x00, 0x01,
+        0x00, 0x00, 0x01, 0x2c, 0x00, 0x10, 0x2a, 0x00, 0x14, 0x50, 0x40, 0x01, 0x08, 0x1c, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x0e
+    },
+    };
+  }
+}  // namespace dns_corpus
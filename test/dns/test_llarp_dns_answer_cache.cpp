@@ -0,0 +1,117 @@
+#include <catch2/catch.hpp>
+#include <llarp/dns/answer_cache.hpp>
+#include <llarp/dns/dns.hpp>
+#include <llarp/net/net_int.hpp>
+
+using namespace llarp;
+
+namespace
+{
+  dns::Message
+  MakeQuery(std::string name, dns::QType_t qtype = dns::qTypeA, dns::MsgID_t id = 1)
+  {
+    dns::Message msg{dns::Question{std::move(name), qtype}};
+    msg.hdr_id = id;
+    return msg;
+  }
+}  // namespace
+
+TEST_CASE("DNS answer cache", "[dns]")
+{
+  dns::AnswerCache cache;
+  auto answer = MakeQuery("foo.loki.");
+  answer.AddINReply(huint128_t{0x0a000001}, false, 60);
+
+  SECTION("answers are cached for their ttl")
+  {
+    CHECK(cache.Pend(answer, nullptr, 10s));
+    cache.Put(answer, 10s);
+    CHECK(cache.size() == 1);
+
+    auto query = MakeQuery("FOO.loki.", dns::qTypeA, 7);
+    REQUIRE(cache.Get(query, 30s));
+    CHECK(query.hdr_id == 7);
+    REQUIRE(query.answers.size() == 1);
+    CHECK(query.answers[0].ttl == 40);
+    CHECK(query.answers[0].rData == answer.answers[0].rData);
+
+    auto aaaa = MakeQuery("foo.loki.", dns::qTypeAAAA);
+    CHECK(not cache.Get(aaaa, 30s));
+
+    auto late = MakeQuery("foo.loki.");
+    CHECK(not cache.Get(late, 70s));
+    CHECK(cache.size() == 0);
+  }
+
+  SECTION("short ttls and failures are not cached")
+  {
+    auto uncached = MakeQuery("bar.loki.");
+    uncached.AddINReply(huint128_t{0x0a000002}, false, 1);
+    cache.Put(uncached, 0s);
+    auto fail = MakeQuery("baz.loki.");
+    fail.AddServFail();
+    cache.Put(fail, 0s);
+    auto nx = MakeQuery("nope.loki.");
+    nx.AddNXReply();
+    cache.Put(nx, 0s);
+    CHECK(cache.size() == 0);
+  }
+
+  SECTION("negative answers are cached for their nx ttl")
+  {
+    auto nx = MakeQuery("nope.loki.");
+    nx.AddNXReply(dns::NegativeAnswerTTL);
+    cache.Put(nx, 0s);
+    auto query = MakeQuery("nope.loki.");
+    REQUIRE(cache.Get(query, 1s));
+    CHECK((query.hdr_fields & 0xf) == dns::flags_RCODENameError);
+    CHECK(query.answers.empty());
+    auto late = MakeQuery("nope.loki.");
+    CHECK(not cache.Get(late, std::chrono::seconds{dns::NegativeAnswerTTL}));
+  }
+
+  SECTION("concurrent lookups are coalesced")
+  {
+    std::vector<dns::MsgID_t> replied;
+    auto first = MakeQuery("foo.loki.", dns::qTypeA, 1);
+    CHECK(cache.Pend(first, nullptr, 0s));
+    for (dns::MsgID_t id = 2; id < 5; ++id)
+    {
+      auto reply = [&replied](auto msg) {
+        CHECK(msg.answers.size() == 1);
+        replied.push_back(msg.hdr_id);
+      };
+      CHECK(not cache.Pend(MakeQuery("foo.loki.", dns::qTypeA, id), reply, 1s));
+    }
+    CHECK(replied.empty());
+    cache.Put(answer, 0s);
+    CHECK(replied == std::vector<dns::MsgID_t>{2, 3, 4});
+    // the next query starts a new lookup
+    CHECK(cache.Pend(MakeQuery("bar.loki."), nullptr, 1s));
+  }
+
+  SECTION("abandoned lookups fail their waiters")
+  {
+    std::vector<uint16_t> rcodes;
+    auto reply = [&rcodes](auto msg) { rcodes.push_back(msg.hdr_fields & 0xf); };
+    auto query = MakeQuery("foo.loki.");
+    CHECK(cache.Pend(query, nullptr, 0s));
+    CHECK(not cache.Pend(query, reply, 0s));
+    cache.Cancel(query);
+    CHECK(rcodes == std::vector<uint16_t>{dns::flags_RCODEServFail});
+
+    // lookups that never answer are given up on
+    CHECK(cache.Pend(query, nullptr, 0s));
+    CHECK(not cache.Pend(query, reply, 0s));
+    cache.Expire(1min);
+    CHECK(rcodes.size() == 2);
+    CHECK(cache.Pend(query, nullptr, 1min));
+  }
+
+  SECTION("ttls are clamped")
+  {
+    CHECK(dns::AnswerTTL(0s) == 1);
+    CHECK(dns::AnswerTTL(90s) == 90);
+    CHECK(dns::AnswerTTL(1h) == dns::MaxAnswerTTL);
+  }
+}
@@ -0,0 +1,370 @@
+#include "dns_reply_corpus.hpp"
+
+#include <catch2/catch.hpp>
+#include <llarp/dns/dns.hpp>
+#include <llarp/dns/message.hpp>
+#include <llarp/dns/packet.hpp>
+#include <llarp/util/buffer.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace llarp;
+using namespace llarp::dns;
+
+namespace
+{
+  using Packet = std::vector<byte_t>;
+
+  byte_view_t
+  View(const Packet& pkt)
+  {
+    return byte_view_t{pkt.data(), pkt.size()};
+  }
+
+  /// a reply to "Example.COM. A" with a compressed answer name and a CNAME whose target points
+  /// into the middle of the question name
+  const Packet compressed_reply{
+      0x12, 0x34, 0x81, 0x80, 0, 1, 0, 2, 0, 0, 0, 0,
+      // question: example.com A IN
+      7, 'E', 'x', 'a', 'm', 'p', 'l', 'e', 3, 'C', 'O', 'M', 0, 0, 1, 0, 1,
+      // answer: www.example.com CNAME example.com
+      3, 'w', 'w', 'w', 0xc0, 12, 0, 5, 0, 1, 0, 0, 0, 60, 0, 2, 0xc0, 12,
+      // answer: example.com A 10.0.0.1
+      0xc0, 12, 0, 1, 0, 1, 0, 0, 1, 0, 0, 4, 10, 0, 0, 1};
+
+  /// well formed packets the fuzzer starts from
+  std::vector<Packet>
+  SeedCorpus()
+  {
+    std::vector<Packet> corpus = dns_corpus::Replies();
+    corpus.push_back(compressed_reply);
+    // plain query with an edns opt record in the additional section
+    corpus.push_back(Packet{0xab, 0xcd, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, 1,
+                            3,    'f',  'o',  'o',  4, 'l', 'o', 'k', 'i', 0, 0, 28, 0, 1,
+                            0,    0,    41,   0x10, 0, 0, 0, 0, 0, 0, 0});
+    // root query
+    corpus.push_back(Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 1});
+    // a reply we wrote ourselves with every record type we hand out
+    Message msg{Question{"some.name.loki.", qTypeA}};
+    msg.AddCNAMEReply("other.name.loki");
+    msg.AddMXReply("mail.name.loki", 10);
+    msg.AddTXTReply("hello");
+    msg.AddINReply(huint128_t{0x0a000001}, false);
+    auto buf = msg.ToBuffer();
+    corpus.emplace_back(buf.buf.get(), buf.buf.get() + buf.sz);
+    return corpus;
+  }
+
+  /// packets that are broken in ways a naive parser trips over
+  std::vector<Packet>
+  BadCorpus()
+  {
+    return {
+        // short header
+        Packet{0, 1, 0, 0, 0, 1},
+        // question count with no question
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
+        // label runs off the end
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 9, 'a', 'b', 0},
+        // pointer to itself
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0xc0, 12, 0, 1, 0, 1},
+        // pointer forwards
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0xc0, 14, 0, 1, 0, 1, 0},
+        // two pointers pointing at each other through a label
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 'a', 0xc0, 12, 0, 1, 0, 1},
+        // truncated pointer
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0xc0},
+        // extended label type
+        Packet{0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0x41, 'a', 0, 0, 1, 0, 1},
+        // rdata longer than the packet
+        Packet{0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 9, 1, 2},
+    };
+  }
+
+  /// walk everything in a parsed message the way the server does
+  size_t
+  Exercise(const MessageView& view)
+  {
+    size_t n = 0;
+    view.ForEachQuestion([&n](const QuestionView& q) {
+      n += q.qname.ToString().size();
+      n += q.qname.EndsWith("loki");
+    });
+    for (auto section : {Section::answer, Section::authority, Section::additional})
+      view.ForEachRecord(section, [&n, &view](const RecordView& rr) {
+        n += rr.rr_name.ToString().size() + view.RData(rr).size();
+      });
+    return n;
+  }
+
+  /// encode msg and decode it again
+  std::optional<Message>
+  RoundTrip(const Message& msg)
+  {
+    std::array<byte_t, 4096> out;
+    llarp_buffer_t outbuf{out};
+    if (not msg.Encode(&outbuf))
+      return std::nullopt;
+    auto view = MessageView::Parse(byte_view_t{out.data(), size_t(outbuf.cur - outbuf.base)});
+    REQUIRE(view);
+    return Message{*view};
+  }
+
+  void
+  CheckSameMessage(const Message& decoded, const Message& expected)
+  {
+    CHECK(decoded.hdr_id == expected.hdr_id);
+    CHECK(decoded.hdr_fields == expected.hdr_fields);
+    CHECK(decoded.questions == expected.questions);
+    REQUIRE(decoded.answers.size() == expected.answers.size());
+    for (size_t idx = 0; idx < decoded.answers.size(); ++idx)
+    {
+      const auto& got = decoded.answers[idx];
+      const auto& want = expected.answers[idx];
+      INFO("answer " << idx << " " << want.rr_name);
+      CHECK(got.rr_name == want.rr_name);
+      CHECK(got.rr_type == want.rr_type);
+      CHECK(got.rr_class == want.rr_class);
+      CHECK(got.ttl == want.ttl);
+      CHECK(got.rData == want.rData);
+    }
+  }
+
+  /// an uncompressed encoded name
+  Packet
+  Encoded(std::string_view name)
+  {
+    Packet out;
+    while (not name.empty())
+    {
+      const auto label = name.substr(0, name.find('.'));
+      out.push_back(label.size());
+      out.insert(out.end(), label.begin(), label.end());
+      name.remove_prefix(std::min(name.size(), label.size() + 1));
+    }
+    out.push_back(0);
+    return out;
+  }
+}  // namespace
+
+TEST_CASE("DNS message view follows compressed names", "[dns]")
+{
+  auto view = MessageView::Parse(View(compressed_reply));
+  REQUIRE(view);
+  CHECK(view->Header().id == 0x1234);
+  CHECK(view->Header().an_count == 2);
+
+  auto q = view->FirstQuestion();
+  REQUIRE(q);
+  CHECK(q->qname.ToString() == "Example.COM.");
+  CHECK(q->qname.Equals("example.com"));
+  CHECK(q->qname.Equals("EXAMPLE.com."));
+  CHECK_FALSE(q->qname.Equals("example.co"));
+  CHECK_FALSE(q->qname.Equals("www.example.com"));
+  CHECK(q->qname.EndsWith(".com"));
+  CHECK(q->qname.EndsWith("example.com."));
+  CHECK_FALSE(q->qname.EndsWith("ample.com"));
+  CHECK(q->qtype == qTypeA);
+
+  std::vector<std::string> names;
+  std::vector<RRType_t> types;
+  view->ForEachRecord(Section::answer, [&](const RecordView& rr) {
+    names.push_back(rr.rr_name.ToString());
+    types.push_back(rr.rr_type);
+  });
+  CHECK(names == std::vector<std::string>{"www.Example.COM.", "Example.COM."});
+  CHECK(types == std::vector<RRType_t>{qTypeCNAME, qTypeA});
+
+  // the old decoder could not follow pointers, the message built from the view can
+  auto msg = MaybeParseDNSMessage(llarp_buffer_t{compressed_reply});
+  REQUIRE(msg);
+  REQUIRE(msg->answers.size() == 2);
+  CHECK(msg->answers[0].rr_name == "www.Example.COM.");
+  CHECK(msg->answers[1].rData == std::vector<byte_t>{10, 0, 0, 1});
+}
+
+TEST_CASE("DNS message spells out compressed names in rdata", "[dns]")
+{
+  auto msg = MaybeParseDNSMessage(llarp_buffer_t{compressed_reply});
+  REQUIRE(msg);
+  REQUIRE(msg->answers.size() == 2);
+  // the CNAME target was a pointer into the question
+  CHECK(msg->answers[0].rData == Encoded("Example.COM"));
+
+  const auto replies = dns_corpus::Replies();
+  // MX records whose exchanges point into each other
+  auto mx = MessageView::Parse(View(replies[1]));
+  REQUIRE(mx);
+  std::vector<Packet> rdata;
+  mx->ForEachRecord(
+      Section::answer, [&](const RecordView& rr) { rdata.push_back(mx->RData(rr)); });
+  REQUIRE(rdata.size() == 5);
+  Packet alt1{0, 10};
+  const auto alt1name = Encoded("alt1.gmail-smtp-in.l.google.com");
+  alt1.insert(alt1.end(), alt1name.begin(), alt1name.end());
+  CHECK(rdata[1] == alt1);
+
+  // the SOA in the authority section has two names and five numbers
+  auto nx = MessageView::Parse(View(replies[3]));
+  REQUIRE(nx);
+  nx->ForEachRecord(Section::authority, [&](const RecordView& rr) {
+    REQUIRE(rr.rr_type == qTypeSOA);
+    auto expect = Encoded("ns.icann.org");
+    const auto rname = Encoded("noc.dns.icann.org");
+    expect.insert(expect.end(), rname.begin(), rname.end());
+    const auto soa = nx->RData(rr);
+    REQUIRE(soa.size() == expect.size() + 20);
+    CHECK(Packet{soa.begin(), soa.begin() + expect.size()} == expect);
+    CHECK(Packet{soa.end() - 20, soa.end()} == Packet{rr.rData.end() - 20, rr.rData.end()});
+  });
+
+  // a name in rdata that runs past the rdata is a malformed record
+  Packet broken = compressed_reply;
+  // CNAME rdata length down to 1, its pointer now ends outside of it
+  broken[44] = 1;
+  broken.erase(broken.begin() + 46);
+  CHECK_FALSE(MessageView::Parse(View(broken)));
+}
+
+TEST_CASE("DNS replies survive a round trip through Message", "[dns]")
+{
+  for (const auto& pkt : dns_corpus::Replies())
+  {
+    auto msg = MaybeParseDNSMessage(llarp_buffer_t{pkt});
+    REQUIRE(msg);
+    auto again = RoundTrip(*msg);
+    REQUIRE(again);
+    CheckSameMessage(*again, *msg);
+    // and the names in the rdata still read the same from the packet we wrote
+    auto twice = RoundTrip(*again);
+    REQUIRE(twice);
+    CheckSameMessage(*twice, *msg);
+  }
+}
+
+TEST_CASE("DNS packet writer compresses names", "[dns]")
+{
+  std::array<byte_t, 512> buf{};
+  PacketWriter writer{buf};
+  writer.Header(0x4242, flags_QR);
+  writer.Question("foo.example.loki.", qTypeA);
+  const std::array<byte_t, 4> addr{10, 0, 0, 1};
+  writer.Record(Section::answer, "foo.example.loki", qTypeA, 60, byte_view_t{addr.data(), 4});
+  writer.NameRecord(Section::answer, "FOO.example.loki", qTypeCNAME, 60, "bar.example.loki");
+  auto sz = writer.Finish();
+  REQUIRE(sz);
+
+  // header + question + answer with a pointer for its name
+  CHECK(*sz > MessageHeader::Size + 22 + 2 + 14);
+  CHECK(buf[MessageHeader::Size + 22] == 0xc0);
+  CHECK(buf[MessageHeader::Size + 23] == MessageHeader::Size);
+
+  auto view = MessageView::Parse(byte_view_t{buf.data(), *sz});
+  REQUIRE(view);
+  CHECK(view->Header().id == 0x4242);
+  CHECK(view->Header().an_count == 2);
+  std::vector<std::string> targets;
+  view->ForEachRecord(Section::answer, [&](const RecordView& rr) {
+    CHECK(rr.rr_name.Equals("foo.example.loki"));
+    if (rr.rr_type == qTypeCNAME)
+    {
+      // bar + a pointer to example.loki
+      CHECK(rr.rData.size() == 6);
+      auto packet = view->Packet();
+      targets.push_back(
+          NameView{packet, size_t(rr.rData.data() - packet.data())}.ToString());
+    }
+  });
+  CHECK(targets == std::vector<std::string>{"bar.example.loki."});
+}
+
+TEST_CASE("DNS packet writer refuses what does not fit", "[dns]")
+{
+  std::array<byte_t, 32> small{};
+  PacketWriter writer{small};
+  writer.Question("a-rather-long-name.that-will-not.fit.loki", qTypeA);
+  CHECK_FALSE(writer.Finish());
+
+  std::array<byte_t, 512> buf{};
+  PacketWriter bad_label{buf};
+  bad_label.Question("empty..label", qTypeA);
+  CHECK_FALSE(bad_label.Finish());
+
+  PacketWriter long_label{buf};
+  long_label.Question(std::string(64, 'a') + ".loki", qTypeA);
+  CHECK_FALSE(long_label.Finish());
+}
+
+TEST_CASE("DNS message encode round trips through the view", "[dns]")
+{
+  Message msg{Question{"Some.Name.loki.", qTypeA}};
+  msg.hdr_id = 0x1111;
+  msg.AddINReply(huint128_t{0x0a000001}, false, 30);
+  msg.AddINReply(huint128_t{0x0a000002}, false, 30);
+  auto buf = msg.ToBuffer();
+
+  auto parsed = MaybeParseDNSMessage(buf);
+  REQUIRE(parsed);
+  CHECK(parsed->hdr_id == 0x1111);
+  CHECK(parsed->questions[0] == msg.questions[0]);
+  REQUIRE(parsed->answers.size() == 2);
+  for (size_t idx = 0; idx < 2; ++idx)
+  {
+    CHECK(parsed->answers[idx].rr_name == "Some.Name.loki.");
+    CHECK(parsed->answers[idx].ttl == 30);
+    CHECK(parsed->answers[idx].rData == msg.answers[idx].rData);
+  }
+  // both answer names are a 2 byte pointer to the question
+  CHECK(buf.sz == MessageHeader::Size + 20 + 2 * (2 + 10 + 4));
+}
+
+TEST_CASE("DNS message view survives the fuzz corpus", "[dns]")
+{
+  for (const auto& pkt : BadCorpus())
+    CHECK_FALSE(MessageView::Parse(View(pkt)));
+
+  // flip, truncate and splice the seeds, nothing may crash and anything that parses must be
+  // walkable and survive a round trip through Message
+  std::mt19937 rng{1337};
+  const auto seeds = SeedCorpus();
+  size_t parsed = 0;
+  for (size_t round = 0; round < 20000; ++round)
+  {
+    Packet pkt = seeds[round % seeds.size()];
+    REQUIRE(MessageView::Parse(View(pkt)));
+    const auto mutations = 1 + rng() % 4;
+    for (size_t m = 0; m < mutations and not pkt.empty(); ++m)
+    {
+      switch (rng() % 4)
+      {
+        case 0:
+          pkt[rng() % pkt.size()] ^= 1 << (rng() % 8);
+          break;
+        case 1:
+          pkt[rng() % pkt.size()] = rng();
+          break;
+        case 2:
+          pkt.resize(rng() % pkt.size());
+          break;
+        default:
+        {
+          const auto& other = seeds[rng() % seeds.size()];
+          const auto from = rng() % other.size();
+          pkt.insert(pkt.begin() + rng() % pkt.size(), other.begin() + from, other.end());
+        }
+      }
+    }
+    if (auto view = MessageView::Parse(View(pkt)))
+    {
+      ++parsed;
+      Exercise(*view);
+      Message msg{*view};
+      if (auto again = RoundTrip(msg))
+        CheckSameMessage(*again, msg);
+    }
+  }
+  // the mutations should not be so harsh that nothing gets through
+  CHECK(parsed > 0);
+}
@@ -0,0 +1,234 @@
+#include <catch2/catch.hpp>
+#include <llarp/dns/dns.hpp>
+#include <llarp/dns/server.hpp>
+#include <mocks/mock_dns.hpp>
+#include <oxenc/endian.h>
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace llarp;
+
+namespace
+{
+  /// what a hooking resolver on the main loop saw
+  struct Hooked
+  {
+    std::string name;
+    bool onLoop;
+  };
+
+  /// stands in for the .loki/.snode/reverse resolvers an endpoint adds, answers NXDOMAIN
+  class HookResolver : public dns::Resolver_Base
+  {
+    EventLoop_ptr m_Loop;
+
+   protected:
+    int
+    Rank() const override
+    {
+      return 0;
+    }
+
+   public:
+    std::mutex mutex;
+    std::vector<Hooked> hooked;
+
+    explicit HookResolver(EventLoop_ptr loop) : m_Loop{std::move(loop)}
+    {}
+
+    std::string_view
+    ResolverName() const override
+    {
+      return "test-hook";
+    }
+
+    bool
+    MaybeHookDNS(
+        std::shared_ptr<dns::PacketSource_Base> source,
+        const dns::Message& query,
+        const SockAddr& to,
+        const SockAddr& from) override
+    {
+      const auto& q = query.questions[0];
+      if (not(q.HasTLD(".loki") or q.HasTLD(".snode") or q.qtype == dns::qTypePTR))
+        return false;
+      {
+        std::lock_guard lock{mutex};
+        hooked.push_back({q.Name(), m_Loop->inEventLoop()});
+      }
+      dns::Message reply{query};
+      reply.AddNXReply();
+      source->SendTo(from, to, reply.ToBuffer());
+      return true;
+    }
+  };
+
+  /// a udp socket on loopback to ask the server from
+  class Asker
+  {
+    int m_FD;
+
+   public:
+    SockAddr addr;
+
+    Asker() : m_FD{mocks::BindLoopbackUDP(addr)}
+    {}
+
+    ~Asker()
+    {
+      ::close(m_FD);
+    }
+
+    void
+    Send(const SockAddr& to, const std::vector<byte_t>& pkt) const
+    {
+      ::sendto(
+          m_FD, pkt.data(), pkt.size(), 0, static_cast<const sockaddr*>(to), to.sockaddr_len());
+    }
+
+    /// wait for up to count replies, keyed by message id
+    std::map<uint16_t, std::vector<byte_t>>
+    Receive(size_t count) const
+    {
+      std::map<uint16_t, std::vector<byte_t>> replies;
+      std::array<byte_t, 1500> buf;
+      pollfd pfd{m_FD, POLLIN, 0};
+      while (replies.size() < count and ::poll(&pfd, 1, 5000) > 0)
+      {
+        const auto sz = ::recv(m_FD, buf.data(), buf.size(), 0);
+        if (sz >= static_cast<ssize_t>(dns::MessageHeader::Size))
+        {
+          replies.emplace(
+              oxenc::load_big_to_host<uint16_t>(buf.data()),
+              std::vector<byte_t>{buf.data(), buf.data() + sz});
+        }
+      }
+      return replies;
+    }
+  };
+
+  uint16_t
+  RCode(const std::vector<byte_t>& reply)
+  {
+    return oxenc::load_big_to_host<uint16_t>(&reply[2]) & 0xf;
+  }
+
+  uint16_t
+  AnswerCount(const std::vector<byte_t>& reply)
+  {
+    return oxenc::load_big_to_host<uint16_t>(&reply[6]);
+  }
+}  // namespace
+
+TEST_CASE("DNS resolver pool hands hooked queries to the main loop", "[dns]")
+{
+  mocks::DNSUpstream upstream;
+  mocks::DNSServer dns{upstream, 2};
+  auto hook = std::make_shared<HookResolver>(dns.Loop());
+  dns.Call([&]() { dns.server->AddResolver(std::weak_ptr<dns::Resolver_Base>{hook}); });
+
+  Asker asker;
+  asker.Send(dns.addr, mocks::MakeDNSQuery(1, "example.loki"));
+  asker.Send(dns.addr, mocks::MakeDNSQuery(2, "example.snode"));
+  asker.Send(dns.addr, mocks::MakeDNSQuery(3, "1.0.0.10.in-addr.arpa", dns::qTypePTR));
+  asker.Send(dns.addr, mocks::MakeDNSQuery(4, "plain.test"));
+  const auto replies = asker.Receive(4);
+  REQUIRE(replies.size() == 4);
+
+  for (uint16_t id : {1, 2, 3})
+    CHECK(RCode(replies.at(id)) == dns::flags_RCODENameError);
+  // the plain query went upstream from a pool thread and never reached the hook
+  CHECK(RCode(replies.at(4)) == dns::flags_RCODENoError);
+  CHECK(AnswerCount(replies.at(4)) == 1);
+  CHECK(upstream.queries >= 1);
+
+  std::lock_guard lock{hook->mutex};
+  REQUIRE(hook->hooked.size() == 3);
+  for (const auto& hooked : hook->hooked)
+  {
+    INFO(hooked.name);
+    CHECK(hooked.onLoop);
+  }
+}
+
+TEST_CASE("DNS resolver pool answers the asker with its own message id", "[dns]")
+{
+  mocks::DNSUpstream upstream;
+  mocks::DNSServer dns{upstream, 2};
+
+  // two askers with overlapping ids, every reply must come back to the socket that asked
+  constexpr size_t count = 32;
+  Asker first, second;
+  for (uint16_t idx = 0; idx < count; ++idx)
+  {
+    const auto name = "q" + std::to_string(idx);
+    first.Send(dns.addr, mocks::MakeDNSQuery(1000 + idx, name + ".first.test"));
+    second.Send(dns.addr, mocks::MakeDNSQuery(1000 + idx, name + ".second.test"));
+  }
+
+  for (const auto* asker : {&first, &second})
+  {
+    const auto replies = asker->Receive(count);
+    REQUIRE(replies.size() == count);
+    const std::string expect = asker == &first ? "first" : "second";
+    for (const auto& [id, reply] : replies)
+    {
+      REQUIRE(id >= 1000);
+      REQUIRE(id < 1000 + count);
+      const auto view = dns::MessageView::Parse(byte_view_t{reply.data(), reply.size()});
+      REQUIRE(view);
+      const auto name = view->FirstQuestion()->qname.ToString();
+      CHECK(name == "q" + std::to_string(id - 1000) + "." + expect + ".test.");
+      CHECK(AnswerCount(reply) == 1);
+    }
+  }
+}
+
+TEST_CASE("DNS resolver pool replies SERVFAIL when upstream gives no usable answer", "[dns]")
+{
+  dns::PooledQuery query{
+      SockAddr{"127.0.0.1:53"}, 0x1234, dns::flags_RD, dns::qTypeA, dns::qClassIN};
+  const std::string name = "example.test.";
+  std::copy(name.begin(), name.end(), query.qname.begin());
+  query.qname[name.size()] = 0;
+
+  std::array<byte_t, 512> servfail;
+  const auto checkServFail = [&](byte_view_t reply) {
+    REQUIRE(reply.data() == servfail.data());
+    const auto view = dns::MessageView::Parse(reply);
+    REQUIRE(view);
+    CHECK(view->Header().id == 0x1234);
+    CHECK((view->Header().fields & 0xf) == dns::flags_RCODEServFail);
+    CHECK(view->Header().fields & dns::flags_QR);
+    CHECK(view->FirstQuestion()->qname.ToString() == name);
+    CHECK(view->FirstQuestion()->qtype == dns::qTypeA);
+  };
+
+  SECTION("lookup failed")
+  {
+    checkServFail(dns::PooledReply(query, nullptr, 0, servfail));
+  }
+
+  SECTION("answer shorter than a header")
+  {
+    std::array<byte_t, 5> answer{0xaa, 0xbb, 0x81, 0x80, 0};
+    checkServFail(dns::PooledReply(query, answer.data(), answer.size(), servfail));
+  }
+
+  SECTION("good answer gets the asker's id")
+  {
+    auto answer = mocks::MakeDNSQuery(0xbeef, "example.test");
+    const auto reply = dns::PooledReply(query, answer.data(), answer.size(), servfail);
+    REQUIRE(reply.data() == answer.data());
+    REQUIRE(reply.size() == answer.size());
+    CHECK(oxenc::load_big_to_host<uint16_t>(reply.data()) == 0x1234);
+  }
+}
@@ -0,0 +1,108 @@
+#include <llarp/handlers/exit_route_cache.hpp>
+
+#include <catch2/catch.hpp>
+
+using llarp::huint128_t;
+using llarp::handlers::ExitRouteCache;
+
+namespace
+{
+  /// stands in for an outbound context to an exit
+  struct FakeSession : public std::enable_shared_from_this<FakeSession>
+  {
+    bool ready = true;
+
+    bool
+    ReadyToSend() const
+    {
+      return ready;
+    }
+  };
+
+  huint128_t
+  MakeIP(uint64_t n)
+  {
+    return huint128_t{0xffff'0a00'0000 + n};
+  }
+}  // namespace
+
+TEST_CASE("Exit route cache hands back ready sessions", "[exit]")
+{
+  ExitRouteCache<FakeSession> routes;
+  auto session = std::make_shared<FakeSession>();
+  const auto ip = MakeIP(1);
+
+  CHECK_FALSE(routes.Get(ip, 0));
+  routes.Put(ip, session.get(), 0);
+  CHECK(routes.Get(ip, 0) == session);
+  CHECK_FALSE(routes.Get(MakeIP(2), 0));
+
+  SECTION("a session that is not ready is not remembered")
+  {
+    auto notReady = std::make_shared<FakeSession>();
+    notReady->ready = false;
+    routes.Put(MakeIP(2), notReady.get(), 0);
+    CHECK(routes.size() == 1);
+    CHECK_FALSE(routes.Get(MakeIP(2), 0));
+  }
+
+  SECTION("a session that stops being ready falls back to the slow path")
+  {
+    session->ready = false;
+    CHECK_FALSE(routes.Get(ip, 0));
+    CHECK(routes.size() == 0);
+    // and stays forgotten once it is ready again
+    session->ready = true;
+    CHECK_FALSE(routes.Get(ip, 0));
+  }
+
+  SECTION("a session that went away falls back to the slow path")
+  {
+    session.reset();
+    CHECK_FALSE(routes.Get(ip, 0));
+    CHECK(routes.size() == 0);
+  }
+
+  SECTION("a new exit map version forgets every route")
+  {
+    routes.Put(MakeIP(2), session.get(), 0);
+    CHECK_FALSE(routes.Get(MakeIP(2), 1));
+    CHECK(routes.size() == 0);
+    CHECK_FALSE(routes.Get(ip, 1));
+
+    // routes found under the old version are not remembered under the new one
+    routes.Put(ip, session.get(), 0);
+    CHECK(routes.size() == 0);
+    routes.Put(ip, session.get(), 1);
+    CHECK(routes.Get(ip, 1) == session);
+  }
+}
+
+TEST_CASE("Exit route cache evicts at its limit", "[exit]")
+{
+  using Cache_t = ExitRouteCache<FakeSession>;
+  Cache_t routes;
+  auto session = std::make_shared<FakeSession>();
+  for (uint64_t n = 0; n < Cache_t::MaxRoutes; ++n)
+    routes.Put(MakeIP(n), session.get(), 0);
+  REQUIRE(routes.size() == Cache_t::MaxRoutes);
+
+  // a route we already have is updated in place
+  auto other = std::make_shared<FakeSession>();
+  routes.Put(MakeIP(0), other.get(), 0);
+  CHECK(routes.size() == Cache_t::MaxRoutes);
+  CHECK(routes.Get(MakeIP(0), 0) == other);
+
+  // a new one pushes an old one out
+  const auto newIP = MakeIP(Cache_t::MaxRoutes);
+  routes.Put(newIP, session.get(), 0);
+  CHECK(routes.size() == Cache_t::MaxRoutes);
+  CHECK(routes.Get(newIP, 0) == session);
+  size_t remembered = 0;
+  for (uint64_t n = 0; n <= Cache_t::MaxRoutes; ++n)
+  {
+    if (routes.Get(MakeIP(n), 0))
+      remembered++;
+  }
+  CHECK(remembered == Cache_t::MaxRoutes);
+}
@@ -45,3 +45,16 @@ def HiveForPeerStats():
   yield _make
   if router_hive:
     router_hive.Stop()
+
+@pytest.fixture()
+def HiveSimulated():
+  router_hive = None
+  def _make(n_relays, n_clients, netid="hive"):
+    nonlocal router_hive
+    router_hive = hive.RouterHive(n_relays, n_clients, netid, simulated=True)
+    router_hive.Start()
+    return router_hive
+
+  yield _make
+  if router_hive:
+    router_hive.Stop()
@@ -14,7 +14,7 @@ import traceback
 
 class RouterHive(object):
 
-  def __init__(self, n_relays=10, n_clients=10, netid="hive", shutup=True):
+  def __init__(self, n_relays=10, n_clients=10, netid="hive", shutup=True, simulated=False):
     self._log = pyllarp.LogContext()
     self._log.shutup = shutup
     try:
@@ -25,6 +25,7 @@ class RouterHive(object):
 
       self.n_relays = n_relays
       self.n_clients = n_clients
+      self.simulated = simulated
 
       self.addrs = []
       self.events = deque()
@@ -114,11 +115,11 @@ class RouterHive(object):
 
   def InitFirstRC(self):
     print("Starting first router to init its RC for bootstrap")
-    self.hive = pyllarp.RouterHive()
+    self.hive = self.MakeHive()
     self.AddRelay(0)
     self.hive.StartRelays()
     print("sleeping 2 sec to give plenty of time to save bootstrap rc")
-    sleep(2)
+    self.Advance(2)
 
     self.hive.StopAll()
 
@@ -128,7 +129,7 @@ class RouterHive(object):
 
     print("Resetting hive.  Creating %d relays and %d clients" % (self.n_relays, self.n_clients))
 
-    self.hive = pyllarp.RouterHive()
+    self.hive = self.MakeHive()
 
     for i in range(0, self.n_relays):
       self.AddRelay(i)
@@ -140,7 +141,7 @@ class RouterHive(object):
     self.hive.StartRelays()
 
     print("Sleeping 2 seconds before starting clients")
-    sleep(2)
+    self.Advance(2)
 
     self.RCs = self.hive.GetRelayRCs()
 
@@ -149,6 +150,15 @@ class RouterHive(object):
   def Stop(self):
     self.hive.StopAll()
 
+  def MakeHive(self):
+    if self.simulated:
+      return pyllarp.RouterHive(True, 0)
+    return pyllarp.RouterHive()
+
+  def Advance(self, seconds):
+    """let the hive run for some seconds, of virtual time if simulated"""
+    self.hive.RunFor(int(seconds * 1000))
+
   def CollectNextEvent(self):
     self.events.append(self.hive.GetNextEvent())
 
@@ -0,0 +1,29 @@
+def test_sim_path_builds(HiveSimulated):
+  h = HiveSimulated(n_relays=200, n_clients=50)
+
+  attempts = 0
+  successes = 0
+  failures = 0
+
+  # one minute of virtual time
+  for _ in range(60):
+    h.Advance(1)
+    h.CollectAllEvents()
+
+    for event in h.events:
+      event_name = event.__class__.__name__
+      if event_name == "PathAttemptEvent":
+        attempts = attempts + 1
+      elif event_name == "PathStatusReceivedEvent":
+        if event.Successful:
+          successes = successes + 1
+        else:
+          failures = failures + 1
+
+    h.events = []
+
+  print("Path attempts: {}, successful: {}, failed: {}".format(attempts, successes, failures))
+
+  assert attempts > 0
+  assert successes > 0
+  assert failures == 0
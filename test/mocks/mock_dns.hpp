@@ -0,0 +1,175 @@
+#pragma once
+#include <llarp/config/config.hpp>
+#include <llarp/dns/dns.hpp>
+#include <llarp/dns/server.hpp>
+#include <llarp/ev/ev.hpp>
+#include <oxenc/endian.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace mocks
+{
+  /// bind a udp socket on loopback with a random port
+  inline int
+  BindLoopbackUDP(llarp::SockAddr& bound)
+  {
+    int fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    llarp::SockAddr addr{"127.0.0.1:0"};
+    if (fd == -1 or ::bind(fd, static_cast<const sockaddr*>(addr), addr.sockaddr_len()) != 0)
+      throw std::runtime_error{"cannot bind udp socket on loopback"};
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&ss), &len);
+    bound = llarp::SockAddr{*reinterpret_cast<sockaddr*>(&ss)};
+    return fd;
+  }
+
+  /// a dns query packet with one question
+  inline std::vector<byte_t>
+  MakeDNSQuery(uint16_t id, std::string_view name, uint16_t qtype = llarp::dns::qTypeA)
+  {
+    std::vector<byte_t> pkt(llarp::dns::MessageHeader::Size);
+    oxenc::write_host_as_big<uint16_t>(id, &pkt[0]);
+    oxenc::write_host_as_big<uint16_t>(llarp::dns::flags_RD, &pkt[2]);
+    oxenc::write_host_as_big<uint16_t>(1, &pkt[4]);
+    while (not name.empty())
+    {
+      const auto label = name.substr(0, name.find('.'));
+      pkt.push_back(label.size());
+      pkt.insert(pkt.end(), label.begin(), label.end());
+      name.remove_prefix(std::min(name.size(), label.size() + 1));
+    }
+    pkt.push_back(0);
+    pkt.resize(pkt.size() + 4);
+    oxenc::write_host_as_big<uint16_t>(qtype, &pkt[pkt.size() - 4]);
+    oxenc::write_host_as_big<uint16_t>(llarp::dns::qClassIN, &pkt[pkt.size() - 2]);
+    return pkt;
+  }
+
+  /// stand-in upstream resolver on loopback that answers every query with an A record for
+  /// 10.0.0.1
+  class DNSUpstream
+  {
+    int m_FD;
+    std::atomic<bool> m_Running{true};
+    std::thread m_Thread;
+
+   public:
+    llarp::SockAddr addr;
+    /// how many queries we answered
+    std::atomic<size_t> queries{0};
+
+    DNSUpstream() : m_FD{BindLoopbackUDP(addr)}
+    {
+      m_Thread = std::thread{[this]() {
+        std::array<byte_t, 1500> buf;
+        pollfd pfd{m_FD, POLLIN, 0};
+        while (m_Running)
+        {
+          if (::poll(&pfd, 1, 100) <= 0)
+            continue;
+          sockaddr_storage src{};
+          socklen_t srclen = sizeof(src);
+          auto sz = ::recvfrom(
+              m_FD, buf.data(), buf.size(), 0, reinterpret_cast<sockaddr*>(&src), &srclen);
+          if (sz < static_cast<ssize_t>(llarp::dns::MessageHeader::Size))
+            continue;
+          // keep id and question, drop anything after the question
+          size_t pos = llarp::dns::MessageHeader::Size;
+          while (pos < size_t(sz) and buf[pos])
+            pos += buf[pos] + 1;
+          pos += 5;
+          oxenc::write_host_as_big<uint16_t>(0x8180, &buf[2]);
+          oxenc::write_host_as_big<uint16_t>(1, &buf[6]);
+          oxenc::write_host_as_big<uint32_t>(0, &buf[8]);
+          const std::array<byte_t, 16> answer{
+              0xc0, 0x0c, 0, 1, 0, 1, 0, 0, 0, 60, 0, 4, 10, 0, 0, 1};
+          std::copy(answer.begin(), answer.end(), buf.begin() + pos);
+          ++queries;
+          ::sendto(
+              m_FD,
+              buf.data(),
+              pos + answer.size(),
+              0,
+              reinterpret_cast<sockaddr*>(&src),
+              srclen);
+        }
+      }};
+    }
+
+    ~DNSUpstream()
+    {
+      m_Running = false;
+      m_Thread.join();
+      ::close(m_FD);
+    }
+  };
+
+  /// a dns server on loopback forwarding to upstream, with its own event loop thread and
+  /// threads resolver pool threads
+  class DNSServer
+  {
+    llarp::EventLoop_ptr m_Loop = llarp::EventLoop::create();
+    std::thread m_Runner{[loop = m_Loop]() { loop->run(); }};
+
+   public:
+    std::shared_ptr<llarp::dns::Server> server;
+    llarp::SockAddr addr;
+
+    DNSServer(const DNSUpstream& upstream, int threads)
+    {
+      llarp::DnsConfig conf{};
+      conf.m_raw_dns = false;
+      conf.m_bind = {llarp::SockAddr{"127.0.0.1:0"}};
+      conf.m_upstreamDNS = {upstream.addr};
+      conf.m_ResolverThreads = threads;
+      conf.m_ExtraOpts.emplace("do-not-query-localhost:", "no");
+      Call([&]() {
+        server = std::make_shared<llarp::dns::Server>(m_Loop, conf, 0);
+        server->Start();
+        addr = *server->FirstBoundPacketSourceAddr();
+      });
+    }
+
+    ~DNSServer()
+    {
+      Call([this]() {
+        server->Stop();
+        server.reset();
+      });
+      m_Loop->stop();
+      m_Runner.join();
+    }
+
+    const llarp::EventLoop_ptr&
+    Loop() const
+    {
+      return m_Loop;
+    }
+
+    /// run f on the event loop and wait for it
+    template <typename Func_t>
+    void
+    Call(Func_t&& f)
+    {
+      std::promise<void> done;
+      m_Loop->call([&]() {
+        f();
+        done.set_value();
+      });
+      done.get_future().get();
+    }
+  };
+}  // namespace mocks
@@ -0,0 +1,115 @@
+#pragma once
+#include <llarp/ev/ev.hpp>
+#include <llarp/util/timer_wheel.hpp>
+
+namespace mocks
+{
+  /// an event loop that runs calls right away on the calling thread and only runs its timers
+  /// when the test moves its clock with Advance
+  class ManualLoop : public llarp::EventLoop
+  {
+    llarp_time_t _now = std::chrono::hours{1};
+    llarp::util::TimerWheel _timers{std::chrono::milliseconds{1}, _now};
+    TimerID _nextID = 0;
+
+   public:
+    void
+    Advance(llarp_time_t dur)
+    {
+      _now += dur;
+      _timers.Advance(_now);
+    }
+
+    size_t
+    NumTimers() const
+    {
+      return _timers.Size();
+    }
+
+    void
+    run() override
+    {}
+
+    bool
+    running() const override
+    {
+      return true;
+    }
+
+    llarp_time_t
+    time_now() const override
+    {
+      return _now;
+    }
+
+    void
+    call_soon(std::function<void(void)> f) override
+    {
+      f();
+    }
+
+    TimerID
+    call_later(llarp_time_t delay_ms, std::function<void(void)> callback) override
+    {
+      const auto id = ++_nextID;
+      _timers.Schedule(id, _now + delay_ms, std::move(callback));
+      return id;
+    }
+
+    void
+    cancel_later(TimerID id) override
+    {
+      _timers.Cancel(id);
+    }
+
+    bool
+    add_network_interface(
+        std::shared_ptr<llarp::vpn::NetworkInterface>,
+        std::function<void(llarp::net::IPPacket)>) override
+    {
+      return false;
+    }
+
+    void
+    pause_network_interface(const llarp::vpn::NetworkInterface&, bool) override
+    {}
+
+    bool
+    add_ticker(std::function<void(void)>) override
+    {
+      return false;
+    }
+
+    void
+    stop() override
+    {}
+
+    std::shared_ptr<llarp::UDPHandle>
+    make_udp(UDPReceiveFunc) override
+    {
+      return nullptr;
+    }
+
+    std::shared_ptr<llarp::EventLoopWakeup>
+    make_waker(std::function<void()>) override
+    {
+      return nullptr;
+    }
+
+    std::shared_ptr<llarp::EventLoopRepeater>
+    make_repeater() override
+    {
+      return nullptr;
+    }
+
+    bool
+    inEventLoop() const override
+    {
+      return true;
+    }
+
+    void
+    wakeup() override
+    {}
+  };
+}  // namespace mocks
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <llarp.hpp>
 #include <llarp/net/net.hpp>
 #include <llarp/ev/libuv.hpp>
 #include <oxenc/variant.h>
@@ -192,7 +193,7 @@ namespace mocks
       }
   };
 
-  bool
+  inline bool
   MockUDPHandle::listen(const llarp::SockAddr& addr)
   {
     if (not _net->HasInterfaceAddress(addr.getIP()))
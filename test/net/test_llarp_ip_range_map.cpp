@@ -0,0 +1,172 @@
+#include <llarp/net/ip_range_map.hpp>
+#include <llarp/net/traffic_policy.hpp>
+
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+namespace
+{
+  std::mt19937_64 rng{0x1b2a};
+
+  huint128_t
+  RandomIP()
+  {
+    return huint128_t{uint128_t{rng(), rng()}};
+  }
+
+  /// a random range, mostly ipv4 with the prefix lengths people actually use
+  IPRange
+  RandomRange()
+  {
+    if (rng() % 4)
+    {
+      const auto ip = huint32_t{static_cast<uint32_t>(rng())};
+      return IPRange{net::ExpandV4(ip), netmask_ipv6_bits(96 + rng() % 33)};
+    }
+    return IPRange{RandomIP(), netmask_ipv6_bits(rng() % 129)};
+  }
+
+  /// a random ip that is often inside one of ranges
+  huint128_t
+  RandomIPNear(const std::vector<IPRange>& ranges)
+  {
+    if (ranges.empty() or rng() % 4 == 0)
+      return RandomIP();
+    const auto& range = ranges[rng() % ranges.size()];
+    const auto hostbits = ~range.netmask_bits;
+    return (range.addr & range.netmask_bits) | (RandomIP() & hostbits);
+  }
+
+  std::set<std::pair<IPRange, std::string>>
+  LinearFindAll(const net::IPRangeMap<std::string>& map, const huint128_t& ip)
+  {
+    std::set<std::pair<IPRange, std::string>> found;
+    map.ForEachEntry([&](const auto& range, const auto& value) {
+      if (range.Contains(ip))
+        found.emplace(range, value);
+    });
+    return found;
+  }
+
+  net::IPPacket
+  MakePacket(bool v6, uint8_t protocol, const huint128_t& dst, uint16_t dstport)
+  {
+    std::vector<byte_t> data(v6 ? 64 : 48);
+    size_t ports = 20;
+    if (v6)
+    {
+      data[0] = 0x60;
+      data[6] = protocol;
+      const auto nip = ToNet(dst);
+      std::memcpy(data.data() + 24, &nip.n, 16);
+      ports = 40;
+    }
+    else
+    {
+      data[0] = 0x45;
+      const auto nip = ToNet(net::TruncateV6(dst));
+      std::memcpy(data.data() + 16, &nip.n, 4);
+    }
+    // the v4 header's protocol field is what policies look at
+    data[9] = protocol;
+    data[ports + 2] = dstport >> 8;
+    data[ports + 3] = dstport & 0xff;
+    return net::IPPacket{std::move(data)};
+  }
+}  // namespace
+
+TEST_CASE("IPRangeMap finds the same entries as a linear scan", "[net][iprangemap]")
+{
+  for (size_t numRanges : {0, 1, 2, 10, 100, 1000})
+  {
+    net::IPRangeMap<std::string> map;
+    std::vector<IPRange> ranges;
+    for (size_t idx = 0; idx < numRanges; ++idx)
+    {
+      ranges.emplace_back(RandomRange());
+      map.Insert(ranges.back(), std::to_string(rng() % 8));
+      // same range mapped to more than one value
+      if (rng() % 8 == 0)
+        map.Insert(ranges.back(), std::to_string(8 + rng() % 8));
+    }
+    // whole address space and a single address
+    map.Insert(IPRange{huint128_t{0}, netmask_ipv6_bits(0)}, "all");
+    map.Insert(IPRange{RandomIP(), netmask_ipv6_bits(128)}, "one");
+    for (size_t idx = 0; idx < 2000; ++idx)
+    {
+      const auto ip = RandomIPNear(ranges);
+      REQUIRE(map.FindAllEntries(ip) == LinearFindAll(map, ip));
+    }
+
+    // take some out and check again
+    map.RemoveIf([](const auto& entry) { return entry.second == "3" or entry.second == "all"; });
+    REQUIRE(not map.ContainsValue("3"));
+    REQUIRE(not map.ContainsValue("all"));
+    REQUIRE(map.ContainsValue("one"));
+    for (size_t idx = 0; idx < 2000; ++idx)
+    {
+      const auto ip = RandomIPNear(ranges);
+      REQUIRE(map.FindAllEntries(ip) == LinearFindAll(map, ip));
+    }
+  }
+}
+
+TEST_CASE("IPRangeTrie visits shorter prefixes first", "[net][iprangemap]")
+{
+  net::IPRangeTrie trie;
+  trie.Insert(IPRange::FromIPv4(10, 1, 2, 0, 24), 2);
+  trie.Insert(IPRange::FromIPv4(0, 0, 0, 0, 0), 0);
+  trie.Insert(IPRange::FromIPv4(10, 0, 0, 0, 8), 1);
+  trie.Insert(IPRange::FromIPv4(10, 1, 3, 0, 24), 3);
+
+  std::vector<size_t> tags;
+  trie.ForEachMatch(net::ExpandV4(ipaddr_ipv4_bits(10, 1, 2, 3)), [&](auto tag) {
+    tags.push_back(tag);
+  });
+  REQUIRE(tags == std::vector<size_t>{0, 1, 2});
+  REQUIRE(trie.Contains(net::ExpandV4(ipaddr_ipv4_bits(192, 168, 0, 1))));
+
+  trie.Clear();
+  REQUIRE(trie.Empty());
+  REQUIRE(not trie.Contains(net::ExpandV4(ipaddr_ipv4_bits(10, 1, 2, 3))));
+}
+
+TEST_CASE("TrafficPolicyMatcher agrees with TrafficPolicy", "[net][traffic-policy]")
+{
+  const std::vector<uint8_t> protos{1, 6, 17, 58, 132};
+  const std::vector<uint16_t> ports{22, 53, 80, 443, 8080};
+  for (size_t round = 0; round < 50; ++round)
+  {
+    net::TrafficPolicy policy;
+    std::vector<IPRange> ranges;
+    for (size_t idx = rng() % 4; idx > 0; --idx)
+    {
+      net::ProtocolInfo info;
+      info.protocol = static_cast<net::IPProtocol>(protos[rng() % protos.size()]);
+      if (rng() % 2)
+        info.port = ToNet(huint16_t{ports[rng() % ports.size()]});
+      policy.protocols.insert(info);
+    }
+    for (size_t idx = rng() % 20; idx > 0; --idx)
+    {
+      ranges.emplace_back(RandomRange());
+      policy.ranges.insert(ranges.back());
+    }
+    const net::TrafficPolicyMatcher matcher{policy};
+    for (size_t idx = 0; idx < 500; ++idx)
+    {
+      auto dst = RandomIPNear(ranges);
+      const bool v6 = not IPRange::V4MappedRange().Contains(dst);
+      const auto pkt = MakePacket(
+          v6, protos[rng() % protos.size()], dst, ports[rng() % ports.size()] + (rng() % 2));
+      REQUIRE(matcher.AllowsTraffic(pkt) == policy.AllowsTraffic(pkt));
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#include <llarp/util/thread/batch_pool.hpp>
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+TEST_CASE("BatchPool reuses the storage of returned batches", "[path][batch-pool]")
+{
+  thread::BatchPool<int> pool{2, 16};
+  auto batch = pool.Take();
+  REQUIRE(batch.capacity() == 0);
+  batch.resize(8);
+  const auto* storage = batch.data();
+  pool.Give(std::move(batch));
+  REQUIRE(pool.NumSpare() == 1);
+
+  auto again = pool.Take();
+  REQUIRE(again.empty());
+  REQUIRE(again.data() == storage);
+  REQUIRE(pool.NumSpare() == 0);
+}
+
+TEST_CASE("BatchPool bounds what it keeps", "[path][batch-pool]")
+{
+  thread::BatchPool<int> pool{2, 16};
+  // never used, nothing to keep
+  pool.Give({});
+  REQUIRE(pool.NumSpare() == 0);
+  // grew too big
+  pool.Give(std::vector<int>(17));
+  REQUIRE(pool.NumSpare() == 0);
+
+  for (int i = 0; i < 4; ++i)
+    pool.Give(std::vector<int>(4));
+  REQUIRE(pool.NumSpare() == 2);
+}
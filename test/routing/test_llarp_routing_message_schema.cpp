@@ -0,0 +1,497 @@
+#include <llarp/path/path_types.hpp>
+#include <llarp/routing/handler.hpp>
+#include <llarp/routing/message_parser.hpp>
+#include <llarp/routing/path_confirm_message.hpp>
+#include <llarp/routing/path_latency_message.hpp>
+#include <llarp/routing/path_transfer_message.hpp>
+#include <llarp/routing/transfer_traffic_message.hpp>
+#include <llarp/util/bencode_schema.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <optional>
+#include <random>
+#include <string>
+
+using namespace llarp;
+using namespace llarp::routing;
+
+namespace
+{
+  // the hand written codecs the schemas replaced, what goes on the wire must not change
+
+  bool
+  LegacyEncode(const PathLatencyMessage& msg, llarp_buffer_t* buf)
+  {
+    if (!bencode_start_dict(buf))
+      return false;
+    if (!BEncodeWriteDictMsgType(buf, "A", "L"))
+      return false;
+    if (msg.L)
+    {
+      if (!BEncodeWriteDictInt("L", msg.L, buf))
+        return false;
+    }
+    if (msg.T)
+    {
+      if (!BEncodeWriteDictInt("T", msg.T, buf))
+        return false;
+    }
+    if (!BEncodeWriteDictInt("S", msg.S, buf))
+      return false;
+    return bencode_end(buf);
+  }
+
+  bool
+  LegacyDecodeKey(PathLatencyMessage& msg, const llarp_buffer_t& key, llarp_buffer_t* val)
+  {
+    bool read = false;
+    if (!BEncodeMaybeReadDictInt("L", msg.L, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("S", msg.S, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("T", msg.T, read, key, val))
+      return false;
+    return read;
+  }
+
+  bool
+  LegacyEncode(const PathConfirmMessage& msg, llarp_buffer_t* buf)
+  {
+    if (!bencode_start_dict(buf))
+      return false;
+    if (!BEncodeWriteDictMsgType(buf, "A", "P"))
+      return false;
+    if (!BEncodeWriteDictInt("L", msg.pathLifetime.count(), buf))
+      return false;
+    if (!BEncodeWriteDictInt("S", msg.S, buf))
+      return false;
+    if (!BEncodeWriteDictInt("T", msg.pathCreated.count(), buf))
+      return false;
+    if (!BEncodeWriteDictInt("V", msg.version, buf))
+      return false;
+    return bencode_end(buf);
+  }
+
+  bool
+  LegacyDecodeKey(PathConfirmMessage& msg, const llarp_buffer_t& key, llarp_buffer_t* val)
+  {
+    bool read = false;
+    if (!BEncodeMaybeReadDictInt("L", msg.pathLifetime, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("S", msg.S, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("T", msg.pathCreated, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("V", msg.version, read, key, val))
+      return false;
+    return read;
+  }
+
+  bool
+  LegacyEncode(const PathTransferMessage& msg, llarp_buffer_t* buf)
+  {
+    if (!bencode_start_dict(buf))
+      return false;
+    if (!BEncodeWriteDictMsgType(buf, "A", "T"))
+      return false;
+    if (!BEncodeWriteDictEntry("P", msg.P, buf))
+      return false;
+    if (!BEncodeWriteDictInt("S", msg.S, buf))
+      return false;
+    if (!BEncodeWriteDictEntry("T", msg.T, buf))
+      return false;
+    if (!BEncodeWriteDictInt("V", llarp::constants::proto_version, buf))
+      return false;
+    if (!BEncodeWriteDictEntry("Y", msg.Y, buf))
+      return false;
+    return bencode_end(buf);
+  }
+
+  bool
+  LegacyDecodeKey(PathTransferMessage& msg, const llarp_buffer_t& key, llarp_buffer_t* val)
+  {
+    bool read = false;
+    if (!BEncodeMaybeReadDictEntry("P", msg.P, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("S", msg.S, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictEntry("T", msg.T, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictInt("V", msg.version, read, key, val))
+      return false;
+    if (!BEncodeMaybeReadDictEntry("Y", msg.Y, read, key, val))
+      return false;
+    return read;
+  }
+
+  bool
+  LegacyEncode(const TransferTrafficMessage& msg, llarp_buffer_t* buf)
+  {
+    if (!bencode_start_dict(buf))
+      return false;
+    if (!BEncodeWriteDictMsgType(buf, "A", "I"))
+      return false;
+    if (!BEncodeWriteDictInt("P", msg.protocol, buf))
+      return false;
+    if (!BEncodeWriteDictInt("S", msg.S, buf))
+      return false;
+    if (!BEncodeWriteDictInt("V", msg.version, buf))
+      return false;
+    if (!BEncodeWriteDictList("X", msg.X, buf))
+      return false;
+    return bencode_end(buf);
+  }
+
+  bool
+  LegacyDecodeKey(TransferTrafficMessage& msg, const llarp_buffer_t& key, llarp_buffer_t* buf)
+  {
+    bool read = false;
+    if (!BEncodeMaybeReadDictInt("S", msg.S, read, key, buf))
+      return false;
+    if (!BEncodeMaybeReadDictInt("P", msg.protocol, read, key, buf))
+      return false;
+    if (!BEncodeMaybeReadDictInt("V", msg.version, read, key, buf))
+      return false;
+    if (!BEncodeMaybeReadDictList("X", msg.X, read, key, buf))
+      return false;
+    return read or bencode_discard(buf);
+  }
+
+  template <typename Buf_t>
+  void
+  Fill(Buf_t& buf, std::mt19937_64& rng)
+  {
+    for (size_t idx = 0; idx < buf.size(); ++idx)
+      buf.data()[idx] = rng();
+  }
+
+  void
+  Randomize(PathLatencyMessage& msg, std::mt19937_64& rng)
+  {
+    msg.L = rng() % 2 ? rng() : 0;
+    msg.T = rng() % 2 ? rng() : 0;
+    msg.S = rng();
+  }
+
+  void
+  Randomize(PathConfirmMessage& msg, std::mt19937_64& rng)
+  {
+    msg.pathLifetime = std::chrono::milliseconds{rng() % (1ull << 40)};
+    msg.pathCreated = std::chrono::milliseconds{rng() % (1ull << 40)};
+    msg.S = rng();
+    msg.version = rng() % 4;
+  }
+
+  void
+  Randomize(PathTransferMessage& msg, std::mt19937_64& rng)
+  {
+    Fill(msg.P, rng);
+    Fill(msg.Y, rng);
+    Fill(msg.T.F, rng);
+    Fill(msg.T.N, rng);
+    Fill(msg.T.Z, rng);
+    if (rng() % 2)
+      Fill(msg.T.T, rng);
+    msg.T.D = service::ProtocolFrame::Encrypted_t{rng() % 256};
+    Fill(msg.T.D, rng);
+    msg.T.R = rng() % 3;
+    msg.S = rng();
+  }
+
+  void
+  Randomize(TransferTrafficMessage& msg, std::mt19937_64& rng)
+  {
+    std::array<byte_t, MaxExitMTU> payload;
+    Fill(payload, rng);
+    for (auto num = rng() % 4; num > 0; --num)
+      REQUIRE(msg.PutBuffer(llarp_buffer_t{payload.data(), rng() % payload.size()}, rng()));
+    msg.protocol = static_cast<service::ProtocolType>(rng() % 8);
+    msg.S = rng();
+    msg.version = rng() % 4;
+  }
+
+  template <typename Msg_t>
+  std::string
+  Encode(const Msg_t& msg, bool legacy)
+  {
+    std::array<byte_t, 8192> tmp;
+    llarp_buffer_t buf{tmp};
+    REQUIRE((legacy ? LegacyEncode(msg, &buf) : msg.BEncode(&buf)));
+    return std::string{reinterpret_cast<const char*>(tmp.data()), size_t(buf.cur - buf.base)};
+  }
+
+  /// decode the way InboundMessageParser does, it checks "A" and hands every other key to
+  /// DecodeKey. gives the legacy encoding of what was decoded, nothing if it did not decode.
+  template <typename Msg_t>
+  std::optional<std::string>
+  Parse(std::string data, char msgType, bool legacy)
+  {
+    Msg_t msg;
+    msg.Clear();
+    // std::string keeps a nul past the end, the legacy dict reader peeks one byte too far
+    llarp_buffer_t buf{data.data(), data.size()};
+    bool sawType = false;
+    const bool ok = bencode_read_dict(
+        [&](llarp_buffer_t* val, llarp_buffer_t* key) {
+          if (key == nullptr)
+            return sawType;
+          if (key->sz == 1 and *key->base == 'A')
+          {
+            llarp_buffer_t type;
+            sawType = bencode_read_string(val, &type) and type.sz == 1 and *type.base == msgType;
+            return sawType;
+          }
+          return legacy ? LegacyDecodeKey(msg, *key, val) : msg.DecodeKey(*key, val);
+        },
+        &buf);
+    if (not ok)
+      return std::nullopt;
+    return Encode(msg, true);
+  }
+
+  /// decode data in one pass with the schema alone
+  template <typename Msg_t, typename Schema_t>
+  std::optional<std::string>
+  Decode(const Schema_t& schema, std::string data)
+  {
+    Msg_t msg;
+    msg.Clear();
+    if (not bencode::Decode(schema, msg, std::string_view{data}))
+      return std::nullopt;
+    return Encode(msg, true);
+  }
+
+  /// true if any key in data is not a single character. nothing reads further into a dict than
+  /// discarding its values does, so decoders cannot see keys this misses.
+  bool
+  HasLongKey(std::string data)
+  {
+    llarp_buffer_t buf{data.data(), data.size()};
+    bool longKey = false;
+    bencode_read_dict(
+        [&](llarp_buffer_t* val, llarp_buffer_t* key) {
+          if (key == nullptr)
+            return true;
+          longKey = longKey or key->sz != 1;
+          return bencode_discard(val);
+        },
+        &buf);
+    return longKey;
+  }
+
+  std::string
+  Mutate(std::string data, std::mt19937_64& rng)
+  {
+    static constexpr std::string_view interesting = "ilde:0123456789AX";
+    const auto pos = rng() % (data.size() + 1);
+    switch (rng() % 4)
+    {
+      case 0:
+        data.resize(pos);
+        break;
+      case 1:
+        if (pos < data.size())
+          data.erase(pos, 1);
+        break;
+      case 2:
+        data.insert(pos, 1, interesting[rng() % interesting.size()]);
+        break;
+      default:
+        if (pos < data.size())
+          data[pos] = rng() % 2 ? interesting[rng() % interesting.size()] : char(rng());
+    }
+    return data;
+  }
+
+  template <typename Msg_t, typename Schema_t>
+  void
+  CheckEquivalent(const Schema_t& schema, uint64_t seed)
+  {
+    std::mt19937_64 rng{seed};
+    for (int round = 0; round < 200; ++round)
+    {
+      Msg_t msg;
+      Randomize(msg, rng);
+      const auto wire = Encode(msg, true);
+      REQUIRE(Encode(msg, false) == wire);
+      REQUIRE(Parse<Msg_t>(wire, schema.msgType, false) == wire);
+      REQUIRE(Decode<Msg_t>(schema, wire) == wire);
+
+      auto data = wire;
+      for (int mutation = 0; mutation < 50; ++mutation)
+      {
+        data = Mutate(data, rng);
+        const auto decoded = Parse<Msg_t>(data, schema.msgType, false);
+        REQUIRE(Decode<Msg_t>(schema, data) == decoded);
+        // the legacy codec takes any key that merely starts with a known one, the schema wants
+        // an exact match, so they only have to agree when every key is one character long
+        if (not HasLongKey(data))
+          REQUIRE(Parse<Msg_t>(data, schema.msgType, true) == decoded);
+        if (not decoded or rng() % 4 == 0)
+          data = wire;
+      }
+    }
+  }
+
+  /// remembers the latency and confirm messages handed to it, refuses everything else
+  struct RecordingHandler : public IMessageHandler
+  {
+    std::optional<PathLatencyMessage> latency;
+    std::optional<PathConfirmMessage> confirm;
+
+    bool
+    HandleObtainExitMessage(const ObtainExitMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleGrantExitMessage(const GrantExitMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleRejectExitMessage(const RejectExitMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleTransferTrafficMessage(const TransferTrafficMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleUpdateExitMessage(const UpdateExitMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleUpdateExitVerifyMessage(const UpdateExitVerifyMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleCloseExitMessage(const CloseExitMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleDataDiscardMessage(const DataDiscardMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandlePathTransferMessage(const PathTransferMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+
+    bool
+    HandleHiddenServiceFrame(const service::ProtocolFrame&) override
+    {
+      return false;
+    }
+
+    bool
+    HandlePathConfirmMessage(const PathConfirmMessage& msg, AbstractRouter*) override
+    {
+      confirm = msg;
+      return true;
+    }
+
+    bool
+    HandlePathLatencyMessage(const PathLatencyMessage& msg, AbstractRouter*) override
+    {
+      latency = msg;
+      return true;
+    }
+
+    bool
+    HandleDHTMessage(const dht::IMessage&, AbstractRouter*) override
+    {
+      return false;
+    }
+  };
+
+  bool
+  Parse(InboundMessageParser& parser, RecordingHandler& handler, std::string data)
+  {
+    const llarp_buffer_t buf{data.data(), data.size()};
+    return parser.ParseMessageBuffer(buf, &handler, PathID_t{}, nullptr);
+  }
+}  // namespace
+
+TEST_CASE("Message schemas encode what the legacy codec did", "[routing][bencode]")
+{
+  PathLatencyMessage latency;
+  latency.S = 7;
+  CHECK(Encode(latency, false) == "d1:A1:L1:Si7ee");
+  latency.T = 2;
+  CHECK(Encode(latency, false) == "d1:A1:L1:Ti2e1:Si7ee");
+
+  PathTransferMessage transfer;
+  transfer.version = 0;
+  CHECK(Encode(transfer, false) == Encode(transfer, true));
+}
+
+TEST_CASE("Message schemas decode single keys", "[routing][bencode]")
+{
+  PathConfirmMessage msg;
+  std::string val = "i42e";
+  llarp_buffer_t buf{val.data(), val.size()};
+  REQUIRE(bencode::DecodeKey(PathConfirmMessageSchema, msg, "L", &buf));
+  CHECK(msg.pathLifetime == 42ms);
+
+  buf.cur = buf.base;
+  CHECK_FALSE(bencode::DecodeKey(PathConfirmMessageSchema, msg, "Q", &buf));
+
+  TransferTrafficMessage traffic;
+  buf.cur = buf.base;
+  REQUIRE(bencode::DecodeKey(TransferTrafficMessageSchema, traffic, "Q", &buf));
+  CHECK(buf.size_left() == 0);
+}
+
+TEST_CASE("Message schemas fuzz equivalent to the legacy codec", "[routing][bencode]")
+{
+  CheckEquivalent<PathLatencyMessage>(PathLatencyMessageSchema, 1);
+  CheckEquivalent<PathConfirmMessage>(PathConfirmMessageSchema, 2);
+  CheckEquivalent<PathTransferMessage>(PathTransferMessageSchema, 3);
+  CheckEquivalent<TransferTrafficMessage>(TransferTrafficMessageSchema, 4);
+}
+
+TEST_CASE("Routing parser decodes the schema messages", "[routing][bencode]")
+{
+  InboundMessageParser parser;
+  RecordingHandler handler;
+
+  REQUIRE(Parse(parser, handler, "d1:A1:L1:Ti2e1:Si7ee"));
+  REQUIRE(handler.latency);
+  CHECK(handler.latency->T == 2);
+  CHECK(handler.latency->S == 7);
+
+  REQUIRE(Parse(parser, handler, "d1:A1:P1:Li600000e1:Si1e1:Ti5e1:Vi0ee"));
+  REQUIRE(handler.confirm);
+  CHECK(handler.confirm->pathLifetime == 600000ms);
+  CHECK(handler.confirm->pathCreated == 5ms);
+
+  // an unknown key is still refused and a later message parses clean
+  CHECK_FALSE(Parse(parser, handler, "d1:A1:L1:Qi1e1:Si8ee"));
+  handler.latency.reset();
+  REQUIRE(Parse(parser, handler, "d1:A1:L1:Si9ee"));
+  REQUIRE(handler.latency);
+  CHECK(handler.latency->T == 0);
+  CHECK(handler.latency->S == 9);
+
+  // a type without a schema goes through the key by key parser
+  CHECK_FALSE(Parse(parser, handler, "d1:A1:D1:Si1e1:Vi0ee"));
+  CHECK_FALSE(Parse(parser, handler, "d1:A1:Xe"));
+}
@@ -0,0 +1,331 @@
+#include <llarp/router/router.hpp>
+#include <llarp/rpc/lokid_rpc_client.hpp>
+#include <llarp/rpc/service_node_list.hpp>
+#include <mocks/mock_loop.hpp>
+#include <test_util.hpp>
+
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+#include <oxenc/bt_serialize.h>
+#include <oxenmq/oxenmq.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <unistd.h>
+
+using namespace std::literals;
+using llarp::RouterID;
+using llarp::RouterListColour;
+using llarp::rpc::ServiceNodeList;
+using llarp::rpc::ServiceNodeState;
+
+namespace
+{
+  /// bt-encoded service node entry the way oxend sends it, keys as raw bytes
+  oxenc::bt_dict
+  MakeBTNode(uint8_t id, bool active, bool funded)
+  {
+    const auto rid = llarp::test::makeBuf<RouterID>(id);
+    const auto pk = llarp::test::makeBuf<llarp::PubKey>(id + 1);
+    return oxenc::bt_dict{
+        {"active", active ? 1 : 0},
+        {"funded", funded ? 1 : 0},
+        {"pubkey_ed25519", std::string{reinterpret_cast<const char*>(rid.data()), rid.size()}},
+        {"service_node_pubkey", std::string{reinterpret_cast<const char*>(pk.data()), pk.size()}},
+    };
+  }
+
+  /// json service node entry the way older oxend sends it, keys as hex
+  nlohmann::json
+  MakeJSONNode(uint8_t id, bool active, bool funded)
+  {
+    return nlohmann::json{
+        {"active", active},
+        {"funded", funded},
+        {"pubkey_ed25519", llarp::test::makeBuf<RouterID>(id).ToHex()},
+        {"service_node_pubkey", llarp::test::makeBuf<llarp::PubKey>(id + 1).ToHex()},
+    };
+  }
+
+  ServiceNodeState
+  MakeState(uint8_t id, RouterListColour colour)
+  {
+    return ServiceNodeState{
+        llarp::test::makeBuf<RouterID>(id), llarp::test::makeBuf<llarp::PubKey>(id + 1), colour};
+  }
+
+  /// the poll_block_hash of a bt or json get_service_nodes request, if it has one
+  std::optional<std::string>
+  PolledHash(std::string_view request)
+  {
+    if (not request.empty() and request.front() == 'd')
+    {
+      oxenc::bt_dict_consumer req{request};
+      if (req.skip_until("poll_block_hash"))
+        return req.consume_string();
+      return std::nullopt;
+    }
+    const auto req = nlohmann::json::parse(request);
+    if (auto it = req.find("poll_block_hash"); it != req.end())
+      return it->get<std::string>();
+    return std::nullopt;
+  }
+
+  /// a service node router that only records the whitelist changes it is handed
+  class WhitelistRouter : public llarp::Router
+  {
+    mutable std::mutex _mutex;
+    std::vector<ServiceNodeList::Changes_t> _updates;
+
+   public:
+    WhitelistRouter() : llarp::Router{std::make_shared<mocks::ManualLoop>(), nullptr}
+    {}
+
+    bool
+    IsServiceNode() const override
+    {
+      return true;
+    }
+
+    void
+    UpdateRouterWhitelist(const ServiceNodeList::Changes_t& changes) override
+    {
+      std::lock_guard lock{_mutex};
+      _updates.push_back(changes);
+    }
+
+    std::vector<ServiceNodeList::Changes_t>
+    WhitelistUpdates() const
+    {
+      std::lock_guard lock{_mutex};
+      return _updates;
+    }
+  };
+
+  /// pretends to be oxend for a LokidRpcClient: hands out a key, sends block notifications and
+  /// answers get_service_nodes with the scripted replies in order, repeating the last one
+  struct StandInOxend
+  {
+    using Reply_t = std::pair<std::string, std::string>;
+
+    const std::string addr =
+        "ipc:///tmp/lokinet-test-oxend-" + llarp::test::randFilename() + ".sock";
+    const std::vector<Reply_t> replies;
+
+    std::shared_ptr<WhitelistRouter> router = std::make_shared<WhitelistRouter>();
+    std::shared_ptr<llarp::rpc::LokidRpcClient> client;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> requests;
+    std::optional<oxenmq::ConnectionID> lokinet;
+
+    // declared last so it goes away first and nothing calls into the client while it does
+    oxenmq::OxenMQ oxend;
+
+    explicit StandInOxend(std::vector<Reply_t> scripted) : replies{std::move(scripted)}
+    {
+      oxend.add_category("rpc", oxenmq::AuthLevel::none)
+          .add_request_command("get_service_nodes", [this](oxenmq::Message& msg) {
+            std::unique_lock lock{mutex};
+            requests.emplace_back(msg.data.empty() ? "" : msg.data[0]);
+            const auto& reply = replies[std::min(requests.size(), replies.size()) - 1];
+            lock.unlock();
+            cv.notify_all();
+            msg.send_reply(reply.first, reply.second);
+          });
+      oxend.add_category("admin", oxenmq::AuthLevel::none)
+          .add_request_command("get_service_privkeys", [this](oxenmq::Message& msg) {
+            {
+              std::lock_guard lock{mutex};
+              lokinet = msg.conn;
+            }
+            const nlohmann::json keys{{"service_node_ed25519_privkey", std::string(128, '1')}};
+            msg.send_reply("200", keys.dump());
+          });
+      oxend.listen_plain(addr);
+      oxend.start();
+
+      auto lmq = std::make_shared<oxenmq::OxenMQ>();
+      client = std::make_shared<llarp::rpc::LokidRpcClient>(lmq, router);
+      lmq->start();
+      client->ConnectAsync(oxenmq::address{addr});
+      // the key request tells us which connection to send block notifications down
+      client->ObtainIdentityKey();
+    }
+
+    /// keep announcing new blocks until the client has asked for the service node list count
+    /// times, then return the request it made that time
+    std::string
+    WaitForRequest(size_t count)
+    {
+      std::unique_lock lock{mutex};
+      for (auto tries = 0; tries < 250 and requests.size() < count; ++tries)
+      {
+        oxend.send(*lokinet, "notify.block", "100", std::string(32, '\xbb'));
+        cv.wait_for(lock, 20ms);
+      }
+      REQUIRE(requests.size() >= count);
+      return requests[count - 1];
+    }
+  };
+}  // namespace
+
+TEST_CASE("Parse bt-encoded service node states", "[rpc][snode]")
+{
+  oxenc::bt_list states{
+      MakeBTNode(1, true, true), MakeBTNode(2, false, true), MakeBTNode(3, false, false)};
+  // entries missing fields are skipped
+  states.push_back(oxenc::bt_dict{{"active", 1}});
+  const auto encoded = oxenc::bt_serialize(states);
+
+  const auto parsed = llarp::rpc::ParseServiceNodeStates(oxenc::bt_list_consumer{encoded});
+  REQUIRE(parsed.size() == 3);
+  CHECK(parsed[0].router == llarp::test::makeBuf<RouterID>(1));
+  CHECK(parsed[0].pubkey == llarp::test::makeBuf<llarp::PubKey>(2));
+  CHECK(parsed[0].colour == RouterListColour::white);
+  CHECK(parsed[1].colour == RouterListColour::grey);
+  CHECK(parsed[2].colour == RouterListColour::green);
+}
+
+TEST_CASE("Service node list only reports changes", "[rpc][snode]")
+{
+  ServiceNodeList list;
+
+  auto changes = list.Update(
+      {MakeState(1, RouterListColour::white),
+       MakeState(2, RouterListColour::white),
+       MakeState(3, RouterListColour::grey)});
+  CHECK(changes.size() == 3);
+  CHECK(list.size() == 3);
+  REQUIRE(list.FindPubKey(llarp::test::makeBuf<RouterID>(1)) != nullptr);
+  CHECK(
+      *list.FindPubKey(llarp::test::makeBuf<RouterID>(1))
+      == llarp::test::makeBuf<llarp::PubKey>(2));
+
+  SECTION("same list again has no changes")
+  {
+    changes = list.Update(
+        {MakeState(1, RouterListColour::white),
+         MakeState(2, RouterListColour::white),
+         MakeState(3, RouterListColour::grey)});
+    CHECK(changes.empty());
+  }
+
+  SECTION("added, removed and recoloured nodes")
+  {
+    changes = list.Update(
+        {MakeState(1, RouterListColour::grey),
+         MakeState(3, RouterListColour::grey),
+         MakeState(4, RouterListColour::green)});
+    REQUIRE(changes.size() == 3);
+    CHECK(changes[0] == std::make_pair(llarp::test::makeBuf<RouterID>(1), RouterListColour::grey));
+    CHECK(changes[1] == std::make_pair(llarp::test::makeBuf<RouterID>(4), RouterListColour::green));
+    CHECK(changes[2] == std::make_pair(llarp::test::makeBuf<RouterID>(2), RouterListColour::none));
+    CHECK(list.size() == 3);
+    CHECK(list.FindPubKey(llarp::test::makeBuf<RouterID>(2)) == nullptr);
+  }
+}
+
+TEST_CASE("Lokid client falls back to json when oxend will not give a bt list", "[rpc][snode]")
+{
+  const nlohmann::json jsonReply{
+      {"block_hash", "abcd"},
+      {"service_node_states", {MakeJSONNode(1, true, true), MakeJSONNode(2, false, true)}},
+      {"status", "OK"},
+  };
+
+  SECTION("not found")
+  {
+    StandInOxend oxend{{{"404", "no such thing"}, {"200", jsonReply.dump()}}};
+    CHECK(oxend.WaitForRequest(1).front() == 'd');
+    CHECK(oxend.WaitForRequest(2).front() == '{');
+  }
+
+  SECTION("unsupported media type")
+  {
+    StandInOxend oxend{{{"415", "bt not supported"}, {"200", jsonReply.dump()}}};
+    CHECK(oxend.WaitForRequest(1).front() == 'd');
+    CHECK(oxend.WaitForRequest(2).front() == '{');
+  }
+
+  SECTION("a json reply to a bt request")
+  {
+    StandInOxend oxend{{{"200", jsonReply.dump()}}};
+    CHECK(oxend.WaitForRequest(1).front() == 'd');
+    CHECK(oxend.WaitForRequest(2).front() == '{');
+  }
+
+  SECTION("and then polls the json block hash")
+  {
+    StandInOxend oxend{{{"404", "no such thing"}, {"200", jsonReply.dump()}}};
+    CHECK_FALSE(PolledHash(oxend.WaitForRequest(2)));
+    CHECK(PolledHash(oxend.WaitForRequest(3)) == "abcd");
+    const auto updates = oxend.router->WhitelistUpdates();
+    REQUIRE(updates.size() == 1);
+    CHECK(updates[0].size() == 2);
+  }
+}
+
+TEST_CASE("Lokid client keeps asking for bt after transient errors", "[rpc][snode]")
+{
+  const oxenc::bt_dict listReply{
+      {"block_hash", std::string(32, '\xaa')},
+      {"service_node_states", oxenc::bt_list{MakeBTNode(1, true, true)}},
+      {"status", "OK"},
+  };
+  const auto error = GENERATE(
+      std::make_pair("500", "internal error"),
+      std::make_pair("503", "busy"),
+      std::make_pair("400", "bad request"));
+  INFO(error.first);
+  StandInOxend oxend{
+      {{error.first, error.second},
+       {"200", oxenc::bt_serialize(oxenc::bt_dict{{"status", "BUSY"}})},
+       {"200", oxenc::bt_serialize(listReply)}}};
+
+  // neither the error status nor a bt reply that is not OK makes it give up on bt
+  CHECK(oxend.WaitForRequest(1).front() == 'd');
+  CHECK(oxend.WaitForRequest(2).front() == 'd');
+  CHECK(oxend.WaitForRequest(3).front() == 'd');
+  CHECK(oxend.WaitForRequest(4).front() == 'd');
+  const auto updates = oxend.router->WhitelistUpdates();
+  REQUIRE(updates.size() == 1);
+  CHECK(updates[0].size() == 1);
+}
+
+TEST_CASE("Lokid client polls oxend with the last bt block hash", "[rpc][snode]")
+{
+  const std::string hash(32, '\xaa');
+  const oxenc::bt_dict listReply{
+      {"block_hash", hash},
+      {"service_node_states",
+       oxenc::bt_list{MakeBTNode(1, true, true), MakeBTNode(2, false, true)}},
+      {"status", "OK"},
+  };
+  const oxenc::bt_dict unchangedReply{
+      {"block_hash", hash},
+      {"status", "OK"},
+      {"unchanged", 1},
+  };
+  StandInOxend oxend{
+      {{"200", oxenc::bt_serialize(listReply)}, {"200", oxenc::bt_serialize(unchangedReply)}}};
+
+  CHECK_FALSE(PolledHash(oxend.WaitForRequest(1)));
+
+  const auto polled = oxend.WaitForRequest(2);
+  CHECK(polled.front() == 'd');
+  CHECK(PolledHash(polled) == hash);
+  auto updates = oxend.router->WhitelistUpdates();
+  REQUIRE(updates.size() == 1);
+  REQUIRE(updates[0].size() == 2);
+  CHECK(updates[0][0].first == llarp::test::makeBuf<RouterID>(1));
+  CHECK(updates[0][0].second == RouterListColour::white);
+  CHECK(updates[0][1].first == llarp::test::makeBuf<RouterID>(2));
+  CHECK(updates[0][1].second == RouterListColour::grey);
+
+  // an unchanged list keeps the hash and leaves the whitelist alone
+  CHECK(PolledHash(oxend.WaitForRequest(3)) == hash);
+  CHECK(PolledHash(oxend.WaitForRequest(4)) == hash);
+  CHECK(oxend.router->WhitelistUpdates().size() == 1);
+}
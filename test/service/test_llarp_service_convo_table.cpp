@@ -0,0 +1,126 @@
+#include <llarp/service/convo_table.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <vector>
+
+using namespace std::literals;
+using llarp::service::ConvoTable;
+using llarp::service::ConvoTag;
+using llarp::service::SessionLifetime;
+
+namespace
+{
+  ConvoTag
+  MakeTag(uint64_t n)
+  {
+    ConvoTag tag;
+    std::memcpy(tag.data(), &n, sizeof(n));
+    return tag;
+  }
+
+  llarp::service::ServiceInfo
+  MakeInfo(uint8_t n)
+  {
+    llarp::PubKey sign, enc;
+    sign.Fill(n);
+    enc.Fill(n);
+    llarp::service::ServiceInfo info;
+    info.Update(sign.data(), enc.data());
+    return info;
+  }
+}  // namespace
+
+TEST_CASE("Convo table indexes sessions by remote address", "[service][convo]")
+{
+  ConvoTable table{0s};
+  const auto alice = MakeInfo(1);
+  const auto bob = MakeInfo(2);
+
+  table.Insert(MakeTag(1), alice, true);
+  table.Insert(MakeTag(2), alice, false);
+  table.Insert(MakeTag(3), bob, true);
+  // a blank session has no sender and is in no address's index
+  table.Insert(MakeTag(4)).seqno = 7;
+  REQUIRE(table.Size() == 4);
+
+  CHECK(table.TagsFor(alice.Addr()).size() == 2);
+  CHECK(table.HasInbound(alice.Addr()));
+  CHECK(table.HasOutbound(alice.Addr()));
+  CHECK(table.HasInbound(bob.Addr()));
+  CHECK_FALSE(table.HasOutbound(bob.Addr()));
+
+  // inserting again with a different sender leaves the session as it was
+  CHECK(table.Insert(MakeTag(3), alice, false).remote == bob);
+  CHECK(table.TagsFor(bob.Addr()).size() == 1);
+
+  SECTION("erase by tag")
+  {
+    CHECK(table.Erase(MakeTag(1)));
+    CHECK_FALSE(table.Erase(MakeTag(1)));
+    CHECK_FALSE(table.HasInbound(alice.Addr()));
+    CHECK(table.HasOutbound(alice.Addr()));
+    CHECK(table.TagsFor(alice.Addr()) == std::vector<ConvoTag>{MakeTag(2)});
+  }
+
+  SECTION("erase by address")
+  {
+    CHECK(table.EraseAllFor(alice.Addr()) == 2);
+    CHECK(table.TagsFor(alice.Addr()).empty());
+    CHECK_FALSE(table.Has(MakeTag(1)));
+    CHECK(table.Has(MakeTag(3)));
+    CHECK(table.Find(MakeTag(4))->seqno == 7);
+  }
+}
+
+TEST_CASE("Convo table expires sessions as they come due", "[service][convo]")
+{
+  ConvoTable table{0s};
+  const auto alice = MakeInfo(1);
+  std::vector<ConvoTag> expired;
+  const auto expire = [&](auto now) {
+    table.Expire(now, [&](const auto& tag, const auto&) { expired.push_back(tag); });
+  };
+
+  table.Insert(MakeTag(1), alice, true).lastRecv = 10s;
+  table.Insert(MakeTag(2), alice, false).forever = true;
+  // never used and no intro, gone on the first tick like a full scan would do
+  table.Insert(MakeTag(3));
+
+  expire(5s);
+  CHECK(expired == std::vector<ConvoTag>{MakeTag(3)});
+  expired.clear();
+
+  // not past its lifetime yet
+  expire(10s + SessionLifetime);
+  CHECK(expired.empty());
+
+  SECTION("used again pushes it back")
+  {
+    table.Find(MakeTag(1))->lastSend = 20s;
+    expire(10s + SessionLifetime + 2s);
+    CHECK(expired.empty());
+    expire(20s + SessionLifetime + 2s);
+    CHECK(expired == std::vector<ConvoTag>{MakeTag(1)});
+  }
+
+  SECTION("erased and made again is only expired once")
+  {
+    table.Erase(MakeTag(1));
+    table.Insert(MakeTag(1), alice, true).lastRecv = 10s;
+    expire(10s + SessionLifetime + 2s);
+    CHECK(expired == std::vector<ConvoTag>{MakeTag(1)});
+  }
+
+  SECTION("a long stall")
+  {
+    expire(24h);
+    CHECK(expired == std::vector<ConvoTag>{MakeTag(1)});
+  }
+
+  // kept forever whatever happened above
+  expire(SessionLifetime * 10);
+  CHECK(table.Has(MakeTag(2)));
+  CHECK(table.TagsFor(alice.Addr()) == std::vector<ConvoTag>{MakeTag(2)});
+}
@@ -0,0 +1,129 @@
+#include <llarp/service/endpoint.hpp>
+#include <llarp/service/protocol.hpp>
+#include <llarp/crypto/crypto_libsodium.hpp>
+
+#include <catch2/catch.hpp>
+#include "mocks/mock_router.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace std::literals;
+using namespace llarp;
+using llarp::service::ConvoTag;
+using llarp::service::ProtocolType;
+
+namespace
+{
+  /// endpoint that records the seqno of every packet Pump hands to it
+  struct RecordingEndpoint final : public service::Endpoint,
+                                   public std::enable_shared_from_this<RecordingEndpoint>
+  {
+    std::vector<uint64_t> handled;
+
+    explicit RecordingEndpoint(AbstractRouter* r) : service::Endpoint{r, nullptr}
+    {}
+
+    bool
+    HandleInboundPacket(
+        const ConvoTag, const llarp_buffer_t&, ProtocolType, uint64_t seqno) override
+    {
+      handled.push_back(seqno);
+      return true;
+    }
+
+    std::string
+    GetIfName() const override
+    {
+      return "";
+    }
+
+    path::PathSet_ptr
+    GetSelf() override
+    {
+      return shared_from_this();
+    }
+
+    std::weak_ptr<path::PathSet>
+    GetWeak() override
+    {
+      return weak_from_this();
+    }
+
+    bool
+    SupportsV6() const override
+    {
+      return false;
+    }
+
+    void
+    SendPacketToRemote(const llarp_buffer_t&, ProtocolType) override
+    {}
+
+    huint128_t
+    ObtainIPForAddr(std::variant<service::Address, RouterID>) override
+    {
+      return {0};
+    }
+
+    std::optional<std::variant<service::Address, RouterID>>
+    ObtainAddrForIP(huint128_t) const override
+    {
+      return std::nullopt;
+    }
+
+    /// queue an inbound data message the way the path handler does
+    void
+    Receive(uint64_t tag, uint64_t seqno)
+    {
+      auto msg = std::make_shared<service::ProtocolMessage>();
+      msg->proto = ProtocolType::TrafficV4;
+      std::memcpy(msg->tag.data(), &tag, sizeof(tag));
+      msg->seqno = seqno;
+      REQUIRE(ProcessDataMessage(std::move(msg)));
+    }
+  };
+}  // namespace
+
+TEST_CASE("Endpoint pump hands off inbound traffic in sequence per convo tag", "[service][pump]")
+{
+  CryptoManager manager{new sodium::CryptoLibSodium{}};
+  mocks::Network net{{{"lo", IPRange::FromIPv4(127, 0, 0, 1, 8)}}};
+  mocks::MockRouter router{net, nullptr};
+  auto ep = std::make_shared<RecordingEndpoint>(&router);
+  const auto now = time_now_ms();
+
+  ep->Receive(1, 10);
+  ep->Receive(1, 12);
+  ep->Receive(1, 13);
+  ep->Pump(now);
+  // 12 and 13 wait for the gap at 11
+  CHECK(ep->handled == std::vector<uint64_t>{10});
+
+  SECTION("gap filled")
+  {
+    ep->Receive(1, 11);
+    ep->Pump(now + 1ms);
+    CHECK(ep->handled == std::vector<uint64_t>{10, 11, 12, 13});
+  }
+
+  SECTION("gap times out")
+  {
+    ep->Pump(now + service::InboundReorderGapTimeout - 1ms);
+    CHECK(ep->handled.size() == 1);
+    ep->Pump(now + service::InboundReorderGapTimeout);
+    CHECK(ep->handled == std::vector<uint64_t>{10, 12, 13});
+    // too late to be held back for, handed off as it comes
+    ep->Receive(1, 11);
+    ep->Pump(now + service::InboundReorderGapTimeout + 1ms);
+    CHECK(ep->handled == std::vector<uint64_t>{10, 12, 13, 11});
+  }
+
+  SECTION("convo tags are sequenced apart")
+  {
+    ep->Receive(2, 5);
+    ep->Receive(2, 6);
+    ep->Pump(now + 1ms);
+    CHECK(ep->handled == std::vector<uint64_t>{10, 5, 6});
+  }
+}
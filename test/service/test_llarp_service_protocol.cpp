@@ -0,0 +1,52 @@
+#include "catch2/catch.hpp"
+#include <llarp/service/protocol.hpp>
+
+#include <vector>
+
+using llarp::service::ProtocolMessage;
+using llarp::service::ProtocolType;
+
+TEST_CASE("Traffic batch round trip", "[service][batch]")
+{
+  std::vector<byte_t> batch;
+  std::vector<byte_t> first(40, 'a');
+  std::vector<byte_t> second(llarp::service::MAX_BATCHED_PACKET_SIZE, 'b');
+  REQUIRE(ProtocolMessage::AppendToBatch(batch, ProtocolType::TrafficV4, llarp_buffer_t{first}));
+  REQUIRE(ProtocolMessage::AppendToBatch(batch, ProtocolType::QUIC, llarp_buffer_t{second}));
+
+  std::vector<std::pair<ProtocolType, std::vector<byte_t>>> got;
+  REQUIRE(ProtocolMessage::ForEachInBatch(
+      llarp_buffer_t{batch}, [&got](ProtocolType t, const llarp_buffer_t& pkt) {
+        got.emplace_back(t, std::vector<byte_t>{pkt.base, pkt.base + pkt.sz});
+      }));
+  REQUIRE(got.size() == 2);
+  CHECK(got[0].first == ProtocolType::TrafficV4);
+  CHECK(got[0].second == first);
+  CHECK(got[1].first == ProtocolType::QUIC);
+  CHECK(got[1].second == second);
+}
+
+TEST_CASE("Traffic batch limits", "[service][batch]")
+{
+  std::vector<byte_t> batch;
+  std::vector<byte_t> big(llarp::service::MAX_BATCHED_PACKET_SIZE + 1, 'c');
+  CHECK(not ProtocolMessage::AppendToBatch(batch, ProtocolType::TrafficV4, llarp_buffer_t{big}));
+  std::vector<byte_t> pkt(llarp::service::MAX_BATCHED_PACKET_SIZE, 'd');
+  size_t n = 0;
+  while (ProtocolMessage::AppendToBatch(batch, ProtocolType::TrafficV6, llarp_buffer_t{pkt}))
+    ++n;
+  CHECK(n > 1);
+  CHECK(batch.size() <= llarp::service::MAX_TRAFFIC_BATCH_SIZE);
+}
+
+TEST_CASE("Malformed traffic batch", "[service][batch]")
+{
+  std::vector<byte_t> batch;
+  std::vector<byte_t> pkt(10, 'e');
+  REQUIRE(ProtocolMessage::AppendToBatch(batch, ProtocolType::TrafficV4, llarp_buffer_t{pkt}));
+  batch.pop_back();
+  size_t visited = 0;
+  CHECK(not ProtocolMessage::ForEachInBatch(
+      llarp_buffer_t{batch}, [&visited](auto, const auto&) { ++visited; }));
+  CHECK(visited == 0);
+}
@@ -6,6 +6,10 @@
 #include <llarp/messages/relay_commit.hpp>
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 using namespace ::llarp;
 
 using EncryptedFrame = EncryptedFrame;
@@ -53,3 +57,67 @@ TEST_CASE_METHOD(FrameTest, "Frame crypto")
   REQUIRE(otherRecord.BDecode(buf));
   REQUIRE(otherRecord == record);
 }
+
+TEST_CASE("Encrypted only uses the space its payload needs", "[crypto]")
+{
+  using Encrypted_t = Encrypted<MAX_LINK_MSG_SIZE>;
+  // a short payload never allocates and keeps the type small
+  STATIC_REQUIRE(sizeof(Encrypted_t) < 256);
+
+  std::vector<byte_t> data(MAX_LINK_MSG_SIZE);
+  for (size_t idx = 0; idx < data.size(); ++idx)
+    data[idx] = idx % 251;
+
+  for (size_t sz : {size_t{0}, size_t{16}, Encrypted_t::InlineSize, size_t{1500}, data.size()})
+  {
+    Encrypted_t enc{data.data(), sz};
+    REQUIRE(enc.size() == sz);
+    REQUIRE(std::equal(enc.data(), enc.data() + sz, data.data()));
+    REQUIRE(enc.Buffer()->base == enc.data());
+    REQUIRE(enc.Buffer()->sz == sz);
+
+    Encrypted_t copy{enc};
+    REQUIRE(copy == enc);
+    REQUIRE(copy.data() != enc.data());
+
+    Encrypted_t moved{std::move(copy)};
+    REQUIRE(moved == enc);
+    REQUIRE(moved.Buffer()->base == moved.data());
+    REQUIRE(copy.size() == 0);
+
+    std::array<byte_t, MAX_LINK_MSG_SIZE + 16> tmp;
+    llarp_buffer_t buf{tmp};
+    REQUIRE(enc.BEncode(&buf));
+    buf.sz = buf.cur - buf.base;
+    buf.cur = buf.base;
+    Encrypted_t decoded{data.data(), 42};
+    REQUIRE(decoded.BDecode(&buf));
+    REQUIRE(decoded == enc);
+  }
+
+  // too big is refused
+  Encrypted_t enc;
+  REQUIRE_FALSE(enc.size());
+  enc = llarp_buffer_t{data.data(), 64};
+  REQUIRE(enc.size() == 64);
+  std::vector<byte_t> big(MAX_LINK_MSG_SIZE + 1);
+  Encrypted_t tooBig{big.data(), big.size()};
+  REQUIRE(tooBig.size() == 0);
+}
+
+TEST_CASE("Encrypted resize keeps the payload", "[crypto]")
+{
+  Encrypted<1024> enc{32};
+  enc.Fill(7);
+  enc.Resize(512);
+  REQUIRE(enc.size() == 512);
+  REQUIRE(std::all_of(enc.data(), enc.data() + 32, [](auto b) { return b == 7; }));
+  REQUIRE(std::all_of(enc.data() + 32, enc.data() + 512, [](auto b) { return b == 0; }));
+  REQUIRE(enc.Buffer()->base == enc.data());
+  REQUIRE(enc.Buffer()->sz == 512);
+  enc.Resize(8);
+  REQUIRE(enc.size() == 8);
+  REQUIRE(enc.data()[7] == 7);
+  enc.Resize(2048);
+  REQUIRE(enc.size() == 8);
+}
@@ -0,0 +1,159 @@
+#include <llarp/profiling.hpp>
+#include <llarp/util/file.hpp>
+
+#include <oxenc/bt_serialize.h>
+
+#include <catch2/catch.hpp>
+#include "test_util.hpp"
+
+#include <fstream>
+
+using namespace std::literals;
+using llarp::Profiling;
+using llarp::RouterID;
+using llarp::test::makeBuf;
+
+namespace
+{
+  struct ProfilesFile
+  {
+    const fs::path path{"profiles-" + llarp::test::randFilename() + ".dat"};
+    const fs::path journal{path.string() + ".journal"};
+    const llarp::test::FileGuard pathGuard{path};
+    const llarp::test::FileGuard journalGuard{journal};
+
+    /// the profile dicts in each journal entry
+    std::vector<std::string>
+    JournalEntries() const
+    {
+      std::vector<std::string> entries;
+      const auto data = "l" + llarp::util::slurp_file(journal) + "e";
+      oxenc::bt_list_consumer list{data};
+      while (not list.is_finished())
+        entries.emplace_back(list.consume_string());
+      return entries;
+    }
+  };
+}  // namespace
+
+TEST_CASE("Profiling decays profiles once every 30 seconds", "[profiling]")
+{
+  Profiling profiling;
+  const auto router = makeBuf<RouterID>(1);
+  for (int n = 0; n < 8; ++n)
+    profiling.MarkConnectSuccess(router);
+  CHECK(profiling.Find(router)->connectGoodCount == 8);
+
+  // never decayed before, so decays on the first tick
+  const llarp_time_t now = 1h;
+  profiling.Tick(now);
+  CHECK(profiling.Find(router)->connectGoodCount == 4);
+
+  // the router ticks every fraction of a second, none of these are due
+  for (auto at = now; at <= now + 30s; at += 250ms)
+    profiling.Tick(at);
+  CHECK(profiling.Find(router)->connectGoodCount == 4);
+
+  profiling.Tick(now + 30s + 1ms);
+  CHECK(profiling.Find(router)->connectGoodCount == 2);
+}
+
+TEST_CASE("Profiling finds routers before and after they are indexed", "[profiling]")
+{
+  Profiling profiling;
+  const auto good = makeBuf<RouterID>(1);
+  const auto bad = makeBuf<RouterID>(2);
+  for (int n = 0; n < 8; ++n)
+  {
+    profiling.MarkConnectSuccess(good);
+    profiling.MarkConnectTimeout(bad);
+  }
+  CHECK_FALSE(profiling.IsBadForConnect(good));
+  CHECK(profiling.IsBadForConnect(bad));
+  CHECK_FALSE(profiling.Find(makeBuf<RouterID>(3)));
+
+  // folded into the index by the tick, the same records carry on
+  profiling.Tick(0s);
+  profiling.MarkConnectTimeout(bad);
+  CHECK(profiling.Find(bad)->connectTimeoutCount == 9);
+
+  profiling.ClearProfile(bad);
+  CHECK_FALSE(profiling.Find(bad));
+  CHECK_FALSE(profiling.IsBadForConnect(bad));
+}
+
+TEST_CASE("Profiling journals changed profiles and replays them on load", "[profiling]")
+{
+  ProfilesFile file;
+  const auto alice = makeBuf<RouterID>(1);
+  const auto bob = makeBuf<RouterID>(2);
+  const auto carol = makeBuf<RouterID>(3);
+
+  Profiling profiling;
+  profiling.MarkConnectSuccess(alice);
+  profiling.MarkConnectSuccess(bob);
+  // no profiles file yet, written out whole
+  REQUIRE(profiling.Save(file.path));
+  REQUIRE(fs::exists(file.path));
+  CHECK_FALSE(fs::exists(file.journal));
+  const auto compacted = llarp::util::slurp_file(file.path);
+
+  // nothing changed, nothing written
+  REQUIRE(profiling.Save(file.path));
+  CHECK_FALSE(fs::exists(file.journal));
+
+  profiling.MarkConnectTimeout(bob);
+  profiling.MarkConnectSuccess(carol);
+  REQUIRE(profiling.Save(file.path));
+  profiling.ClearProfile(alice);
+  REQUIRE(profiling.Save(file.path));
+  // the profiles file is left alone, each save is one journal entry
+  CHECK(llarp::util::slurp_file(file.path) == compacted);
+  const auto entries = file.JournalEntries();
+  REQUIRE(entries.size() == 2);
+  {
+    // only what changed, as a dict of router id to profile
+    oxenc::bt_dict_consumer changed{entries[0]};
+    auto [first, bobProfile] = changed.next_dict_consumer();
+    CHECK(first == bob.ToView());
+    CHECK(bobProfile.skip_until("t"));
+    CHECK(bobProfile.consume_integer<uint64_t>() == 1);
+    CHECK(changed.next_dict_consumer().first == carol.ToView());
+    CHECK(changed.is_finished());
+    // a cleared profile is an empty dict
+    oxenc::bt_dict_consumer cleared{entries[1]};
+    auto [second, aliceProfile] = cleared.next_dict_consumer();
+    CHECK(second == alice.ToView());
+    CHECK(aliceProfile.is_finished());
+  }
+
+  SECTION("replayed on load")
+  {
+    Profiling loaded;
+    REQUIRE(loaded.Load(file.path));
+    CHECK_FALSE(loaded.Find(alice));
+    CHECK(loaded.Find(bob)->connectTimeoutCount == 1);
+    CHECK(loaded.Find(bob)->connectGoodCount == 1);
+    CHECK(loaded.Find(carol)->connectGoodCount == 1);
+
+    // the next save folds the journal back into the profiles file
+    REQUIRE(loaded.Save(file.path));
+    CHECK_FALSE(fs::exists(file.journal));
+    Profiling compactedLoad;
+    REQUIRE(compactedLoad.Load(file.path));
+    CHECK_FALSE(compactedLoad.Find(alice));
+    CHECK(compactedLoad.Find(bob)->connectTimeoutCount == 1);
+  }
+
+  SECTION("a torn last entry loses only that save")
+  {
+    {
+      std::ofstream out{file.journal, std::ios::binary | std::ios::app};
+      out << "64:d32:";
+    }
+    Profiling loaded;
+    REQUIRE(loaded.Load(file.path));
+    CHECK_FALSE(loaded.Find(alice));
+    CHECK(loaded.Find(carol));
+  }
+}
@@ -0,0 +1,184 @@
+#include <llarp/tooling/sim_network.hpp>
+#include <llarp/tooling/sim_vpn.hpp>
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace std::literals;
+using namespace tooling;
+
+namespace
+{
+  struct Peer
+  {
+    std::shared_ptr<SimLoop> loop;
+    std::shared_ptr<llarp::UDPHandle> udp;
+    /// when each packet arrived and how big it was
+    std::vector<std::pair<llarp_time_t, size_t>> got;
+
+    Peer(SimNetwork& net, std::string_view addr) : loop{net.MakeLoop()}
+    {
+      udp = loop->make_udp([this](auto&, llarp::SockAddr, llarp::OwnedBuffer buf) {
+        got.emplace_back(loop->time_now(), buf.sz);
+      });
+      REQUIRE(udp->listen(llarp::SockAddr{addr}));
+    }
+
+    /// send num packets of sz bytes from the loop right now
+    void
+    Send(const Peer& to, size_t num, size_t sz)
+    {
+      loop->call_soon([this, dest = *to.udp->LocalAddr(), num, sz]() {
+        std::vector<byte_t> data(sz);
+        for (size_t idx = 0; idx < num; ++idx)
+          udp->send(dest, llarp_buffer_t{data});
+      });
+    }
+  };
+}  // namespace
+
+TEST_CASE("Simulated links delay packets", "[sim]")
+{
+  auto net = std::make_shared<SimNetwork>();
+  LinkParams link;
+  link.latency = 20ms;
+  net->SetDefaultLink(link);
+  Peer alice{*net, "10.0.0.1:1000"};
+  Peer bob{*net, "10.0.0.2:1000"};
+
+  const auto start = net->Now();
+  alice.Send(bob, 1, 100);
+  net->RunFor(19ms);
+  REQUIRE(bob.got.empty());
+  net->RunFor(1ms);
+  REQUIRE(bob.got.size() == 1);
+  REQUIRE(bob.got[0].first == start + 20ms);
+}
+
+TEST_CASE("Simulated links are as fast as their bandwidth", "[sim]")
+{
+  auto net = std::make_shared<SimNetwork>();
+  LinkParams link;
+  link.latency = 10ms;
+  link.bandwidth = 1000;
+  link.maxQueue = 500ms;
+  net->SetDefaultLink(link);
+  Peer alice{*net, "10.0.0.1:1000"};
+  Peer bob{*net, "10.0.0.2:1000"};
+
+  const auto start = net->Now();
+  alice.Send(bob, 10, 100);
+  net->RunFor(10s);
+  // one packet gets on the link every 100ms and we only queue 500ms worth
+  REQUIRE(bob.got.size() == 6);
+  for (size_t idx = 0; idx < bob.got.size(); ++idx)
+    REQUIRE(bob.got[idx].first == start + 10ms + idx * 100ms);
+  REQUIRE(net->GetStats().overflowed == 4);
+}
+
+TEST_CASE("Simulated packet loss is deterministic", "[sim]")
+{
+  const auto run = [](uint64_t seed) {
+    auto net = std::make_shared<SimNetwork>(seed);
+    LinkParams link;
+    link.loss = 0.3;
+    net->SetDefaultLink(link);
+    Peer alice{*net, "10.0.0.1:1000"};
+    Peer bob{*net, "10.0.0.2:1000"};
+    alice.Send(bob, 1000, 10);
+    net->RunFor(1s);
+    return net->GetStats();
+  };
+  const auto first = run(42);
+  REQUIRE(first.delivered + first.lost == 1000);
+  REQUIRE(first.delivered > 600);
+  REQUIRE(first.delivered < 800);
+  REQUIRE(run(42).delivered == first.delivered);
+}
+
+TEST_CASE("Simulated event loops run timers in virtual time", "[sim]")
+{
+  auto net = std::make_shared<SimNetwork>();
+  auto loop = net->MakeLoop();
+  const auto start = net->Now();
+  std::vector<int> order;
+  loop->call_later(2s, [&]() { order.push_back(2); });
+  loop->call_later(1s, [&]() {
+    order.push_back(1);
+    REQUIRE(loop->inEventLoop());
+    REQUIRE(loop->time_now() == start + 1s);
+  });
+  REQUIRE(not loop->inEventLoop());
+  // cancelled before it is due, never runs
+  loop->cancel_later(loop->call_later(1500ms, [&]() { order.push_back(3); }));
+
+  int repeats = 0;
+  auto owner = std::make_shared<int>(0);
+  loop->call_every(100ms, owner, [&]() {
+    if (++repeats == 5)
+      owner.reset();
+  });
+
+  int woken = 0;
+  auto waker = loop->make_waker([&]() { woken++; });
+  waker->Trigger();
+  waker->Trigger();
+
+  net->RunFor(1h);
+  REQUIRE(order == std::vector<int>{1, 2});
+  REQUIRE(repeats == 5);
+  REQUIRE(woken == 1);
+  REQUIRE(net->Now() == start + 1h);
+}
+
+TEST_CASE("Simulated event loops read userspace interfaces", "[sim]")
+{
+  auto net = std::make_shared<SimNetwork>();
+  auto loop = net->MakeLoop();
+  auto netif = std::make_shared<SimInterface>(llarp::vpn::InterfaceInfo{});
+
+  std::vector<size_t> read;
+  REQUIRE(loop->add_network_interface(netif, [&](llarp::net::IPPacket pkt) {
+    read.push_back(pkt.size());
+    // write it back out like lokinet would answer
+    netif->WritePacket(std::move(pkt));
+  }));
+  size_t written = 0;
+  netif->SetSink([&](llarp::net::IPPacket) { written++; });
+
+  loop->call_soon([&]() {
+    netif->Inject(llarp::net::IPPacket{size_t{20}});
+    netif->Inject(llarp::net::IPPacket{size_t{40}});
+  });
+  net->RunFor(1ms);
+  REQUIRE(read == std::vector<size_t>{20, 40});
+  REQUIRE(written == 2);
+  REQUIRE(loop->BusyTime() > std::chrono::nanoseconds{0});
+
+  // paused, packets wait in the interface until we read again
+  loop->call_soon([&]() {
+    loop->pause_network_interface(*netif, true);
+    netif->Inject(llarp::net::IPPacket{size_t{60}});
+  });
+  net->RunFor(1s);
+  REQUIRE(read.size() == 2);
+  loop->call_soon([&]() { loop->pause_network_interface(*netif, false); });
+  net->RunFor(1ms);
+  REQUIRE(read == std::vector<size_t>{20, 40, 60});
+}
+
+TEST_CASE("Simulated time stays on the loops", "[sim]")
+{
+  auto net = std::make_shared<SimNetwork>();
+  auto loop = net->MakeLoop();
+
+  const auto start = loop->time_now();
+  llarp_time_t stamped{0};
+  loop->call_later(10min, [&]() { stamped = loop->time_now(); });
+  net->RunFor(1h);
+  REQUIRE(stamped == start + 10min);
+  REQUIRE(loop->time_now() == start + 1h);
+  // the process clock never went along with it
+  REQUIRE(llarp::time_now_ms() < start + 1h);
+}
@@ -37,3 +37,27 @@ TEST_CASE("DecayingHashSet test decay dynamic time", "[decaying-hashset]")
   hashset.Decay(now + timeout + 1s);
   REQUIRE(not hashset.Contains(zero));
 }
+
+TEST_CASE("DecayingHashSet forgets values in the order they went in", "[decaying-hashset]")
+{
+  static constexpr auto timeout = 5s;
+  llarp::util::DecayingHashSet<llarp::RouterID> hashset{timeout};
+  llarp::RouterID first, second;
+  first.Fill(1);
+  second.Fill(2);
+  REQUIRE(hashset.Insert(first, 1s));
+  REQUIRE(hashset.Insert(second, 2s));
+  REQUIRE_FALSE(hashset.Insert(first, 3s));
+
+  hashset.Decay(1s + timeout);
+  CHECK_FALSE(hashset.Contains(first));
+  CHECK(hashset.Contains(second));
+
+  // removed and put in again later, the old time no longer takes it out
+  hashset.Remove(second);
+  REQUIRE(hashset.Insert(second, 4s));
+  hashset.Decay(2s + timeout);
+  CHECK(hashset.Contains(second));
+  hashset.Decay(4s + timeout);
+  CHECK(hashset.Empty());
+}
@@ -0,0 +1,57 @@
+#include <llarp/util/metrics.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp::metrics;
+
+TEST_CASE("Counter sums adds from many threads", "[metrics]")
+{
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+  {
+    threads.emplace_back([&counter]() {
+      for (int n = 0; n < 10000; ++n)
+        counter.Add();
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  REQUIRE(counter.Value() == 80000);
+}
+
+TEST_CASE("Gauge set and add", "[metrics]")
+{
+  Gauge gauge;
+  gauge.Set(10);
+  gauge.Add(-3);
+  REQUIRE(gauge.Value() == 7);
+}
+
+TEST_CASE("Registry snapshot and prometheus text", "[metrics]")
+{
+  Counter sent;
+  Gauge peers;
+  Registry registry;
+  registry.Register("sent_total", "things sent", sent);
+  registry.Register("peers", "current peers", peers);
+
+  sent.Add(5);
+  peers.Set(3);
+
+  const auto snapshot = registry.Snapshot();
+  REQUIRE(snapshot["sent_total"] == 5);
+  REQUIRE(snapshot["peers"] == 3);
+
+  REQUIRE(
+      registry.PrometheusText("test_")
+      == "# HELP test_sent_total things sent\n"
+         "# TYPE test_sent_total counter\n"
+         "test_sent_total 5\n"
+         "# HELP test_peers current peers\n"
+         "# TYPE test_peers gauge\n"
+         "test_peers 3\n");
+}
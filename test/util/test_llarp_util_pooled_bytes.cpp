@@ -0,0 +1,73 @@
+#include <llarp/crypto/encrypted.hpp>
+#include <llarp/util/pooled_bytes.hpp>
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using llarp::util::PooledBytes;
+
+TEST_CASE("PooledBytes rounds up to a size class", "[pooled-bytes]")
+{
+  REQUIRE_FALSE(PooledBytes{});
+  REQUIRE(PooledBytes{1}.capacity() == 256);
+  REQUIRE(PooledBytes{256}.capacity() == 256);
+  REQUIRE(PooledBytes{257}.capacity() == 512);
+  REQUIRE(PooledBytes{3000}.capacity() == 4096);
+  REQUIRE(PooledBytes{PooledBytes::MaxSize}.capacity() == PooledBytes::MaxSize);
+  REQUIRE_THROWS_AS(PooledBytes{PooledBytes::MaxSize + 1}, std::length_error);
+}
+
+TEST_CASE("PooledBytes gives blocks back to the pool", "[pooled-bytes]")
+{
+  const auto before = PooledBytes::NumSpare(1000);
+  const byte_t* ptr;
+  {
+    PooledBytes bytes{1000};
+    ptr = bytes.data();
+    PooledBytes moved{std::move(bytes)};
+    REQUIRE_FALSE(bytes);
+    REQUIRE(moved.data() == ptr);
+  }
+  REQUIRE(PooledBytes::NumSpare(1000) == before + 1);
+
+  // other classes are left alone
+  const auto small = PooledBytes::NumSpare(100);
+  PooledBytes again{1024};
+  REQUIRE(PooledBytes::NumSpare(1000) == before);
+  REQUIRE(PooledBytes::NumSpare(100) == small);
+}
+
+TEST_CASE("Encrypted payloads recycle pooled blocks", "[pooled-bytes]")
+{
+  using Payload_t = llarp::Encrypted<MAX_LINK_MSG_SIZE - 128>;
+  std::vector<byte_t> data(1500, 0x42);
+
+  // prime the class so the first relayed payload does not allocate either
+  {
+    PooledBytes prime{data.size()};
+  }
+  const auto spare = PooledBytes::NumSpare(data.size());
+  REQUIRE(spare > 0);
+
+  std::vector<Payload_t> batch(8);
+  for (int round = 0; round < 3; ++round)
+  {
+    for (auto& msg : batch)
+      msg = Payload_t{data.data(), data.size()};
+    for (const auto& msg : batch)
+    {
+      REQUIRE(msg.size() == data.size());
+      REQUIRE(msg.data()[msg.size() - 1] == 0x42);
+    }
+    REQUIRE(PooledBytes::NumSpare(data.size()) + batch.size() >= spare);
+    // like BatchPool::Give clearing a relay batch
+    batch.clear();
+    batch.resize(8);
+    REQUIRE(PooledBytes::NumSpare(data.size()) >= spare);
+  }
+
+  // short payloads stay inline
+  Payload_t tiny{data.data(), Payload_t::InlineSize};
+  REQUIRE(PooledBytes::NumSpare(data.size()) >= spare);
+}
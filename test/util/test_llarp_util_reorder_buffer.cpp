@@ -0,0 +1,92 @@
+#include <llarp/util/reorder_buffer.hpp>
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace std::literals;
+
+using Buffer_t = llarp::util::ReorderBuffer<int>;
+
+TEST_CASE("ReorderBuffer hands off in order items immediately", "[reorder-buffer]")
+{
+  Buffer_t buf{8, 100ms};
+  std::vector<int> got;
+  const auto visit = [&got](int v) { got.push_back(v); };
+  for (int i = 0; i < 20; ++i)
+    buf.Put(i, i, 1s, visit);
+  REQUIRE(got.size() == 20);
+  for (int i = 0; i < 20; ++i)
+    REQUIRE(got[i] == i);
+  REQUIRE(not buf.HasGap());
+}
+
+TEST_CASE("ReorderBuffer reorders within window", "[reorder-buffer]")
+{
+  Buffer_t buf{8, 100ms};
+  std::vector<int> got;
+  const auto visit = [&got](int v) { got.push_back(v); };
+  buf.Put(0, 0, 1s, visit);
+  buf.Put(2, 2, 1s, visit);
+  buf.Put(3, 3, 1s, visit);
+  REQUIRE(got == std::vector<int>{0});
+  REQUIRE(buf.Held() == 2);
+  buf.Put(1, 1, 1s, visit);
+  REQUIRE(got == std::vector<int>{0, 1, 2, 3});
+  REQUIRE(not buf.HasGap());
+}
+
+TEST_CASE("ReorderBuffer skips gap on timeout", "[reorder-buffer]")
+{
+  Buffer_t buf{8, 100ms};
+  std::vector<int> got;
+  const auto visit = [&got](int v) { got.push_back(v); };
+  buf.Put(0, 0, 1s, visit);
+  buf.Put(2, 2, 1s, visit);
+  buf.Put(5, 5, 1s, visit);
+  buf.Expire(1s + 50ms, visit);
+  REQUIRE(got == std::vector<int>{0});
+  buf.Expire(1s + 100ms, visit);
+  REQUIRE(got == std::vector<int>{0, 2});
+  REQUIRE(buf.HasGap());
+  buf.Expire(1s + 200ms, visit);
+  REQUIRE(got == std::vector<int>{0, 2, 5});
+  REQUIRE(not buf.HasGap());
+  // late arrival is still handed off
+  buf.Put(1, 1, 2s, visit);
+  REQUIRE(got == std::vector<int>{0, 2, 5, 1});
+  buf.Put(6, 6, 2s, visit);
+  REQUIRE(got == std::vector<int>{0, 2, 5, 1, 6});
+}
+
+TEST_CASE("ReorderBuffer skips gap on window overflow", "[reorder-buffer]")
+{
+  Buffer_t buf{4, 100ms};
+  std::vector<int> got;
+  const auto visit = [&got](int v) { got.push_back(v); };
+  buf.Put(0, 0, 1s, visit);
+  buf.Put(2, 2, 1s, visit);
+  buf.Put(3, 3, 1s, visit);
+  buf.Put(6, 6, 1s, visit);
+  REQUIRE(got == std::vector<int>{0, 2, 3});
+  REQUIRE(buf.Held() == 1);
+  buf.Put(20, 20, 1s, visit);
+  REQUIRE(got == std::vector<int>{0, 2, 3, 6});
+  buf.Put(17, 17, 1s, visit);
+  buf.Put(18, 18, 1s, visit);
+  buf.Put(19, 19, 1s, visit);
+  REQUIRE(got == std::vector<int>{0, 2, 3, 6, 17, 18, 19, 20});
+}
+
+TEST_CASE("ReorderBuffer resyncs when remote restarts sequence", "[reorder-buffer]")
+{
+  Buffer_t buf{4, 100ms};
+  std::vector<int> got;
+  const auto visit = [&got](int v) { got.push_back(v); };
+  buf.Put(100, 100, 1s, visit);
+  buf.Put(102, 102, 1s, visit);
+  buf.Put(0, 0, 1s, visit);
+  REQUIRE(got == std::vector<int>{100, 102, 0});
+  buf.Put(2, 2, 1s, visit);
+  buf.Put(1, 1, 1s, visit);
+  REQUIRE(got == std::vector<int>{100, 102, 0, 1, 2});
+}
@@ -0,0 +1,53 @@
+#include <llarp/util/ring_queue.hpp>
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+TEST_CASE("RingQueue is fifo across growth and wrap around", "[ring-queue]")
+{
+  llarp::util::RingQueue<int> queue{4};
+  REQUIRE(queue.empty());
+  int next_in = 0;
+  int next_out = 0;
+  for (int round = 0; round < 10; ++round)
+  {
+    for (int i = 0; i < round + 3; ++i)
+      queue.push_back(next_in++);
+    for (int i = 0; i < round + 1; ++i)
+    {
+      REQUIRE(queue.front() == next_out++);
+      queue.pop_front();
+    }
+  }
+  REQUIRE(queue.size() == size_t(next_in - next_out));
+  while (not queue.empty())
+  {
+    REQUIRE(queue.front() == next_out++);
+    queue.pop_front();
+  }
+  REQUIRE(next_out == next_in);
+}
+
+TEST_CASE("RingQueue keeps its storage once drained", "[ring-queue]")
+{
+  llarp::util::RingQueue<int> queue{2};
+  for (int i = 0; i < 16; ++i)
+    queue.push_back(i);
+  const auto cap = queue.capacity();
+  REQUIRE(cap >= 16);
+  queue.clear();
+  REQUIRE(queue.empty());
+  for (int i = 0; i < 16; ++i)
+    queue.push_back(i);
+  REQUIRE(queue.capacity() == cap);
+}
+
+TEST_CASE("RingQueue releases popped values", "[ring-queue]")
+{
+  llarp::util::RingQueue<std::shared_ptr<int>> queue;
+  auto val = std::make_shared<int>(42);
+  queue.push_back(val);
+  REQUIRE(val.use_count() == 2);
+  queue.pop_front();
+  REQUIRE(val.use_count() == 1);
+}
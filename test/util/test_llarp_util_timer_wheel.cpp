@@ -0,0 +1,144 @@
+#include <llarp/util/timer_wheel.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <map>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace std::literals;
+using llarp::util::TimerWheel;
+
+TEST_CASE("Timer wheel runs timers in order once they are due", "[util][timer]")
+{
+  TimerWheel wheel{1ms, 0s};
+  std::vector<int> ran;
+  REQUIRE(wheel.Schedule(1, 5ms, [&]() { ran.push_back(1); }));
+  REQUIRE(wheel.Schedule(2, 300ms, [&]() { ran.push_back(2); }));
+  REQUIRE(wheel.Schedule(3, 70s, [&]() { ran.push_back(3); }));
+  REQUIRE(wheel.Schedule(4, 6h, [&]() { ran.push_back(4); }));
+  CHECK_FALSE(wheel.Schedule(1, 1ms, []() {}));
+  CHECK(wheel.Size() == 4);
+  CHECK(wheel.NextDue() == 5ms);
+
+  CHECK(wheel.Advance(4ms) == 0);
+  CHECK(wheel.Advance(5ms) == 1);
+  CHECK(wheel.Advance(299ms) == 0);
+  CHECK(wheel.Advance(1min) == 1);
+  CHECK(wheel.Advance(6h - 1ms) == 1);
+  CHECK(wheel.Advance(6h) == 1);
+  CHECK(ran == std::vector<int>{1, 2, 3, 4});
+  CHECK(wheel.Empty());
+  CHECK_FALSE(wheel.NextDue());
+}
+
+TEST_CASE("Timer wheel cancels and reschedules from callbacks", "[util][timer]")
+{
+  TimerWheel wheel{1ms, 0s};
+  std::vector<int> ran;
+  wheel.Schedule(1, 10ms, [&]() {
+    ran.push_back(1);
+    CHECK(wheel.Cancel(2));
+    // already due, runs on the next tick
+    wheel.Schedule(3, 0ms, [&]() { ran.push_back(3); });
+  });
+  wheel.Schedule(2, 20ms, [&]() { ran.push_back(2); });
+  CHECK_FALSE(wheel.Cancel(42));
+
+  CHECK(wheel.Advance(10ms) == 1);
+  CHECK(wheel.Advance(11ms) == 1);
+  CHECK(wheel.Advance(1s) == 0);
+  CHECK(ran == std::vector<int>{1, 3});
+  CHECK(wheel.Empty());
+}
+
+TEST_CASE("Timer wheel forgets cancelled timers straight away", "[util][timer]")
+{
+  TimerWheel wheel{1ms, 0s};
+  // three in the same slot and one a level up
+  for (TimerWheel::ID_t id = 1; id <= 3; ++id)
+    wheel.Schedule(id, 5ms, []() {});
+  wheel.Schedule(4, 10s, []() {});
+
+  // cancelling the middle one leaves the others where they were
+  CHECK(wheel.Cancel(2));
+  CHECK(wheel.NextDue() == 5ms);
+  CHECK(wheel.Cancel(1));
+  CHECK(wheel.Cancel(3));
+  // nothing is left in the slot to wake up for, next is the tick the 10s one moves down a level
+  CHECK(wheel.NextDue() == 39 * 256ms);
+  CHECK(wheel.Cancel(4));
+  CHECK_FALSE(wheel.NextDue());
+  CHECK(wheel.Empty());
+  CHECK(wheel.Advance(1min) == 0);
+}
+
+TEST_CASE("Timer wheel timers beyond its reach and after long gaps", "[util][timer]")
+{
+  TimerWheel wheel{1ms, 0s};
+  int ran = 0;
+  // further out than 2^32 ticks, parked at the edge and placed again
+  constexpr auto far = std::chrono::hours{24 * 60};
+  wheel.Schedule(1, far, [&]() { ran++; });
+  CHECK(wheel.Advance(far - 1ms) == 0);
+  CHECK(wheel.Advance(far) == 1);
+
+  // scheduled long after the last advance, relative to where the wheel was left
+  wheel.Schedule(2, far * 3 + 10ms, [&]() { ran++; });
+  CHECK(wheel.Advance(far * 3) == 0);
+  CHECK(wheel.Advance(far * 3 + 10ms) == 1);
+  CHECK(ran == 2);
+}
+
+TEST_CASE("Timer wheel runs random timers on time", "[util][timer]")
+{
+  std::mt19937_64 rng{7};
+  TimerWheel wheel{10ms, 0s};
+  std::map<TimerWheel::ID_t, llarp_time_t> pending;
+  std::vector<std::pair<TimerWheel::ID_t, llarp_time_t>> fired;
+  llarp_time_t now = 0s;
+  // timers run on the first tick at or after their time
+  const auto tickOf = [](llarp_time_t at) { return (at + 9ms) / 10ms * 10ms; };
+
+  TimerWheel::ID_t id = 0;
+  for (int round = 0; round < 200; ++round)
+  {
+    for (int n = 0; n < 20; ++n)
+    {
+      // anywhere from now to past the second level
+      const auto at = now + llarp_time_t(rng() % (1 << (rng() % 24)));
+      ++id;
+      wheel.Schedule(id, at, [&fired, id, at]() { fired.emplace_back(id, at); });
+      pending.emplace(id, at);
+    }
+    if (rng() % 2)
+    {
+      auto itr = std::next(pending.begin(), rng() % pending.size());
+      REQUIRE(wheel.Cancel(itr->first));
+      pending.erase(itr);
+    }
+    now += llarp_time_t(rng() % 5000);
+    wheel.Advance(now);
+
+    // each pending timer ran exactly once and never early
+    for (const auto& [thisID, at] : fired)
+    {
+      REQUIRE(at <= now);
+      REQUIRE(pending.erase(thisID) == 1);
+    }
+    fired.clear();
+    // and none was left behind
+    std::optional<llarp_time_t> earliest;
+    for (const auto& [thisID, at] : pending)
+    {
+      REQUIRE(tickOf(at) > now);
+      if (not earliest or at < *earliest)
+        earliest = at;
+    }
+    // the wheel never sleeps past the next timer
+    if (earliest)
+      REQUIRE(wheel.NextDue() <= tickOf(*earliest));
+    REQUIRE(wheel.Size() == pending.size());
+  }
+}
@@ -0,0 +1,72 @@
+#include <llarp/util/thread/block_pool.hpp>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp::thread;
+
+TEST_CASE("BlockPool reuses dropped blocks", "[block-pool]")
+{
+  BlockPool<64> pool{2};
+  REQUIRE(pool.NumSpare() == 0);
+
+  auto first = pool.Take();
+  auto second = pool.Take();
+  REQUIRE(first);
+  REQUIRE(first.get() != second.get());
+  const auto firstBlock = first.get();
+
+  first.reset();
+  REQUIRE(pool.NumSpare() == 1);
+  auto again = pool.Take();
+  REQUIRE(again.get() == firstBlock);
+  REQUIRE(pool.NumSpare() == 0);
+}
+
+TEST_CASE("BlockPool only keeps so many spares", "[block-pool]")
+{
+  BlockPool<64> pool{2};
+  {
+    std::vector<BlockPool<64>::Ptr_t> blocks;
+    for (int n = 0; n < 5; ++n)
+      blocks.emplace_back(pool.Take());
+  }
+  REQUIRE(pool.NumSpare() == 2);
+}
+
+TEST_CASE("BlockPool hands each block to one taker at a time", "[block-pool]")
+{
+  constexpr size_t threads = 4;
+  constexpr size_t rounds = 20000;
+  BlockPool<8> pool{4};
+  std::atomic<bool> go{false};
+  std::atomic<size_t> failures{0};
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&, t]() {
+      while (not go)
+        std::this_thread::yield();
+      for (size_t n = 0; n < rounds; ++n)
+      {
+        auto block = pool.Take();
+        (*block)[0] = t;
+        std::this_thread::yield();
+        // anyone else holding this block at the same time would have overwritten it
+        if ((*block)[0] != t)
+          failures++;
+      }
+    });
+  }
+  go = true;
+  for (auto& worker : workers)
+    worker.join();
+
+  REQUIRE(failures == 0);
+  REQUIRE(pool.NumSpare() <= 4);
+}
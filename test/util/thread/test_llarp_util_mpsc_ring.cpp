@@ -0,0 +1,115 @@
+#include <llarp/util/thread/mpsc_ring.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp::thread;
+
+namespace
+{
+  struct Item
+  {
+    size_t producer = 0;
+    size_t seqno = 0;
+  };
+
+  /// run producers threads each pushing count items into push(Item&&), retrying when full,
+  /// while the calling thread pops with pop(visit) until every item has arrived.
+  /// returns the per producer sequence numbers in the order they were received.
+  template <typename Push_t, typename Pop_t>
+  std::vector<std::vector<size_t>>
+  RunProducers(size_t producers, size_t count, Push_t push, Pop_t pop)
+  {
+    std::vector<std::vector<size_t>> received(producers);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+      threads.emplace_back([&go, &push, p, count]() {
+        while (not go)
+          std::this_thread::yield();
+        for (size_t seqno = 0; seqno < count; ++seqno)
+        {
+          while (not push(Item{p, seqno}))
+            std::this_thread::yield();
+        }
+      });
+    }
+    go = true;
+    size_t total = 0;
+    while (total < producers * count)
+    {
+      const auto popped =
+          pop([&received](Item item) { received[item.producer].push_back(item.seqno); });
+      if (popped == 0)
+        std::this_thread::yield();
+      total += popped;
+    }
+    for (auto& thread : threads)
+      thread.join();
+    return received;
+  }
+}  // namespace
+
+TEST_CASE("MPSCRing rounds capacity up to a power of 2", "[mpsc-ring]")
+{
+  MPSCRing<int> ring{1000};
+  REQUIRE(ring.capacity() == 1024);
+  REQUIRE(ring.empty());
+}
+
+TEST_CASE("MPSCRing single threaded push and pop", "[mpsc-ring]")
+{
+  MPSCRing<std::unique_ptr<int>> ring{4};
+
+  for (int i = 0; i < 4; ++i)
+    REQUIRE(ring.tryPushBack(std::make_unique<int>(i)));
+
+  auto extra = std::make_unique<int>(4);
+  REQUIRE_FALSE(ring.tryPushBack(std::move(extra)));
+  // a failed push leaves the value with the caller
+  REQUIRE(extra);
+  REQUIRE(ring.size() == 4);
+
+  auto val = ring.tryPopFront();
+  REQUIRE(val);
+  REQUIRE(**val == 0);
+
+  // wrap around
+  REQUIRE(ring.tryPushBack(std::move(extra)));
+
+  std::vector<int> popped;
+  REQUIRE(ring.popBatch([&popped](std::unique_ptr<int> ptr) { popped.push_back(*ptr); }, 2) == 2);
+  REQUIRE(popped == std::vector<int>{1, 2});
+  REQUIRE(ring.popBatch([&popped](std::unique_ptr<int> ptr) { popped.push_back(*ptr); }, 10) == 2);
+  REQUIRE(popped == std::vector<int>{1, 2, 3, 4});
+  REQUIRE(ring.empty());
+  REQUIRE_FALSE(ring.tryPopFront());
+}
+
+TEST_CASE("MPSCRing delivers every item in per producer order", "[mpsc-ring]")
+{
+  constexpr size_t producers = 4;
+  constexpr size_t count = 20000;
+  // small ring so producers regularly find it full
+  MPSCRing<Item> ring{64};
+
+  const auto received = RunProducers(
+      producers,
+      count,
+      [&ring](Item item) { return ring.tryPushBack(std::move(item)); },
+      [&ring](auto visit) { return ring.popBatch(visit, 32); });
+
+  for (const auto& seqnos : received)
+  {
+    REQUIRE(seqnos.size() == count);
+    for (size_t idx = 0; idx < count; ++idx)
+      REQUIRE(seqnos[idx] == idx);
+  }
+  REQUIRE(ring.empty());
+}